@@ -7,6 +7,7 @@
 #include "zipArchive.h"
 #include <TFE_FileSystem/fileutil.h>
 #include <assert.h>
+#include <ctype.h>
 #include <string>
 #include <map>
 
@@ -37,6 +38,69 @@ ArchiveType Archive::getArchiveTypeFromName(const char* path)
 	return ARCHIVE_UNKNOWN;
 }
 
+// FNV-1a over the upper case characters.
+u32 Archive::hashFileName(const char* name)
+{
+	u32 hash = 2166136261u;
+	for (const u8* c = (const u8*)name; *c; c++)
+	{
+		hash ^= u32(toupper(*c));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void Archive::clearFileIndex()
+{
+	m_fileHash.clear();
+}
+
+void Archive::buildFileIndex()
+{
+	m_fileHash.clear();
+	const u32 count = getFileCount();
+	if (!count) { return; }
+
+	// Keep the load factor at or below 50%.
+	u32 size = 16;
+	while (size < count * 2) { size <<= 1; }
+	m_fileHash.resize(size, { 0, INVALID_FILE });
+
+	// Entries are inserted in directory order, so the first of any duplicate names is found first -
+	// matching the original linear search.
+	const u32 mask = size - 1;
+	for (u32 i = 0; i < count; i++)
+	{
+		const char* name = getFileName(i);
+		if (!name) { continue; }
+
+		const u32 hash = hashFileName(name);
+		u32 slot = hash & mask;
+		while (m_fileHash[slot].index != INVALID_FILE)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_fileHash[slot] = { hash, i };
+	}
+}
+
+u32 Archive::findFileIndex(const char* file)
+{
+	if (m_fileHash.empty() || !file) { return INVALID_FILE; }
+
+	const u32 mask = u32(m_fileHash.size()) - 1;
+	const u32 hash = hashFileName(file);
+	for (u32 slot = hash & mask; m_fileHash[slot].index != INVALID_FILE; slot = (slot + 1) & mask)
+	{
+		const FileHashEntry* entry = &m_fileHash[slot];
+		if (entry->hash == hash && strcasecmp(file, getFileName(entry->index)) == 0)
+		{
+			return entry->index;
+		}
+	}
+	return INVALID_FILE;
+}
+
 Archive* Archive::getArchive(ArchiveType type, const char* name, const char* path)
 {
 	ArchiveMap::iterator iArchive = s_archives[type].find(path);
@@ -102,6 +166,7 @@ void Archive::freeArchive(Archive* archive)
 
 		s_archives[type].erase(iArchive);
 	}
+	TFE_Paths::invalidateFileCache();
 }
 
 void Archive::freeAllArchives()
@@ -117,6 +182,7 @@ void Archive::freeAllArchives()
 		}
 		s_archives[i].clear();
 	}
+	TFE_Paths::invalidateFileCache();
 }
 
 Archive* Archive::createCustomArchive(ArchiveType type, const char* path)
@@ -175,4 +241,5 @@ void Archive::deleteCustomArchive(Archive* archive)
 		s_archives->erase(iArchive);
 	}
 	delete archive;
+	TFE_Paths::invalidateFileCache();
 }
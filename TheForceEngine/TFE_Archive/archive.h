@@ -3,6 +3,7 @@
 
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/paths.h>
+#include <vector>
 
 enum ArchiveType
 {
@@ -28,6 +29,8 @@ public:
 	static void deleteCustomArchive(Archive* archive);
 
 	static ArchiveType getArchiveTypeFromName(const char* path);
+	// Case-insensitive hash of a file name, shared with the TFE_Paths lookup cache.
+	static u32 hashFileName(const char* name);
 	
 	// Public Archive API
 public:
@@ -63,6 +66,12 @@ public:
 	// Edit
 	virtual void addFile(const char* fileName, const char* filePath) = 0;
 
+	// Name to index lookup, each archive builds it once the directory has been read.
+protected:
+	void buildFileIndex();
+	void clearFileIndex();
+	u32  findFileIndex(const char* file);
+
 	// Shared Private State
 protected:
 	ArchiveType m_type;
@@ -70,4 +79,12 @@ protected:
 	char m_archivePath[TFE_MAX_PATH];
 
 	s32 m_fileOffset;
+
+private:
+	struct FileHashEntry
+	{
+		u32 hash;
+		u32 index;		// INVALID_FILE for empty slots.
+	};
+	std::vector<FileHashEntry> m_fileHash;	// open addressing, the size is a power of 2.
 };
@@ -32,6 +32,7 @@ bool GobArchive::create(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	clearFileIndex();
 
 	return true;
 }
@@ -52,6 +53,7 @@ bool GobArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	buildFileIndex();
 
 	return true;
 }
@@ -62,6 +64,7 @@ void GobArchive::close()
 	m_archiveOpen = false;
 	delete[] m_fileList.entries;
 	m_fileList.entries = nullptr;
+	clearFileIndex();
 }
 
 // File Access
@@ -70,18 +73,11 @@ bool GobArchive::openFile(const char *file)
 	if (!m_archiveOpen) { return false; }
 
 	m_file.open(m_archivePath, FileStream::MODE_READ);
-	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
+	const u32 index = findFileIndex(file);
+	m_curFile = index != INVALID_FILE ? s32(index) : -1;
 
 	if (m_curFile == -1)
 	{
@@ -115,32 +111,14 @@ void GobArchive::closeFile()
 u32 GobArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobArchive::fileExists(u32 index)
@@ -242,6 +220,8 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 	newFile->LEN = long(len);
 	strcpy(newFile->NAME, fileName);
 	m_header.MASTERX += newFile->LEN;
+	buildFileIndex();
+	TFE_Paths::invalidateFileCache();
 
 	// Read all of the file data.
 	std::vector<std::vector<u8>> fileData(m_fileList.MASTERN);
@@ -40,6 +40,7 @@ bool GobMemoryArchive::open(const u8* buffer, size_t size)
 	m_fileList.entries = (GobArchive::GOB_Entry_t*)(readBuffer);
 
 	m_archiveOpen = true;
+	buildFileIndex();
 
 	return true;
 }
@@ -49,6 +50,7 @@ void GobMemoryArchive::close()
 	m_archiveOpen = false;
 	free((void*)m_buffer);
 	m_buffer = nullptr;
+	clearFileIndex();
 }
 
 // File Access
@@ -56,18 +58,11 @@ bool GobMemoryArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
+	const u32 index = findFileIndex(file);
+	m_curFile = index != INVALID_FILE ? s32(index) : -1;
 
 	if (m_curFile == -1)
 	{
@@ -99,32 +94,14 @@ void GobMemoryArchive::closeFile()
 u32 GobMemoryArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobMemoryArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobMemoryArchive::fileExists(u32 index)
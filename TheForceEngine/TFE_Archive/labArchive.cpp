@@ -33,9 +33,11 @@ bool LabArchive::open(const char *archivePath)
 
 	// Read string table.
 	m_file.readBuffer(m_stringTable, m_header.stringTableSize);
+	m_stringTable[m_header.stringTableSize] = 0;
 	m_file.close();
 		
 	strcpy(m_archivePath, archivePath);
+	buildFileIndex();
 	
 	return true;
 }
@@ -46,6 +48,7 @@ void LabArchive::close()
 	m_archiveOpen = false;
 	delete[] m_entries;
 	delete[] m_stringTable;
+	clearFileIndex();
 }
 
 // File Access
@@ -54,18 +57,11 @@ bool LabArchive::openFile(const char *file)
 	if (!m_archiveOpen) { return false; }
 
 	m_file.open(m_archivePath, FileStream::MODE_READ);
-	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
+	const u32 index = findFileIndex(file);
+	m_curFile = index != INVALID_FILE ? s32(index) : -1;
 
 	if (m_curFile == -1)
 	{
@@ -100,32 +96,14 @@ u32 LabArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LabArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LabArchive::fileExists(u32 index)
@@ -25,6 +25,7 @@ bool LfdArchive::create(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	clearFileIndex();
 
 	return true;
 }
@@ -62,6 +63,7 @@ bool LfdArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	buildFileIndex();
 
 	return true;
 }
@@ -76,6 +78,7 @@ void LfdArchive::close()
 		delete[] m_fileList.entries;
 		m_fileList.entries = nullptr;
 	}
+	clearFileIndex();
 }
 
 // File Access
@@ -84,18 +87,11 @@ bool LfdArchive::openFile(const char *file)
 	if (!m_archiveOpen) { return false; }
 
 	m_file.open(m_archivePath, FileStream::MODE_READ);
-	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
-	}
+	const u32 index = findFileIndex(file);
+	m_curFile = index != INVALID_FILE ? s32(index) : -1;
 
 	if (m_curFile == -1)
 	{
@@ -130,32 +126,14 @@ u32 LfdArchive::getFileIndex(const char* file)
 {
 	if (!m_archiveOpen) { return INVALID_FILE; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LfdArchive::fileExists(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 	m_curFile = -1;
-
-	//search for this file.
-	for (s32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LfdArchive::fileExists(u32 index)
@@ -1,30 +1,109 @@
 #include "zipArchive.h"
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_System/system.h>
-#include "zip/zip.h"
+#include <TFE_System/Threads/mutex.h>
+#define MINIZ_HEADER_FILE_ONLY
+#include "zip/miniz.h"
 #include <assert.h>
 #include <string>
 #include <algorithm>
 #include <map>
 
+// Streaming decompression state.
+// Output is decompressed into the dictionary ring buffer and copied out as it is read, so entries of any size
+// can be read in pieces without a full size temporary buffer.
+struct ZipStream
+{
+	tinfl_decompressor inflator;
+	u8 dict[TINFL_LZ_DICT_SIZE];
+	u8 input[16384];
+
+	size_t inputOffset;
+	size_t inputAvail;
+	u64 compressedRead;	// compressed bytes read from the archive.
+	u64 produced;		// uncompressed bytes written into the dictionary.
+	u64 consumed;		// uncompressed bytes returned or skipped, this is the stream position.
+	bool done;
+
+	ZipStream* next;
+};
+
 namespace
 {
-	const size_t c_blockShift = 8;	// 256 bytes.
-	const size_t c_blockSize = 1 << c_blockShift;
+	// Local directory header layout, see the ZIP specification.
+	const u32 c_localHeaderSig = 0x04034b50;
+	const u32 c_localHeaderSize = 30;
+	const u32 c_localHeaderNameLenOfs = 26;
+	const u32 c_localHeaderExtraLenOfs = 28;
+	const u16 c_methodStored = 0;
+	const u16 c_methodDeflate = 8;
+
+	// Decompressor states are large (~60Kb) so they are shared by all Zip archives.
+	// Any number can be in use at once, but only a few free states are kept around.
+	const s32 c_maxFreeStreams = 4;
+	static ZipStream* s_freeStreams = nullptr;
+	static s32 s_freeStreamCount = 0;
+	static Mutex* s_streamMutex = Mutex::create();
+
+	ZipStream* allocStream()
+	{
+		s_streamMutex->lock();
+		ZipStream* stream = s_freeStreams;
+		if (stream)
+		{
+			s_freeStreams = stream->next;
+			s_freeStreamCount--;
+		}
+		s_streamMutex->unlock();
+
+		if (!stream)
+		{
+			stream = (ZipStream*)malloc(sizeof(ZipStream));
+		}
+		return stream;
+	}
 
-	size_t roundBufferSize(size_t size)
+	void freeStream(ZipStream* stream)
 	{
-		size = (size + c_blockSize - 1) >> c_blockShift;
-		return size << c_blockShift;
+		if (!stream) { return; }
+
+		s_streamMutex->lock();
+		if (s_freeStreamCount < c_maxFreeStreams)
+		{
+			stream->next = s_freeStreams;
+			s_freeStreams = stream;
+			s_freeStreamCount++;
+			stream = nullptr;
+		}
+		s_streamMutex->unlock();
+
+		free(stream);
+	}
+
+	void resetStream(ZipStream* stream)
+	{
+		tinfl_init(&stream->inflator);
+		stream->inputOffset = 0;
+		stream->inputAvail = 0;
+		stream->compressedRead = 0;
+		stream->produced = 0;
+		stream->consumed = 0;
+		stream->done = false;
+	}
+
+	u16 readLE16(const u8* data)
+	{
+		return u16(data[0]) | (u16(data[1]) << 8);
+	}
+
+	u32 readLE32(const u8* data)
+	{
+		return u32(data[0]) | (u32(data[1]) << 8) | (u32(data[2]) << 16) | (u32(data[3]) << 24);
 	}
 }
 
 ZipArchive::~ZipArchive()
 {
-	free(m_tempBuffer);
-	m_tempBuffer = nullptr;
-	m_tempBufferSize = 0;
-
 	close();
 }
 
@@ -35,47 +114,58 @@ bool ZipArchive::create(const char *archivePath)
 
 bool ZipArchive::open(const char *archivePath)
 {
+	close();
 	m_curFile = INVALID_FILE;
 	m_entryCount = 0;
 	m_fileOffset = 0;
-	m_tempBuffer = nullptr;
-	m_tempBufferSize = 0;
 
-	struct zip_t* zip = zip_open(archivePath, 0, 'r');
-	if (!zip)
+	// The archive stays open until close(), so the central directory is only parsed once.
+	mz_zip_archive* zip = (mz_zip_archive*)malloc(sizeof(mz_zip_archive));
+	memset(zip, 0, sizeof(mz_zip_archive));
+	if (!mz_zip_reader_init_file(zip, archivePath, 0))
 	{
 		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open Zip Archive '%s'", archivePath);
+		free(zip);
 		return false;
 	}
 
 	// Read the directory.
-	m_entryCount = zip_total_entries(zip);
+	m_entryCount = s32(mz_zip_reader_get_num_files(zip));
 	if (m_entryCount <= 0)
 	{
 		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Zip Archive '%s' is empty.", archivePath);
-		zip_close(zip);
+		mz_zip_reader_end(zip);
+		free(zip);
+		m_entryCount = 0;
 		return false;
 	}
 	m_entries = new ZipEntry[m_entryCount];
 
 	for (s32 i = 0; i < m_entryCount; i++)
 	{
-		if (zip_entry_openbyindex(zip, i) != 0)
+		mz_zip_archive_file_stat stat;
+		if (!mz_zip_reader_file_stat(zip, i, &stat))
 		{
 			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot read entry '%d' from archive '%s'", i, archivePath);
-			zip_close(zip);
+			mz_zip_reader_end(zip);
+			free(zip);
+			delete[] m_entries;
+			m_entries = nullptr;
+			m_entryCount = 0;
 			return false;
 		}
 
-		m_entries[i].isDir = (zip_entry_isdir(zip) == 1);
-		m_entries[i].name = zip_entry_name(zip);
-		m_entries[i].length = (size_t)zip_entry_size(zip);
-		zip_entry_close(zip);
+		m_entries[i].isDir = mz_zip_reader_is_file_a_directory(zip, i) != 0;
+		m_entries[i].name = stat.m_filename;
+		m_entries[i].length = (size_t)stat.m_uncomp_size;
+		m_entries[i].compressedLength = (size_t)stat.m_comp_size;
+		m_entries[i].localHeaderOffset = stat.m_local_header_ofs;
+		m_entries[i].method = stat.m_method;
 	}
-	zip_close(zip);
 
 	strcpy(m_archivePath, archivePath);
-	m_fileHandle = nullptr;
+	m_zip = zip;
+	buildFileIndex();
 
 	return true;
 }
@@ -84,79 +174,78 @@ void ZipArchive::close()
 {
 	closeFile();
 
+	if (m_zip)
+	{
+		mz_zip_reader_end((mz_zip_archive*)m_zip);
+		free(m_zip);
+		m_zip = nullptr;
+	}
+
 	delete[] m_entries;
 	m_entries = nullptr;
 	m_curFile = INVALID_FILE;
+	m_entryCount = 0;
+	clearFileIndex();
 }
 
 // File Access
 bool ZipArchive::openFile(const char *file)
 {
-	m_curFile = getFileIndex(file);
-	m_fileOffset = 0;
-	if (m_curFile != INVALID_FILE)
+	const u32 index = getFileIndex(file);
+	if (index == INVALID_FILE || !beginEntry(index))
 	{
-		m_fileHandle = zip_open(m_archivePath, 0, 'r');
-		if (zip_entry_openbyindex((struct zip_t*)m_fileHandle, m_curFile) != 0)
-		{
-			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", file, m_archivePath);
-			m_curFile = INVALID_FILE;
-			zip_close((struct zip_t*)m_fileHandle);
-			m_fileHandle = nullptr;
-		}
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", file, m_archivePath);
+		return false;
 	}
+	return true;
+}
 
-	// Make sure our temp buffer is large enough to hold the entry.
-	if (m_curFile != INVALID_FILE && m_tempBufferSize < m_entries[m_curFile].length)
+bool ZipArchive::openFile(u32 index)
+{
+	if (index >= (u32)m_entryCount) { return false; }
+	if (!beginEntry(index))
 	{
-		m_tempBufferSize = roundBufferSize(m_entries[m_curFile].length);
-		m_tempBuffer = (u8*)realloc(m_tempBuffer, m_tempBufferSize);
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", m_entries[index].name.c_str(), m_archivePath);
+		return false;
 	}
-	m_entryRead = false;
-
-	return m_curFile != INVALID_FILE;
+	return true;
 }
 
-bool ZipArchive::openFile(u32 index)
+// Locate the entry data from its local header, no data is read or decompressed until readFile().
+bool ZipArchive::beginEntry(u32 index)
 {
-	m_curFile = INVALID_FILE;
+	closeFile();
 	m_fileOffset = 0;
-	if (index <= (u32)m_entryCount)
+	if (!m_zip) { return false; }
+
+	const ZipEntry* entry = &m_entries[index];
+	if (entry->method != c_methodStored && entry->method != c_methodDeflate)
 	{
-		// Open the system file.
-		m_fileHandle = zip_open(m_archivePath, 0, 'r');
-		// Open the file entry itself.
-		m_curFile = index;
-		if (zip_entry_openbyindex((struct zip_t*)m_fileHandle, index) != 0)
-		{
-			TFE_System::logWrite(LOG_ERROR, "zipArchive", "Cannot open file '%s' from archive '%s'", m_entries[index].name.c_str(), m_archivePath);
-			m_curFile = INVALID_FILE;
-			zip_close((struct zip_t*)m_fileHandle);
-			m_fileHandle = nullptr;
-		}
+		TFE_System::logWrite(LOG_ERROR, "zipArchive", "Unsupported compression method %d in archive '%s'", entry->method, m_archivePath);
+		return false;
 	}
 
-	// Make sure our temp buffer is large enough to hold the entry.
-	if (m_curFile != INVALID_FILE && m_tempBufferSize < m_entries[m_curFile].length)
+	mz_zip_archive* zip = (mz_zip_archive*)m_zip;
+	u8 header[c_localHeaderSize];
+	if (zip->m_pRead(zip->m_pIO_opaque, entry->localHeaderOffset, header, c_localHeaderSize) != c_localHeaderSize ||
+		readLE32(header) != c_localHeaderSig)
 	{
-		m_tempBufferSize = roundBufferSize(m_entries[m_curFile].length);
-		m_tempBuffer = (u8*)realloc(m_tempBuffer, m_tempBufferSize);
+		return false;
+	}
+	m_dataOffset = entry->localHeaderOffset + c_localHeaderSize + readLE16(header + c_localHeaderNameLenOfs) + readLE16(header + c_localHeaderExtraLenOfs);
+	if (m_dataOffset + entry->compressedLength > zip->m_archive_size)
+	{
+		return false;
 	}
-	m_entryRead = false;
 
-	return m_curFile != INVALID_FILE;
+	m_curFile = index;
+	return true;
 }
 
 void ZipArchive::closeFile()
 {
-	if (m_fileHandle)
-	{
-		// Close the file entry.
-		zip_entry_close((struct zip_t*)m_fileHandle);
-		// Close the system file.
-		zip_close((struct zip_t*)m_fileHandle);
-		m_fileHandle = nullptr;
-	}
+	freeStream(m_stream);
+	m_stream = nullptr;
 	m_curFile = INVALID_FILE;
 }
 
@@ -172,14 +261,7 @@ bool ZipArchive::fileExists(u32 index)
 
 u32 ZipArchive::getFileIndex(const char* file)
 {
-	for (s32 i = 0; i < m_entryCount; i++)
-	{
-		if (strcasecmp(file, m_entries[i].name.c_str()) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 size_t ZipArchive::getFileLength()
@@ -190,39 +272,115 @@ size_t ZipArchive::getFileLength()
 
 size_t ZipArchive::readFile(void *data, size_t size)
 {
-	if (m_curFile == INVALID_FILE) { return false; }
-	if (size == 0) { size = m_entries[m_curFile].length; }
+	if (m_curFile == INVALID_FILE) { return 0; }
+	const ZipEntry* entry = &m_entries[m_curFile];
+	if (size == 0) { size = entry->length; }
+	if ((size_t)m_fileOffset >= entry->length) { return 0; }
 
-	const size_t sizeToRead = std::min(size, m_entries[m_curFile].length);
-	// The fast path is to just read the entire entry into the provided memory, avoiding the extra memcopy.
-	// This is only done if we are reading the entire file and there is no offset.
-	if (m_fileOffset == 0 && sizeToRead == m_entries[m_curFile].length)
+	const size_t sizeToRead = std::min(size, entry->length - m_fileOffset);
+	mz_zip_archive* zip = (mz_zip_archive*)m_zip;
+
+	size_t bytesRead = 0;
+	if (entry->method == c_methodStored)
+	{
+		// Stored data can be read directly from any offset.
+		bytesRead = zip->m_pRead(zip->m_pIO_opaque, m_dataOffset + m_fileOffset, data, sizeToRead);
+	}
+	else if (m_fileOffset == 0 && sizeToRead == entry->length && !m_stream)
 	{
-		m_fileOffset += (s32)sizeToRead;
-		return zip_entry_noallocread((struct zip_t*)m_fileHandle, data, sizeToRead);
+		// The fast path is to decompress the entire entry directly into the provided memory.
+		bytesRead = mz_zip_reader_extract_to_mem_no_alloc(zip, m_curFile, data, sizeToRead, 0, nullptr, 0) ? sizeToRead : 0;
 	}
+	else
+	{
+		// Otherwise stream from the current position, restarting if seeking backwards.
+		if (!m_stream)
+		{
+			m_stream = allocStream();
+			resetStream(m_stream);
+		}
+		else if (m_stream->consumed > (u64)m_fileOffset)
+		{
+			resetStream(m_stream);
+		}
+		// Skip forward to the read location.
+		const size_t skip = size_t(m_fileOffset - m_stream->consumed);
+		if (readStream(nullptr, skip) == skip)
+		{
+			bytesRead = readStream(data, sizeToRead);
+		}
+	}
+	m_fileOffset += (s32)bytesRead;
+	return bytesRead;
+}
 
-	// Otherwise go through the slower path - a one time decompression and read, followed
-	// by memcopying the data into the output as needed.
-	if (!m_entryRead)
+// Decompress the next 'size' bytes of the current entry into 'data', or discard them if 'data' is null.
+size_t ZipArchive::readStream(void* data, size_t size)
+{
+	ZipStream* stream = m_stream;
+	const ZipEntry* entry = &m_entries[m_curFile];
+	mz_zip_archive* zip = (mz_zip_archive*)m_zip;
+	u8* out = (u8*)data;
+
+	size_t bytesRead = 0;
+	while (bytesRead < size)
 	{
-		// Read the whole entry into temporary memory.
-		assert(m_tempBufferSize >= m_entries[m_curFile].length);
-		if (!zip_entry_noallocread((struct zip_t*)m_fileHandle, m_tempBuffer, m_entries[m_curFile].length))
+		// Copy out any data already decompressed.
+		const size_t pending = size_t(stream->produced - stream->consumed);
+		if (pending)
 		{
-			return false;
+			const size_t dictOffset = size_t(stream->consumed & (TINFL_LZ_DICT_SIZE - 1));
+			const size_t copySize = std::min(std::min(pending, size - bytesRead), TINFL_LZ_DICT_SIZE - dictOffset);
+			if (out)
+			{
+				memcpy(out + bytesRead, stream->dict + dictOffset, copySize);
+			}
+			stream->consumed += copySize;
+			bytesRead += copySize;
+			continue;
+		}
+		if (stream->done) { break; }
+
+		// Refill the input buffer.
+		if (!stream->inputAvail && stream->compressedRead < entry->compressedLength)
+		{
+			const size_t readSize = (size_t)std::min(u64(sizeof(stream->input)), u64(entry->compressedLength) - stream->compressedRead);
+			if (zip->m_pRead(zip->m_pIO_opaque, m_dataOffset + stream->compressedRead, stream->input, readSize) != readSize)
+			{
+				stream->done = true;
+				break;
+			}
+			stream->compressedRead += readSize;
+			stream->inputOffset = 0;
+			stream->inputAvail = readSize;
+		}
+
+		// Decompress into the dictionary, which is only safe to overwrite once all pending data has been consumed.
+		const size_t dictOffset = size_t(stream->produced & (TINFL_LZ_DICT_SIZE - 1));
+		size_t inSize  = stream->inputAvail;
+		size_t outSize = TINFL_LZ_DICT_SIZE - dictOffset;
+		const mz_uint32 flags = stream->compressedRead < entry->compressedLength ? TINFL_FLAG_HAS_MORE_INPUT : 0;
+		const tinfl_status status = tinfl_decompress(&stream->inflator, stream->input + stream->inputOffset, &inSize,
+			stream->dict, stream->dict + dictOffset, &outSize, flags);
+
+		stream->inputOffset += inSize;
+		stream->inputAvail -= inSize;
+		stream->produced += outSize;
+		if (status <= TINFL_STATUS_DONE)
+		{
+			if (status < TINFL_STATUS_DONE)
+			{
+				TFE_System::logWrite(LOG_ERROR, "zipArchive", "Failed to decompress '%s' from archive '%s'", entry->name.c_str(), m_archivePath);
+			}
+			stream->done = true;
 		}
-		m_entryRead = true;
 	}
-	// Then copy the section we want into the output.
-	memcpy(data, m_tempBuffer + m_fileOffset, sizeToRead);
-	m_fileOffset += (s32)sizeToRead;
-	return sizeToRead;
+	return bytesRead;
 }
 
 bool ZipArchive::seekFile(s32 offset, s32 origin)
 {
-	if (m_curFile < 0) { return false; }
+	if (m_curFile == INVALID_FILE) { return false; }
 	size_t size = m_entries[m_curFile].length;
 
 	switch (origin)
@@ -275,4 +433,4 @@ size_t ZipArchive::getFileLength(u32 index)
 // Edit
 void ZipArchive::addFile(const char* fileName, const char* filePath)
 {
-}
\ No newline at end of file
+}
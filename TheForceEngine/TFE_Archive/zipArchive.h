@@ -2,10 +2,12 @@
 #include "archive.h"
 #include <string>
 
+struct ZipStream;
+
 class ZipArchive : public Archive
 {
 public:
-	ZipArchive() : m_entryCount(0), m_curFile(INVALID_FILE), m_entries(nullptr), m_fileHandle(nullptr) {}
+	ZipArchive() : m_entryCount(0), m_curFile(INVALID_FILE), m_entries(nullptr), m_zip(nullptr), m_stream(nullptr), m_dataOffset(0) {}
 	~ZipArchive() override;
 
 	// Archive
@@ -40,15 +42,19 @@ private:
 	{
 		std::string name;
 		size_t length;
+		size_t compressedLength;
+		u64 localHeaderOffset;
+		u16 method;
 		bool isDir;
 	};
 
+	bool beginEntry(u32 index);
+	size_t readStream(void* data, size_t size);
+
 	s32 m_entryCount;
 	u32 m_curFile;
 	ZipEntry* m_entries;
-	void* m_fileHandle;
-
-	u8* m_tempBuffer = nullptr;
-	size_t m_tempBufferSize = 0;
-	bool m_entryRead;
+	void* m_zip;			// The archive is kept open, with its central directory, until close().
+	ZipStream* m_stream;	// Decompression state of the current file, taken from a shared pool.
+	u64 m_dataOffset;		// Location of the current file data in the archive.
 };
@@ -120,6 +120,31 @@ namespace TFE_Jedi_Object3d
 			}
 		}
 	}
+
+	void object3d_buildStreams(const vec3* vIn, s32 count, VertexStreams* streams)
+	{
+		if (!vIn)
+		{
+			streams->x = nullptr;
+			streams->y = nullptr;
+			streams->z = nullptr;
+			return;
+		}
+
+		const s32 paddedCount = (count + MODEL_STREAM_PAD - 1) & ~(MODEL_STREAM_PAD - 1);
+		f32* data = (f32*)malloc(paddedCount * 3 * sizeof(f32));
+		memset(data, 0, paddedCount * 3 * sizeof(f32));
+		streams->x = data;
+		streams->y = data + paddedCount;
+		streams->z = data + paddedCount * 2;
+
+		for (s32 i = 0; i < count; i++, vIn++)
+		{
+			streams->x[i] = fixed16ToFloat(vIn->x);
+			streams->y[i] = fixed16ToFloat(vIn->y);
+			streams->z[i] = fixed16ToFloat(vIn->z);
+		}
+	}
 }
 
 using namespace TFE_Jedi_Object3d;
@@ -205,6 +230,11 @@ namespace TFE_Model_Jedi
 		}
 		model->radius = maxDist;
 
+		// Build the structure of arrays vertex data.
+		object3d_buildStreams(model->vertices, model->vertexCount, &model->vertexStreams);
+		object3d_buildStreams(model->vertexNormals, model->vertexCount, &model->vertexNormalStreams);
+		object3d_buildStreams(model->polygonNormals, model->polygonCount, &model->polygonNormalStreams);
+
 		// TODO (maybe): Cache binary models to disk so they can be
 		// directly loaded, which will reduce load time.
 		s_models[name] = model;
@@ -8,6 +8,8 @@
 
 #define MAX_VERTEX_COUNT_3DO 500
 #define MAX_POLYGON_COUNT_3DO 400
+// Vertex streams are padded to a multiple of this count, so SIMD loops can process whole vectors.
+#define MODEL_STREAM_PAD 8
 
 struct TextureData;
 
@@ -51,6 +53,15 @@ struct Polygon
 	s32 p24;
 };
 
+// Floating point copy of a vec3 array stored as structure of arrays.
+// Each component holds the padded count, the padding is zero.
+struct VertexStreams
+{
+	f32* x;
+	f32* y;
+	f32* z;
+};
+
 struct JediModel
 {
 	s32 isBridge;		// this 3D object is a 3D "bridge" which gets special sorting. All 3D objects with '_' in their name get this flag.
@@ -64,6 +75,10 @@ struct JediModel
 	s32 textureCount;
 	TextureData** textures;
 	s32 radius;
+	// Structure of arrays copies of vertices, vertexNormals and polygonNormals used by the float renderer.
+	VertexStreams vertexStreams;
+	VertexStreams vertexNormalStreams;
+	VertexStreams polygonNormalStreams;
 };
 
 namespace TFE_Model_Jedi
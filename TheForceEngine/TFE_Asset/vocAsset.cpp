@@ -56,7 +56,7 @@ namespace TFE_VocAsset
 			return nullptr;
 		}
 				
-		SoundBuffer* voc = new SoundBuffer;
+		SoundBuffer* voc = new SoundBuffer();
 		if (!parseVoc(voc))
 		{
 			delete voc;
@@ -76,6 +76,7 @@ namespace TFE_VocAsset
 		{
 			SoundBuffer* voc = *iVoc;
 			delete[] voc->data;
+			free(voc->samples);
 			delete voc;
 		}
 		s_vocAssets.clear();
@@ -96,7 +97,7 @@ namespace TFE_VocAsset
 			return -1;
 		}
 
-		SoundBuffer* voc = new SoundBuffer;
+		SoundBuffer* voc = new SoundBuffer();
 		if (!parseVoc(voc))
 		{
 			delete voc;
@@ -283,6 +284,7 @@ namespace TFE_VocAsset
 			voc->loopEnd = voc->size;
 		}
 
+		TFE_Audio::buildSamples(voc);
 		return voc->data != nullptr;
 	}
 
@@ -363,6 +365,7 @@ namespace TFE_VocAsset
 			voc->loopEnd = voc->size;
 		}
 
+		TFE_Audio::buildSamples(voc);
 		return voc->data != nullptr;
 	}
 }
@@ -45,6 +45,11 @@ namespace TFE_AudioDevice
 		TFE_System::logWrite(LOG_ERROR, "Audio Device", "%s", errorText.c_str());
 	}
 
+	u32 getPreferredSampleRate()
+	{
+		return s_device ? s_OutputInfo.preferredSampleRate : 0u;
+	}
+
 	bool startOutput(StreamCallback callback, void* userData, u32 channels, u32 sampleRate)
 	{
 		if (!s_device) { return false; }
@@ -77,4 +82,9 @@ namespace TFE_AudioDevice
 			s_streamStarted = false;
 		}
 	}
+
+	bool isOutputRunning()
+	{
+		return s_streamStarted;
+	}
 }
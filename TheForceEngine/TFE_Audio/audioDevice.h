@@ -27,6 +27,9 @@ namespace TFE_AudioDevice
 	bool init(u32 audioFrameSize = 256u);
 	void destroy();
 
+	// The sample rate the output device runs at natively, 0 if unknown.
+	u32  getPreferredSampleRate();
 	bool startOutput(StreamCallback callback, void* userData = 0, u32 channels = 2, u32 sampleRate = 44100);
 	void stopOutput();
+	bool isOutputRunning();
 };
@@ -10,6 +10,11 @@
 #include <assert.h>
 #include <algorithm>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+	#define AUDIO_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 // Comment out the desired sigmoid function and comment all of the others.
 //#define AUDIO_SIGMOID_CLIP 1
 #define AUDIO_SIGMOID_TANH 1
@@ -21,24 +26,48 @@
 // Set to 1 to enable audio timing counters.
 #define AUDIO_TIMING 0
 
+enum AudioMixConstants
+{
+	// Sources are resampled and mixed in blocks of up to this many output frames.
+	MIX_BLOCK_SIZE = 256,
+	// Filter phases, the coefficients are interpolated between adjacent phases.
+	RESAMPLE_PHASES = 64,
+	RESAMPLE_HALF_TAPS = RESAMPLE_TAPS / 2,
+	// Limits the input samples read per block, a source can play at most this many times faster than the output rate.
+	RESAMPLE_MAX_STEP = 4,
+};
+
+enum AudioQueueConstants
+{
+	MAX_AUDIO_CMD   = 512,	// Must be a power of 2.
+	MAX_AUDIO_EVENT = 256,	// Must be a power of 2.
+	// Parameter frames are triple buffered: one being written, one being read and one waiting to be picked up.
+	PARAM_FRAME_COUNT = 3,
+	PARAM_FRAME_INDEX = 3,
+	PARAM_FRAME_NEW   = 4,
+	// Maximum time spent waiting for the mixer to catch up, in milliseconds.
+	MIXER_WAIT_MS     = 250,
+};
+
 enum SoundSourceFlags
 {
 	SND_FLAG_ONE_SHOT = (1 << 0),
 	SND_FLAG_ACTIVE   = (1 << 1),
 	SND_FLAG_LOOPING  = (1 << 2),
 	SND_FLAG_PLAYING  = (1 << 3),
-	SND_FLAG_FINISHED = (1 << 4),
 };
 
+// Game thread view of a sound source, the audio thread never reads it.
 struct SoundSource
 {
 	SoundType type;
 	f32 baseVolume;
 	f32 volume;
 	f32 seperation;		//stereo seperation.
-	u32 sampleIndex;
+	f32 pitch;
 	u32 flags;
 	s32 slot;
+	u32 generation;		// incremented every time the source is (re)started or stopped.
 
 	// Sound data.
 	const SoundBuffer* buffer;
@@ -54,6 +83,61 @@ struct SoundSource
 	s32 finishedArg = 0;
 };
 
+// Parameters updated while a source is playing.
+struct SourceParams
+{
+	f32 volumeLeft;
+	f32 volumeRight;
+	f32 pitch;
+	u32 generation;		// parameters are ignored unless they match the generation of the voice.
+};
+
+enum AudioCmdType
+{
+	ACMD_PLAY = 0,
+	ACMD_STOP,
+	ACMD_STOP_ALL,
+	ACMD_PAUSE,
+	ACMD_RESUME,
+};
+
+struct AudioCmd
+{
+	AudioCmdType type;
+	s32 slot;
+	const SoundBuffer* buffer;
+	bool looping;
+	SourceParams params;
+};
+
+// Posted by the audio thread when a voice reaches the end of its buffer.
+struct AudioEvent
+{
+	s32 slot;
+	u32 generation;
+};
+
+enum MixVoiceFlags
+{
+	VOICE_PLAYING  = (1 << 0),
+	VOICE_LOOPING  = (1 << 1),
+	VOICE_FINISHED = (1 << 2),	// the finished event still needs to be posted.
+};
+
+// Audio thread view of a sound source, the game thread never reads it.
+struct MixVoice
+{
+	const SoundBuffer* buffer;
+	u32 flags;
+	SourceParams params;
+
+	// Resampling.
+	u32 sampleIndex;					// next input sample to read from the buffer.
+	f64 phase;							// position between history[RESAMPLE_HALF_TAPS - 1] and history[RESAMPLE_HALF_TAPS].
+	f32 history[RESAMPLE_TAPS];			// the last input samples read.
+	u32 tailCount;						// silent samples read past the end of the buffer.
+};
+
 namespace TFE_Audio
 {
 	// This assumes 2 channel support only. This will do for the initial release.
@@ -68,14 +152,45 @@ namespace TFE_Audio
 	// Internal sound scale based on the client volume and headroom.
 	static f32 s_soundFxScale = s_soundFxVolume * c_soundHeadroom;	// actual volume scale based on client set volume and headroom.
 
+	// Game thread state.
 	static u32 s_sourceCount;
 	static Vec3f s_listener;
-	// TODO: This will need to be buffered to avoid locks.
 	static SoundSource s_sources[MAX_SOUND_SOURCES];
-	static Mutex s_mutex;
-	static bool s_paused = false;
+	static bool s_paramsDirty = false;
+	static u32 s_outputRate = 44100;
+
+	// Game thread -> audio thread: single producer, single consumer command ring.
+	static AudioCmd s_cmdBuffer[MAX_AUDIO_CMD];
+	static atomic_u32 s_cmdWrite;
+	static atomic_u32 s_cmdRead;
+	// Audio thread -> game thread: finished sources, handled by updateSources().
+	static AudioEvent s_eventBuffer[MAX_AUDIO_EVENT];
+	static atomic_u32 s_eventWrite;
+	static atomic_u32 s_eventRead;
+	// Source parameters, written by the game thread and picked up by the audio thread at the start of each callback.
+	static SourceParams s_paramFrames[PARAM_FRAME_COUNT][MAX_SOUND_SOURCES];
+	static u32 s_paramFrameCount[PARAM_FRAME_COUNT];
+	static atomic_u32 s_paramFrameShared;
+	static u32 s_paramFrameWrite = 0;	// game thread.
+	static u32 s_paramFrameRead = 1;	// audio thread.
+
+	// Audio thread state.
+	static MixVoice s_voices[MAX_SOUND_SOURCES];
+	static u32 s_voiceCount = 0;
+	static bool s_mixPaused = false;
+
+	// Polyphase windowed sinc filter, the extra phase holds phase 0 shifted by one sample for interpolation.
+	static f32 s_resampleFilter[RESAMPLE_PHASES + 1][RESAMPLE_TAPS];
+	// Mixer scratch buffers, only used by the audio thread.
+	static f32 s_mixInput[RESAMPLE_TAPS + MIX_BLOCK_SIZE * RESAMPLE_MAX_STEP + 1];
+	static f32 s_mixSamples[MIX_BLOCK_SIZE];
 
 	s32 audioCallback(void *outputBuffer, void* inputBuffer, u32 bufferSize, f64 streamTime, u32 status, void* userData);
+	void buildResampleFilter();
+	void resetResampler(MixVoice* voice);
+	void resetSources();
+	bool pushCmd(const AudioCmd* cmd);
+	void computeParams(const SoundSource* source, SourceParams* params);
 	void setSoundVolumeConsole(const ConsoleArgList& args);
 	void getSoundVolumeConsole(const ConsoleArgList& args);
 
@@ -92,8 +207,6 @@ namespace TFE_Audio
 		s_sourceCount = 0u;
 		s_listener = { 0 };
 
-		MUTEX_INITIALIZE(&s_mutex);
-
 		CCMD("setSoundVolume", setSoundVolumeConsole, 1, "Sets the sound volume, range is 0.0 to 1.0");
 		CCMD("getSoundVolume", getSoundVolumeConsole, 0, "Get the current sound volume.");
 
@@ -110,9 +223,27 @@ namespace TFE_Audio
 		{
 			s_sources[i].slot = i;
 		}
-
+		memset(s_voices, 0, sizeof(MixVoice) * MAX_SOUND_SOURCES);
+		s_voiceCount = 0u;
+		s_mixPaused = false;
+
+		s_cmdWrite.store(0);
+		s_cmdRead.store(0);
+		s_eventWrite.store(0);
+		s_eventRead.store(0);
+		memset(s_paramFrameCount, 0, sizeof(u32) * PARAM_FRAME_COUNT);
+		s_paramFrameWrite = 0;
+		s_paramFrameShared.store(2);
+		s_paramFrameRead = 1;
+		s_paramsDirty = false;
+
+		buildResampleFilter();
+
+		// Sources are resampled, so the device can run at its native rate.
 		bool res = TFE_AudioDevice::init();
-		res |= TFE_AudioDevice::startOutput(audioCallback, nullptr, 2u, 11025u);
+		s_outputRate = TFE_AudioDevice::getPreferredSampleRate() == 48000u ? 48000u : 44100u;
+		TFE_System::logWrite(LOG_MSG, "Audio", "Output sample rate: %u Hz.", s_outputRate);
+		res |= TFE_AudioDevice::startOutput(audioCallback, nullptr, 2u, s_outputRate);
 		return res;
 	}
 
@@ -122,25 +253,24 @@ namespace TFE_Audio
 		stopAllSounds();
 
 		TFE_AudioDevice::destroy();
-		MUTEX_DESTROY(&s_mutex);
 	}
 
 	void stopAllSounds()
 	{
-		MUTEX_LOCK(&s_mutex);
-		s_sourceCount = 0u;
-		memset(s_sources, 0, sizeof(SoundSource) * MAX_SOUND_SOURCES);
-		for (s32 i = 0; i < MAX_SOUND_SOURCES; i++)
-		{
-			s_sources[i].slot = i;
-		}
-		MUTEX_UNLOCK(&s_mutex);
+		resetSources();
+
+		AudioCmd cmd = {};
+		cmd.type = ACMD_STOP_ALL;
+		pushCmd(&cmd);
+		// The caller may free the sound buffers next.
+		waitForMixer();
 	}
 
 	void setVolume(f32 volume)
 	{
 		s_soundFxVolume = volume;
 		s_soundFxScale = s_soundFxVolume * c_soundHeadroom;
+		s_paramsDirty = true;
 	}
 
 	f32 getVolume()
@@ -148,14 +278,51 @@ namespace TFE_Audio
 		return s_soundFxVolume;
 	}
 
+	void buildSamples(SoundBuffer* buffer)
+	{
+		static const f32 c_scale[] = { 2.0f / 255.0f, 2.0f / 65535.0f, 1.0f };
+		static const f32 c_offset[] = { -1.0f, -1.0f, 0.0f };
+
+		free(buffer->samples);
+		buffer->samples = nullptr;
+		if (!buffer->data || !buffer->size) { return; }
+
+		const u32 count = buffer->size;
+		const f32 scale = c_scale[buffer->type];
+		const f32 offset = c_offset[buffer->type];
+		f32* samples = (f32*)malloc(sizeof(f32) * count);
+		switch (buffer->type)
+		{
+			case SOUND_DATA_8BIT:
+			{
+				const u8* data = buffer->data;
+				for (u32 i = 0; i < count; i++) { samples[i] = f32(data[i]) * scale + offset; }
+			} break;
+			case SOUND_DATA_16BIT:
+			{
+				const u16* data = (const u16*)buffer->data;
+				for (u32 i = 0; i < count; i++) { samples[i] = f32(data[i]) * scale + offset; }
+			} break;
+			case SOUND_DATA_FLOAT:
+			{
+				memcpy(samples, buffer->data, sizeof(f32) * count);
+			} break;
+		}
+		buffer->samples = samples;
+	}
+
 	void pause()
 	{
-		s_paused = true;
+		AudioCmd cmd = {};
+		cmd.type = ACMD_PAUSE;
+		pushCmd(&cmd);
 	}
 
 	void resume()
 	{
-		s_paused = false;
+		AudioCmd cmd = {};
+		cmd.type = ACMD_RESUME;
+		pushCmd(&cmd);
 	}
 
 	void update(const Vec3f* listenerPos, const Vec3f* listenerDir)
@@ -208,32 +375,118 @@ namespace TFE_Audio
 				}
 			}
 		}
+		s_paramsDirty = true;
 	}
 
-	// One shot, play and forget. Only do this if the client needs no control until stopAllSounds() is called.
-	// Note that looping one shots are valid.
-	bool playOneShot(SoundType type, f32 volume, f32 stereoSeperation, const SoundBuffer* buffer, bool looping, const Vec3f* pos, bool copyPosition, SoundFinishedCallback finishedCallback, void* cbUserData, s32 cbArg)
+	void updateSources()
 	{
-		if (!buffer) { return false; }
+		// Handle the sources finished by the audio thread.
+		const u32 write = s_eventWrite.load(std::memory_order_acquire);
+		u32 read = s_eventRead.load(std::memory_order_relaxed);
+		for (; read != write; read++)
+		{
+			const AudioEvent* evt = &s_eventBuffer[read & (MAX_AUDIO_EVENT - 1)];
+			SoundSource* source = &s_sources[evt->slot];
+			// Ignore sources that have been stopped or restarted since.
+			if (!(source->flags & SND_FLAG_PLAYING) || source->generation != evt->generation) { continue; }
+
+			source->flags = 0;
+			source->buffer = nullptr;
+			if (source->finishedCallback)
+			{
+				source->finishedCallback(source->finishedUserData, source->finishedArg);
+			}
+		}
+		s_eventRead.store(read, std::memory_order_release);
+
+		//shrink the number of sources until an active source is found.
+		const s32 end = (s32)s_sourceCount - 1;
+		for (s32 s = end; s >= 0; s--)
+		{
+			if (s_sources[s].flags&SND_FLAG_ACTIVE)
+			{
+				break;
+			}
+			s_sourceCount--;
+		}
+
+		// Publish the source parameters.
+		if (!s_paramsDirty) { return; }
+		s_paramsDirty = false;
+
+		SourceParams* params = s_paramFrames[s_paramFrameWrite];
+		for (u32 s = 0; s < s_sourceCount; s++)
+		{
+			computeParams(&s_sources[s], &params[s]);
+		}
+		s_paramFrameCount[s_paramFrameWrite] = s_sourceCount;
+		s_paramFrameWrite = s_paramFrameShared.exchange(s_paramFrameWrite | PARAM_FRAME_NEW, std::memory_order_acq_rel) & PARAM_FRAME_INDEX;
+	}
+
+	void waitForMixer()
+	{
+		if (!TFE_AudioDevice::isOutputRunning()) { return; }
+
+		const u32 target = s_cmdWrite.load(std::memory_order_relaxed);
+		for (s32 i = 0; i < MIXER_WAIT_MS && s32(s_cmdRead.load(std::memory_order_acquire) - target) < 0; i++)
+		{
+			TFE_System::sleep(1);
+		}
+	}
 
-		MUTEX_LOCK(&s_mutex);
+	SoundSource* allocateSource()
+	{
 		// Find the first inactive source.
 		SoundSource* snd = s_sources;
-		SoundSource* newSource = nullptr;
 		for (u32 s = 0; s < s_sourceCount; s++, snd++)
 		{
 			if (!(snd->flags&SND_FLAG_ACTIVE))
 			{
-				newSource = snd;
-				break;
+				return snd;
 			}
 		}
-		if (!newSource && s_sourceCount < MAX_SOUND_SOURCES)
+		if (s_sourceCount < MAX_SOUND_SOURCES)
 		{
-			newSource = &s_sources[s_sourceCount];
+			snd = &s_sources[s_sourceCount];
 			s_sourceCount++;
+			return snd;
+		}
+		return nullptr;
+	}
+
+	void startSource(SoundSource* source)
+	{
+		source->generation++;
+
+		AudioCmd cmd = {};
+		cmd.type = ACMD_PLAY;
+		cmd.slot = source->slot;
+		cmd.buffer = source->buffer;
+		cmd.looping = (source->flags & SND_FLAG_LOOPING) != 0;
+		computeParams(source, &cmd.params);
+		if (!pushCmd(&cmd))
+		{
+			source->flags &= ~SND_FLAG_PLAYING;
 		}
+	}
+
+	void stopVoice(SoundSource* source)
+	{
+		source->generation++;
+
+		AudioCmd cmd = {};
+		cmd.type = ACMD_STOP;
+		cmd.slot = source->slot;
+		pushCmd(&cmd);
+	}
 
+	// One shot, play and forget. Only do this if the client needs no control until stopAllSounds() is called.
+	// Note that looping one shots are valid.
+	bool playOneShot(SoundType type, f32 volume, f32 stereoSeperation, const SoundBuffer* buffer, bool looping, const Vec3f* pos, bool copyPosition, SoundFinishedCallback finishedCallback, void* cbUserData, s32 cbArg)
+	{
+		if (!buffer) { return false; }
+
+		SoundSource* newSource = allocateSource();
 		if (newSource)
 		{
 			newSource->type = type;
@@ -245,7 +498,7 @@ namespace TFE_Audio
 			newSource->volume = type == SOUND_3D ? 0.0f : volume;
 			newSource->baseVolume = volume;
 			newSource->buffer = buffer;
-			newSource->sampleIndex = 0u;
+			newSource->pitch = 1.0f;
 			if (copyPosition)
 			{
 				newSource->localPos = *pos;
@@ -259,8 +512,14 @@ namespace TFE_Audio
 			newSource->finishedCallback = finishedCallback;
 			newSource->finishedUserData = cbUserData;
 			newSource->finishedArg = cbArg;
+
+			startSource(newSource);
+			if (!(newSource->flags & SND_FLAG_PLAYING))
+			{
+				newSource->flags = 0;
+				newSource = nullptr;
+			}
 		}
-		MUTEX_UNLOCK(&s_mutex);
 
 		return newSource != nullptr;
 	}
@@ -272,24 +531,7 @@ namespace TFE_Audio
 		assert(volume >= 0.0f && volume <= 1.0f);
 		assert(stereoSeperation >= 0.0f && stereoSeperation <= 1.0f);
 
-		MUTEX_LOCK(&s_mutex);
-		// Find the first inactive source.
-		SoundSource* snd = s_sources;
-		SoundSource* newSource = nullptr;
-		for (u32 s = 0; s < s_sourceCount; s++, snd++)
-		{
-			if (!(snd->flags&SND_FLAG_ACTIVE))
-			{
-				newSource = snd;
-				break;
-			}
-		}
-		if (!newSource && s_sourceCount < MAX_SOUND_SOURCES)
-		{
-			newSource = &s_sources[s_sourceCount];
-			s_sourceCount++;
-		}
-
+		SoundSource* newSource = allocateSource();
 		if (newSource)
 		{
 			newSource->type = type;
@@ -297,7 +539,7 @@ namespace TFE_Audio
 			newSource->volume = type == SOUND_2D ? volume : 0.0f;
 			newSource->baseVolume = volume;
 			newSource->buffer = buffer;
-			newSource->sampleIndex = 0u;
+			newSource->pitch = 1.0f;
 			if (copyPosition && pos)
 			{
 				newSource->localPos = *pos;
@@ -311,7 +553,6 @@ namespace TFE_Audio
 			newSource->finishedCallback = callback;
 			newSource->finishedUserData = userData;
 		}
-		MUTEX_UNLOCK(&s_mutex);
 
 		return newSource;
 	}
@@ -342,30 +583,26 @@ namespace TFE_Audio
 		{
 			return;
 		}
-		
-		MUTEX_LOCK(&s_mutex);
-			source->flags |= SND_FLAG_PLAYING;
-			if (looping) { source->flags |= SND_FLAG_LOOPING; }
-			source->sampleIndex = 0u;
-		MUTEX_UNLOCK(&s_mutex);
+
+		source->flags |= SND_FLAG_PLAYING;
+		if (looping) { source->flags |= SND_FLAG_LOOPING; }
+		startSource(source);
 	}
 
 	void stopSource(SoundSource* source)
 	{
 		if (!source) { return; }
-		MUTEX_LOCK(&s_mutex);
-			source->flags &= ~SND_FLAG_PLAYING;
-		MUTEX_UNLOCK(&s_mutex);
+		source->flags &= ~SND_FLAG_PLAYING;
+		stopVoice(source);
 	}
-	
+
 	void freeSource(SoundSource* source)
 	{
 		if (!source) { return; }
-		MUTEX_LOCK(&s_mutex);
-			source->flags &= ~SND_FLAG_PLAYING;
-			source->flags &= ~SND_FLAG_ACTIVE;
-			source->buffer = nullptr;
-		MUTEX_UNLOCK(&s_mutex);
+		source->flags &= ~SND_FLAG_PLAYING;
+		source->flags &= ~SND_FLAG_ACTIVE;
+		source->buffer = nullptr;
+		stopVoice(source);
 	}
 
 	void setSourceVolume(SoundSource* source, f32 volume)
@@ -376,11 +613,19 @@ namespace TFE_Audio
 		{
 			source->volume = source->baseVolume;
 		}
+		s_paramsDirty = true;
 	}
 
 	void setSourceStereoSeperation(SoundSource* source, f32 stereoSeperation)
 	{
 		source->seperation = std::max(0.0f, std::min(stereoSeperation, 1.0f));
+		s_paramsDirty = true;
+	}
+
+	void setSourcePitch(SoundSource* source, f32 pitch)
+	{
+		source->pitch = std::max(0.0f, pitch);
+		s_paramsDirty = true;
 	}
 
 	void setSourcePosition(SoundSource* source, const Vec3f* pos)
@@ -391,10 +636,11 @@ namespace TFE_Audio
 	// This will restart the sound and change the buffer.
 	void setSourceBuffer(SoundSource* source, const SoundBuffer* buffer)
 	{
-		MUTEX_LOCK(&s_mutex);
-			source->sampleIndex = 0u;
-			source->buffer = buffer;
-		MUTEX_UNLOCK(&s_mutex);
+		source->buffer = buffer;
+		if (source->flags & SND_FLAG_PLAYING)
+		{
+			startSource(source);
+		}
 	}
 
 	bool isSourcePlaying(SoundSource* source)
@@ -408,54 +654,294 @@ namespace TFE_Audio
 	}
 
 	// Internal
-	static const f32 c_scale[] = { 2.0f / 255.0f, 2.0f / 65535.0f, 1.0f };
-	static const f32 c_offset[] = { -1.0f, -1.0f, 0.0f };
+	void resetSources()
+	{
+		s_sourceCount = 0u;
+		for (s32 i = 0; i < MAX_SOUND_SOURCES; i++)
+		{
+			// Keep the generation so events posted for the old sources are ignored.
+			const u32 generation = s_sources[i].generation;
+			memset(&s_sources[i], 0, sizeof(SoundSource));
+			s_sources[i].slot = i;
+			s_sources[i].generation = generation + 1;
+		}
+	}
 
-	void cleanupSources()
+	// Returns false if the command cannot be queued.
+	bool pushCmd(const AudioCmd* cmd)
 	{
-		// call any finished callbacks.
-		for (u32 s = 0; s < s_sourceCount; s++)
+		// Without an output stream nothing reads the commands.
+		if (!TFE_AudioDevice::isOutputRunning()) { return true; }
+
+		const u32 write = s_cmdWrite.load(std::memory_order_relaxed);
+		if (write - s_cmdRead.load(std::memory_order_acquire) >= MAX_AUDIO_CMD)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Audio", "Audio command buffer is full, command dropped.");
+			return false;
+		}
+		s_cmdBuffer[write & (MAX_AUDIO_CMD - 1)] = *cmd;
+		s_cmdWrite.store(write + 1, std::memory_order_release);
+		return true;
+	}
+
+	void computeParams(const SoundSource* source, SourceParams* params)
+	{
+		// Stereo Seperation.
+		params->volumeLeft  = std::max(source->volume - source->seperation*source->seperation, 0.0f) * s_soundFxScale;
+		params->volumeRight = std::max(source->volume - (1.0f - source->seperation) * (1.0f - source->seperation), 0.0f) * s_soundFxScale;
+		params->pitch = source->pitch;
+		params->generation = source->generation;
+	}
+
+	void buildResampleFilter()
+	{
+		const f64 pi = 3.14159265358979323846;
+		for (s32 p = 0; p <= RESAMPLE_PHASES; p++)
+		{
+			const f64 frac = f64(p) / f64(RESAMPLE_PHASES);
+			f64 sum = 0.0;
+			f64 coef[RESAMPLE_TAPS];
+			for (s32 t = 0; t < RESAMPLE_TAPS; t++)
+			{
+				// Distance from the output position, in input samples.
+				const f64 x = f64(t - (RESAMPLE_HALF_TAPS - 1)) - frac;
+				const f64 sinc = (x == 0.0) ? 1.0 : sin(pi * x) / (pi * x);
+				// Blackman window over [-RESAMPLE_HALF_TAPS, RESAMPLE_HALF_TAPS].
+				const f64 w = pi * x / f64(RESAMPLE_HALF_TAPS);
+				const f64 window = 0.42 + 0.5*cos(w) + 0.08*cos(2.0*w);
+				coef[t] = sinc * window;
+				sum += coef[t];
+			}
+			// Normalize so each phase has unity gain.
+			for (s32 t = 0; t < RESAMPLE_TAPS; t++)
+			{
+				s_resampleFilter[p][t] = f32(coef[t] / sum);
+			}
+		}
+	}
+
+	void resetResampler(MixVoice* voice)
+	{
+		voice->sampleIndex = 0u;
+		voice->phase = 0.0;
+		voice->tailCount = 0u;
+		memset(voice->history, 0, sizeof(f32) * RESAMPLE_TAPS);
+	}
+
+	// Read the next 'count' input samples, following the loop.
+	// Samples past the end of a sound that does not loop are silent.
+	void readSamples(MixVoice* voice, f32* out, u32 count)
+	{
+		const SoundBuffer* sndBuffer = voice->buffer;
+		const u32 size = sndBuffer->size;
+		while (count)
 		{
-			if (s_sources[s].flags&SND_FLAG_FINISHED)
+			if (voice->sampleIndex >= size)
 			{
-				s_sources[s].flags = 0;
-				s_sources[s].buffer = nullptr;
-				if (s_sources[s].finishedCallback)
+				if ((voice->flags & VOICE_LOOPING) && sndBuffer->loopStart < size)
 				{
-					s_sources[s].finishedCallback(s_sources[s].finishedUserData, s_sources[s].finishedArg);
+					voice->sampleIndex = sndBuffer->loopStart;
+				}
+				else
+				{
+					memset(out, 0, sizeof(f32) * count);
+					voice->tailCount += count;
+					return;
 				}
 			}
+
+			const u32 readCount = std::min(count, size - voice->sampleIndex);
+			memcpy(out, sndBuffer->samples + voice->sampleIndex, sizeof(f32) * readCount);
+			voice->sampleIndex += readCount;
+			out += readCount;
+			count -= readCount;
 		}
+	}
 
-		const s32 end = (s32)s_sourceCount - 1;
-		//shrink the number of sources until an active source is found.
-		for (s32 s = end; s >= 0; s--)
+	// Resample 'count' output samples, starting 'phase' samples after input[RESAMPLE_HALF_TAPS - 1].
+	void resampleBlock(const f32* input, f64 phase, f64 step, u32 count, f32* out)
+	{
+		for (u32 i = 0; i < count; i++)
 		{
-			if (s_sources[s].flags&SND_FLAG_ACTIVE)
+			const f64 pos = phase + f64(i) * step;
+			const u32 index = u32(pos);
+			const f32 phaseF = f32(pos - f64(index)) * f32(RESAMPLE_PHASES);
+			const s32 p = std::min(s32(phaseF), RESAMPLE_PHASES - 1);
+			const f32 blend = phaseF - f32(p);
+			const f32* coef0 = s_resampleFilter[p];
+			const f32* coef1 = s_resampleFilter[p + 1];
+			const f32* x = &input[index];
+
+		#if AUDIO_SSE2
+			static_assert(RESAMPLE_TAPS == 8, "The SSE2 filter expects 8 taps.");
+			const __m128 blendVec = _mm_set1_ps(blend);
+			const __m128 c0 = _mm_loadu_ps(coef0);
+			const __m128 c1 = _mm_loadu_ps(coef0 + 4);
+			const __m128 ca = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(coef1), c0), blendVec));
+			const __m128 cb = _mm_add_ps(c1, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(coef1 + 4), c1), blendVec));
+			__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x), ca), _mm_mul_ps(_mm_loadu_ps(x + 4), cb));
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+			out[i] = _mm_cvtss_f32(sum);
+		#else
+			f32 sum = 0.0f;
+			for (s32 t = 0; t < RESAMPLE_TAPS; t++)
 			{
-				break;
+				sum += x[t] * (coef0[t] + (coef1[t] - coef0[t]) * blend);
 			}
-			s_sourceCount--;
+			out[i] = sum;
+		#endif
 		}
 	}
-		
-	f32 sampleBuffer(u32 index, SoundDataType type, const u8* data)
+
+	// Add the mono samples to the interleaved stereo output.
+	void mixBlock(f32* out, const f32* samples, u32 count, f32 volumeLeft, f32 volumeRight)
 	{
-		f32 sampleValue;
-		switch (type)
+		u32 i = 0;
+	#if AUDIO_SSE2
+		const __m128 volume = _mm_setr_ps(volumeLeft, volumeRight, volumeLeft, volumeRight);
+		for (; i + 4 <= count; i += 4, out += 8)
+		{
+			const __m128 s = _mm_loadu_ps(&samples[i]);
+			_mm_storeu_ps(out,     _mm_add_ps(_mm_loadu_ps(out),     _mm_mul_ps(_mm_unpacklo_ps(s, s), volume)));
+			_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), volume)));
+		}
+	#endif
+		for (; i < count; i++, out += 2)
 		{
-			case SOUND_DATA_8BIT:  { sampleValue = (f32)data[index]; } break;
-			case SOUND_DATA_16BIT: { sampleValue = (f32)(*((u16*)data + index)); } break;
-			case SOUND_DATA_FLOAT: { sampleValue = *((f32*)data + index); } break;
-		};
+			out[0] += samples[i] * volumeLeft;
+			out[1] += samples[i] * volumeRight;
+		}
+	}
+
+	// Resample and mix 'frameCount' frames of the voice into the output.
+	// When 'audible' is false the voice advances without producing output.
+	void mixVoice(MixVoice* voice, f32* out, u32 frameCount, bool audible)
+	{
+		const f64 step = std::min(f64(voice->buffer->sampleRate) * f64(voice->params.pitch) / f64(s_outputRate), f64(RESAMPLE_MAX_STEP));
+		for (u32 f = 0; f < frameCount; f += MIX_BLOCK_SIZE, out += MIX_BLOCK_SIZE * 2)
+		{
+			const u32 count = std::min(frameCount - f, u32(MIX_BLOCK_SIZE));
+			// Input samples consumed by this block, the filter reads up to RESAMPLE_TAPS - 1 past the last.
+			const f64 endPhase = voice->phase + f64(count) * step;
+			const u32 readCount = u32(endPhase);
+
+			memcpy(s_mixInput, voice->history, sizeof(f32) * RESAMPLE_TAPS);
+			readSamples(voice, s_mixInput + RESAMPLE_TAPS, readCount);
+			if (audible)
+			{
+				resampleBlock(s_mixInput, voice->phase, step, count, s_mixSamples);
+				mixBlock(out, s_mixSamples, count, voice->params.volumeLeft, voice->params.volumeRight);
+			}
 
-		return sampleValue * c_scale[type] + c_offset[type];
+			memcpy(voice->history, s_mixInput + readCount, sizeof(f32) * RESAMPLE_TAPS);
+			voice->phase = endPhase - f64(readCount);
+		}
+
+		// The sound is finished once the last sample has moved through the filter.
+		if (voice->tailCount >= RESAMPLE_TAPS)
+		{
+			voice->flags &= ~VOICE_PLAYING;
+			voice->flags |= VOICE_FINISHED;
+		}
+	}
+
+	// Apply the commands issued by the game thread since the last callback.
+	void processCommands()
+	{
+		const u32 write = s_cmdWrite.load(std::memory_order_acquire);
+		u32 read = s_cmdRead.load(std::memory_order_relaxed);
+		for (; read != write; read++)
+		{
+			const AudioCmd* cmd = &s_cmdBuffer[read & (MAX_AUDIO_CMD - 1)];
+			MixVoice* voice = cmd->slot >= 0 && cmd->slot < MAX_SOUND_SOURCES ? &s_voices[cmd->slot] : nullptr;
+			switch (cmd->type)
+			{
+				case ACMD_PLAY:
+				{
+					voice->buffer = cmd->buffer;
+					voice->flags = VOICE_PLAYING | (cmd->looping ? VOICE_LOOPING : 0);
+					voice->params = cmd->params;
+					resetResampler(voice);
+					s_voiceCount = std::max(s_voiceCount, u32(cmd->slot + 1));
+				} break;
+				case ACMD_STOP:
+				{
+					voice->flags = 0;
+					voice->buffer = nullptr;
+				} break;
+				case ACMD_STOP_ALL:
+				{
+					for (u32 s = 0; s < s_voiceCount; s++)
+					{
+						s_voices[s].flags = 0;
+						s_voices[s].buffer = nullptr;
+					}
+					s_voiceCount = 0;
+				} break;
+				case ACMD_PAUSE:
+				{
+					s_mixPaused = true;
+				} break;
+				case ACMD_RESUME:
+				{
+					s_mixPaused = false;
+				} break;
+			}
+		}
+		s_cmdRead.store(read, std::memory_order_release);
+
+		// Then pick up the latest source parameters.
+		if (s_paramFrameShared.load(std::memory_order_relaxed) & PARAM_FRAME_NEW)
+		{
+			s_paramFrameRead = s_paramFrameShared.exchange(s_paramFrameRead, std::memory_order_acq_rel) & PARAM_FRAME_INDEX;
+			const SourceParams* params = s_paramFrames[s_paramFrameRead];
+			const u32 count = std::min(s_paramFrameCount[s_paramFrameRead], s_voiceCount);
+			for (u32 s = 0; s < count; s++)
+			{
+				// Parameters from before the voice was (re)started are stale.
+				if (params[s].generation == s_voices[s].params.generation)
+				{
+					s_voices[s].params = params[s];
+				}
+			}
+		}
+	}
+
+	// Post the finished events back to the game thread, voices are retried on the next callback if the buffer is full.
+	void postEvents()
+	{
+		const u32 read = s_eventRead.load(std::memory_order_acquire);
+		u32 write = s_eventWrite.load(std::memory_order_relaxed);
+		for (u32 s = 0; s < s_voiceCount; s++)
+		{
+			MixVoice* voice = &s_voices[s];
+			if (!(voice->flags & VOICE_FINISHED)) { continue; }
+			if (write - read >= MAX_AUDIO_EVENT) { break; }
+
+			AudioEvent* evt = &s_eventBuffer[write & (MAX_AUDIO_EVENT - 1)];
+			evt->slot = s32(s);
+			evt->generation = voice->params.generation;
+			write++;
+
+			voice->flags = 0;
+			voice->buffer = nullptr;
+		}
+		s_eventWrite.store(write, std::memory_order_release);
+
+		//shrink the number of voices until a voice in use is found.
+		while (s_voiceCount && !s_voices[s_voiceCount - 1].flags)
+		{
+			s_voiceCount--;
+		}
 	}
 
 	// Audio callback
 	s32 audioCallback(void *outputBuffer, void* inputBuffer, u32 bufferSize, f64 streamTime, u32 status, void* userData)
 	{
 		f32* buffer = (f32*)outputBuffer;
+		TFE_Profiler::setThreadName("Audio");
+		TFE_ZONE("Audio Mix");
 
 	#if AUDIO_TIMING == 1
 		u64 soundIterStart = TFE_System::getCurrentTimeInTicks();
@@ -464,77 +950,25 @@ namespace TFE_Audio
 		// First clear samples
 		memset(buffer, 0, sizeof(f32)*bufferSize*2);
 
-		MUTEX_LOCK(&s_mutex);
-		// Then loop through the sources.
-		SoundSource* snd = s_sources;
-		for (u32 s = 0; s < s_sourceCount && !s_paused; s++, snd++)
-		{
-			if (!(snd->flags&SND_FLAG_PLAYING)) { continue; }
-			assert(snd->buffer->data);
-
-			// Stereo Seperation.
-			const f32 sepSq = std::max(snd->volume - snd->seperation*snd->seperation, 0.0f) * s_soundFxScale;
-			const f32 invSepSq = std::max(snd->volume - (1.0f - snd->seperation) * (1.0f - snd->seperation), 0.0f) * s_soundFxScale;
+		processCommands();
 
-			// Skip sound sample processing the sound is too quiet...
-			const u32 sndBufferSize = snd->buffer->size;
-			if (sepSq < SND_CULL_VOLUME && invSepSq < SND_CULL_VOLUME)
+		// Then loop through the voices.
+		MixVoice* voice = s_voices;
+		for (u32 s = 0; s < s_voiceCount && !s_mixPaused; s++, voice++)
+		{
+			if (!(voice->flags & VOICE_PLAYING)) { continue; }
+			if (!voice->buffer->samples)
 			{
-				// Pretend we played the sound and handle looping.
-				snd->sampleIndex += bufferSize;
-				if (snd->sampleIndex >= sndBufferSize)
-				{
-					if (snd->flags&SND_FLAG_LOOPING)
-					{
-						snd->sampleIndex = (snd->sampleIndex % sndBufferSize) + snd->buffer->loopStart;
-					}
-					else
-					{
-						snd->flags &= ~SND_FLAG_PLAYING;
-						snd->flags |= SND_FLAG_FINISHED;
-						snd->sampleIndex = 0u;
-					}
-				}
+				voice->flags &= ~VOICE_PLAYING;
+				voice->flags |= VOICE_FINISHED;
 				continue;
 			}
 
-			// Sample loop.
-			buffer = (f32*)outputBuffer;
-			// The sound may be split into multiple iterations if it loops or the loop
-			// may end early, once we reach the end.
-			for (u32 i = 0; i < bufferSize;)
-			{
-				if (snd->sampleIndex >= sndBufferSize)
-				{
-					if (snd->flags&SND_FLAG_LOOPING)
-					{
-						snd->sampleIndex = snd->buffer->loopStart;
-					}
-					else
-					{
-						snd->flags &= ~SND_FLAG_PLAYING;
-						snd->flags |= SND_FLAG_FINISHED;
-						snd->sampleIndex = 0u;
-						break;
-					}
-				}
-
-				const SoundDataType type = snd->buffer->type;
-				const u8* data = snd->buffer->data;
-				const u32 end = std::min(sndBufferSize, snd->sampleIndex + bufferSize - i);
-				u32 sIndex = snd->sampleIndex;
-				for (; sIndex < end; i++, sIndex++, buffer += 2)
-				{
-					const f32 sample = sampleBuffer(sIndex, type, data);
-					buffer[0] += sample * sepSq;
-					buffer[1] += sample * invSepSq;
-				}
-				snd->sampleIndex = sIndex;
-			}
+			// Skip sound sample processing the sound is too quiet, but keep the playback position moving.
+			const bool audible = voice->params.volumeLeft >= SND_CULL_VOLUME || voice->params.volumeRight >= SND_CULL_VOLUME;
+			mixVoice(voice, (f32*)outputBuffer, bufferSize, audible);
 		}
-		// Cleanup sound sources while we are still in the mutex.
-		cleanupSources();
-		MUTEX_UNLOCK(&s_mutex);
+		postEvents();
 
 		// Finally handle out of range audio samples.
 		buffer = (f32*)outputBuffer;
@@ -569,17 +1003,16 @@ namespace TFE_Audio
 		s_soundIterAve = s32(s_soundIterAveF);
 		s_soundIterMax = s32(s_soundIterMaxF);
 	#endif
-		
+
 		return 0;
 	}
-		
+
 	// Console functions.
 	void setSoundVolumeConsole(const ConsoleArgList& args)
 	{
 		if (args.size() < 2) { return; }
 
-		s_soundFxVolume = TFE_Console::getFloatArg(args[1]);
-		s_soundFxScale = s_soundFxVolume * c_soundHeadroom;
+		setVolume(TFE_Console::getFloatArg(args[1]));
 
 		TFE_Settings_Sound* soundSettings = TFE_Settings::getSoundSettings();
 		soundSettings->soundFxVolume = s_soundFxVolume;
@@ -2,7 +2,7 @@
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/paths.h>
 
-// Source data type. The sound data will be converted to float time during mixing.
+// Source data type. The sound data is converted to float once, when the buffer is loaded (see buildSamples()).
 enum SoundDataType
 {
 	SOUND_DATA_8BIT = 0,
@@ -29,6 +29,8 @@ struct SoundBuffer
 	u32 loopEnd;
 
 	u8* data;
+	// Mono float samples used by the mixer, built from data by TFE_Audio::buildSamples().
+	f32* samples;
 };
 
 struct SoundSource;
@@ -42,6 +44,8 @@ enum SoundType
 
 #define MONO_SEPERATION 0.5f
 #define MAX_SOUND_SOURCES 128
+// Number of input samples used to compute each resampled output sample.
+#define RESAMPLE_TAPS 8
 
 typedef void (*SoundFinishedCallback)(void* userData, s32 arg);
 
@@ -58,6 +62,10 @@ namespace TFE_Audio
 	void shutdown();
 	void stopAllSounds();
 
+	// Convert the buffer data to the float samples used by the mixer, call once the data is complete.
+	// The samples are allocated with malloc() and freed by the owner of the buffer.
+	void buildSamples(SoundBuffer* buffer);
+
 	void setVolume(f32 volume);
 	f32  getVolume();
 	void pause();
@@ -65,6 +73,11 @@ namespace TFE_Audio
 
 	// Update position audio and other audio effects.
 	void update(const Vec3f* listenerPos, const Vec3f* listenerDir);
+	// Run the finished callbacks posted by the mixer and send the latest source parameters to it, called once per frame.
+	// Sources are controlled through a command buffer, so the game thread never waits on the audio thread.
+	void updateSources();
+	// Wait until the mixer has processed the commands issued so far, after which stopped sources no longer reference their buffers.
+	void waitForMixer();
 
 	// One shot, play and forget. Only do this if the client needs no control until stopAllSounds() is called.
 	// Note that looping one shots are valid though may generate too many sound sources if not used carefully.
@@ -78,6 +91,8 @@ namespace TFE_Audio
 	void freeSource(SoundSource* source);
 	void setSourceVolume(SoundSource* source, f32 volume);
 	void setSourceStereoSeperation(SoundSource* source, f32 stereoSeperation);
+	// Playback rate scale, 1.0 = the buffer sample rate.
+	void setSourcePitch(SoundSource* source, f32 pitch);
 	// This will restart the sound and change the buffer.
 	void setSourceBuffer(SoundSource* source, const SoundBuffer* buffer);
 	void setSourcePosition(SoundSource* source, const Vec3f* pos);
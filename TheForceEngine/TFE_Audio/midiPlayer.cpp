@@ -3,7 +3,9 @@
 #include "audioDevice.h"
 #include <TFE_Asset/gmidAsset.h>
 #include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
 #include <TFE_System/Threads/thread.h>
+#include <TFE_System/Threads/signal.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_FrontEndUI/console.h>
 #include <algorithm>
@@ -47,9 +49,22 @@ namespace TFE_MidiPlayer
 		bool loop;
 	};
 
-	enum { MAX_MIDI_CMD = 256 };
+	enum
+	{
+		MAX_MIDI_CMD = 256,	// Must be a power of 2.
+		MAX_LOCAL_MIDI_CMD = 16,
+	};
+	// Commands from the game thread are passed to the midi thread through a single producer, single consumer ring buffer,
+	// so issuing commands never blocks.
 	static MidiCmd s_midiCmdBuffer[MAX_MIDI_CMD];
-	static u32 s_midiCmdCount = 0;
+	static atomic_u32 s_midiCmdWrite;
+	static atomic_u32 s_midiCmdRead;
+	// Commands issued on the midi thread itself (from iMuse callbacks) are handled on the next update.
+	static MidiCmd s_midiLocalCmdBuffer[MAX_LOCAL_MIDI_CMD];
+	static u32 s_midiLocalCmdCount = 0;
+	// Commands gathered by the midi thread for the current update.
+	static MidiCmd s_midiPendingCmd[MAX_MIDI_CMD + MAX_LOCAL_MIDI_CMD];
+	static thread_local bool t_midiThread = false;
 		
 	struct MidiRuntimeTrack
 	{
@@ -93,7 +108,8 @@ namespace TFE_MidiPlayer
 	static s32 s_trackId = 0;
 
 	static u8 s_channelSrcVolume[16] = { 0 };
-	static Mutex s_mutex;
+	// Wakes up the midi thread when commands are issued while it is idle.
+	static Signal* s_cmdSignal = nullptr;
 			
 	TFE_THREADRET midiUpdateFunc(void* userData);
 	void stopAllNotes();
@@ -113,7 +129,10 @@ namespace TFE_MidiPlayer
 		TFE_MidiDevice::selectDevice(0);
 		s_runMusicThread.store(true);
 
-		MUTEX_INITIALIZE(&s_mutex);
+		s_midiCmdWrite.store(0);
+		s_midiCmdRead.store(0);
+		s_midiLocalCmdCount = 0;
+		s_cmdSignal = Signal::create();
 
 		s_thread = Thread::create("MidiThread", midiUpdateFunc, nullptr);
 		if (s_thread)
@@ -139,6 +158,7 @@ namespace TFE_MidiPlayer
 		// Destroy the thread before shutting down the Midi Device.
 		stop();
 		s_runMusicThread.store(false);
+		s_cmdSignal->fire();
 		if (s_thread->isPaused())
 		{
 			s_thread->resume();
@@ -148,7 +168,8 @@ namespace TFE_MidiPlayer
 		delete s_thread;
 		TFE_MidiDevice::destroy();
 
-		MUTEX_DESTROY(&s_mutex);
+		delete s_cmdSignal;
+		s_cmdSignal = nullptr;
 	}
 	
 	void midiSetTimeScale(f64 scale)
@@ -159,17 +180,51 @@ namespace TFE_MidiPlayer
 	//////////////////////////////////////////////////
 	// Command Buffer
 	//////////////////////////////////////////////////
+	// Returns the next command slot or null if the buffer is full, the command is not visible to the midi thread until midiCommitCmd() is called.
 	MidiCmd* midiAllocCmd()
 	{
-		if (s_midiCmdCount >= MAX_MIDI_CMD) { return nullptr; }
-		MidiCmd* cmd = &s_midiCmdBuffer[s_midiCmdCount];
-		s_midiCmdCount++;
-		return cmd;
+		if (t_midiThread)
+		{
+			return s_midiLocalCmdCount < MAX_LOCAL_MIDI_CMD ? &s_midiLocalCmdBuffer[s_midiLocalCmdCount] : nullptr;
+		}
+
+		const u32 write = s_midiCmdWrite.load(std::memory_order_relaxed);
+		if (write - s_midiCmdRead.load(std::memory_order_acquire) >= MAX_MIDI_CMD)
+		{
+			return nullptr;
+		}
+		return &s_midiCmdBuffer[write & (MAX_MIDI_CMD - 1)];
+	}
+
+	void midiCommitCmd()
+	{
+		if (t_midiThread)
+		{
+			s_midiLocalCmdCount++;
+			return;
+		}
+		s_midiCmdWrite.store(s_midiCmdWrite.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		s_cmdSignal->fire();
 	}
 
-	void midiClearCmdBuffer()
+	// Gather the commands to process this update, called from the midi thread.
+	u32 midiReadCmds()
 	{
-		s_midiCmdCount = 0;
+		u32 count = 0;
+		for (u32 i = 0; i < s_midiLocalCmdCount; i++, count++)
+		{
+			s_midiPendingCmd[count] = s_midiLocalCmdBuffer[i];
+		}
+		s_midiLocalCmdCount = 0;
+
+		const u32 write = s_midiCmdWrite.load(std::memory_order_acquire);
+		u32 read = s_midiCmdRead.load(std::memory_order_relaxed);
+		for (; read != write; read++, count++)
+		{
+			s_midiPendingCmd[count] = s_midiCmdBuffer[read & (MAX_MIDI_CMD - 1)];
+		}
+		s_midiCmdRead.store(read, std::memory_order_release);
+		return count;
 	}
 	
 	//////////////////////////////////////////////////
@@ -179,7 +234,6 @@ namespace TFE_MidiPlayer
 	{
 		if (!gmidAsset) { return; }
 
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
@@ -188,8 +242,8 @@ namespace TFE_MidiPlayer
 			midiCmd->newTrack  = track;
 			midiCmd->newVolume = s_masterVolume;
 			midiCmd->loop = loop;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 
 		if (s_thread->isPaused())
 		{
@@ -199,52 +253,47 @@ namespace TFE_MidiPlayer
 	
 	void setVolume(f32 volume)
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
 			midiCmd->cmd = MIDI_CHANGE_VOL;
 			midiCmd->newVolume = volume;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 	
 	void pause()
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
 			midiCmd->cmd = MIDI_PAUSE;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 
 	void resume()
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
 			midiCmd->cmd = MIDI_RESUME;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 	
 	void stop()
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
 			midiCmd->cmd = MIDI_STOP;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 
 	void midiJump(s32 track, s32 measure, s32 beat, s32 tick)
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
@@ -255,20 +304,19 @@ namespace TFE_MidiPlayer
 			midiCmd->measure = measure - 1;
 			midiCmd->beat = beat - 1;
 			midiCmd->tick = tick;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 
 	void midiSet_iMuseCallback(iMuseCallback callback)
 	{
-		MUTEX_LOCK(&s_mutex);
 		MidiCmd* midiCmd = midiAllocCmd();
 		if (midiCmd)
 		{
 			midiCmd->cmd = MIDI_SET_IMUSE_CALLBACK;
 			midiCmd->callback = callback;
+			midiCommitCmd();
 		}
-		MUTEX_UNLOCK(&s_mutex);
 	}
 
 	iMuseCallback midiGet_iMuseCallback()
@@ -349,6 +397,8 @@ namespace TFE_MidiPlayer
 	// Thread Function
 	TFE_THREADRET midiUpdateFunc(void* userData)
 	{
+		TFE_Profiler::setThreadName("MidiThread");
+		t_midiThread = true;
 		bool runThread  = true;
 		bool wasPlaying = false;
 		bool isPlaying  = false;
@@ -359,9 +409,9 @@ namespace TFE_MidiPlayer
 		while (runThread)
 		{
 			// Read from the command buffer.
-			MUTEX_LOCK(&s_mutex);
-			MidiCmd* midiCmd = s_midiCmdBuffer;
-			for (u32 i = 0; i < s_midiCmdCount; i++, midiCmd++)
+			const u32 cmdCount = midiReadCmds();
+			const MidiCmd* midiCmd = s_midiPendingCmd;
+			for (u32 i = 0; i < cmdCount; i++, midiCmd++)
 			{
 				switch (midiCmd->cmd)
 				{
@@ -429,8 +479,6 @@ namespace TFE_MidiPlayer
 					} break;
 				}
 			}
-			s_midiCmdCount = 0;
-			MUTEX_UNLOCK(&s_mutex);
 
 			if (!isPlaying)
 			{
@@ -443,16 +491,19 @@ namespace TFE_MidiPlayer
 					loopStart = -1;
 				}
 
+				// Sleep until the next command.
 				runThread = s_runMusicThread.load();
-				if (runThread) { TFE_System::sleep(16); }
+				if (runThread && !s_midiLocalCmdCount) { s_cmdSignal->wait(); }
 				continue;
 			}
 			wasPlaying = true;
 
 			if (isPaused)
 			{
+				// Sleep until resumed, the time spent paused is discarded.
+				if (runThread && !s_midiLocalCmdCount) { s_cmdSignal->wait(); }
 				TFE_System::updateThreadLocal(&localTime);
-				if (runThread) { TFE_System::sleep(1); }
+				runThread = s_runMusicThread.load();
 				continue;
 			}
 
@@ -464,6 +515,7 @@ namespace TFE_MidiPlayer
 			bool allTracksFinished = true;
 			if (trackCount && dt >= MIDI_FRAME)
 			{
+				TFE_ZONE("Midi Update");
 				const Track* track = &asset->tracks[trackId];
 				MidiRuntimeTrack* runtimeTrack = &s_runtime.tracks[trackId];
 				if ((u32)runtimeTrack->curTick >= track->length)
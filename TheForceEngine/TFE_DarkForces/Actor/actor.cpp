@@ -5,6 +5,7 @@
 #include "../gameMusic.h"
 #include "aiActor.h"
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_DarkForces/random.h>
 #include <TFE_DarkForces/player.h>
 #include <TFE_DarkForces/hitEffect.h>
@@ -13,6 +14,7 @@
 #include <TFE_DarkForces/player.h>
 #include <TFE_Jedi/Level/rsector.h>
 #include <TFE_Jedi/Level/rwall.h>
+#include <TFE_Jedi/Collision/losQuery.h>
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
@@ -47,6 +49,11 @@ namespace TFE_DarkForces
 	SoundSourceID s_stormAlertSndSrc[STORM_ALERT_COUNT];
 	SoundSourceID s_agentSndSrc[AGENTSND_COUNT];
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_istate);
+	SNAPSHOT_STATE(s_physicsActors);
+	SNAPSHOT_STATE(s_actorState);
+
 	///////////////////////////////////////////
 	// Forward Declarations
 	///////////////////////////////////////////
@@ -1528,7 +1535,7 @@ namespace TFE_DarkForces
 	{
 		vec3_fixed p0 = { actorObj->posWS.x, actorObj->posWS.y - actorObj->worldHeight, actorObj->posWS.z };
 		vec3_fixed p1 = { obj->posWS.x, obj->posWS.y, obj->posWS.z };
-		if (collision_canHitObject(actorObj->sector, obj->sector, p0, p1, 0))
+		if (losQuery_canHit(actorObj->sector, obj->sector, p0, p1, 0))
 		{
 			return JTRUE;
 		}
@@ -1538,7 +1545,7 @@ namespace TFE_DarkForces
 		}
 
 		vec3_fixed p2 = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
-		return collision_canHitObject(actorObj->sector, obj->sector, p0, p2, 0);
+		return losQuery_canHit(actorObj->sector, obj->sector, p0, p2, 0);
 	}
 	   
 	JBool actor_canSeeObjFromDist(SecObject* actorObj, SecObject* obj)
@@ -18,6 +18,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Settings/settings.h>
 
 namespace TFE_DarkForces
@@ -62,6 +63,10 @@ namespace TFE_DarkForces
 	static s32 s_bobaFettNum = 0;
 	static s32 s_bobaFett_pitchScale = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curBobaFett);
+	SNAPSHOT_STATE(s_bobaFettNum);
+
 	void bobaFett_handleDamage(MessageType msg)
 	{
 		struct LocalContext
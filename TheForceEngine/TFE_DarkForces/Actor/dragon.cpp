@@ -17,6 +17,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -60,6 +61,10 @@ namespace TFE_DarkForces
 	static KellDragon* s_curDragon = nullptr;
 	static s32 s_dragonNum = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curDragon);
+	SNAPSHOT_STATE(s_dragonNum);
+
 	void kellDragon_handleDamage(MessageType msg)
 	{
 		struct LocalContext
@@ -15,6 +15,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -42,6 +43,10 @@ namespace TFE_DarkForces
 	static MouseBot* s_curMouseBot;
 	static s32 s_mouseNum = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curMouseBot);
+	SNAPSHOT_STATE(s_mouseNum);
+
 	MessageType mousebot_handleDamage(MessageType msg, MouseBot* mouseBot)
 	{
 		SecObject* obj = mouseBot->logic.obj;
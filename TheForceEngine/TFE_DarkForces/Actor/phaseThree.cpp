@@ -17,6 +17,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -55,6 +56,10 @@ namespace TFE_DarkForces
 	static PhaseThree* s_curTrooper = nullptr;
 	static s32 s_trooperNum = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curTrooper);
+	SNAPSHOT_STATE(s_trooperNum);
+
 	JBool phaseThree_updatePlayerPos(PhaseThree* trooper)
 	{
 		if (actor_canSeeObject(trooper->logic.obj, s_playerObject))
@@ -17,6 +17,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -67,6 +68,10 @@ namespace TFE_DarkForces
 	static Turret* s_curTurret;
 	static s32 s_turretNum = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curTurret);
+	SNAPSHOT_STATE(s_turretNum);
+
 	MessageType turret_handleDamage(MessageType msg, Turret* turret)
 	{
 		PhysicsActor* physicsActor = &turret->actor;
@@ -18,6 +18,7 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -51,6 +52,10 @@ namespace TFE_DarkForces
 	static Welder* s_curWelder = nullptr;
 	static s32 s_welderNum = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curWelder);
+	SNAPSHOT_STATE(s_welderNum);
+
 	MessageType welder_handleDamage(MessageType msg, Welder* welder)
 	{
 		PhysicsActor* physicsActor = &welder->actor;
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "lsound.h"
 #include <TFE_DarkForces/Landru/cutscene_film.h>
 #include <TFE_System/system.h>
@@ -268,8 +270,10 @@ namespace TFE_DarkForces
 				if (sound->soundSource)
 				{
 					TFE_Audio::freeSource(sound->soundSource);
+					TFE_Audio::waitForMixer();
 				}
 				free(sound->soundBuffer.data);
+				free(sound->soundBuffer.samples);
 			}
 
 			if (sound->varPtr)  { landru_free(sound->varPtr); }
@@ -311,6 +315,9 @@ namespace TFE_DarkForces
 
 		sound->callback = nullptr;
 		sound->data = nullptr;
+
+		// TFE
+		memset(&sound->soundBuffer, 0, sizeof(SoundBuffer));
 	}
 		
 	void lsound_addFader(LSound* sound, FaderType type, s16 target, s16 time)
@@ -10,6 +10,7 @@
 #include <TFE_FileSystem/paths.h>
 #include <TFE_System/system.h>
 #include <TFE_System/parser.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <assert.h>
 
 namespace TFE_DarkForces
@@ -28,6 +29,15 @@ namespace TFE_DarkForces
 	char** s_levelSrcPaths;
 
 	static Task* s_levelEndTask = nullptr;
+
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_agentData);
+	SNAPSHOT_STATE(s_levelComplete);
+	SNAPSHOT_STATE(s_invalidLevelIndex);
+	SNAPSHOT_STATE(s_maxLevelIndex);
+	SNAPSHOT_STATE(s_levelIndex);
+	SNAPSHOT_STATE(s_agentId);
+	SNAPSHOT_STATE(s_levelEndTask);
 		
 	///////////////////////////////////////////
 	// API Implementation
@@ -2,6 +2,7 @@
 #include "time.h"
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/InfSystem/message.h>
+#include <TFE_Game/gameSnapshot.h>
 
 using namespace TFE_Jedi;
 
@@ -10,6 +11,10 @@ namespace TFE_DarkForces
 	Allocator* s_spriteAnimList = nullptr;
 	Task* s_spriteAnimTask = nullptr;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_spriteAnimList);
+	SNAPSHOT_STATE(s_spriteAnimTask);
+
 	void setSpriteAnimation(Task* spriteAnimTask, Allocator* spriteAnimAlloc)
 	{
 		s_spriteAnimTask = spriteAnimTask;
@@ -0,0 +1,419 @@
+#include <cstring>
+
+#include "benchmark.h"
+#include "demo.h"
+#include "mission.h"
+#include "player.h"
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Renderer/virtualFramebuffer.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include <string>
+#include <map>
+
+using namespace TFE_Jedi;
+
+namespace TFE_DarkForces
+{
+	enum BenchmarkConstants
+	{
+		BENCH_DEFAULT_FRAMES = 1200,
+		BENCH_DEFAULT_RATE   = 60,
+		// Number of frames spent at each point along the camera path, the camera does a full turn at each point.
+		BENCH_FRAMES_PER_WAYPOINT = 60,
+		// Give up if the level has not started after this many frames.
+		BENCH_MAX_WAIT_FRAMES = 3000,
+	};
+
+	struct BenchmarkOptions
+	{
+		char levelName[64];
+		char outputPath[TFE_MAX_PATH];
+		s32  frameCount;
+		s32  frameRate;
+		s32  width;
+		s32  height;
+		JBool floatRenderer;
+		JBool demo;
+	};
+
+	struct BenchmarkZone
+	{
+		std::string name;
+		f64 total;
+		f64 maxTime;
+		u32 frameCount;
+	};
+
+	static BenchmarkOptions s_options;
+	static JBool s_active = JFALSE;
+	static JBool s_recording = JFALSE;
+	static JBool s_done = JFALSE;
+	static s32 s_waitFrames = 0;
+	static s32 s_frame = 0;
+
+	static std::vector<s32> s_pathSectors;
+	static std::vector<f64> s_frameTime;
+	static std::vector<u32> s_frameHash;
+	static std::vector<BenchmarkZone> s_zones;
+	static std::map<std::string, u32> s_zoneMap;
+
+	// Graphics settings are restored when the benchmark is done so they are not written back to disk.
+	static Vec2i s_prevResolution;
+	static bool  s_prevWidescreen;
+
+	void benchmark_finish(JBool success);
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	JBool benchmark_parseCommandLine(s32 argCount, const char* argv[])
+	{
+		s_options.levelName[0] = 0;
+		s_options.outputPath[0] = 0;
+		s_options.frameCount = BENCH_DEFAULT_FRAMES;
+		s_options.frameRate  = BENCH_DEFAULT_RATE;
+		s_options.width  = 640;
+		s_options.height = 400;
+		s_options.floatRenderer = JFALSE;
+		s_options.demo = JFALSE;
+		JBool frameCountSet = JFALSE;
+
+		for (s32 i = 0; i < argCount; i++)
+		{
+			const char* arg = argv[i];
+			const char* value = (i + 1 < argCount && argv[i + 1][0] != '-') ? argv[i + 1] : nullptr;
+			if (!arg || arg[0] != '-' || arg[1] != '-' || !value) { continue; }
+
+			const char* name = arg + 2;
+			if (strcasecmp(name, "benchmark") == 0)
+			{
+				strncpy(s_options.levelName, value, 63);
+				s_options.levelName[63] = 0;
+				s_active = JTRUE;
+			}
+			else if (strcasecmp(name, "benchFrames") == 0)
+			{
+				s_options.frameCount = std::max(1, atoi(value));
+				frameCountSet = JTRUE;
+			}
+			else if (strcasecmp(name, "benchRenderer") == 0)
+			{
+				s_options.floatRenderer = strcasecmp(value, "float") == 0 ? JTRUE : JFALSE;
+			}
+			else if (strcasecmp(name, "benchResolution") == 0)
+			{
+				s32 width, height;
+				if (sscanf(value, "%dx%d", &width, &height) == 2 && width >= 320 && height >= 200)
+				{
+					s_options.width  = width;
+					s_options.height = height;
+				}
+			}
+			else if (strcasecmp(name, "benchRate") == 0)
+			{
+				s_options.frameRate = std::max(1, atoi(value));
+			}
+			else if (strcasecmp(name, "benchOutput") == 0)
+			{
+				strncpy(s_options.outputPath, value, TFE_MAX_PATH - 1);
+				s_options.outputPath[TFE_MAX_PATH - 1] = 0;
+			}
+			else if (strcasecmp(name, "benchDemo") == 0)
+			{
+				s_options.demo = demo_load(value);
+			}
+		}
+
+		// The demo determines the level and, unless overridden, how many frames are recorded.
+		if (s_options.demo)
+		{
+			strncpy(s_options.levelName, demo_getLevelName(), 63);
+			s_options.levelName[63] = 0;
+			s_options.frameCount = frameCountSet ? s_options.frameCount : INT_MAX;
+			s_active = JTRUE;
+		}
+
+		if (s_active && !s_options.outputPath[0])
+		{
+			char fileName[TFE_MAX_PATH];
+			sprintf(fileName, "benchmark_%s.json", s_options.levelName);
+			TFE_Paths::appendPath(PATH_USER_DOCUMENTS, fileName, s_options.outputPath);
+		}
+		return s_active;
+	}
+
+	JBool benchmark_isActive()
+	{
+		return s_active;
+	}
+
+	const char* benchmark_getLevelName()
+	{
+		return s_options.levelName;
+	}
+
+	void benchmark_begin()
+	{
+		if (!s_active) { return; }
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "Level: %s, Frames: %d, Renderer: %s, Rate: %d fps, Path: %s, Output: %s", s_options.levelName, s_options.frameCount,
+			s_options.floatRenderer ? "Classic_Float" : "Classic_Fixed", s_options.frameRate, s_options.demo ? "demo" : "camera", s_options.outputPath);
+
+		// The renderer is selected by the game resolution (320x200 = Classic_Fixed).
+		TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
+		s_prevResolution = graphics->gameResolution;
+		s_prevWidescreen = graphics->widescreen;
+		graphics->widescreen = false;
+		if (s_options.floatRenderer && (s_options.width != 320 || s_options.height != 200))
+		{
+			graphics->gameResolution.x = s_options.width;
+			graphics->gameResolution.z = s_options.height;
+		}
+		else
+		{
+			graphics->gameResolution.x = 320;
+			graphics->gameResolution.z = 200;
+			s_options.floatRenderer = JFALSE;
+		}
+
+		// Game time advances by a fixed amount each frame so the run is the same no matter how long each frame takes.
+		TFE_System::setFixedTimeStep(1.0 / f64(s_options.frameRate));
+
+		s_recording = JFALSE;
+		s_done = JFALSE;
+		s_waitFrames = 0;
+		s_frame = 0;
+		s_frameTime.clear();
+		s_frameHash.clear();
+		s_zones.clear();
+		s_zoneMap.clear();
+		if (!s_options.demo)
+		{
+			s_frameTime.reserve(s_options.frameCount);
+			s_frameHash.reserve(s_options.frameCount);
+		}
+	}
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static u32 hashFramebuffer()
+	{
+		u32 width, height;
+		vfb_getResolution(&width, &height);
+		const u8* buffer = vfb_getCpuBuffer();
+		if (!buffer) { return 0; }
+
+		// FNV-1a
+		u32 hash = 2166136261u;
+		const u32 size = width * height;
+		for (u32 i = 0; i < size; i++)
+		{
+			hash = (hash ^ buffer[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	// Sectors are visited in order, only using sectors where the center of the bounds is inside of the sector.
+	static void buildCameraPath()
+	{
+		s_pathSectors.clear();
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			RSector* sector = &s_sectors[i];
+			if (sector->floorHeight - sector->ceilingHeight < FIXED(7)) { continue; }
+
+			const fixed16_16 x = (sector->boundsMin.x >> 1) + (sector->boundsMax.x >> 1);
+			const fixed16_16 z = (sector->boundsMin.z >> 1) + (sector->boundsMax.z >> 1);
+			if (sector_which3D(x, sector->floorHeight - ONE_16, z) == sector)
+			{
+				s_pathSectors.push_back(s32(i));
+			}
+		}
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "Camera path: %u of %u sectors usable.", u32(s_pathSectors.size()), s_sectorCount);
+	}
+
+	static void updateCamera(s32 frame)
+	{
+		if (s_pathSectors.empty()) { return; }
+
+		const s32 waypointCount = (s_options.frameCount + BENCH_FRAMES_PER_WAYPOINT - 1) / BENCH_FRAMES_PER_WAYPOINT;
+		const s32 stride = std::max(1, s32(s_pathSectors.size()) / waypointCount);
+		const s32 waypoint = frame / BENCH_FRAMES_PER_WAYPOINT;
+		const s32 waypointFrame = frame - waypoint * BENCH_FRAMES_PER_WAYPOINT;
+
+		RSector* sector = &s_sectors[s_pathSectors[(waypoint * stride) % s32(s_pathSectors.size())]];
+		const fixed16_16 x = (sector->boundsMin.x >> 1) + (sector->boundsMax.x >> 1);
+		const fixed16_16 z = (sector->boundsMin.z >> 1) + (sector->boundsMax.z >> 1);
+		const angle14_32 yaw = angle14_32(waypointFrame * (ANGLE_MASK + 1) / BENCH_FRAMES_PER_WAYPOINT);
+		player_warp(sector, x, z, yaw);
+	}
+
+	static void recordFrame()
+	{
+		s_frameTime.push_back(TFE_Profiler::getTimeInFrame());
+		s_frameHash.push_back(hashFramebuffer());
+
+	#ifdef TFE_PROFILE_ENABLED
+		const u32 zoneCount = TFE_Profiler::getZoneCount();
+		for (u32 i = 0; i < zoneCount; i++)
+		{
+			TFE_ZoneInfo info;
+			TFE_Profiler::getZoneInfo(i, &info);
+
+			u32 index;
+			std::map<std::string, u32>::iterator iZone = s_zoneMap.find(info.name);
+			if (iZone == s_zoneMap.end())
+			{
+				index = u32(s_zones.size());
+				s_zones.push_back({ info.name, 0.0, 0.0, 0 });
+				s_zoneMap[info.name] = index;
+			}
+			else
+			{
+				index = iZone->second;
+			}
+
+			BenchmarkZone* zone = &s_zones[index];
+			zone->total += info.timeInZone;
+			zone->maxTime = std::max(zone->maxTime, info.timeInZone);
+			zone->frameCount++;
+		}
+	#endif
+	}
+
+	static f64 getPercentile(const std::vector<f64>& sorted, f64 percentile)
+	{
+		if (sorted.empty()) { return 0.0; }
+		const size_t index = std::min(sorted.size() - 1, size_t(percentile * f64(sorted.size() - 1) + 0.5));
+		return sorted[index];
+	}
+
+	static JBool writeResults()
+	{
+		FileStream file;
+		if (!file.open(s_options.outputPath, FileStream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Benchmark", "Cannot write benchmark results to '%s'.", s_options.outputPath);
+			return JFALSE;
+		}
+
+		const size_t frameCount = s_frameTime.size();
+		std::vector<f64> sorted = s_frameTime;
+		std::sort(sorted.begin(), sorted.end());
+		f64 total = 0.0;
+		u32 runHash = 2166136261u;
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			total += s_frameTime[i];
+			runHash = (runHash ^ s_frameHash[i]) * 16777619u;
+		}
+		const f64 ave = frameCount ? total / f64(frameCount) : 0.0;
+
+		u32 width, height;
+		vfb_getResolution(&width, &height);
+
+		file.writeString("{\n");
+		file.writeString("  \"version\": \"%s\",\n", TFE_System::getVersionString());
+		file.writeString("  \"level\": \"%s\",\n", s_options.levelName);
+		file.writeString("  \"renderer\": \"%s\",\n", s_options.floatRenderer ? "Classic_Float" : "Classic_Fixed");
+		file.writeString("  \"width\": %u,\n  \"height\": %u,\n", width, height);
+		file.writeString("  \"frameRate\": %d,\n", s_options.frameRate);
+		file.writeString("  \"path\": \"%s\",\n", s_options.demo ? "demo" : "camera");
+		file.writeString("  \"frameCount\": %u,\n", u32(frameCount));
+		file.writeString("  \"pathSectorCount\": %u,\n", u32(s_pathSectors.size()));
+		file.writeString("  \"totalMs\": %0.4f,\n", total * 1000.0);
+		file.writeString("  \"aveMs\": %0.4f,\n", ave * 1000.0);
+		file.writeString("  \"minMs\": %0.4f,\n", getPercentile(sorted, 0.0) * 1000.0);
+		file.writeString("  \"medianMs\": %0.4f,\n", getPercentile(sorted, 0.5) * 1000.0);
+		file.writeString("  \"p95Ms\": %0.4f,\n", getPercentile(sorted, 0.95) * 1000.0);
+		file.writeString("  \"p99Ms\": %0.4f,\n", getPercentile(sorted, 0.99) * 1000.0);
+		file.writeString("  \"maxMs\": %0.4f,\n", getPercentile(sorted, 1.0) * 1000.0);
+		file.writeString("  \"framebufferHash\": \"%08x\",\n", runHash);
+
+		file.writeString("  \"zones\": [\n");
+		const size_t zoneCount = s_zones.size();
+		for (size_t i = 0; i < zoneCount; i++)
+		{
+			const BenchmarkZone* zone = &s_zones[i];
+			file.writeString("    { \"name\": \"%s\", \"totalMs\": %0.4f, \"aveMs\": %0.4f, \"maxMs\": %0.4f, \"frames\": %u }%s\n", zone->name.c_str(),
+				zone->total * 1000.0, frameCount ? zone->total * 1000.0 / f64(frameCount) : 0.0, zone->maxTime * 1000.0, zone->frameCount, i + 1 < zoneCount ? "," : "");
+		}
+		file.writeString("  ],\n");
+
+		file.writeString("  \"frames\": [\n");
+		for (size_t i = 0; i < frameCount; i++)
+		{
+			file.writeString("    { \"ms\": %0.4f, \"hash\": \"%08x\" }%s\n", s_frameTime[i] * 1000.0, s_frameHash[i], i + 1 < frameCount ? "," : "");
+		}
+		file.writeString("  ]\n");
+		file.writeString("}\n");
+		file.close();
+
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "%u frames, ave %0.3fms, p95 %0.3fms, max %0.3fms, hash %08x. Results written to '%s'.", u32(frameCount), ave * 1000.0,
+			getPercentile(sorted, 0.95) * 1000.0, getPercentile(sorted, 1.0) * 1000.0, runHash, s_options.outputPath);
+		return JTRUE;
+	}
+
+	void benchmark_finish(JBool success)
+	{
+		if (success)
+		{
+			writeResults();
+		}
+		s_done = JTRUE;
+		s_recording = JFALSE;
+
+		TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
+		graphics->gameResolution = s_prevResolution;
+		graphics->widescreen = s_prevWidescreen;
+		TFE_System::setFixedTimeStep(0.0);
+		TFE_System::postQuitMessage();
+	}
+
+	void benchmark_update()
+	{
+		if (!s_active || s_done) { return; }
+
+		// The profiler and framebuffer hold the results of the previous frame at this point.
+		if (s_recording)
+		{
+			recordFrame();
+			s_frame++;
+			// Demo runs end when the demo is done.
+			if (s_frame >= s_options.frameCount || (s_options.demo && !demo_isPlaying()))
+			{
+				benchmark_finish(JTRUE);
+				return;
+			}
+		}
+		else if (s_missionMode == MISSION_MODE_MAIN && s_playerObject)
+		{
+			if (!s_options.demo)
+			{
+				buildCameraPath();
+				// God mode, so the run is not cut short by enemies.
+				s_invincibility = -2;
+			}
+			s_recording = JTRUE;
+		}
+		else if (++s_waitFrames > BENCH_MAX_WAIT_FRAMES)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Benchmark", "Level '%s' failed to start.", s_options.levelName);
+			benchmark_finish(JFALSE);
+			return;
+		}
+
+		if (s_recording && !s_options.demo)
+		{
+			updateCamera(s_frame);
+		}
+	}
+}  // namespace TFE_DarkForces
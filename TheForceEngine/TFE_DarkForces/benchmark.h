@@ -0,0 +1,35 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Dark Forces Benchmark
+// TFE specific headless benchmark runner.
+//
+// Loads a level directly, moves the camera along a scripted path
+// through the level sectors (or plays back a recorded demo) at a fixed
+// tick rate and writes per-frame timings, profiler zone totals and
+// framebuffer hashes to a JSON file.
+//
+// Command line:
+//   --benchmark LEVEL          Level to load, such as SECBASE.
+//   --benchFrames N            Number of frames to record (default 1200).
+//   --benchRenderer NAME       fixed or float (default fixed).
+//   --benchResolution WxH      Float renderer resolution (default 640x400).
+//   --benchRate FPS            Fixed frame rate used for game time (default 60).
+//   --benchOutput PATH         Output file (default: <Documents>/benchmark_LEVEL.json).
+//   --benchDemo PATH           Play back a demo instead of the camera path, the level is
+//                              taken from the demo and --benchmark is not required.
+//                              By default the whole demo is recorded.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_DarkForces
+{
+	// Parse the benchmark options, returns JTRUE if a benchmark was requested.
+	JBool benchmark_parseCommandLine(s32 argCount, const char* argv[]);
+	JBool benchmark_isActive();
+	const char* benchmark_getLevelName();
+
+	// Setup the fixed time step and render settings, called once the game has been started.
+	void benchmark_begin();
+	// Called at the start of every game frame, records the previous frame and moves the camera.
+	void benchmark_update();
+}  // namespace TFE_DarkForces
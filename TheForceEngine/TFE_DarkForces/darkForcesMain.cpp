@@ -2,7 +2,9 @@
 
 #include "darkForcesMain.h"
 #include "agent.h"
+#include "benchmark.h"
 #include "config.h"
+#include "demo.h"
 #include "briefingList.h"
 #include "gameMessage.h"
 #include "gameMusic.h"
@@ -36,6 +38,7 @@
 #include <TFE_Archive/gobMemoryArchive.h>
 #include <TFE_Jedi/Level/rfont.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Collision/losQuery.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
@@ -207,6 +210,7 @@ namespace TFE_DarkForces
 	void gameStartup();
 	void loadAgentAndLevelData();
 	void startNextMode();
+	JBool launchLevel(const char* levelName);
 	void freeAllMidi();
 	void pauseLevelSound();
 	void resumeLevelSound();
@@ -238,6 +242,25 @@ namespace TFE_DarkForces
 		
 		// TFE Specific
 		actorDebug_init();
+		demo_init();
+
+		// TFE: Go directly to the level, skipping the menus, cutscenes and briefing.
+		if (benchmark_isActive())
+		{
+			benchmark_begin();
+			if (!launchLevel(benchmark_getLevelName()))
+			{
+				TFE_System::postQuitMessage();
+			}
+		}
+		else if (demo_isPlaybackPending())
+		{
+			launchLevel(demo_getLevelName());
+		}
+		else if (s_launchLevelName)
+		{
+			launchLevel(s_launchLevelName);
+		}
 
 		return true;
 	}
@@ -279,12 +302,18 @@ namespace TFE_DarkForces
 		escapeMenu_resetState();
 		vue_resetState();
 		lsystem_destroy();
+		demo_stop();
 		// Free debug data
 		actorDebug_free();
 	}
 
 	void DarkForces::pauseGame(bool pause)
 	{
+		// TFE: The console is not part of the simulation, so opening it ends demo recording and playback.
+		if (pause)
+		{
+			demo_stop();
+		}
 		mission_pause(pause ? JTRUE : JFALSE);
 	}
 
@@ -351,7 +380,10 @@ namespace TFE_DarkForces
 	****************************************************/
 	void DarkForces::loopGame()
 	{
-		updateTime();
+		// TFE: Benchmark camera and timing.
+		benchmark_update();
+		// TFE: Demo playback replaces the game clock and input with the recorded values.
+		demo_updateTime();
 
 		switch (s_state)
 		{
@@ -551,6 +583,8 @@ namespace TFE_DarkForces
 
 				agent_setLevelComplete(JFALSE);
 				agent_readSavedDataForLevel(s_agentId, levelIndex);
+				// TFE: Start demo recording or playback from the initial mission state.
+				demo_beginMission();
 
 				// The load mission task should begin immediately once the Task System updates,
 				// so launchCurrentTask() is not required here.
@@ -560,6 +594,47 @@ namespace TFE_DarkForces
 		}
 	}
 
+	// Start the mission for the level, this is the same as selecting it from the agent menu
+	// and then skipping the cutscenes and mission briefing.
+	JBool launchLevel(const char* levelName)
+	{
+		s32 levelIndex = 0;
+		for (s32 i = 0; i < s_maxLevelIndex; i++)
+		{
+			if (s_levelGamePaths[i] && strcasecmp(levelName, s_levelGamePaths[i]) == 0)
+			{
+				levelIndex = i + 1;
+				break;
+			}
+		}
+		if (!levelIndex)
+		{
+			TFE_System::logWrite(LOG_ERROR, "DarkForcesMain", "Cannot launch level '%s', it is not in the level list.", levelName);
+			return JFALSE;
+		}
+
+		s_invalidLevelIndex = JTRUE;
+		for (s32 i = 0; i < TFE_ARRAYSIZE(s_cutsceneData); i++)
+		{
+			if (s_cutsceneData[i].levelIndex == levelIndex && s_cutsceneData[i].nextGameMode == GMODE_MISSION)
+			{
+				s_cutsceneIndex = i;
+				s_invalidLevelIndex = JFALSE;
+				break;
+			}
+		}
+		if (s_invalidLevelIndex)
+		{
+			return JFALSE;
+		}
+
+		s_levelIndex = levelIndex;
+		s_abortLevel = JFALSE;
+		agent_setNextLevelByIndex(levelIndex);
+		startNextMode();
+		return JTRUE;
+	}
+
 	/////////////////////////////////////////////
 	// Internal Implementation
 	/////////////////////////////////////////////
@@ -594,6 +669,8 @@ namespace TFE_DarkForces
 				}
 			}
 		}
+		demo_parseCommandLine(argCount, argv);
+		benchmark_parseCommandLine(argCount, argv);
 
 		// TFE: Support drag and drop.
 		if (argCount == 2)
@@ -895,6 +972,7 @@ namespace TFE_DarkForces
 		projectile_startup();
 		hitEffect_startup();
 		weapon_startup();
+		losQuery_init();
 
 		FilePath filePath;
 		TFE_Paths::getFilePath("swfont1.fnt", &filePath);
@@ -0,0 +1,709 @@
+#include <cstring>
+
+#include "demo.h"
+#include "agent.h"
+#include "player.h"
+#include "random.h"
+#include "time.h"
+#include "mission.h"
+#include "GameUI/escapeMenu.h"
+#include "GameUI/pda.h"
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_Input/inputMapping.h>
+#include <TFE_Jedi/Task/task.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_System/system.h>
+#include <vector>
+
+using namespace TFE_Input;
+using namespace TFE_Jedi;
+
+namespace TFE_DarkForces
+{
+	enum DemoConstants
+	{
+		DEMO_MAGIC   = 0x4d444654,	// "TFDM"
+		DEMO_VERSION = 1,
+		DEMO_LEVEL_NAME_LEN = 32,
+		// Buffered text is at most 63 characters + the null terminator.
+		DEMO_MAX_TEXT_LEN = 63,
+		// Action states only need 2 bits each.
+		DEMO_ACTION_BYTES = (IA_COUNT + 3) / 4,
+		// The snapshot check advances the game clock by a fixed step every frame.
+		DEMO_CHECK_FRAME_TICKS = 2,
+		DEMO_CHECK_DEFAULT_FRAMES = 300,
+	};
+
+	enum DemoState
+	{
+		DEMO_IDLE = 0,
+		DEMO_RECORD_PENDING,	// Recording begins with the next mission.
+		DEMO_RECORD,
+		DEMO_PLAYBACK_PENDING,	// Playback begins when the demo level is started.
+		DEMO_PLAYBACK,
+		DEMO_CHECK_PENDING,		// The snapshot check begins with the next game frame.
+		DEMO_CHECK_RECORD,
+		DEMO_CHECK_REPLAY,
+	};
+
+	enum DemoFrameFlags
+	{
+		DFRAME_ACTIONS = FLAG_BIT(0),	// The action states changed since the previous frame.
+		DFRAME_AXIS    = FLAG_BIT(1),	// The analog axis values changed since the previous frame.
+		DFRAME_MOUSE   = FLAG_BIT(2),	// Non-zero mouse movement.
+		DFRAME_TEXT    = FLAG_BIT(3),	// Buffered text, which is used for cheat codes.
+	};
+
+	// The state the mission depends on, captured when the mission is started.
+	struct DemoHeader
+	{
+		u32 magic;
+		u32 version;
+		char levelName[DEMO_LEVEL_NAME_LEN];
+		u32 difficulty;
+		u32 seed;
+		Tick curTick;
+		Tick prevTick;
+		fixed16_16 frameTicks[13];
+		u8  inv[32];
+		s32 ammo[10];
+		// Settings that change how the game plays.
+		s32 airControl;
+		u32 fixBobaFettFireDir;
+		u32 mouseFlags;
+		u32 mouseMode;
+		f32 mouseSensitivity[2];
+	};
+
+	// The input for one frame of the snapshot check.
+	struct DemoCheckFrame
+	{
+		InputFrame input;
+		char text[DEMO_MAX_TEXT_LEN + 1];
+	};
+
+	// Settings that playback replaces, restored when it is done.
+	struct DemoRestoreState
+	{
+		u8  difficulty;
+		s32 airControl;
+		bool fixBobaFettFireDir;
+		u32 mouseFlags;
+		MouseMode mouseMode;
+		f32 mouseSensitivity[2];
+	};
+
+	static DemoState s_demoState = DEMO_IDLE;
+	static DemoHeader s_header;
+	static DemoRestoreState s_restore;
+	static char s_demoPath[TFE_MAX_PATH];
+	static MemoryStream s_stream;
+	static std::vector<u8> s_playbackData;
+	static std::vector<Tick> s_frameDeltas;
+	static InputFrame s_prevInput;
+	static Tick s_lastTick = 0;
+	static u32 s_frameCount = 0;
+
+	// Snapshot check state.
+	static MemoryStream s_checkStart;
+	static MemoryStream s_checkRecorded;
+	static std::vector<DemoCheckFrame> s_checkFrames;
+	static u32 s_checkFrameCount = 0;
+
+	extern JBool s_palModified;
+	extern JBool s_updateHudColors;
+
+	void console_demoRecord(const ConsoleArgList& args);
+	void console_demoStop(const ConsoleArgList& args);
+	void console_snapshotCheck(const ConsoleArgList& args);
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static void writeVarint(u32 value)
+	{
+		while (value >= 0x80)
+		{
+			const u8 byte = u8(value & 0x7f) | 0x80;
+			s_stream.write(&byte);
+			value >>= 7;
+		}
+		const u8 byte = u8(value);
+		s_stream.write(&byte);
+	}
+
+	static u32 readVarint()
+	{
+		u32 value = 0;
+		for (u32 shift = 0; shift < 32; shift += 7)
+		{
+			u8 byte = 0;
+			s_stream.read(&byte);
+			value |= u32(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) { break; }
+		}
+		return value;
+	}
+
+	// Small signed values, such as mouse movement, encode to a single byte.
+	static u32 zigzagEncode(s32 value)
+	{
+		return (u32(value) << 1) ^ u32(value >> 31);
+	}
+
+	static s32 zigzagDecode(u32 value)
+	{
+		return s32(value >> 1) ^ -s32(value & 1);
+	}
+
+	// The game clock normally limits the task system to one update per tick.
+	static void resetTaskInterval()
+	{
+		task_setMinStepInterval(1.0f / f32(TICKS_PER_SECOND));
+	}
+
+	// Menus and the console are not part of the simulation, so the demo ends when they are opened.
+	// It also ends when the mission is over.
+	static JBool isMissionInterrupted()
+	{
+		return escapeMenu_isOpen() || pda_isOpen() || !task_getCount();
+	}
+
+	static void beginRecording()
+	{
+		memset(&s_header, 0, sizeof(DemoHeader));
+		s_header.magic = DEMO_MAGIC;
+		s_header.version = DEMO_VERSION;
+		strncpy(s_header.levelName, agent_getLevelName(), DEMO_LEVEL_NAME_LEN - 1);
+		s_header.difficulty = s_agentData[s_agentId].difficulty;
+		s_header.seed = random_getSeed();
+		s_header.curTick = s_curTick;
+		s_header.prevTick = s_prevTick;
+		memcpy(s_header.frameTicks, s_frameTicks, sizeof(fixed16_16) * 13);
+		player_writeInfo(s_header.inv, s_header.ammo);
+
+		const TFE_Settings_Game* gameSettings = TFE_Settings::getGameSettings();
+		const InputConfig* inputConfig = inputMapping_get();
+		s_header.airControl = gameSettings->df_airControl;
+		s_header.fixBobaFettFireDir = gameSettings->df_fixBobaFettFireDir ? 1 : 0;
+		s_header.mouseFlags = inputConfig->mouseFlags;
+		s_header.mouseMode = u32(inputConfig->mouseMode);
+		s_header.mouseSensitivity[0] = inputConfig->mouseSensitivity[0];
+		s_header.mouseSensitivity[1] = inputConfig->mouseSensitivity[1];
+
+		s_stream.open(MemoryStream::MODE_WRITE);
+		s_stream.writeBuffer(&s_header, sizeof(DemoHeader));
+
+		memset(&s_prevInput, 0, sizeof(InputFrame));
+		s_frameDeltas.clear();
+		s_lastTick = s_curTick;
+		s_frameCount = 0;
+		s_demoState = DEMO_RECORD;
+
+		// Make sure the first task frame starts on the next update, which is where playback starts as well.
+		resetTaskInterval();
+		TFE_System::logWrite(LOG_MSG, "Demo", "Recording level %s to '%s'.", s_header.levelName, s_demoPath);
+	}
+
+	static void beginPlayback()
+	{
+		if (strcasecmp(s_header.levelName, agent_getLevelName()) != 0)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "The demo was recorded on level %s, but level %s was started.", s_header.levelName, agent_getLevelName());
+			demo_stop();
+			return;
+		}
+
+		TFE_Settings_Game* gameSettings = TFE_Settings::getGameSettings();
+		InputConfig* inputConfig = inputMapping_get();
+		s_restore.difficulty = s_agentData[s_agentId].difficulty;
+		s_restore.airControl = gameSettings->df_airControl;
+		s_restore.fixBobaFettFireDir = gameSettings->df_fixBobaFettFireDir;
+		s_restore.mouseFlags = inputConfig->mouseFlags;
+		s_restore.mouseMode = inputConfig->mouseMode;
+		s_restore.mouseSensitivity[0] = inputConfig->mouseSensitivity[0];
+		s_restore.mouseSensitivity[1] = inputConfig->mouseSensitivity[1];
+
+		s_agentData[s_agentId].difficulty = u8(s_header.difficulty);
+		gameSettings->df_airControl = s_header.airControl;
+		gameSettings->df_fixBobaFettFireDir = s_header.fixBobaFettFireDir != 0;
+		inputConfig->mouseFlags = s_header.mouseFlags;
+		inputConfig->mouseMode = MouseMode(s_header.mouseMode);
+		inputConfig->mouseSensitivity[0] = s_header.mouseSensitivity[0];
+		inputConfig->mouseSensitivity[1] = s_header.mouseSensitivity[1];
+
+		random_seed(s_header.seed);
+		time_setTick(s_header.curTick);
+		s_prevTick = s_header.prevTick;
+		memcpy(s_frameTicks, s_header.frameTicks, sizeof(fixed16_16) * 13);
+		player_readInfo(s_header.inv, s_header.ammo);
+
+		s_stream.load(s_playbackData.data(), s_playbackData.size());
+		s_stream.seek(sizeof(DemoHeader));
+		memset(&s_prevInput, 0, sizeof(InputFrame));
+		inputMapping_beginReplay();
+		s_frameCount = 0;
+		s_demoState = DEMO_PLAYBACK;
+
+		// Like recording, the first task frame runs on the next update.
+		resetTaskInterval();
+		TFE_System::logWrite(LOG_MSG, "Demo", "Playing back '%s' on level %s.", s_demoPath, s_header.levelName);
+	}
+
+	static void writeFrame()
+	{
+		InputFrame input;
+		inputMapping_captureFrame(&input);
+		const char* text = TFE_Input::getBufferedText();
+		const u8 textLen = u8(min(strlen(text), size_t(DEMO_MAX_TEXT_LEN)));
+
+		// Tick deltas are stored individually since the fractional frame ticks depend on each step.
+		writeVarint(u32(s_frameDeltas.size()));
+		for (size_t i = 0; i < s_frameDeltas.size(); i++)
+		{
+			writeVarint(s_frameDeltas[i]);
+		}
+		s_frameDeltas.clear();
+
+		u8 flags = 0;
+		if (memcmp(input.actions, s_prevInput.actions, IA_COUNT) != 0)          { flags |= DFRAME_ACTIONS; }
+		if (memcmp(input.axis, s_prevInput.axis, sizeof(f32) * AA_COUNT) != 0) { flags |= DFRAME_AXIS; }
+		if (input.mouseMove[0] || input.mouseMove[1]) { flags |= DFRAME_MOUSE; }
+		if (textLen) { flags |= DFRAME_TEXT; }
+		s_stream.write(&flags);
+
+		if (flags & DFRAME_ACTIONS)
+		{
+			u8 packed[DEMO_ACTION_BYTES] = { 0 };
+			for (u32 i = 0; i < IA_COUNT; i++)
+			{
+				packed[i >> 2] |= (input.actions[i] & 3) << ((i & 3) << 1);
+			}
+			s_stream.writeBuffer(packed, DEMO_ACTION_BYTES);
+		}
+		if (flags & DFRAME_AXIS)
+		{
+			s_stream.write(input.axis, AA_COUNT);
+		}
+		if (flags & DFRAME_MOUSE)
+		{
+			writeVarint(zigzagEncode(input.mouseMove[0]));
+			writeVarint(zigzagEncode(input.mouseMove[1]));
+		}
+		if (flags & DFRAME_TEXT)
+		{
+			s_stream.write(&textLen);
+			s_stream.writeBuffer(text, textLen);
+		}
+
+		s_prevInput = input;
+		s_frameCount++;
+	}
+
+	static JBool readFrame()
+	{
+		if (s_stream.getLoc() >= s_stream.getSize())
+		{
+			return JFALSE;
+		}
+
+		const u32 deltaCount = readVarint();
+		for (u32 i = 0; i < deltaCount; i++)
+		{
+			time_advance(readVarint());
+		}
+
+		u8 flags = 0;
+		s_stream.read(&flags);
+		if (flags & DFRAME_ACTIONS)
+		{
+			u8 packed[DEMO_ACTION_BYTES];
+			s_stream.readBuffer(packed, DEMO_ACTION_BYTES);
+			for (u32 i = 0; i < IA_COUNT; i++)
+			{
+				s_prevInput.actions[i] = (packed[i >> 2] >> ((i & 3) << 1)) & 3;
+			}
+		}
+		if (flags & DFRAME_AXIS)
+		{
+			s_stream.read(s_prevInput.axis, AA_COUNT);
+		}
+		s_prevInput.mouseMove[0] = 0;
+		s_prevInput.mouseMove[1] = 0;
+		if (flags & DFRAME_MOUSE)
+		{
+			s_prevInput.mouseMove[0] = zigzagDecode(readVarint());
+			s_prevInput.mouseMove[1] = zigzagDecode(readVarint());
+		}
+		char text[DEMO_MAX_TEXT_LEN + 1] = { 0 };
+		if (flags & DFRAME_TEXT)
+		{
+			u8 textLen = 0;
+			s_stream.read(&textLen);
+			s_stream.readBuffer(text, u32(min(s32(textLen), s32(DEMO_MAX_TEXT_LEN))));
+		}
+
+		inputMapping_replayFrame(&s_prevInput);
+		// Replace any text typed during playback.
+		TFE_Input::setBufferedInput(text);
+		s_frameCount++;
+		return JTRUE;
+	}
+
+	static void recordUpdate()
+	{
+		if (isMissionInterrupted())
+		{
+			demo_stop();
+			return;
+		}
+
+		const Tick delta = s_curTick - s_lastTick;
+		s_lastTick = s_curTick;
+		if (delta)
+		{
+			s_frameDeltas.push_back(delta);
+		}
+
+		// A frame is written for every task system update, which is when the game consumes the input.
+		if (task_canRun())
+		{
+			writeFrame();
+		}
+	}
+
+	static JBool playbackUpdate()
+	{
+		if (isMissionInterrupted() || !readFrame())
+		{
+			demo_stop();
+			return JFALSE;
+		}
+		// Every recorded frame was a task system update, so the update rate is not limited during playback.
+		task_setMinStepInterval(0.0);
+		return JTRUE;
+	}
+
+	static void reportCheck(const char* msg)
+	{
+		TFE_Console::addToHistory(msg);
+		TFE_System::logWrite(LOG_MSG, "Snapshot", "%s", msg);
+	}
+
+	// The snapshot check records the input for a number of frames starting from a snapshot, then restores the snapshot,
+	// replays the same input and compares the resulting state. Any difference is game state the snapshot is missing
+	// (or non-deterministic simulation), which would break quickloads, rewind and demos.
+	static void checkUpdate()
+	{
+		if (isMissionInterrupted())
+		{
+			reportCheck("Snapshot check cancelled, the mission was interrupted.");
+			demo_stop();
+			updateTime();
+			return;
+		}
+
+		if (s_demoState == DEMO_CHECK_PENDING)
+		{
+			if (!TFE_Snapshot::capture(&s_checkStart))
+			{
+				reportCheck("Snapshot check failed: cannot capture the game state.");
+				s_demoState = DEMO_IDLE;
+				updateTime();
+				return;
+			}
+			s_checkFrames.clear();
+			s_demoState = DEMO_CHECK_RECORD;
+		}
+
+		if (s_demoState == DEMO_CHECK_RECORD)
+		{
+			if (s_checkFrames.size() < s_checkFrameCount)
+			{
+				DemoCheckFrame frame;
+				inputMapping_captureFrame(&frame.input);
+				strncpy(frame.text, TFE_Input::getBufferedText(), DEMO_MAX_TEXT_LEN);
+				frame.text[DEMO_MAX_TEXT_LEN] = 0;
+				s_checkFrames.push_back(frame);
+
+				// Every frame is a task system update, so the frames match exactly when replayed.
+				task_setMinStepInterval(0.0);
+				time_advance(DEMO_CHECK_FRAME_TICKS);
+				return;
+			}
+
+			// All of the frames have been simulated, go back to the start and replay them.
+			TFE_Snapshot::capture(&s_checkRecorded);
+			if (!TFE_Snapshot::restore(&s_checkStart))
+			{
+				reportCheck("Snapshot check failed: cannot restore the game state, see the log for details.");
+				demo_stop();
+				updateTime();
+				return;
+			}
+			s_palModified = JTRUE;
+			s_updateHudColors = JTRUE;
+			inputMapping_beginReplay();
+			s_frameCount = 0;
+			s_demoState = DEMO_CHECK_REPLAY;
+		}
+
+		if (s_frameCount < s_checkFrames.size())
+		{
+			const DemoCheckFrame& frame = s_checkFrames[s_frameCount];
+			inputMapping_replayFrame(&frame.input);
+			TFE_Input::setBufferedInput(frame.text);
+			s_frameCount++;
+
+			task_setMinStepInterval(0.0);
+			time_advance(DEMO_CHECK_FRAME_TICKS);
+			return;
+		}
+
+		MemoryStream replayed;
+		TFE_Snapshot::capture(&replayed);
+		const u32 diffCount = TFE_Snapshot::compare(&s_checkRecorded, &replayed);
+		demo_stop();
+
+		char res[256];
+		if (diffCount)
+		{
+			sprintf(res, "Snapshot check FAILED after %u frames: %u differences, see the log for details.", s_frameCount, diffCount);
+			TFE_Console::addToHistory(res);
+			TFE_System::logWrite(LOG_ERROR, "Snapshot", "%s", res);
+		}
+		else
+		{
+			sprintf(res, "Snapshot check passed after %u frames.", s_frameCount);
+			reportCheck(res);
+		}
+		updateTime();
+	}
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	void demo_init()
+	{
+		CCMD("demoRecord", console_demoRecord, 1, "demoRecord(name) - record the next mission that is started to <Documents>/name.tfd.");
+		CCMD("demoStop", console_demoStop, 0, "Stop demo recording or playback.");
+		CCMD("snapshotCheck", console_snapshotCheck, 0, "snapshotCheck [frames] - play the given number of frames, restore the starting snapshot, replay the same input and report any game state that differs.");
+	}
+
+	JBool demo_parseCommandLine(s32 argCount, const char* argv[])
+	{
+		for (s32 i = 0; i < argCount; i++)
+		{
+			const char* arg = argv[i];
+			const char* value = (i + 1 < argCount && argv[i + 1][0] != '-') ? argv[i + 1] : nullptr;
+			if (!arg || arg[0] != '-' || arg[1] != '-' || !value) { continue; }
+
+			const char* name = arg + 2;
+			if (strcasecmp(name, "demoRecord") == 0)
+			{
+				return demo_record(value);
+			}
+			else if (strcasecmp(name, "demoPlay") == 0)
+			{
+				return demo_load(value);
+			}
+		}
+		return JFALSE;
+	}
+
+	JBool demo_record(const char* path)
+	{
+		demo_stop();
+		strncpy(s_demoPath, path, TFE_MAX_PATH - 1);
+		s_demoPath[TFE_MAX_PATH - 1] = 0;
+		s_demoState = DEMO_RECORD_PENDING;
+		return JTRUE;
+	}
+
+	JBool demo_load(const char* path)
+	{
+		demo_stop();
+
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_READ))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Cannot open demo '%s'.", path);
+			return JFALSE;
+		}
+		s_playbackData.resize(file.getSize());
+		file.readBuffer(s_playbackData.data(), u32(s_playbackData.size()));
+		file.close();
+
+		if (s_playbackData.size() < sizeof(DemoHeader))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Invalid demo '%s'.", path);
+			return JFALSE;
+		}
+		memcpy(&s_header, s_playbackData.data(), sizeof(DemoHeader));
+		s_header.levelName[DEMO_LEVEL_NAME_LEN - 1] = 0;
+		if (s_header.magic != DEMO_MAGIC || s_header.version != DEMO_VERSION)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Demo", "Invalid demo '%s' or the demo is from a different version.", path);
+			return JFALSE;
+		}
+
+		strncpy(s_demoPath, path, TFE_MAX_PATH - 1);
+		s_demoPath[TFE_MAX_PATH - 1] = 0;
+		s_demoState = DEMO_PLAYBACK_PENDING;
+		return JTRUE;
+	}
+
+	void demo_stop()
+	{
+		if (s_demoState == DEMO_RECORD)
+		{
+			s_stream.close();
+			FileStream file;
+			if (file.open(s_demoPath, FileStream::MODE_WRITE))
+			{
+				file.writeBuffer(s_stream.data(), u32(s_stream.getSize()));
+				file.close();
+				TFE_System::logWrite(LOG_MSG, "Demo", "Recorded %u frames (%u bytes) to '%s'.", s_frameCount, u32(s_stream.getSize()), s_demoPath);
+			}
+			else
+			{
+				TFE_System::logWrite(LOG_ERROR, "Demo", "Cannot write demo '%s'.", s_demoPath);
+			}
+			s_stream.clear();
+		}
+		else if (s_demoState == DEMO_PLAYBACK)
+		{
+			s_stream.close();
+			inputMapping_endReplay();
+			resetTaskInterval();
+
+			TFE_Settings_Game* gameSettings = TFE_Settings::getGameSettings();
+			InputConfig* inputConfig = inputMapping_get();
+			s_agentData[s_agentId].difficulty = s_restore.difficulty;
+			gameSettings->df_airControl = s_restore.airControl;
+			gameSettings->df_fixBobaFettFireDir = s_restore.fixBobaFettFireDir;
+			inputConfig->mouseFlags = s_restore.mouseFlags;
+			inputConfig->mouseMode = s_restore.mouseMode;
+			inputConfig->mouseSensitivity[0] = s_restore.mouseSensitivity[0];
+			inputConfig->mouseSensitivity[1] = s_restore.mouseSensitivity[1];
+			TFE_System::logWrite(LOG_MSG, "Demo", "Played back %u frames from '%s'.", s_frameCount, s_demoPath);
+		}
+		else if (s_demoState == DEMO_CHECK_RECORD || s_demoState == DEMO_CHECK_REPLAY)
+		{
+			if (s_demoState == DEMO_CHECK_REPLAY)
+			{
+				inputMapping_endReplay();
+			}
+			resetTaskInterval();
+			s_checkStart.clear();
+			s_checkRecorded.clear();
+			s_checkFrames.clear();
+		}
+		s_demoState = DEMO_IDLE;
+	}
+
+	JBool demo_isRecording()
+	{
+		return s_demoState == DEMO_RECORD ? JTRUE : JFALSE;
+	}
+
+	JBool demo_isPlaying()
+	{
+		return s_demoState == DEMO_PLAYBACK ? JTRUE : JFALSE;
+	}
+
+	JBool demo_isPlaybackPending()
+	{
+		return s_demoState == DEMO_PLAYBACK_PENDING ? JTRUE : JFALSE;
+	}
+
+	const char* demo_getLevelName()
+	{
+		return s_header.levelName;
+	}
+
+	void demo_beginMission()
+	{
+		if (s_demoState == DEMO_RECORD_PENDING)
+		{
+			beginRecording();
+		}
+		else if (s_demoState == DEMO_PLAYBACK_PENDING)
+		{
+			beginPlayback();
+		}
+		else if (s_demoState != DEMO_IDLE)
+		{
+			// A new mission was started without the previous one ending.
+			demo_stop();
+		}
+	}
+
+	void demo_updateTime()
+	{
+		if (s_demoState >= DEMO_CHECK_PENDING)
+		{
+			checkUpdate();
+			return;
+		}
+		if (s_demoState == DEMO_PLAYBACK && playbackUpdate())
+		{
+			return;
+		}
+
+		updateTime();
+		if (s_demoState == DEMO_RECORD)
+		{
+			recordUpdate();
+		}
+	}
+
+	/////////////////////////////////////////////
+	// Console Commands
+	/////////////////////////////////////////////
+	void console_demoRecord(const ConsoleArgList& args)
+	{
+		char fileName[TFE_MAX_PATH];
+		char path[TFE_MAX_PATH];
+		snprintf(fileName, TFE_MAX_PATH, "%s.tfd", args[1].c_str());
+		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, fileName, path);
+		demo_record(path);
+
+		char res[TFE_MAX_PATH + 64];
+		snprintf(res, sizeof(res), "Recording to '%s' will start with the next mission.", path);
+		TFE_Console::addToHistory(res);
+	}
+
+	void console_demoStop(const ConsoleArgList& args)
+	{
+		if (s_demoState == DEMO_IDLE)
+		{
+			TFE_Console::addToHistory("No demo is being recorded or played back.");
+			return;
+		}
+		demo_stop();
+		TFE_Console::addToHistory("Demo stopped.");
+	}
+
+	void console_snapshotCheck(const ConsoleArgList& args)
+	{
+		if (s_missionMode != MISSION_MODE_MAIN)
+		{
+			TFE_Console::addToHistory("The snapshot check can only be run while playing a level.");
+			return;
+		}
+		if (s_demoState != DEMO_IDLE)
+		{
+			TFE_Console::addToHistory("The snapshot check cannot be run while a demo is being recorded or played back.");
+			return;
+		}
+		const s32 frames = args.size() >= 2 ? atoi(args[1].c_str()) : DEMO_CHECK_DEFAULT_FRAMES;
+		s_checkFrameCount = u32(clamp(frames, 1, 36000));
+		s_demoState = DEMO_CHECK_PENDING;
+		TFE_Console::addToHistory("The snapshot check will start when the console is closed.");
+	}
+}  // namespace TFE_DarkForces
@@ -0,0 +1,50 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Dark Forces Demos
+// TFE specific input recording and deterministic playback.
+//
+// A demo starts with a mission and stores the state the mission
+// depends on (level, difficulty, inventory, random seed, game clock
+// and gameplay settings) followed by one small record per task frame:
+// the game clock ticks added since the previous frame and the input
+// seen by the game. Playback feeds the recorded ticks and input back
+// into the game, so it reproduces the same simulation regardless of
+// the frame rate and runs as fast as frames can be produced.
+//
+// Recording and playback stop when the escape menu, PDA or console is
+// opened, since these are not part of the simulation.
+//
+// Command line:
+//   --demoRecord PATH   Record the next mission that is started.
+//   --demoPlay PATH     Launch the recorded level and play the demo.
+// Console:
+//   demoRecord NAME     Record the next mission to <Documents>/NAME.tfd.
+//   demoStop            Stop recording or playback.
+//   snapshotCheck [N]   Play N frames from a snapshot, restore it, replay
+//                       the same input and log any game state that
+//                       differs, which is state snapshots are missing.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_DarkForces
+{
+	void demo_init();
+	JBool demo_parseCommandLine(s32 argCount, const char* argv[]);
+
+	// Recording begins when the next mission is started.
+	JBool demo_record(const char* path);
+	// Load a demo, playback begins when its level is started.
+	JBool demo_load(const char* path);
+	void  demo_stop();
+
+	JBool demo_isRecording();
+	JBool demo_isPlaying();
+	// JTRUE if a demo has been loaded but its level has not been started yet.
+	JBool demo_isPlaybackPending();
+	const char* demo_getLevelName();
+
+	// Called when the mission is started, after the agent data for the level has been read.
+	void demo_beginMission();
+	// Called at the start of every game frame in place of updateTime().
+	void demo_updateTime();
+}  // namespace TFE_DarkForces
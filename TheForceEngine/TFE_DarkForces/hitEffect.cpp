@@ -9,6 +9,7 @@
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Task/task.h>
+#include <TFE_Game/gameSnapshot.h>
 
 using namespace TFE_Jedi;
 
@@ -39,6 +40,12 @@ namespace TFE_DarkForces
 	vec3_fixed s_explodePos;
 	EffectData* s_curEffectData = nullptr;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_hitEffects);
+	SNAPSHOT_STATE(s_hitEffectTask);
+	SNAPSHOT_STATE(s_explodePos);
+	SNAPSHOT_STATE(s_curEffectData);
+
 	void hitEffectWakeupFunc(SecObject* obj);
 	void hitEffectExplodeFunc(SecObject* obj);
 	void hitEffectTaskFunc(MessageType msg);
@@ -15,6 +15,7 @@
 #include <TFE_Jedi/Level/rfont.h>
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/Level/roffscreenBuffer.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -100,6 +101,17 @@ namespace TFE_DarkForces
 	s32 s_secretsPercent = 0;
 	JBool s_showData = JFALSE;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_hudMessage);
+	SNAPSHOT_STATE(s_hudCurrentMsgId);
+	SNAPSHOT_STATE(s_hudMsgPriority);
+	SNAPSHOT_STATE(s_hudMsgExpireTick);
+	SNAPSHOT_STATE(s_flashEffect);
+	SNAPSHOT_STATE(s_healthDamageFx);
+	SNAPSHOT_STATE(s_shieldDamageFx);
+	SNAPSHOT_STATE(s_secretsFound);
+	SNAPSHOT_STATE(s_secretsPercent);
+
 	///////////////////////////////////////////
 	// Forward Declarations
 	///////////////////////////////////////////
@@ -16,6 +16,8 @@
 #include <TFE_DarkForces/GameUI/pda.h>
 #include <TFE_DarkForces/logic.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_FileSystem/memorystream.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Jedi/Level/rtexture.h>
@@ -90,6 +92,21 @@ namespace TFE_DarkForces
 	static s32 s_visionFxCountdown = 0;
 	static s32 s_visionFxEndCountdown = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_exitLevel);
+	SNAPSHOT_STATE(s_levelEndTask);
+	SNAPSHOT_STATE(s_mainTask);
+	SNAPSHOT_STATE(s_missionLoadTask);
+	SNAPSHOT_STATE(s_visionFxCountdown);
+	SNAPSHOT_STATE(s_visionFxEndCountdown);
+	SNAPSHOT_STATE(s_canTeleport);
+	SNAPSHOT_STATE(s_flashFxLevel);
+	SNAPSHOT_STATE(s_healthFxLevel);
+	SNAPSHOT_STATE(s_shieldFxLevel);
+	SNAPSHOT_STATE(s_luminanceMask);
+	SNAPSHOT_STATE(s_colormap);
+	SNAPSHOT_STATE(s_lightSourceRamp);
+
 	/////////////////////////////////////////////
 	// Forward Declarations
 	/////////////////////////////////////////////
@@ -144,6 +161,88 @@ namespace TFE_DarkForces
 		logic_spawnEnemy(args[1].c_str(), args[2].c_str());
 	}
 
+	// Quick snapshot slot, only valid while the game that created it is running.
+	static MemoryStream s_quickSnapshot;
+
+	void console_snapshotSave(const ConsoleArgList& args)
+	{
+		if (s_missionMode != MISSION_MODE_MAIN)
+		{
+			TFE_Console::addToHistory("Snapshots can only be taken while playing a level.");
+			return;
+		}
+		if (TFE_Snapshot::capture(&s_quickSnapshot))
+		{
+			char res[256];
+			sprintf(res, "Snapshot saved, size: %u bytes.", u32(s_quickSnapshot.getSize()));
+			TFE_Console::addToHistory(res);
+		}
+	}
+
+	void console_snapshotLoad(const ConsoleArgList& args)
+	{
+		if (s_missionMode != MISSION_MODE_MAIN)
+		{
+			TFE_Console::addToHistory("Snapshots can only be restored while playing a level.");
+			return;
+		}
+		if (!s_quickSnapshot.getSize())
+		{
+			TFE_Console::addToHistory("No snapshot has been saved.");
+			return;
+		}
+		if (!TFE_Snapshot::restore(&s_quickSnapshot))
+		{
+			TFE_Console::addToHistory("Failed to restore the snapshot, see the log for details.");
+			return;
+		}
+		// The palette and HUD are derived from the restored state.
+		s_palModified = JTRUE;
+		s_updateHudColors = JTRUE;
+		TFE_Console::addToHistory("Snapshot restored.");
+	}
+
+	// Capture and restore the current level state repeatedly and report the snapshot size and average timings.
+	void console_snapshotBench(const ConsoleArgList& args)
+	{
+		if (s_missionMode != MISSION_MODE_MAIN)
+		{
+			TFE_Console::addToHistory("The snapshot benchmark can only be run while playing a level.");
+			return;
+		}
+		s32 iterations = args.size() >= 2 ? atoi(args[1].c_str()) : 16;
+		iterations = clamp(iterations, 1, 1024);
+
+		MemoryStream snapshot;
+		u64 captureTicks = 0, restoreTicks = 0;
+		for (s32 i = 0; i < iterations; i++)
+		{
+			u64 start = TFE_System::getCurrentTimeInTicks();
+			if (!TFE_Snapshot::capture(&snapshot))
+			{
+				TFE_Console::addToHistory("Snapshot capture failed.");
+				return;
+			}
+			captureTicks += TFE_System::getCurrentTimeInTicks() - start;
+
+			start = TFE_System::getCurrentTimeInTicks();
+			if (!TFE_Snapshot::restore(&snapshot))
+			{
+				TFE_Console::addToHistory("Snapshot restore failed, see the log for details.");
+				return;
+			}
+			restoreTicks += TFE_System::getCurrentTimeInTicks() - start;
+		}
+
+		const f64 captureMs = TFE_System::convertFromTicksToSeconds(captureTicks) * 1000.0 / f64(iterations);
+		const f64 restoreMs = TFE_System::convertFromTicksToSeconds(restoreTicks) * 1000.0 / f64(iterations);
+		char res[256];
+		sprintf(res, "Level %s: snapshot size %u bytes, %u states, capture %0.3fms, restore %0.3fms (%d iterations).",
+			agent_getLevelName(), u32(snapshot.getSize()), TFE_Snapshot::getRegisteredStateCount(), captureMs, restoreMs, iterations);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Snapshot", "%s", res);
+	}
+
 	void mission_createDisplay()
 	{
 		vfb_setResolution(320, 200);
@@ -191,6 +290,9 @@ namespace TFE_DarkForces
 			// TFE-specific
 			CCMD("cheat", console_cheat, 1, "Enter a Dark Forces cheat code as a string, example: cheat lacds");
 			CCMD("spawnEnemy", console_spawnEnemy, 2, "spawnEnemy(waxName, enemyTypeName) - spawns an enemy 8 units away in the player direction. Example: spawnEnemy offcfin.wax i_officer");
+			CCMD("snapshotSave", console_snapshotSave, 0, "Save the current game state to the in-memory snapshot slot.");
+			CCMD("snapshotLoad", console_snapshotLoad, 0, "Restore the game state saved by snapshotSave.");
+			CCMD("snapshotBench", console_snapshotBench, 0, "snapshotBench [iterations] - capture and restore the game state repeatedly and report the snapshot size and timings.");
 
 			// Make sure the loading screen is displayed for at least 1 second.
 			displayLoadingScreen();
@@ -3,6 +3,7 @@
 #include "hud.h"
 #include "weapon.h"
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Sound/soundSystem.h>
@@ -32,6 +33,16 @@ namespace TFE_DarkForces
 	static Pickup* s_listToFree[MAX_PICKUP_FREE_ITEMS];
 	static s32 s_listToFreeCnt = 0;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_playerDying);
+	SNAPSHOT_STATE(s_pickupTask);
+	SNAPSHOT_STATE(s_superchargeTask);
+	SNAPSHOT_STATE(s_invincibilityTask);
+	SNAPSHOT_STATE(s_gasmaskTask);
+	SNAPSHOT_STATE(s_gasSectorTask);
+	SNAPSHOT_STATE(s_listToFree);
+	SNAPSHOT_STATE(s_listToFreeCnt);
+
 	//////////////////////////////////////////////////////////////
 	// Forward Declarations
 	//////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 #include <TFE_Settings/settings.h>
 #include <TFE_Input/inputMapping.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_DarkForces/mission.h>
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
@@ -229,6 +230,97 @@ namespace TFE_DarkForces
 	s32 s_jumpScale = 0;
 	s32 s_playerSlow = 0;
 	s32 s_onMovingSurface = 0;
+
+	// Game state captured by snapshots, sound sources are owned by the sound system and are not included.
+	SNAPSHOT_STATE(s_externalYawSpd);
+	SNAPSHOT_STATE(s_playerPitch);
+	SNAPSHOT_STATE(s_playerRoll);
+	SNAPSHOT_STATE(s_forwardSpd);
+	SNAPSHOT_STATE(s_strafeSpd);
+	SNAPSHOT_STATE(s_maxMoveDist);
+	SNAPSHOT_STATE(s_playerStopAccel);
+	SNAPSHOT_STATE(s_minEyeDistFromFloor);
+	SNAPSHOT_STATE(s_postLandVel);
+	SNAPSHOT_STATE(s_landUpVel);
+	SNAPSHOT_STATE(s_playerVelX);
+	SNAPSHOT_STATE(s_playerUpVel);
+	SNAPSHOT_STATE(s_playerUpVel2);
+	SNAPSHOT_STATE(s_playerVelZ);
+	SNAPSHOT_STATE(s_externalVelX);
+	SNAPSHOT_STATE(s_externalVelZ);
+	SNAPSHOT_STATE(s_playerCrouchSpd);
+	SNAPSHOT_STATE(s_playerSpeed);
+	SNAPSHOT_STATE(s_prevDistFromFloor);
+	SNAPSHOT_STATE(s_wpnSin);
+	SNAPSHOT_STATE(s_wpnCos);
+	SNAPSHOT_STATE(s_moveDirX);
+	SNAPSHOT_STATE(s_moveDirZ);
+	SNAPSHOT_STATE(s_dist);
+	SNAPSHOT_STATE(s_distScale);
+	SNAPSHOT_STATE(s_levelAtten);
+	SNAPSHOT_STATE(s_curSafe);
+	SNAPSHOT_STATE(s_playerUse);
+	SNAPSHOT_STATE(s_playerActionUse);
+	SNAPSHOT_STATE(s_playerPrimaryFire);
+	SNAPSHOT_STATE(s_playerSecFire);
+	SNAPSHOT_STATE(s_playerJumping);
+	SNAPSHOT_STATE(s_playerInWater);
+	SNAPSHOT_STATE(s_limitStepHeight);
+	SNAPSHOT_STATE(s_smallModeEnabled);
+	SNAPSHOT_STATE(s_playerPos);
+	SNAPSHOT_STATE(s_playerObjHeight);
+	SNAPSHOT_STATE(s_playerObjPitch);
+	SNAPSHOT_STATE(s_playerObjYaw);
+	SNAPSHOT_STATE(s_playerObjSector);
+	SNAPSHOT_STATE(s_playerSlideWall);
+	SNAPSHOT_STATE(s_playerInfo);
+	SNAPSHOT_STATE(s_playerLogic);
+	SNAPSHOT_STATE(s_energy);
+	SNAPSHOT_STATE(s_lifeCount);
+	SNAPSHOT_STATE(s_playerLight);
+	SNAPSHOT_STATE(s_headwaveVerticalOffset);
+	SNAPSHOT_STATE(s_moveAvail);
+	SNAPSHOT_STATE(s_weaponLight);
+	SNAPSHOT_STATE(s_baseAtten);
+	SNAPSHOT_STATE(s_gravityAccel);
+	SNAPSHOT_STATE(s_invincibility);
+	SNAPSHOT_STATE(s_weaponFiring);
+	SNAPSHOT_STATE(s_weaponFiringSec);
+	SNAPSHOT_STATE(s_wearingCleats);
+	SNAPSHOT_STATE(s_wearingGasmask);
+	SNAPSHOT_STATE(s_nightvisionActive);
+	SNAPSHOT_STATE(s_headlampActive);
+	SNAPSHOT_STATE(s_superCharge);
+	SNAPSHOT_STATE(s_superChargeHud);
+	SNAPSHOT_STATE(s_playerSecMoved);
+	SNAPSHOT_STATE(s_playerInvSaved);
+	SNAPSHOT_STATE(s_playerSector);
+	SNAPSHOT_STATE(s_playerObject);
+	SNAPSHOT_STATE(s_playerEye);
+	SNAPSHOT_STATE(s_eyePos);
+	SNAPSHOT_STATE(s_pitch);
+	SNAPSHOT_STATE(s_yaw);
+	SNAPSHOT_STATE(s_roll);
+	SNAPSHOT_STATE(s_playerEyeFlags);
+	SNAPSHOT_STATE(s_playerTick);
+	SNAPSHOT_STATE(s_prevPlayerTick);
+	SNAPSHOT_STATE(s_nextShieldDmgTick);
+	SNAPSHOT_STATE(s_reviveTick);
+	SNAPSHOT_STATE(s_nextPainSndTick);
+	SNAPSHOT_STATE(s_playerTask);
+	SNAPSHOT_STATE(s_playerYPos);
+	SNAPSHOT_STATE(s_camOffset);
+	SNAPSHOT_STATE(s_camOffsetPitch);
+	SNAPSHOT_STATE(s_camOffsetYaw);
+	SNAPSHOT_STATE(s_camOffsetRoll);
+	SNAPSHOT_STATE(s_playerYaw);
+	SNAPSHOT_STATE(s_itemUnknown1);
+	SNAPSHOT_STATE(s_itemUnknown2);
+	SNAPSHOT_STATE(s_playerHeight);
+	SNAPSHOT_STATE(s_playerRun);
+	SNAPSHOT_STATE(s_jumpScale);
+	SNAPSHOT_STATE(s_playerSlow);
+	SNAPSHOT_STATE(s_onMovingSurface);
 			   
 	///////////////////////////////////////////
 	// Forward Declarations
@@ -993,6 +1085,28 @@ namespace TFE_DarkForces
 		}
 	}
 
+	void player_warp(RSector* sector, fixed16_16 x, fixed16_16 z, angle14_32 yaw)
+	{
+		if (!s_playerObject || !sector) { return; }
+
+		s_playerVelX = 0;
+		s_playerUpVel = 0;
+		s_playerUpVel2 = 0;
+		s_playerVelZ = 0;
+		s_externalVelX = 0;
+		s_externalVelZ = 0;
+		s_forwardSpd = 0;
+		s_strafeSpd = 0;
+
+		s_playerObject->yaw = yaw & ANGLE_MASK;
+		s_playerYaw = s_playerObject->yaw;
+		s_playerObject->posWS.x = x;
+		s_playerObject->posWS.z = z;
+		s_playerObject->posWS.y = sector->floorHeight + sector->secHeight;
+		s_playerYPos = s_playerObject->posWS.y;
+		player_changeSector(sector);
+	}
+
 	void player_clearSuperCharge()
 	{
 		if (s_superchargeTask)
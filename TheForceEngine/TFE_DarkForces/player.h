@@ -138,6 +138,8 @@ namespace TFE_DarkForces
 	fixed16_16 player_getSquaredDistance(SecObject* obj);
 	void player_setupCamera();
 	void player_applyDamage(fixed16_16 healthDmg, fixed16_16 shieldDmg, JBool playHitSound);
+	// TFE: Move the player to the floor of the sector at (x, z), facing yaw, and stop all movement.
+	void player_warp(RSector* sector, fixed16_16 x, fixed16_16 z, angle14_32 yaw);
 
 	JBool player_hasWeapon(s32 weaponIndex);
 	JBool player_hasItem(s32 itemIndex);
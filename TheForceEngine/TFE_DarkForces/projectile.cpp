@@ -2,6 +2,7 @@
 #include "animLogic.h"
 #include "random.h"
 #include "player.h"
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Asset/modelAsset_jedi.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
 #include <TFE_Jedi/Collision/collision.h>
@@ -85,6 +86,12 @@ namespace TFE_DarkForces
 	u32 s_hitWallFlag;
 	angle14_32 s_projReflectOverrideYaw = 0;
 
+	// Game state captured by snapshots, projectiles are in the level region.
+	SNAPSHOT_STATE(s_projectiles);
+	SNAPSHOT_STATE(s_projectileTask);
+	SNAPSHOT_STATE(s_hitWallFlag);
+	SNAPSHOT_STATE(s_projReflectOverrideYaw);
+
 	//////////////////////////////////////////////////////////////
 	// Forward Declarations
 	//////////////////////////////////////////////////////////////
@@ -1,10 +1,12 @@
 #include "random.h"
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
 	// TODO(Core Game Loop Release): Figure out what this value is at program start up. The value here is from when the program was already running.
 	// This should cause the random numbers to match up between TFE and DOS.
 	static u32 s_seed = 0xf444bb3b;
+	SNAPSHOT_STATE(s_seed);
 
 	s32 random_next()
 	{
@@ -41,4 +43,9 @@ namespace TFE_DarkForces
 	{
 		s_seed = seed;
 	}
+
+	u32 random_getSeed()
+	{
+		return s_seed;
+	}
 }  // TFE_DarkForces
\ No newline at end of file
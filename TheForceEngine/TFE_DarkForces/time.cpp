@@ -1,5 +1,6 @@
 #include "time.h"
 #include <TFE_System/system.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -11,6 +12,14 @@ namespace TFE_DarkForces
 
 	JBool s_pauseTimeUpdate = JFALSE;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_curTick);
+	SNAPSHOT_STATE(s_prevTick);
+	SNAPSHOT_STATE(s_timeAccum);
+	SNAPSHOT_STATE(s_deltaTime);
+	SNAPSHOT_STATE(s_frameTicks);
+	SNAPSHOT_STATE(s_pauseTimeUpdate);
+
 	Tick time_frameRateToDelay(u32 frameRate)
 	{
 		return Tick(SECONDS_TO_TICKS_ROUNDED / f32(frameRate));
@@ -31,20 +40,35 @@ namespace TFE_DarkForces
 		s_pauseTimeUpdate = pause;
 	}
 
+	static void advanceTicks(Tick delta)
+	{
+		s_curTick += delta;
+
+		fixed16_16 dt = div16(intToFixed16(delta), FIXED(TICKS_PER_SECOND));
+		for (s32 i = 0; i < 13; i++)
+		{
+			s_frameTicks[i] += mul16(dt, intToFixed16(i));
+		}
+	}
+
 	void updateTime()
 	{
 		if (!s_pauseTimeUpdate)
 		{
 			s_timeAccum += TFE_System::getDeltaTime() * TIMER_FREQ;
 		}
+		advanceTicks(Tick(s_timeAccum) - s_curTick);
+	}
 
-		Tick prevTick = s_curTick;
-		s_curTick = Tick(s_timeAccum);
+	void time_setTick(Tick tick)
+	{
+		s_curTick = tick;
+		s_timeAccum = f64(tick);
+	}
 
-		fixed16_16 dt = div16(intToFixed16(s_curTick - prevTick), FIXED(TICKS_PER_SECOND));
-		for (s32 i = 0; i < 13; i++)
-		{
-			s_frameTicks[i] += mul16(dt, intToFixed16(i));
-		}
+	void time_advance(Tick delta)
+	{
+		s_timeAccum += f64(delta);
+		advanceTicks(delta);
 	}
 }  // TFE_DarkForces
\ No newline at end of file
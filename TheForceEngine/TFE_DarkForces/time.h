@@ -52,4 +52,8 @@ namespace TFE_DarkForces
 	Tick time_frameRateToDelay(f32 frameRate);
 	void updateTime();
 	void time_pause(JBool pause);
+
+	// TFE: Set the game time and advance it by whole ticks, used by demo playback to replay the recorded time.
+	void time_setTick(Tick tick);
+	void time_advance(Tick delta);
 }  // namespace TFE_DarkForces
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Game/gameSnapshot.h>
 
 using namespace TFE_Jedi;
 
@@ -37,6 +38,10 @@ namespace TFE_DarkForces
 	static Task* s_logicUpdateTask = nullptr;
 	static Allocator* s_logicUpdateList = nullptr;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_logicUpdateTask);
+	SNAPSHOT_STATE(s_logicUpdateList);
+
 	void updateLogicTaskFunc(MessageType msg);
 	void updateLogicCleanupFunc(Logic* logic);
 	
@@ -3,6 +3,7 @@
 #include "pickup.h"
 #include "weaponFireFunc.h"
 #include <TFE_System/system.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/Renderer/RClassic_Fixed/rlightingFixed.h>
@@ -73,6 +74,29 @@ namespace TFE_DarkForces
 	SoundSourceID s_superchargeCountdownSound;
 	Task* s_playerWeaponTask = nullptr;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_switchWeapons);
+	SNAPSHOT_STATE(s_queWeaponSwitch);
+	SNAPSHOT_STATE(s_playerWeaponList);
+	SNAPSHOT_STATE(s_weaponDelayPrimary);
+	SNAPSHOT_STATE(s_weaponDelaySeconary);
+	SNAPSHOT_STATE(s_canFirePrimPtr);
+	SNAPSHOT_STATE(s_canFireSecPtr);
+	SNAPSHOT_STATE(s_weaponAnimState);
+	SNAPSHOT_STATE(s_prevWeapon);
+	SNAPSHOT_STATE(s_curWeapon);
+	SNAPSHOT_STATE(s_nextWeapon);
+	SNAPSHOT_STATE(s_lastWeapon);
+	SNAPSHOT_STATE(s_weaponAutoMount2);
+	SNAPSHOT_STATE(s_secondaryFire);
+	SNAPSHOT_STATE(s_weaponOffAnim);
+	SNAPSHOT_STATE(s_isShooting);
+	SNAPSHOT_STATE(s_canFireWeaponSec);
+	SNAPSHOT_STATE(s_canFireWeaponPrim);
+	SNAPSHOT_STATE(s_fireFrame);
+	SNAPSHOT_STATE(s_curPlayerWeapon);
+	SNAPSHOT_STATE(s_playerWeaponTask);
+
 	///////////////////////////////////////////
 	// Forward Declarations
 	///////////////////////////////////////////
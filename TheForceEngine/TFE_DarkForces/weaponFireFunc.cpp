@@ -7,6 +7,7 @@
 #include "hitEffect.h"
 #include <TFE_Jedi/Collision/collision.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
+#include <TFE_Game/gameSnapshot.h>
 
 namespace TFE_DarkForces
 {
@@ -132,6 +133,10 @@ namespace TFE_DarkForces
 	};
 	static JBool s_fusionCycleForward = JTRUE;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_fusionCylinder);
+	SNAPSHOT_STATE(s_fusionCycleForward);
+
 	extern void weapon_handleState(MessageType msg);
 	extern void weapon_handleState2(MessageType msg);
 	extern void weapon_handleOffAnimation(MessageType msg);
@@ -1,5 +1,6 @@
 #pragma once
 #include "filestream.h"
+#include "paths.h"
 #include <TFE_Archive/archive.h>
 #include <assert.h>
 #include <stdio.h>
@@ -35,6 +36,11 @@ bool FileStream::open(const char* filename, FileMode mode)
 	m_file = fopen(filename, modeStrings[mode]);
 	m_mode = mode;
 
+	// A new file may now shadow an archive entry or a previously missing file.
+	if (m_file && mode == MODE_WRITE)
+	{
+		TFE_Paths::invalidateFileCache();
+	}
 	return m_file != nullptr;
 }
 
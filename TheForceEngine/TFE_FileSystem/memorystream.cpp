@@ -0,0 +1,187 @@
+#include <cstring>
+#include "memorystream.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <algorithm>
+
+enum
+{
+	MEMSTREAM_MIN_CAPACITY = 64 * 1024,
+};
+
+MemoryStream::MemoryStream() : Stream()
+{
+	m_memory = nullptr;
+	m_size = 0;
+	m_capacity = 0;
+	m_addr = 0;
+	m_ownsMemory = true;
+	m_mode = MODE_INVALID;
+}
+
+MemoryStream::~MemoryStream()
+{
+	clear();
+}
+
+bool MemoryStream::open(MemMode mode)
+{
+	// External memory is read-only, writing switches back to the internal buffer.
+	if (!m_ownsMemory && mode != MODE_READ)
+	{
+		m_memory = nullptr;
+		m_size = 0;
+		m_capacity = 0;
+		m_ownsMemory = true;
+	}
+	if (mode == MODE_WRITE)
+	{
+		m_size = 0;
+	}
+	m_addr = 0;
+	m_mode = mode;
+	return true;
+}
+
+bool MemoryStream::load(const void* data, size_t size)
+{
+	if (!data) { return false; }
+	clear();
+
+	m_memory = (u8*)data;
+	m_size = size;
+	m_capacity = size;
+	m_addr = 0;
+	m_ownsMemory = false;
+	m_mode = MODE_READ;
+	return true;
+}
+
+void MemoryStream::close()
+{
+	m_addr = 0;
+	m_mode = MODE_INVALID;
+}
+
+void MemoryStream::clear()
+{
+	if (m_ownsMemory)
+	{
+		free(m_memory);
+	}
+	m_memory = nullptr;
+	m_size = 0;
+	m_capacity = 0;
+	m_addr = 0;
+	m_ownsMemory = true;
+	m_mode = MODE_INVALID;
+}
+
+//derived from Stream
+bool MemoryStream::seek(u32 offset, Origin origin/*=ORIGIN_START*/)
+{
+	size_t addr = m_addr;
+	switch (origin)
+	{
+		case ORIGIN_START:
+			addr = offset;
+			break;
+		case ORIGIN_END:
+			addr = m_size - std::min(size_t(offset), m_size);
+			break;
+		case ORIGIN_CURRENT:
+			addr = m_addr + offset;
+			break;
+	}
+	if (addr > m_size) { return false; }
+
+	m_addr = addr;
+	return true;
+}
+
+size_t MemoryStream::getLoc()
+{
+	return m_addr;
+}
+
+size_t MemoryStream::getSize()
+{
+	return m_size;
+}
+
+u32 MemoryStream::readBuffer(void* ptr, u32 size, u32 count)
+{
+	assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
+	const size_t readSize = std::min(size_t(size) * size_t(count), m_size - m_addr);
+	memcpy(ptr, m_memory + m_addr, readSize);
+	m_addr += readSize;
+	return u32(readSize);
+}
+
+void MemoryStream::read(std::string* ptr, u32 count)
+{
+	assert(m_mode == MODE_READ || m_mode == MODE_READWRITE);
+	for (u32 s = 0; s < count; s++)
+	{
+		u32 len = 0;
+		readBuffer(&len, sizeof(u32));
+		len = u32(std::min(size_t(len), m_size - m_addr));
+
+		ptr[s].assign((const char*)m_memory + m_addr, len);
+		m_addr += len;
+	}
+}
+
+u8* MemoryStream::writeReserve(size_t size)
+{
+	assert(m_mode == MODE_WRITE || m_mode == MODE_READWRITE);
+	assert(m_ownsMemory);
+	if (m_addr + size > m_capacity)
+	{
+		resizeBuffer(m_addr + size);
+	}
+
+	u8* ptr = m_memory + m_addr;
+	m_addr += size;
+	m_size = std::max(m_size, m_addr);
+	return ptr;
+}
+
+void MemoryStream::writeBuffer(const void* ptr, u32 size, u32 count)
+{
+	memcpy(writeReserve(size_t(size) * size_t(count)), ptr, size_t(size) * size_t(count));
+}
+
+void MemoryStream::write(const std::string* ptr, u32 count)
+{
+	for (u32 s = 0; s < count; s++)
+	{
+		const u32 len = (u32)ptr[s].length();
+		writeBuffer(&len, sizeof(u32));
+		writeBuffer(ptr[s].data(), len);
+	}
+}
+
+void MemoryStream::writeString(const char* fmt, ...)
+{
+	static char tmpStr[4096];
+
+	va_list arg;
+	va_start(arg, fmt);
+	vsnprintf(tmpStr, 4096, fmt, arg);
+	va_end(arg);
+
+	writeBuffer(tmpStr, (u32)strlen(tmpStr));
+}
+
+// Grow geometrically so that streams written in many small pieces are not constantly reallocated.
+void MemoryStream::resizeBuffer(size_t newSize)
+{
+	size_t capacity = std::max(m_capacity, size_t(MEMSTREAM_MIN_CAPACITY));
+	while (capacity < newSize) { capacity += capacity >> 1; }
+
+	m_memory = (u8*)realloc(m_memory, capacity);
+	m_capacity = capacity;
+}
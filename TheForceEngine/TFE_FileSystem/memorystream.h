@@ -0,0 +1,88 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Stream that reads from and writes to memory.
+// When writing the stream owns a growable buffer which is kept
+// between uses, so repeated snapshots do not reallocate.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_FileSystem/stream.h>
+
+class MemoryStream : public Stream
+{
+public:
+	enum MemMode
+	{
+		MODE_READ = 0,		// read-only
+		MODE_WRITE,			// write, the existing contents are discarded.
+		MODE_READWRITE,		// read-write, the existing contents are kept.
+		MODE_COUNT,
+		MODE_INVALID = MODE_COUNT
+	};
+public:
+	MemoryStream();
+	~MemoryStream();
+
+	// Open the stream for reading or writing from the start of the buffer.
+	bool open(MemMode mode);
+	// Open an external buffer for reading, the memory must remain valid until the stream is closed.
+	bool load(const void* data, size_t size);
+	void close();
+	// Free the internal buffer.
+	void clear();
+
+	const u8* data() const { return m_memory; }
+	bool isOpen() const { return m_mode != MODE_INVALID; }
+
+	// Reserve space for 'size' bytes at the current location and advance past it,
+	// the caller fills in the returned memory directly.
+	u8* writeReserve(size_t size);
+
+	//derived functions.
+	bool seek(u32 offset, Origin origin=ORIGIN_START) override;
+	size_t getLoc() override;
+	size_t getSize() override;
+
+	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u8*  ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u16* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(s64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(u64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f32* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(f64* ptr, u32 count=1) override { readType(ptr, count); }
+	void read(std::string* ptr, u32 count=1) override;
+	u32  readBuffer(void* ptr, u32 size, u32 count=1) override;
+
+	void write(const s8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u8*  ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u16* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u32* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const s64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const u64* ptr, u32 count=1)  override { writeType(ptr, count); }
+	void write(const f32* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const f64* ptr, u32 count=1) override { writeType(ptr, count); }
+	void write(const std::string* ptr, u32 count=1) override;
+	void writeBuffer(const void* ptr, u32 size, u32 count=1) override;
+
+	void writeString(const char* fmt, ...) override;
+
+private:
+	template <typename T>
+	void readType(T* ptr, u32 count) { readBuffer(ptr, sizeof(T), count); }
+
+	template <typename T>
+	void writeType(const T* ptr, u32 count) { writeBuffer(ptr, sizeof(T), count); }
+
+	void resizeBuffer(size_t newSize);
+
+private:
+	u8*     m_memory;
+	size_t  m_size;
+	size_t  m_capacity;
+	size_t  m_addr;
+	bool    m_ownsMemory;
+	MemMode m_mode;
+};
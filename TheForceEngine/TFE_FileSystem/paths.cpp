@@ -27,10 +27,31 @@ namespace TFE_Paths
 		std::string realPath;
 	};
 
+	// Cached getFilePath() result, including files that were not found.
+	struct FileCacheEntry
+	{
+		u32 hash;
+		bool found;
+		Archive* archive;
+		u32 index;
+		std::string fileName;
+		std::string path;
+	};
+	enum
+	{
+		FILE_CACHE_MIN_SIZE = 256,
+		FILE_CACHE_MAX_COUNT = 16384,	// Flush instead of growing forever.
+	};
+
 	static std::string s_paths[PATH_COUNT];
 	static std::vector<Archive*> s_localArchives;
 	static std::vector<std::string> s_searchPaths;
 	static std::vector<FileMapping> s_fileMappings;
+	// Open addressing hash table, the size is a power of 2 and empty slots have an empty fileName.
+	static std::vector<FileCacheEntry> s_fileCache;
+	static u32 s_fileCacheCount = 0;
+
+	bool getFilePathUncached(const char* fileName, FilePath* outPath);
 
 	void setPath(TFE_PathType pathType, const char* path)
 	{
@@ -162,6 +183,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.push_back(fullPath);
+			invalidateFileCache();
 		}
 	}
 
@@ -181,6 +203,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.insert(s_searchPaths.begin(), fullPath);
+			invalidateFileCache();
 		}
 	}
 
@@ -188,6 +211,7 @@ namespace TFE_Paths
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		invalidateFileCache();
 	}
 
 	void clearLocalArchives()
@@ -199,6 +223,7 @@ namespace TFE_Paths
 			Archive::freeArchive(archive[i]);
 		}
 		s_localArchives.clear();
+		invalidateFileCache();
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -214,6 +239,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		invalidateFileCache();
 	}
 
 	void addLocalSearchPath(const char* localSearchPath)
@@ -246,14 +272,101 @@ namespace TFE_Paths
 	void addLocalArchive(Archive* archive)
 	{
 		s_localArchives.push_back(archive);
+		invalidateFileCache();
 	}
 
 	void removeLastArchive()
 	{
 		s_localArchives.pop_back();
+		invalidateFileCache();
+	}
+
+	void invalidateFileCache()
+	{
+		if (!s_fileCacheCount) { return; }
+		s_fileCache.clear();
+		s_fileCacheCount = 0;
 	}
 
+	void resizeFileCache(size_t size)
+	{
+		std::vector<FileCacheEntry> prev;
+		prev.swap(s_fileCache);
+		s_fileCache.resize(size);
+
+		const u32 mask = u32(size) - 1;
+		const size_t prevSize = prev.size();
+		FileCacheEntry* entry = prev.data();
+		for (size_t i = 0; i < prevSize; i++, entry++)
+		{
+			if (entry->fileName.empty()) { continue; }
+
+			u32 slot = entry->hash & mask;
+			while (!s_fileCache[slot].fileName.empty())
+			{
+				slot = (slot + 1) & mask;
+			}
+			s_fileCache[slot] = std::move(*entry);
+		}
+	}
+
+	// Search paths and archives are checked in priority order, so the result for a given name only changes when
+	// the search setup changes - which invalidates the cache. This avoids a file system query per search path
+	// and an archive lookup per archive on every call.
 	bool getFilePath(const char* fileName, FilePath* outPath)
+	{
+		if (!fileName || !fileName[0])
+		{
+			return getFilePathUncached(fileName, outPath);
+		}
+
+		const u32 hash = Archive::hashFileName(fileName);
+		if (!s_fileCache.empty())
+		{
+			const u32 mask = u32(s_fileCache.size()) - 1;
+			for (u32 slot = hash & mask; !s_fileCache[slot].fileName.empty(); slot = (slot + 1) & mask)
+			{
+				const FileCacheEntry* entry = &s_fileCache[slot];
+				if (entry->hash == hash && strcasecmp(entry->fileName.c_str(), fileName) == 0)
+				{
+					outPath->archive = entry->archive;
+					outPath->index = entry->index;
+					strncpy(outPath->path, entry->path.c_str(), TFE_MAX_PATH);
+					return entry->found;
+				}
+			}
+		}
+
+		const bool found = getFilePathUncached(fileName, outPath);
+
+		// Add the result, keeping the load factor at or below 50%.
+		if (s_fileCacheCount >= FILE_CACHE_MAX_COUNT)
+		{
+			invalidateFileCache();
+		}
+		if (s_fileCache.empty() || (s_fileCacheCount + 1) * 2 > s_fileCache.size())
+		{
+			resizeFileCache(s_fileCache.empty() ? size_t(FILE_CACHE_MIN_SIZE) : s_fileCache.size() * 2);
+		}
+		const u32 mask = u32(s_fileCache.size()) - 1;
+		u32 slot = hash & mask;
+		while (!s_fileCache[slot].fileName.empty())
+		{
+			slot = (slot + 1) & mask;
+		}
+		FileCacheEntry* entry = &s_fileCache[slot];
+		entry->hash = hash;
+		entry->found = found;
+		entry->archive = outPath->archive;
+		entry->index = outPath->index;
+		entry->fileName = fileName;
+		entry->path = outPath->path;
+		s_fileCacheCount++;
+
+		return found;
+	}
+
+	bool getFilePathUncached(const char* fileName, FilePath* outPath)
 	{
 		outPath->archive = nullptr;
 		outPath->index = INVALID_FILE;
@@ -49,6 +49,8 @@ namespace TFE_Paths
 	void addLocalArchive(Archive* archive);
 	void removeLastArchive();
 	bool getFilePath(const char* fileName, FilePath* path);
+	// Clear the cached getFilePath() results, this is done automatically when search paths, archives or mappings change.
+	void invalidateFileCache();
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
 	void addSingleFilePath(const char* fileName, const char* filePath);
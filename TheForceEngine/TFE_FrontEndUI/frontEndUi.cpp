@@ -1390,6 +1390,8 @@ namespace TFE_FrontEndUI
 			ImGui::Checkbox("Async Framebuffer", &graphics->asyncFramebuffer);
 			ImGui::Checkbox("GPU Color Conversion", &graphics->gpuColorConvert);
 			ImGui::Checkbox("Perspective Correct 3DO Texturing", &graphics->perspectiveCorrectTexturing);
+			ImGui::SetNextItemWidth(196*s_uiScale);
+			ImGui::SliderInt("Render Threads", &graphics->renderThreadCount, 1, 16);
 		}
 		else if (s_rendererIndex == 1)
 		{
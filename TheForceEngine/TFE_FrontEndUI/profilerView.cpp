@@ -9,16 +9,23 @@
 #include <TFE_Ui/ui.h>
 #include <TFE_Ui/markdown.h>
 #include <TFE_System/parser.h>
+#include <TFE_FrontEndUI/console.h>
 
 #include <TFE_Ui/imGUI/imgui.h>
 #include <algorithm>
+#include <vector>
 
 namespace TFE_ProfilerView
 {
 	static bool s_open = false;
 
+	void console_trace(const ConsoleArgList& args);
+	void console_traceSave(const ConsoleArgList& args);
+
 	bool init()
 	{
+		CCMD("profTrace", console_trace, 0, "profTrace [0|1] - enable or disable recording profiler zones from all threads for trace captures.");
+		CCMD("profTraceSave", console_traceSave, 0, "profTraceSave [seconds] [name] - write the last few seconds (default 5) of profiler zones to <Documents>/name.json (default trace), view with chrome://tracing or Perfetto.");
 		return true;
 	}
 
@@ -81,6 +88,33 @@ namespace TFE_ProfilerView
 		ImGui::Unindent();
 		ImGui::Unindent();
 
+		// Timers, sorted by average time so the most expensive are listed first.
+		const u32 timerCount = TFE_Profiler::getTimerCount();
+		if (timerCount)
+		{
+			ImGui::Spacing();
+			ImGui::LabelText("##Label", "Timers");
+			ImGui::Separator();
+
+			std::vector<TFE_TimerInfo> timers(timerCount);
+			for (u32 t = 0; t < timerCount; t++)
+			{
+				TFE_Profiler::getTimerInfo(t, &timers[t]);
+			}
+			std::sort(timers.begin(), timers.end(), [](const TFE_TimerInfo& a, const TFE_TimerInfo& b) { return a.timeAve > b.timeAve; });
+
+			ImGui::Indent();
+			for (u32 t = 0; t < timerCount; t++)
+			{
+				ImGui::Text("%0.3fms", timers[t].timeAve * 1000.0);
+				ImGui::SameLine(f32(96));
+				ImGui::Text("%4d", timers[t].count);
+				ImGui::SameLine(f32(144));
+				ImGui::Text("%s", timers[t].name);
+			}
+			ImGui::Unindent();
+		}
+
 		ImGui::End();
 	}
 
@@ -89,6 +123,38 @@ namespace TFE_ProfilerView
 		return s_open;
 	}
 
+	void console_trace(const ConsoleArgList& args)
+	{
+		const bool enable = args.size() >= 2 ? atoi(args[1].c_str()) != 0 : !TFE_Profiler::isTraceEnabled();
+		TFE_Profiler::enableTrace(enable);
+		TFE_Console::addToHistory(enable ? "Profiler tracing enabled." : "Profiler tracing disabled.");
+	}
+
+	void console_traceSave(const ConsoleArgList& args)
+	{
+		if (!TFE_Profiler::isTraceEnabled())
+		{
+			TFE_Console::addToHistory("Profiler tracing is not enabled, use profTrace 1 first.");
+			return;
+		}
+		const f64 seconds = args.size() >= 2 ? std::max(0.1, atof(args[1].c_str())) : 5.0;
+		char fileName[TFE_MAX_PATH];
+		char path[TFE_MAX_PATH];
+		snprintf(fileName, TFE_MAX_PATH, "%s.json", args.size() >= 3 ? args[2].c_str() : "trace");
+		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, fileName, path);
+
+		char res[TFE_MAX_PATH + 64];
+		if (TFE_Profiler::writeTrace(path, seconds))
+		{
+			snprintf(res, sizeof(res), "Trace written to '%s'.", path);
+		}
+		else
+		{
+			snprintf(res, sizeof(res), "Cannot write trace to '%s'.", path);
+		}
+		TFE_Console::addToHistory(res);
+	}
+
 	void enable(bool enable)
 	{
 		s_open = enable;
@@ -0,0 +1,327 @@
+#include "gameSnapshot.h"
+#include "igame.h"
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_Memory/memoryRegion.h>
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace TFE_Memory;
+
+namespace TFE_Snapshot
+{
+	enum
+	{
+		SNAPSHOT_MAGIC   = 0x50414e53,	// "SNAP"
+		SNAPSHOT_VERSION = 1,
+		SNAPSHOT_REGION_COUNT = 3,
+	};
+
+	static u32 s_restoreCount = 0;
+
+	// Registration happens during static initialization, so the list is a function static to avoid initialization order issues.
+	static std::vector<SnapshotStateInfo>& getStateList()
+	{
+		static std::vector<SnapshotStateInfo> s_stateList;
+		return s_stateList;
+	}
+
+	static MemoryRegion** getRegions(MemoryRegion** regions)
+	{
+		regions[0] = s_gameRegion;
+		regions[1] = s_levelRegion;
+		regions[2] = s_resRegion;
+		return regions;
+	}
+
+	// Hash of the registered state names and sizes, a mismatch means the snapshot came from a different build.
+	static u32 computeStateHash()
+	{
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		u32 hash = 2166136261u;
+		for (size_t i = 0; i < stateList.size(); i++)
+		{
+			for (const char* c = stateList[i].name; *c; c++)
+			{
+				hash = (hash ^ u8(*c)) * 16777619u;
+			}
+			hash = (hash ^ stateList[i].size) * 16777619u;
+		}
+		return hash;
+	}
+
+	void registerState(const char* name, void* data, u32 size)
+	{
+		std::vector<SnapshotStateInfo>& stateList = getStateList();
+		for (size_t i = 0; i < stateList.size(); i++)
+		{
+			if (stateList[i].data == data) { return; }
+		}
+		stateList.push_back({ name, data, size });
+	}
+
+	u32 getRegisteredStateCount()
+	{
+		return u32(getStateList().size());
+	}
+
+	const SnapshotStateInfo* getRegisteredState(u32 index)
+	{
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		if (index >= stateList.size()) { return nullptr; }
+		return &stateList[index];
+	}
+
+	bool capture(MemoryStream* stream)
+	{
+		TFE_ZONE("Snapshot Capture");
+		MemoryRegion* regions[SNAPSHOT_REGION_COUNT];
+		getRegions(regions);
+		if (!stream || !regions[0] || !regions[1] || !regions[2])
+		{
+			return false;
+		}
+		stream->open(MemoryStream::MODE_WRITE);
+
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		const u32 magic = SNAPSHOT_MAGIC;
+		const u32 version = SNAPSHOT_VERSION;
+		const u32 stateCount = u32(stateList.size());
+		const u32 stateHash = computeStateHash();
+		stream->write(&magic);
+		stream->write(&version);
+		stream->write(&stateCount);
+		stream->write(&stateHash);
+		// Region addresses identify the run the snapshot was taken in.
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			const u64 address = u64(size_t(regions[r]));
+			stream->write(&address);
+		}
+
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			region_writeSnapshot(regions[r], stream);
+		}
+		for (u32 i = 0; i < stateCount; i++)
+		{
+			stream->writeBuffer(stateList[i].data, stateList[i].size);
+		}
+		stream->close();
+		return true;
+	}
+
+	bool restore(MemoryStream* stream)
+	{
+		TFE_ZONE("Snapshot Restore");
+		MemoryRegion* regions[SNAPSHOT_REGION_COUNT];
+		getRegions(regions);
+		if (!stream || !stream->getSize() || !regions[0] || !regions[1] || !regions[2])
+		{
+			return false;
+		}
+		stream->open(MemoryStream::MODE_READ);
+
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		u32 magic, version, stateCount, stateHash;
+		stream->read(&magic);
+		stream->read(&version);
+		stream->read(&stateCount);
+		stream->read(&stateHash);
+		if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || stateCount != stateList.size() || stateHash != computeStateHash())
+		{
+			TFE_System::logWrite(LOG_ERROR, "Snapshot", "Invalid snapshot or the snapshot is from a different version.");
+			stream->close();
+			return false;
+		}
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			u64 address;
+			stream->read(&address);
+			if (address != u64(size_t(regions[r])))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Snapshot", "Snapshots can only be restored while the game that created them is running.");
+				stream->close();
+				return false;
+			}
+		}
+
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			if (!region_restoreSnapshot(regions[r], stream))
+			{
+				// Region blocks are never freed during a run, so once the region addresses match this should not fail.
+				assert(0);
+				stream->close();
+				return false;
+			}
+		}
+		for (u32 i = 0; i < stateCount; i++)
+		{
+			stream->readBuffer(stateList[i].data, stateList[i].size);
+		}
+		stream->close();
+		s_restoreCount++;
+		return true;
+	}
+
+	struct SnapshotSpan
+	{
+		u32 offset;
+		u32 size;
+		const u8* data;
+	};
+
+	// The contents of a captured snapshot, pointing into the snapshot data.
+	struct SnapshotLayout
+	{
+		char regionName[SNAPSHOT_REGION_COUNT][32];
+		std::vector<std::vector<SnapshotSpan>> blocks[SNAPSHOT_REGION_COUNT];
+		const u8* states;
+	};
+
+	static bool readSnapshotData(const u8* data, size_t dataSize, size_t* loc, void* dst, size_t size)
+	{
+		if (*loc + size > dataSize) { return false; }
+		memcpy(dst, data + *loc, size);
+		*loc += size;
+		return true;
+	}
+
+	// Follows the layout written by capture() and region_writeSnapshot().
+	static bool parseSnapshot(MemoryStream* stream, SnapshotLayout* layout)
+	{
+		const u8* data = stream->data();
+		const size_t dataSize = stream->getSize();
+		size_t loc = 0;
+
+		u32 header[4];
+		u64 addresses[SNAPSHOT_REGION_COUNT];
+		if (!data || !readSnapshotData(data, dataSize, &loc, header, sizeof(header)) || !readSnapshotData(data, dataSize, &loc, addresses, sizeof(addresses)))
+		{
+			return false;
+		}
+		if (header[0] != SNAPSHOT_MAGIC || header[1] != SNAPSHOT_VERSION || header[2] != getStateList().size() || header[3] != computeStateHash())
+		{
+			return false;
+		}
+
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			u64 blockSize;
+			u32 blockCount;
+			if (!readSnapshotData(data, dataSize, &loc, layout->regionName[r], 32) || !readSnapshotData(data, dataSize, &loc, &blockSize, sizeof(u64)) ||
+				!readSnapshotData(data, dataSize, &loc, &blockCount, sizeof(u32)))
+			{
+				return false;
+			}
+			layout->regionName[r][31] = 0;
+			// Skip the block addresses.
+			loc += sizeof(u64) * blockCount;
+
+			layout->blocks[r].resize(blockCount);
+			for (u32 b = 0; b < blockCount; b++)
+			{
+				while (1)
+				{
+					SnapshotSpan span;
+					if (!readSnapshotData(data, dataSize, &loc, &span.offset, sizeof(u32))) { return false; }
+					if (span.offset == 0xffffffffu) { break; }
+					if (!readSnapshotData(data, dataSize, &loc, &span.size, sizeof(u32)) || loc + span.size > dataSize) { return false; }
+					span.data = data + loc;
+					loc += span.size;
+					layout->blocks[r][b].push_back(span);
+				}
+			}
+		}
+
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		size_t stateSize = 0;
+		for (size_t i = 0; i < stateList.size(); i++)
+		{
+			stateSize += stateList[i].size;
+		}
+		if (loc + stateSize != dataSize) { return false; }
+		layout->states = data + loc;
+		return true;
+	}
+
+	// Returns the offset of the first byte that differs between the block contents, or -1 if they match.
+	// If the allocations are laid out differently, the offset of the first span that differs is returned instead.
+	static s32 compareBlock(const std::vector<SnapshotSpan>& spans0, const std::vector<SnapshotSpan>& spans1)
+	{
+		const size_t count = std::min(spans0.size(), spans1.size());
+		for (size_t s = 0; s < count; s++)
+		{
+			const SnapshotSpan& span0 = spans0[s];
+			const SnapshotSpan& span1 = spans1[s];
+			if (span0.offset != span1.offset || span0.size != span1.size)
+			{
+				return s32(std::min(span0.offset, span1.offset));
+			}
+			if (memcmp(span0.data, span1.data, span0.size) != 0)
+			{
+				u32 i = 0;
+				while (span0.data[i] == span1.data[i]) { i++; }
+				return s32(span0.offset + i);
+			}
+		}
+		if (spans0.size() != spans1.size())
+		{
+			return count < spans0.size() ? s32(spans0[count].offset) : s32(spans1[count].offset);
+		}
+		return -1;
+	}
+
+	u32 compare(MemoryStream* snapshot0, MemoryStream* snapshot1)
+	{
+		SnapshotLayout layout0, layout1;
+		if (!snapshot0 || !snapshot1 || !parseSnapshot(snapshot0, &layout0) || !parseSnapshot(snapshot1, &layout1))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Snapshot", "Cannot compare invalid snapshots.");
+			return 1;
+		}
+
+		u32 diffCount = 0;
+		for (s32 r = 0; r < SNAPSHOT_REGION_COUNT; r++)
+		{
+			const u32 blockCount0 = u32(layout0.blocks[r].size());
+			const u32 blockCount1 = u32(layout1.blocks[r].size());
+			if (blockCount0 != blockCount1)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Snapshot", "Region '%s' block count differs: %u vs %u.", layout0.regionName[r], blockCount0, blockCount1);
+				diffCount++;
+			}
+			const u32 blockCount = std::min(blockCount0, blockCount1);
+			for (u32 b = 0; b < blockCount; b++)
+			{
+				const s32 offset = compareBlock(layout0.blocks[r][b], layout1.blocks[r][b]);
+				if (offset >= 0)
+				{
+					TFE_System::logWrite(LOG_ERROR, "Snapshot", "Region '%s' block %u differs, starting at offset 0x%x.", layout0.regionName[r], b, offset);
+					diffCount++;
+				}
+			}
+		}
+
+		const std::vector<SnapshotStateInfo>& stateList = getStateList();
+		size_t offset = 0;
+		for (size_t i = 0; i < stateList.size(); i++)
+		{
+			if (memcmp(layout0.states + offset, layout1.states + offset, stateList[i].size) != 0)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Snapshot", "State '%s' differs.", stateList[i].name);
+				diffCount++;
+			}
+			offset += stateList[i].size;
+		}
+		return diffCount;
+	}
+
+	u32 getRestoreCount()
+	{
+		return s_restoreCount;
+	}
+}
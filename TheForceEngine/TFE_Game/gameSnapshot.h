@@ -0,0 +1,55 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Game State Snapshots
+// Captures the full game state in memory so it can be restored
+// instantly - for quicksaves, rewind and deterministic testing.
+//
+// The game state is the contents of the game, level and resource
+// memory regions plus any static state registered with
+// SNAPSHOT_STATE(). Regions are restored in place, so pointers
+// between the regions and registered state remain valid. As a result
+// snapshots can only be restored during the same run, and any state
+// that is not registered (audio, renderer caches) is left as-is.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/memorystream.h>
+
+struct SnapshotStateInfo
+{
+	const char* name;
+	void* data;
+	u32 size;
+};
+
+namespace TFE_Snapshot
+{
+	// Register static state to be captured with the snapshot, use SNAPSHOT_STATE() instead.
+	// Only plain data is supported, pointers must point into the game memory regions or other registered state.
+	void registerState(const char* name, void* data, u32 size);
+
+	// Write the game state into the stream, which is opened for writing.
+	bool capture(MemoryStream* stream);
+	// Restore the game state from a stream written by capture().
+	bool restore(MemoryStream* stream);
+
+	// Incremented every time a snapshot is restored, caches derived from the game state compare it to know when to reset.
+	u32 getRestoreCount();
+
+	// Compare two snapshots taken during the same run, each region block and registered state that differs is written to the log.
+	// Returns the number of differences.
+	u32 compare(MemoryStream* snapshot0, MemoryStream* snapshot1);
+
+	u32 getRegisteredStateCount();
+	const SnapshotStateInfo* getRegisteredState(u32 index);
+}
+
+struct SnapshotStateRegistrar
+{
+	SnapshotStateRegistrar(const char* name, void* data, u32 size)
+	{
+		TFE_Snapshot::registerState(name, data, size);
+	}
+};
+
+// Register a global or file static variable with the snapshot system, used at namespace scope after the variable is defined.
+#define SNAPSHOT_STATE(var) static SnapshotStateRegistrar s_snapshotState_##var(#var, &(var), u32(sizeof(var)))
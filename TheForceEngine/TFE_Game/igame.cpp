@@ -2,6 +2,11 @@
 #include <TFE_FrontEndUI/console.h>
 #include <TFE_DarkForces/darkForcesMain.h>
 #include <TFE_Outlaws/outlawsMain.h>
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+#include <algorithm>
 
 enum GameConstants
 {
@@ -36,6 +41,149 @@ void displayMemoryUsage(const ConsoleArgList& args)
 	TFE_Console::addToHistory("-------------------------------------------------------------------");
 }
 
+// Start or stop recording the level region allocations, load a level while recording and then use regionBench.
+void regionTrace(const ConsoleArgList& args)
+{
+	const bool enable = !region_isTracing(s_levelRegion);
+	region_setTracing(s_levelRegion, enable);
+	TFE_Console::addToHistory(enable ? "Recording level region allocations." : "Stopped recording level region allocations.");
+}
+
+void regionBench(const ConsoleArgList& args)
+{
+	s32 iterations = 10;
+	if (args.size() > 1)
+	{
+		iterations = std::max(1, atoi(args[1].c_str()));
+	}
+
+	RegionBenchResult slabs, bins;
+	if (!region_benchmarkTrace(s_levelRegion, iterations, &slabs, &bins))
+	{
+		TFE_Console::addToHistory("No allocation trace recorded, use regionTrace first.");
+		return;
+	}
+
+	char res[256];
+	sprintf(res, "Replayed %zu operations, %d iterations.", slabs.opCount, iterations);
+	TFE_Console::addToHistory(res);
+	TFE_Console::addToHistory("--------------------------------------------------------------------------------------");
+	TFE_Console::addToHistory("Allocator | Time (ms) | Memory Used |  Capacity | Free Slots | Largest Free | Fragmentation");
+	TFE_Console::addToHistory("--------------------------------------------------------------------------------------");
+	sprintf(res, "Slabs     | %9.3f | %11zu | %9zu | %10u | %12zu | %12.1f%%", slabs.seconds * 1000.0, slabs.used, slabs.capacity, slabs.freeSlots, slabs.largestFree, slabs.fragmentation * 100.0);
+	TFE_Console::addToHistory(res);
+	sprintf(res, "Bins      | %9.3f | %11zu | %9zu | %10u | %12zu | %12.1f%%", bins.seconds * 1000.0, bins.used, bins.capacity, bins.freeSlots, bins.largestFree, bins.fragmentation * 100.0);
+	TFE_Console::addToHistory(res);
+	TFE_Console::addToHistory("--------------------------------------------------------------------------------------");
+}
+
+static bool isParserBenchFile(const char* name)
+{
+	const char* ext = strrchr(name, '.');
+	return ext && (strcasecmp(ext, ".LEV") == 0 || strcasecmp(ext, ".INF") == 0 || strcasecmp(ext, ".O") == 0);
+}
+
+// Parse a text buffer the same way the level loaders do, either with the allocating tokenizer and sscanf()
+// or with the zero-allocation tokenizer and field parsers. Returns the number of numeric fields found.
+static u32 parserBenchBuffer(const std::vector<char>& buffer, bool zeroAlloc, u32* tokenCount)
+{
+	TFE_Parser parser;
+	parser.init(buffer.data(), buffer.size());
+	parser.enableBlockComments();
+	parser.addCommentString("#");
+	parser.addCommentString("//");
+	parser.convertToUpperCase(true);
+
+	TokenList tokenList;
+	size_t bufferPos = 0;
+	u32 fieldCount = 0;
+	while (const char* line = parser.readLine(bufferPos))
+	{
+		f32 value;
+		if (zeroAlloc)
+		{
+			const TokenView* tokens;
+			const s32 count = parser.tokenizeLine(line, &tokens);
+			for (s32 t = 0; t < count; t++)
+			{
+				if (TFE_Parser::parseF32(tokens[t].str, &value)) { fieldCount++; }
+			}
+			*tokenCount += u32(count);
+		}
+		else
+		{
+			parser.tokenizeLine(line, tokenList);
+			for (size_t t = 0; t < tokenList.size(); t++)
+			{
+				if (sscanf(tokenList[t].c_str(), "%f", &value) == 1) { fieldCount++; }
+			}
+			*tokenCount += u32(tokenList.size());
+		}
+	}
+	return fieldCount;
+}
+
+// Measure the parser throughput over every LEV, INF and O file in DARK.GOB.
+void parserBench(const ConsoleArgList& args)
+{
+	s32 iterations = 10;
+	if (args.size() > 1)
+	{
+		iterations = std::max(1, atoi(args[1].c_str()));
+	}
+
+	char gobPath[TFE_MAX_PATH];
+	TFE_Paths::appendPath(PATH_SOURCE_DATA, "DARK.GOB", gobPath);
+	Archive* archive = Archive::getArchive(ARCHIVE_GOB, "DARK.GOB", gobPath);
+	if (!archive)
+	{
+		TFE_Console::addToHistory("Cannot open DARK.GOB.");
+		return;
+	}
+
+	std::vector<std::vector<char>> files;
+	size_t totalSize = 0;
+	const u32 fileCount = archive->getFileCount();
+	for (u32 i = 0; i < fileCount; i++)
+	{
+		if (!isParserBenchFile(archive->getFileName(i)) || !archive->openFile(i)) { continue; }
+
+		std::vector<char> buffer(archive->getFileLength());
+		archive->readFile(buffer.data(), buffer.size());
+		archive->closeFile();
+
+		totalSize += buffer.size();
+		files.push_back(std::move(buffer));
+	}
+
+	char res[256];
+	sprintf(res, "Parsing %zu files (%zu bytes), %d iterations.", files.size(), totalSize, iterations);
+	TFE_Console::addToHistory(res);
+	TFE_Console::addToHistory("-------------------------------------------------------------");
+	TFE_Console::addToHistory("Tokenizer  | Time (ms) | MB / sec | Tokens     | Fields");
+	TFE_Console::addToHistory("-------------------------------------------------------------");
+	for (s32 mode = 0; mode < 2; mode++)
+	{
+		const bool zeroAlloc = mode == 1;
+		u32 tokenCount = 0, fieldCount = 0;
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 it = 0; it < iterations; it++)
+		{
+			tokenCount = 0;
+			fieldCount = 0;
+			for (size_t f = 0; f < files.size(); f++)
+			{
+				fieldCount += parserBenchBuffer(files[f], zeroAlloc, &tokenCount);
+			}
+		}
+		const f64 seconds = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+		const f64 throughput = seconds > 0.0 ? f64(totalSize) * f64(iterations) / (seconds * 1024.0 * 1024.0) : 0.0;
+		sprintf(res, "%-10s | %9.3f | %8.2f | %10u | %u", zeroAlloc ? "Views" : "TokenList", seconds * 1000.0 / f64(iterations), throughput, tokenCount, fieldCount);
+		TFE_Console::addToHistory(res);
+	}
+	TFE_Console::addToHistory("-------------------------------------------------------------");
+}
+
 void game_init()
 {
 	s_gameRegion  = region_create("game",  GAME_MEMORY_BASE);	// Region for "permanent" game allocations.
@@ -43,6 +191,9 @@ void game_init()
 	s_resRegion   = region_create("resources", RES_MEMORY_BASE);	// Region for "per-level" resource allocations.
 
 	CCMD("displayMemoryUsage", displayMemoryUsage, 0, "Display memory usage.");
+	CCMD("regionTrace", regionTrace, 0, "Start or stop recording the level region allocations.");
+	CCMD("regionBench", regionBench, 0, "regionBench [iterations] - replay the recorded level allocations with and without slabs.");
+	CCMD("parserBench", parserBench, 0, "parserBench [iterations] - tokenize the LEV, INF and O files in DARK.GOB with both tokenizers.");
 }
 
 void game_destroy()
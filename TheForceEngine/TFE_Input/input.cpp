@@ -184,12 +184,27 @@ namespace TFE_Input
 		s_mouseMoveAccum[1] = 0;
 	}
 
+	// Get the accumulated mouse movement without clearing it.
+	void peekAccumulatedMouseMove(s32* x, s32* y)
+	{
+		assert(x && y);
+
+		*x = s_mouseMoveAccum[0];
+		*y = s_mouseMoveAccum[1];
+	}
+
 	void clearAccumulatedMouseMove()
 	{
 		s_mouseMoveAccum[0] = 0;
 		s_mouseMoveAccum[1] = 0;
 	}
 
+	void setAccumulatedMouseMove(s32 x, s32 y)
+	{
+		s_mouseMoveAccum[0] = x;
+		s_mouseMoveAccum[1] = y;
+	}
+
 	void getMousePos(s32* x, s32* y)
 	{
 		assert(x && y);
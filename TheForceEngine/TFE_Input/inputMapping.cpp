@@ -101,6 +101,8 @@ namespace TFE_Input
 
 	static InputConfig s_inputConfig = { 0 };
 	static ActionState s_actions[IA_COUNT];
+	static bool s_replay = false;
+	static f32 s_replayAxis[AA_COUNT];
 		
 	void addDefaultControlBinds();
 			   
@@ -350,6 +352,10 @@ namespace TFE_Input
 
 	f32 inputMapping_getAnalogAxis(AnalogAxis axis)
 	{
+		if (s_replay)
+		{
+			return s_replayAxis[axis];
+		}
 		if (!(s_inputConfig.controllerFlags & CFLAG_ENABLE))
 		{
 			return 0.0f;
@@ -376,6 +382,43 @@ namespace TFE_Input
 		return s_inputConfig.mouseSensitivity[1] * ((s_inputConfig.mouseFlags & MFLAG_INVERT_VERT) ? -1.0f : 1.0f);
 	}
 
+	void inputMapping_captureFrame(InputFrame* frame)
+	{
+		for (u32 i = 0; i < IA_COUNT; i++)
+		{
+			frame->actions[i] = u8(s_actions[i]);
+		}
+		for (u32 i = 0; i < AA_COUNT; i++)
+		{
+			frame->axis[i] = inputMapping_getAnalogAxis(AnalogAxis(i));
+		}
+		// The game reads and clears the accumulated movement, so only peek at it here.
+		TFE_Input::peekAccumulatedMouseMove(&frame->mouseMove[0], &frame->mouseMove[1]);
+	}
+
+	void inputMapping_beginReplay()
+	{
+		s_replay = true;
+		memset(s_replayAxis, 0, sizeof(f32) * AA_COUNT);
+	}
+
+	void inputMapping_replayFrame(const InputFrame* frame)
+	{
+		assert(s_replay);
+		for (u32 i = IAS_COUNT; i < IA_COUNT; i++)
+		{
+			s_actions[i] = ActionState(frame->actions[i]);
+		}
+		memcpy(s_replayAxis, frame->axis, sizeof(f32) * AA_COUNT);
+		TFE_Input::setAccumulatedMouseMove(frame->mouseMove[0], frame->mouseMove[1]);
+	}
+
+	void inputMapping_endReplay()
+	{
+		s_replay = false;
+		TFE_Input::clearAccumulatedMouseMove();
+	}
+
 	u32 inputMapping_getBindingsForAction(InputAction action, u32* indices, u32 maxIndices)
 	{
 		assert(indices);
@@ -157,6 +157,14 @@ namespace TFE_Input
 		f32 mouseSensitivity[2];// horizontal/vertical sensitivity.
 	};
 
+	// The input seen by the game for a single frame, used to record and replay demos.
+	struct InputFrame
+	{
+		u8  actions[IA_COUNT];	// see ActionState.
+		f32 axis[AA_COUNT];		// mapped analog axis values.
+		s32 mouseMove[2];		// accumulated mouse movement.
+	};
+
 	void inputMapping_startup();
 	void inputMapping_shutdown();
 	void inputMapping_resetToDefaults();
@@ -178,4 +186,12 @@ namespace TFE_Input
 
 	f32 inputMapping_getHorzMouseSensitivity();
 	f32 inputMapping_getVertMouseSensitivity();
+
+	// Demo recording and playback.
+	// While replaying, the game actions, analog axes and mouse movement come from the replayed frame
+	// instead of the input devices. System actions, such as the console, are not affected.
+	void inputMapping_captureFrame(InputFrame* frame);
+	void inputMapping_beginReplay();
+	void inputMapping_replayFrame(const InputFrame* frame);
+	void inputMapping_endReplay();
 }  // TFE_Input
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
+#include <algorithm>
+#include <vector>
 // Merge player collision into collision
 #include <TFE_DarkForces/playerCollision.h>
 using namespace TFE_DarkForces;
@@ -64,11 +66,33 @@ namespace TFE_Jedi
 		NO_INTERSECT = 0,
 	};
 
+	enum
+	{
+		EFFECT_LOS_CACHE_SIZE = 16,	// must be a power of 2.
+	};
+
+	struct EffectLosEntry
+	{
+		RSector* sector;
+		vec3_fixed pos;
+		JBool canHit;
+	};
+
 	////////////////////////////////////////////////////////
 	// Internal State
 	////////////////////////////////////////////////////////
 	s32 s_collisionFrameWall;
+
+	// Effect query broadphase.
+	static std::vector<u32> s_effectSectorMark;
+	static std::vector<RSector*> s_effectSectors;
+	static u32 s_effectQueryFrame = 0;
+	static EffectLosEntry s_effectLosCache[EFFECT_LOS_CACHE_SIZE];
+	static s32 s_effectLosCount = 0;
+	static s32 s_effectLosNext = 0;
 	JBool s_collision_wallHit = JFALSE;
+	RSector* s_collision_pathSectors[COLLISION_MAX_PATH_SECTORS];
+	s32 s_collision_pathSectorCount = 0;
 	u32 s_collision_excludeEntityFlags = 0;
 	static ColPath s_col_path;
 
@@ -497,6 +521,115 @@ namespace TFE_Jedi
 		return JFALSE;
 	}
 		
+	// The effect queries used to loop over every sector in the level, but an object can only be reached if the path from the origin
+	// crosses a chain of adjoins from the start sector. Every wall crossed lies on the path, which is inside of the query bounds,
+	// so flood filling through the adjoins that overlap the bounds finds every sector that can contain an affected object.
+	// The sectors are then visited in index order, so the effect functions are called in the same order as before.
+	static void collision_gatherEffectSectors(RSector* startSector, fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1)
+	{
+		// Make sure rounding in the path intersection tests cannot miss a wall right on the edge of the bounds.
+		x0 -= ONE_16; z0 -= ONE_16;
+		x1 += ONE_16; z1 += ONE_16;
+
+		if (s_effectSectorMark.size() < s_sectorCount)
+		{
+			s_effectSectorMark.resize(s_sectorCount, 0);
+		}
+		s_effectQueryFrame++;
+		if (s_effectQueryFrame == 0)
+		{
+			std::fill(s_effectSectorMark.begin(), s_effectSectorMark.end(), 0);
+			s_effectQueryFrame = 1;
+		}
+
+		s_effectSectors.clear();
+		s_effectSectors.push_back(startSector);
+		s_effectSectorMark[startSector->index] = s_effectQueryFrame;
+		for (size_t i = 0; i < s_effectSectors.size(); i++)
+		{
+			RSector* sector = s_effectSectors[i];
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				RSector* next = wall->nextSector;
+				if (!next || s_effectSectorMark[next->index] == s_effectQueryFrame) { continue; }
+
+				const vec2_fixed* w0 = wall->w0;
+				const vec2_fixed* w1 = wall->w1;
+				if (min(w0->x, w1->x) > x1 || max(w0->x, w1->x) < x0 || min(w0->z, w1->z) > z1 || max(w0->z, w1->z) < z0)
+				{
+					continue;
+				}
+				s_effectSectorMark[next->index] = s_effectQueryFrame;
+				s_effectSectors.push_back(next);
+			}
+		}
+		std::sort(s_effectSectors.begin(), s_effectSectors.end(), [](const RSector* a, const RSector* b) { return a->index < b->index; });
+	}
+
+	// Per-query line of sight cache, objects are often stacked at the same position (dropped items, generated enemies).
+	static JBool collision_effectLosLookup(RSector* sector, vec3_fixed pos, JBool* canHit)
+	{
+		for (s32 i = 0; i < s_effectLosCount; i++)
+		{
+			const EffectLosEntry* entry = &s_effectLosCache[i];
+			if (entry->sector == sector && entry->pos.x == pos.x && entry->pos.y == pos.y && entry->pos.z == pos.z)
+			{
+				*canHit = entry->canHit;
+				return JTRUE;
+			}
+		}
+		return JFALSE;
+	}
+
+	static void collision_effectLosAdd(RSector* sector, vec3_fixed pos, JBool canHit)
+	{
+		EffectLosEntry* entry = &s_effectLosCache[s_effectLosNext];
+		entry->sector = sector;
+		entry->pos = pos;
+		entry->canHit = canHit;
+		s_effectLosNext = (s_effectLosNext + 1) & (EFFECT_LOS_CACHE_SIZE - 1);
+		s_effectLosCount = min(s_effectLosCount + 1, (s32)EFFECT_LOS_CACHE_SIZE);
+	}
+
+	// Returns JFALSE if the start sector rejects the query, which then affects nothing.
+	// Note the original code tests the start sector for every sector in the level, so the test was pulled out of the loop.
+	static JBool collision_effectStartSectorInRange(RSector* startSector, vec3_fixed origin, fixed16_16 x0, fixed16_16 y0, fixed16_16 z0, fixed16_16 x1, fixed16_16 y1, fixed16_16 z1)
+	{
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
+		{
+			return JFALSE;
+		}
+
+		const fixed16_16 secHeightThreshold = origin.y - FIXED(2);
+		fixed16_16 floor, ceil;
+		fixed16_16 secHeight = startSector->secHeight;
+		fixed16_16 adjSecHeight = startSector->floorHeight + secHeight;
+		if (secHeight < 0 && adjSecHeight < secHeightThreshold)
+		{
+			floor = startSector->floorHeight;
+			ceil = adjSecHeight;
+		}
+		else
+		{
+			floor = adjSecHeight;
+			ceil = startSector->ceilingHeight;
+		}
+		if (startSector->flags1 & SEC_FLAGS1_PIT)
+		{
+			floor += SEC_SKY_HEIGHT;
+		}
+		if (startSector->flags1 & SEC_FLAGS1_EXTERIOR)
+		{
+			ceil -= SEC_SKY_HEIGHT;
+		}
+		if (y0 > floor || y1 < ceil)
+		{
+			return JFALSE;
+		}
+		return JTRUE;
+	}
+
 	// Call the effectFunc() for each object within 'range' of point (x,y,z). This will only be called for objects in range and that have a valid collision path.
 	// Note the collision path is 3D (XYZ), in that it takes into account collision based on height.
 	void collision_effectObjectsInRange3D(RSector* startSector, fixed16_16 range, vec3_fixed origin, CollisionEffectFunc effectFunc, SecObject* excludeObj, u32 entityFlags)
@@ -509,45 +642,18 @@ namespace TFE_Jedi
 		const fixed16_16 y1 = origin.y + range;
 		const fixed16_16 z1 = origin.z + range;
 
-		const fixed16_16 secHeightThreshold = origin.y - FIXED(2);
-		RSector* sector = s_sectors;
-		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		if (!collision_effectStartSectorInRange(startSector, origin, x0, y0, z0, x1, y1, z1))
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
-
-			fixed16_16 floor, ceil;
-			fixed16_16 secHeight = startSector->secHeight;
-			fixed16_16 adjSecHeight = startSector->floorHeight + secHeight;
-			if (secHeight < 0 && adjSecHeight < secHeightThreshold)
-			{
-				floor = startSector->floorHeight;
-				ceil = adjSecHeight;
-			}
-			else
-			{
-				floor = adjSecHeight;
-				ceil = startSector->ceilingHeight;
-			}
-
-			if (startSector->flags1 & SEC_FLAGS1_PIT)
-			{
-				floor += SEC_SKY_HEIGHT;
-			}
-			if (startSector->flags1 & SEC_FLAGS1_EXTERIOR)
-			{
-				ceil -= SEC_SKY_HEIGHT;
-			}
-
-			if (y0 > floor || y1 < ceil)
-			{
-				continue;
-			}
-			// End of start sector check.
+			return;
+		}
+		collision_gatherEffectSectors(startSector, x0, z0, x1, z1);
+		s_effectLosCount = 0;
+		s_effectLosNext = 0;
 
+		const size_t sectorCount = s_effectSectors.size();
+		for (size_t i = 0; i < sectorCount; i++)
+		{
+			RSector* sector = s_effectSectors[i];
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
 				SecObject* obj = sector->objectList[objListIndex];
@@ -561,10 +667,11 @@ namespace TFE_Jedi
 					continue;
 				}
 
-				JBool canHit = collision_canHitObject(startSector, obj->sector, origin, obj->posWS, WF3_CANNOT_FIRE_THROUGH);
-				if (!canHit)
+				JBool canHit;
+				if (!collision_effectLosLookup(obj->sector, obj->posWS, &canHit))
 				{
 					canHit = collision_canHitObject(startSector, obj->sector, origin, obj->posWS, WF3_CANNOT_FIRE_THROUGH);
+					collision_effectLosAdd(obj->sector, obj->posWS, canHit);
 				}
 				// Finally the object can be hit, so call the effect function.
 				if (canHit)
@@ -587,42 +694,18 @@ namespace TFE_Jedi
 		const fixed16_16 y1 = origin.y + range;
 		const fixed16_16 z1 = origin.z + range;
 
-		const fixed16_16 secHeightThreshold = origin.y - FIXED(2);
-		RSector* sector = s_sectors;
-		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		if (!collision_effectStartSectorInRange(startSector, origin, x0, y0, z0, x1, y1, z1))
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
-			fixed16_16 floor, ceil;
-			fixed16_16 secHeight = startSector->secHeight;
-			fixed16_16 adjSecHeight = startSector->floorHeight + secHeight;
-			if (secHeight < 0 && adjSecHeight < secHeightThreshold)
-			{
-				floor = startSector->floorHeight;
-				ceil = adjSecHeight;
-			}
-			else
-			{
-				floor = adjSecHeight;
-				ceil = startSector->ceilingHeight;
-			}
-			if (startSector->flags1 & SEC_FLAGS1_PIT)
-			{
-				floor += SEC_SKY_HEIGHT;
-			}
-			if (startSector->flags1 & SEC_FLAGS1_EXTERIOR)
-			{
-				ceil -= SEC_SKY_HEIGHT;
-			}
-			if (y0 > floor || y1 < ceil)
-			{
-				continue;
-			}
-			// End of start sector check.
+			return;
+		}
+		collision_gatherEffectSectors(startSector, x0, z0, x1, z1);
+		s_effectLosCount = 0;
+		s_effectLosNext = 0;
 
+		const size_t sectorCount = s_effectSectors.size();
+		for (size_t i = 0; i < sectorCount; i++)
+		{
+			RSector* sector = s_effectSectors[i];
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
 				SecObject* obj = sector->objectList[objListIndex];
@@ -636,36 +719,44 @@ namespace TFE_Jedi
 					continue;
 				}
 
-				fixed16_16 dx = obj->posWS.x - origin.x;
-				fixed16_16 dz = obj->posWS.z - origin.z;
-				RWall* hitWall = nullptr;
-				if (dx || dz)
+				// The path only depends on XZ here, so the height is not part of the cache key.
+				const vec3_fixed key = { obj->posWS.x, 0, obj->posWS.z };
+				JBool canHit;
+				if (!collision_effectLosLookup(obj->sector, key, &canHit))
 				{
-					s_col_path.x0 = origin.x;
-					s_col_path.z0 = origin.z;
-					s_col_path.x1 = obj->posWS.x;
-					s_col_path.z1 = obj->posWS.z;
-					s_collisionFrameWall++;
-					hitWall = collision_pathWallCollision(startSector);
-				}
+					fixed16_16 dx = obj->posWS.x - origin.x;
+					fixed16_16 dz = obj->posWS.z - origin.z;
+					RWall* hitWall = nullptr;
+					if (dx || dz)
+					{
+						s_col_path.x0 = origin.x;
+						s_col_path.z0 = origin.z;
+						s_col_path.x1 = obj->posWS.x;
+						s_col_path.z1 = obj->posWS.z;
+						s_collisionFrameWall++;
+						hitWall = collision_pathWallCollision(startSector);
+					}
 
-				RSector* nextSector = startSector;
-				while (hitWall && nextSector && nextSector != obj->sector)
-				{
-					nextSector = hitWall->nextSector;
-					if (nextSector)
+					RSector* nextSector = startSector;
+					while (hitWall && nextSector && nextSector != obj->sector)
 					{
-						const fixed16_16 height = nextSector->floorHeight - nextSector->ceilingHeight;
-						if (height < c_minTraversableOpening)
+						nextSector = hitWall->nextSector;
+						if (nextSector)
 						{
-							break;
+							const fixed16_16 height = nextSector->floorHeight - nextSector->ceilingHeight;
+							if (height < c_minTraversableOpening)
+							{
+								break;
+							}
+							hitWall = collision_pathWallCollision(nextSector);
 						}
-						hitWall = collision_pathWallCollision(nextSector);
 					}
+					canHit = (nextSector == obj->sector) ? JTRUE : JFALSE;
+					collision_effectLosAdd(obj->sector, key, canHit);
 				}
 
 				// If there is a clear path from the source position to the object in range, call the specified function.
-				if (nextSector == obj->sector)
+				if (canHit)
 				{
 					effectFunc(obj);
 				}
@@ -1023,10 +1114,21 @@ namespace TFE_Jedi
 		return nullptr;
 	}
 
+	static void collision_addPathSector(RSector* sector)
+	{
+		if (s_collision_pathSectorCount < COLLISION_MAX_PATH_SECTORS)
+		{
+			s_collision_pathSectors[s_collision_pathSectorCount] = sector;
+		}
+		s_collision_pathSectorCount++;
+	}
+
 	// Treat walls with flags3 that includes 'exclWallFlags3' as solid.
 	JBool collision_canHitObject(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3)
 	{
 		s_collision_wallHit = JFALSE;
+		s_collision_pathSectorCount = 0;
+		collision_addPathSector(startSector);
 		fixed16_16 approxDist = distApprox(p0.x, p0.z, p1.x, p1.z);
 		fixed16_16 dy = p1.y - p0.y;
 		fixed16_16 yStep = approxDist ? div16(dy, approxDist) : dy;
@@ -1052,6 +1154,8 @@ namespace TFE_Jedi
 				s_collision_wallHit = JTRUE;
 				return JFALSE;
 			}
+			// The next sector heights are tested even if the ray stops here.
+			collision_addPathSector(nextSector);
 			if (hitWall->flags3 & exclWallFlags3)
 			{
 				return JFALSE;
@@ -25,6 +25,11 @@ struct RSector;
 struct SecObject;
 struct RWall;
 
+enum CollisionConstants
+{
+	COLLISION_MAX_PATH_SECTORS = 8,
+};
+
 struct CollisionInterval
 {
 	fixed16_16 x0;
@@ -98,5 +103,9 @@ namespace TFE_Jedi
 	extern fixed16_16 s_colObjOverlap;
 	extern s32 s_collisionFrameWall;
 	extern JBool s_collision_wallHit;
+	// Sectors whose geometry was tested by the last collision_canHitObject() call, the count may exceed COLLISION_MAX_PATH_SECTORS
+	// in which case only the first sectors are stored.
+	extern RSector* s_collision_pathSectors[COLLISION_MAX_PATH_SECTORS];
+	extern s32 s_collision_pathSectorCount;
 	extern u32 s_collision_excludeEntityFlags;
 }
@@ -0,0 +1,229 @@
+#include <cstring>
+#include <vector>
+
+#include "losQuery.h"
+#include "collision.h"
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Level/levelPvs.h>
+#include <TFE_Jedi/Renderer/rcommon.h>
+#include <TFE_DarkForces/time.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_System/profiler.h>
+
+using namespace TFE_DarkForces;
+
+namespace TFE_Jedi
+{
+	enum
+	{
+		LOS_CACHE_SIZE  = 512,	// must be a power of 2.
+		LOS_CACHE_PROBE = 8,
+	};
+
+	struct LosCacheEntry
+	{
+		u32 generation;		// the entry is only valid if this matches s_losGeneration.
+		RSector* startSector;
+		RSector* endSector;
+		vec3_fixed p0;
+		vec3_fixed p1;
+		u32 exclWallFlags3;
+		JBool result;
+		JBool wallHit;
+		// Sectors tested by the ray and their geometry stamps when the result was computed.
+		s32 pathCount;
+		s32 pathSector[COLLISION_MAX_PATH_SECTORS];
+		u32 pathStamp[COLLISION_MAX_PATH_SECTORS];
+	};
+
+	static LosCacheEntry s_losCache[LOS_CACHE_SIZE];
+	static std::vector<u32> s_losSectorStamp;	// indexed by sector, 0 until the sector geometry changes.
+	static u32  s_losStamp = 0;
+	static u32  s_losGeneration = 1;
+	static Tick s_losTick = 0;
+	static u32  s_losRestoreCount = 0;
+
+	// Counts for the current tick, and the totals of the previous tick which are shown as counters.
+	static s32 s_losTickQueries = 0;
+	static s32 s_losTickHits = 0;
+	static s32 s_losTickRejects = 0;
+	static s32 s_losQueryCount = 0;
+	static s32 s_losCacheHits = 0;
+	static s32 s_losHitRate = 0;
+	static s32 s_losPvsRejects = 0;
+	// The last pair reported by PVS validation, so the same failure is not logged every tick.
+	static RSector* s_losErrorStart = nullptr;
+	static RSector* s_losErrorEnd = nullptr;
+
+	void losQuery_init()
+	{
+		TFE_COUNTER(s_losQueryCount, "LOS Queries Per Tick");
+		TFE_COUNTER(s_losCacheHits, "LOS Cache Hits Per Tick");
+		TFE_COUNTER(s_losHitRate, "LOS Cache Hit Rate (%)");
+		TFE_COUNTER(s_losPvsRejects, "LOS PVS Rejects Per Tick");
+	}
+
+	void losQuery_invalidate()
+	{
+		s_losGeneration++;
+		// Once the generation wraps around, old entries could look valid again.
+		if (s_losGeneration == 0)
+		{
+			memset(s_losCache, 0, sizeof(s_losCache));
+			s_losGeneration = 1;
+		}
+	}
+
+	void losQuery_invalidateSector(RSector* sector)
+	{
+		if (!sector) { return; }
+		s_losStamp++;
+		// Once the stamp wraps around, old entries could look valid again.
+		if (s_losStamp == 0)
+		{
+			s_losSectorStamp.clear();
+			s_losStamp = 1;
+			losQuery_invalidate();
+		}
+
+		if (sector->index >= s32(s_losSectorStamp.size()))
+		{
+			s_losSectorStamp.resize(sector->index + 1, 0);
+		}
+		s_losSectorStamp[sector->index] = s_losStamp;
+	}
+
+	static u32 losQuery_getSectorStamp(s32 index)
+	{
+		return index < s32(s_losSectorStamp.size()) ? s_losSectorStamp[index] : 0;
+	}
+
+	static JBool losQuery_isEntryCurrent(const LosCacheEntry* entry)
+	{
+		// A negative count marks a slot whose result could not be kept.
+		if (entry->pathCount < 0) { return JFALSE; }
+		for (s32 i = 0; i < entry->pathCount; i++)
+		{
+			if (losQuery_getSectorStamp(entry->pathSector[i]) != entry->pathStamp[i])
+			{
+				return JFALSE;
+			}
+		}
+		return JTRUE;
+	}
+
+	static void losQuery_beginTick()
+	{
+		s_losQueryCount = s_losTickQueries;
+		s_losCacheHits  = s_losTickHits;
+		s_losHitRate    = s_losTickQueries ? s_losTickHits * 100 / s_losTickQueries : 0;
+		s_losPvsRejects = s_losTickRejects;
+		s_losTickQueries = 0;
+		s_losTickHits = 0;
+		s_losTickRejects = 0;
+
+		s_losTick = s_curTick;
+		s_losRestoreCount = TFE_Snapshot::getRestoreCount();
+		losQuery_invalidate();
+	}
+
+	static u32 losQuery_hash(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3)
+	{
+		u32 hash = u32(startSector->index) * 0x9e3779b1u;
+		hash = (hash ^ u32(endSector ? endSector->index : -1)) * 0x85ebca6bu;
+		hash = (hash ^ u32(p0.x)) * 0xc2b2ae35u;
+		hash = (hash ^ u32(p0.y)) * 0x9e3779b1u;
+		hash = (hash ^ u32(p0.z)) * 0x85ebca6bu;
+		hash = (hash ^ u32(p1.x)) * 0xc2b2ae35u;
+		hash = (hash ^ u32(p1.y)) * 0x9e3779b1u;
+		hash = (hash ^ u32(p1.z)) * 0x85ebca6bu;
+		hash = (hash ^ exclWallFlags3);
+		return hash ^ (hash >> 16);
+	}
+
+	JBool losQuery_canHit(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3)
+	{
+		if (s_curTick != s_losTick || TFE_Snapshot::getRestoreCount() != s_losRestoreCount)
+		{
+			losQuery_beginTick();
+		}
+		s_losTickQueries++;
+
+		// No line through the adjoins connects the sectors, so the ray would stop at a wall.
+		// This uses the same switches as the renderer: r_pvsCull enables the early out and r_pvsValidate runs the ray test
+		// anyway and reports the pairs the PVS would have rejected wrongly.
+		if ((s_pvsCull || s_pvsValidate) && !pvs_isVisible(startSector, endSector))
+		{
+			if (!s_pvsValidate)
+			{
+				s_losTickRejects++;
+				s_collision_wallHit = JTRUE;
+				return JFALSE;
+			}
+			if (collision_canHitObject(startSector, endSector, p0, p1, exclWallFlags3))
+			{
+				s_pvsErrorCount++;
+				if (s_losErrorStart != startSector || s_losErrorEnd != endSector)
+				{
+					s_losErrorStart = startSector;
+					s_losErrorEnd = endSector;
+					TFE_System::logWrite(LOG_WARNING, "LOS", "PVS validation failed: sector %d can be hit from sector %d but is not in its visible set.", endSector->index, startSector->index);
+				}
+			}
+		}
+
+		const u32 hash = losQuery_hash(startSector, endSector, p0, p1, exclWallFlags3);
+		LosCacheEntry* freeEntry = nullptr;
+		LosCacheEntry* staleEntry = nullptr;
+		for (u32 i = 0; i < LOS_CACHE_PROBE; i++)
+		{
+			LosCacheEntry* entry = &s_losCache[(hash + i) & (LOS_CACHE_SIZE - 1)];
+			if (entry->generation != s_losGeneration)
+			{
+				// Entries are never removed within a generation, so the first free slot ends the search.
+				freeEntry = entry;
+				break;
+			}
+			if (entry->startSector == startSector && entry->endSector == endSector && entry->exclWallFlags3 == exclWallFlags3 &&
+				entry->p0.x == p0.x && entry->p0.y == p0.y && entry->p0.z == p0.z && entry->p1.x == p1.x && entry->p1.y == p1.y && entry->p1.z == p1.z)
+			{
+				// A sector along the path changed since the result was computed, so compute it again in the same slot.
+				if (!losQuery_isEntryCurrent(entry))
+				{
+					staleEntry = entry;
+					break;
+				}
+				s_losTickHits++;
+				s_collision_wallHit = entry->wallHit;
+				return entry->result;
+			}
+		}
+
+		const JBool result = collision_canHitObject(startSector, endSector, p0, p1, exclWallFlags3);
+		// If the probe sequence is full or the path is too long to track, the result is simply not cached.
+		LosCacheEntry* entry = staleEntry ? staleEntry : freeEntry;
+		if (entry && s_collision_pathSectorCount <= COLLISION_MAX_PATH_SECTORS)
+		{
+			entry->generation = s_losGeneration;
+			entry->startSector = startSector;
+			entry->endSector = endSector;
+			entry->p0 = p0;
+			entry->p1 = p1;
+			entry->exclWallFlags3 = exclWallFlags3;
+			entry->result = result;
+			entry->wallHit = s_collision_wallHit;
+			entry->pathCount = s_collision_pathSectorCount;
+			for (s32 i = 0; i < s_collision_pathSectorCount; i++)
+			{
+				entry->pathSector[i] = s_collision_pathSectors[i]->index;
+				entry->pathStamp[i] = losQuery_getSectorStamp(entry->pathSector[i]);
+			}
+		}
+		else if (staleEntry)
+		{
+			// The stale result cannot be kept, but the slot must stay occupied so later probes still reach the entries after it.
+			staleEntry->pathCount = -1;
+		}
+		return result;
+	}
+}
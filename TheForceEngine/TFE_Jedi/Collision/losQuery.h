@@ -0,0 +1,34 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Line of Sight Queries
+// AI logic asks the same visibility questions many times per tick,
+// often more than once per actor. Queries go through this service,
+// which returns the same results as collision_canHitObject() but
+// caches them for the current tick.
+//
+// The cache is cleared when the tick changes and when a snapshot is
+// restored. When the geometry of a sector changes (heights, wall
+// positions, adjoins and wall flags), only the entries whose ray passed
+// through that sector become stale, see losQuery_invalidateSector().
+//
+// When r_pvsCull is enabled, sector pairs that cannot see each other
+// according to the level PVS (see levelPvs.h) fail without a ray test.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	// Register the performance counters.
+	void losQuery_init();
+
+	// Same result as collision_canHitObject(), including setting s_collision_wallHit.
+	JBool losQuery_canHit(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3);
+
+	// Clears the whole cache, call when the level changes.
+	void losQuery_invalidate();
+	// Call whenever the geometry of a sector changes in a way that can affect the result of a ray test.
+	void losQuery_invalidateSector(RSector* sector);
+}
@@ -3,6 +3,7 @@
 #include "infSystem.h"
 #include "message.h"
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Asset/dfKeywords.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/paths.h>
@@ -12,6 +13,8 @@
 #include <TFE_Jedi/Sound/soundSystem.h>
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelPvs.h>
+#include <TFE_Jedi/Collision/losQuery.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
 #include <TFE_System/memoryPool.h>
@@ -66,6 +69,15 @@ namespace TFE_Jedi
 	static char s_infArg4[256];
 	static char s_infArgExtra[256];
 	static Stop* s_nextStop;
+
+	// Game state captured by snapshots, INF elevators, triggers and teleports are in the level region.
+	SNAPSHOT_STATE(s_triggerCount);
+	SNAPSHOT_STATE(s_infElevators);
+	SNAPSHOT_STATE(s_infTeleports);
+	SNAPSHOT_STATE(s_infElevTask);
+	SNAPSHOT_STATE(s_infTriggerTask);
+	SNAPSHOT_STATE(s_teleportTask);
+	SNAPSHOT_STATE(s_nextStop);
 		
 	void inf_elevatorTaskFunc(MessageType msg);
 	void inf_telelporterTaskFunc(MessageType msg);
@@ -2200,6 +2212,11 @@ namespace TFE_Jedi
 		if (flagsIndex == 1)
 		{
 			wall->flags1 |= bits;
+			// The visible sets assume walls without this flag never move.
+			if (bits & WF1_WALL_MORPHS)
+			{
+				pvs_disable();
+			}
 
 			// If there is a mirror, also set some of the bits there.
 			RWall* mirror = wall->mirrorWall;
@@ -2217,11 +2234,13 @@ namespace TFE_Jedi
 		else if (flagsIndex == 3)
 		{
 			wall->flags3 |= bits;
+			losQuery_invalidateSector(wall->sector);
 
 			// If there is a mirror, also set some of the bits there.
 			RWall* mirror = wall->mirrorWall;
 			if (mirror)
 			{
+				losQuery_invalidateSector(mirror->sector);
 				mirror->flags3 |= (bits & 0x0f);
 			}
 		}
@@ -2250,11 +2269,13 @@ namespace TFE_Jedi
 		else if (flagsIndex == 3)
 		{
 			wall->flags3 &= ~bits;
+			losQuery_invalidateSector(wall->sector);
 
 			// If there is a mirror, also set some of the bits there.
 			RWall* mirror = wall->mirrorWall;
 			if (mirror)
 			{
+				losQuery_invalidateSector(mirror->sector);
 				mirror->flags3 &= ~(bits & 0x0f);
 			}
 		}
@@ -2994,6 +3015,9 @@ namespace TFE_Jedi
 
 				wall1->nextSector = sector0;
 				wall1->mirrorWall = wall0;
+				losQuery_invalidateSector(sector0);
+				losQuery_invalidateSector(sector1);
+				pvs_disable();
 
 				sector_setupWallDrawFlags(sector0);
 				sector_setupWallDrawFlags(sector1);
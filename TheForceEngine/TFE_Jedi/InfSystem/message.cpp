@@ -6,6 +6,8 @@
 #include <TFE_System/memoryPool.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Task/task.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_Game/igame.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_DarkForces/logic.h>
 #include <assert.h>
@@ -16,16 +18,82 @@
 
 namespace TFE_Jedi
 {
+	enum MessageAddressConstants
+	{
+		MSG_ADDR_NAME_LEN = 16,
+		MSG_ADDR_TABLE_MIN = 256,	// Must be a power of 2.
+	};
+
 	Allocator* s_messageAddr = nullptr;
+	// Open addressing hash table of the addresses by name (case insensitive), allocated from the level region.
+	static MessageAddress** s_msgAddrTable = nullptr;
+	static u32 s_msgAddrTableSize = 0;
+	static u32 s_msgAddrTableCount = 0;
 	void* s_msgEntity;
 	void* s_msgTarget;
 	u32 s_msgArg1;
 	u32 s_msgArg2;
 	u32 s_msgEvent;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_messageAddr);
+	SNAPSHOT_STATE(s_msgAddrTable);
+	SNAPSHOT_STATE(s_msgAddrTableSize);
+	SNAPSHOT_STATE(s_msgAddrTableCount);
+	SNAPSHOT_STATE(s_msgEntity);
+	SNAPSHOT_STATE(s_msgTarget);
+	SNAPSHOT_STATE(s_msgArg1);
+	SNAPSHOT_STATE(s_msgArg2);
+	SNAPSHOT_STATE(s_msgEvent);
+
+	// FNV-1a of the lower case name, only the characters that are compared are hashed.
+	static u32 message_hashName(const char* name)
+	{
+		u32 hash = 2166136261u;
+		for (s32 i = 0; i < MSG_ADDR_NAME_LEN && name[i]; i++)
+		{
+			hash = (hash ^ u8(tolower(name[i]))) * 16777619u;
+		}
+		return hash;
+	}
+
+	// Returns the table slot holding the name or the empty slot where it would be inserted.
+	static MessageAddress** message_findSlot(const char* name)
+	{
+		const u32 mask = s_msgAddrTableSize - 1;
+		u32 index = message_hashName(name) & mask;
+		while (s_msgAddrTable[index] && strncasecmp(name, s_msgAddrTable[index]->name, MSG_ADDR_NAME_LEN) != 0)
+		{
+			index = (index + 1) & mask;
+		}
+		return &s_msgAddrTable[index];
+	}
+
+	static void message_growTable()
+	{
+		MessageAddress** prevTable = s_msgAddrTable;
+		const u32 prevSize = s_msgAddrTableSize;
+
+		s_msgAddrTableSize = prevSize ? prevSize * 2 : u32(MSG_ADDR_TABLE_MIN);
+		s_msgAddrTable = (MessageAddress**)level_alloc(sizeof(MessageAddress*) * s_msgAddrTableSize);
+		memset(s_msgAddrTable, 0, sizeof(MessageAddress*) * s_msgAddrTableSize);
+		for (u32 i = 0; i < prevSize; i++)
+		{
+			if (prevTable[i])
+			{
+				*message_findSlot(prevTable[i]->name) = prevTable[i];
+			}
+		}
+		level_free(prevTable);
+	}
+
 	void message_free()
 	{
+		// The memory belongs to the level region, which is freed with the level.
 		s_messageAddr = nullptr;
+		s_msgAddrTable = nullptr;
+		s_msgAddrTableSize = 0;
+		s_msgAddrTableCount = 0;
 	}
 
 	void message_addAddress(const char* name, s32 param0, s32 param1, RSector* sector)
@@ -42,18 +110,27 @@ namespace TFE_Jedi
 		msgAddr->param0 = param0;
 		msgAddr->param1 = param1;
 		msgAddr->sector = sector;
+
+		// Keep the load factor at or below 1/2.
+		if ((s_msgAddrTableCount + 1) * 2 > s_msgAddrTableSize)
+		{
+			message_growTable();
+		}
+		// If several sectors share a name, the first one added is used.
+		MessageAddress** slot = message_findSlot(msgAddr->name);
+		if (!*slot)
+		{
+			*slot = msgAddr;
+			s_msgAddrTableCount++;
+		}
 	}
 
 	MessageAddress* message_getAddress(const char* name)
 	{
-		MessageAddress* msgAddr = (MessageAddress*)allocator_getHead(s_messageAddr);
-		while (msgAddr)
+		MessageAddress* msgAddr = s_msgAddrTable ? *message_findSlot(name) : nullptr;
+		if (msgAddr)
 		{
-			if (strncasecmp(name, msgAddr->name, 16) == 0)
-			{
-				return msgAddr;
-			}
-			msgAddr = (MessageAddress*)allocator_getNext(s_messageAddr);
+			return msgAddr;
 		}
 
 		TFE_System::logWrite(LOG_ERROR, "INF", "Message_GetAddress: ADDRESS NOT FOUND: %s", name);
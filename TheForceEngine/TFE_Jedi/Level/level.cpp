@@ -2,9 +2,12 @@
 #include <cstring>
 
 #include "level.h"
+#include "levelCache.h"
+#include "levelPvs.h"
 #include "rwall.h"
 #include "rtexture.h"
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_Asset/assetSystem.h>
 #include <TFE_Asset/dfKeywords.h>
 #include <TFE_Asset/modelAsset_jedi.h>
@@ -15,9 +18,11 @@
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
 
+#include <TFE_Jedi/Collision/losQuery.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/infTypesInternal.h>
 #include <TFE_Jedi/InfSystem/message.h>
+#include <TFE_Jedi/Renderer/rspriteCache.h>
 
 // TODO: Fix game dependency?
 #include <TFE_DarkForces/logic.h>
@@ -54,6 +59,13 @@ namespace TFE_Jedi
 
 	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+
+	// Parsed level geometry, see levelCache.h
+	static std::vector<u32> s_geoTextureNames;
+	static std::vector<LevelCacheSector> s_geoSectors;
+	static std::vector<vec2_fixed> s_geoVertices;
+	static std::vector<LevelCacheWall> s_geoWalls;
+	static std::vector<char> s_geoStrings;
 	
 	s32 s_minLayer;
 	s32 s_maxLayer;
@@ -68,7 +80,39 @@ namespace TFE_Jedi
 	fixed16_16 s_parallax0;
 	fixed16_16 s_parallax1;
 
+	// Game state captured by snapshots.
+	SNAPSHOT_STATE(s_complete);
+	SNAPSHOT_STATE(s_completeNum);
+	SNAPSHOT_STATE(s_textureCount);
+	SNAPSHOT_STATE(s_podCount);
+	SNAPSHOT_STATE(s_spriteCount);
+	SNAPSHOT_STATE(s_fmeCount);
+	SNAPSHOT_STATE(s_soundCount);
+	SNAPSHOT_STATE(s_objectCount);
+	SNAPSHOT_STATE(s_textures);
+	SNAPSHOT_STATE(s_soundEmitters);
+	SNAPSHOT_STATE(s_safeLoc);
+	SNAPSHOT_STATE(s_pods);
+	SNAPSHOT_STATE(s_sprites);
+	SNAPSHOT_STATE(s_frames);
+	SNAPSHOT_STATE(s_soundIds);
+	SNAPSHOT_STATE(s_soundEmitterTask);
+	SNAPSHOT_STATE(s_minLayer);
+	SNAPSHOT_STATE(s_maxLayer);
+	SNAPSHOT_STATE(s_secretCount);
+	SNAPSHOT_STATE(s_sectorCount);
+	SNAPSHOT_STATE(s_bossSector);
+	SNAPSHOT_STATE(s_mohcSector);
+	SNAPSHOT_STATE(s_controlSector);
+	SNAPSHOT_STATE(s_completeSector);
+	SNAPSHOT_STATE(s_sectors);
+	SNAPSHOT_STATE(s_parallax0);
+	SNAPSHOT_STATE(s_parallax1);
+
 	JBool level_loadGeometry(const char* levelName);
+	JBool level_parseGeometry(LevelGeometry* geo);
+	JBool level_buildGeometry(const LevelGeometry* geo);
+	void  level_freeParsedGeometry();
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
 	JBool level_loadGoals(const char* levelName);
 
@@ -82,6 +126,10 @@ namespace TFE_Jedi
 		s_mohcSector       = nullptr;
 
 		s_sectors  = nullptr;
+		sector_clearSpatialIndex();
+		pvs_clear();
+		losQuery_invalidate();
+		spriteCache_clear();
 		s_pods     = nullptr;
 		s_sprites  = nullptr;
 		s_frames   = nullptr;
@@ -153,6 +201,86 @@ namespace TFE_Jedi
 		file.readBuffer(s_buffer.data(), u32(len));
 		file.close();
 
+		// TFE: Use the cached binary image if it matches the source, otherwise parse the level and cache the results.
+		LevelGeometry geo;
+		if (!levelCache_read(levelName, s_buffer.data(), s_buffer.size(), &geo))
+		{
+			if (!level_parseGeometry(&geo)) { return false; }
+			levelCache_write(levelName, s_buffer.data(), s_buffer.size(), &geo);
+		}
+
+		const JBool result = level_buildGeometry(&geo);
+		levelCache_free();
+		// TFE: Sets of the sectors that can see each other, cached with the geometry.
+		if (result)
+		{
+			pvs_load(levelName, s_buffer.data(), s_buffer.size());
+		}
+		level_freeParsedGeometry();
+		return result;
+	}
+
+	static u32 addParsedString(const char* str)
+	{
+		const u32 offset = u32(s_geoStrings.size());
+		s_geoStrings.insert(s_geoStrings.end(), str, str + strlen(str) + 1);
+		return offset;
+	}
+
+	// Token layout of the wall lines: labels, "%d" for integers and "%f" for floats.
+	static const char* c_wallLayout[] =
+	{
+		"WALL", "LEFT:", "%d", "RIGHT:", "%d", "MID:", "%d", "%f", "%f", "%d", "TOP:", "%d", "%f", "%f", "%d", "BOT:", "%d", "%f", "%f", "%d",
+		"SIGN:", "%d", "%f", "%f", "ADJOIN:", "%d", "MIRROR:", "%d", "WALK:", "%d", "FLAGS:", "%d", "%d", "%d", "LIGHT:", "%d"
+	};
+
+	// The vertex and wall lines make up most of the level text, so they are tokenized and the fields parsed directly
+	// instead of using sscanf(). Returns false if the line does not match the layout exactly, in which case the caller
+	// falls back to sscanf() so unusual formatting is still handled the same way.
+	static bool level_parseFieldTokens(TFE_Parser& parser, const char* line, const char** layout, s32 layoutCount, void** fields)
+	{
+		const TokenView* tokens;
+		if (parser.tokenizeLine(line, &tokens) != layoutCount)
+		{
+			return false;
+		}
+
+		s32 fieldIndex = 0;
+		for (s32 t = 0; t < layoutCount; t++)
+		{
+			const char* entry = layout[t];
+			if (entry[0] != '%')
+			{
+				if (strcmp(tokens[t].str, entry)) { return false; }
+			}
+			else if (entry[1] == 'd')
+			{
+				if (!TFE_Parser::parseS32(tokens[t].str, (s32*)fields[fieldIndex++])) { return false; }
+			}
+			else if (!TFE_Parser::parseF32(tokens[t].str, (f32*)fields[fieldIndex++]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool level_parseVertexTokens(TFE_Parser& parser, const char* line, f32* x, f32* z)
+	{
+		static const char* c_vertexLayout[] = { "X:", "%f", "Z:", "%f" };
+		void* fields[] = { x, z };
+		return level_parseFieldTokens(parser, line, c_vertexLayout, s32(TFE_ARRAYSIZE(c_vertexLayout)), fields);
+	}
+
+	// Parse the level geometry in s_buffer, the results are stored in the s_geo* arrays.
+	JBool level_parseGeometry(LevelGeometry* geo)
+	{
+		s_geoTextureNames.clear();
+		s_geoSectors.clear();
+		s_geoVertices.clear();
+		s_geoWalls.clear();
+		s_geoStrings.clear();
+
 		TFE_Parser parser;
 		size_t bufferPos = 0;
 		parser.init(s_buffer.data(), s_buffer.size());
@@ -160,6 +288,8 @@ namespace TFE_Jedi
 		parser.addCommentString("#");
 		parser.addCommentString("//");
 		parser.convertToUpperCase(true);
+		// Keep labels such as "LEFT:" separate from the values for the tokenized vertex and wall lines.
+		parser.enableColonSeperator();
 
 		// Only use the parser "read line" functionality and otherwise read in the same was as the DOS code.
 		const char* line;
@@ -209,21 +339,20 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read parallax values.");
 			return false;
 		}
-		s_parallax0 = floatToFixed16(parallax0);
-		s_parallax1 = floatToFixed16(parallax1);
+		geo->parallax0 = floatToFixed16(parallax0);
+		geo->parallax1 = floatToFixed16(parallax1);
 
 		// Number of textures used by the level.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, "TEXTURES %d", &s_textureCount) != 1)
+		s32 textureCount;
+		if (sscanf(line, "TEXTURES %d", &textureCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture count.");
 			return false;
 		}
-		s_textures = (TextureData**)res_alloc(s_textureCount * sizeof(TextureData**));
 
-		// Load Textures.
-		TextureData** texture = s_textures;
-		for (s32 i = 0; i < s_textureCount; i++, texture++)
+		// Texture names.
+		for (s32 i = 0; i < textureCount; i++)
 		{
 			line = parser.readLine(bufferPos);
 			char textureName[256];
@@ -232,53 +361,22 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture name.");
 				textureName[0] = 0;
 			}
-
-			// If <NoTexture> is found, do not try to load - this will cause the default texture to be used.
-			TextureData* tex = nullptr;
-			if (strcasecmp(textureName, "<NoTexture>"))
-			{
-				if (TFE_Paths::getFilePath(textureName, &filePath))
-				{
-					tex = bitmap_load(&filePath, 1);
-				}
-			}
-
-			if (!tex)
-			{
-				TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
-
-				TFE_Paths::getFilePath("default.bm", &filePath);
-				tex = bitmap_load(&filePath, 1);
-				if (!tex)
-				{
-					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
-					return false;
-				}
-			}
-			*texture = tex;
-
-			// Setup an animated texture.
-			if (tex->uvWidth == BM_ANIMATED_TEXTURE)
-			{
-				bitmap_setupAnimatedTexture(texture);
-			}
+			s_geoTextureNames.push_back(addParsedString(textureName));
 		}
 
-		// Load Sectors.
+		// Sectors.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, "NUMSECTORS %d", &s_sectorCount) != 1)
+		s32 sectorCount;
+		if (sscanf(line, "NUMSECTORS %d", &sectorCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector count.");
 			return false;
 		}
 
-		s_sectors = (RSector*)level_alloc(sizeof(RSector) * s_sectorCount);
-		memset(s_sectors, 0, sizeof(RSector) * s_sectorCount);
-		for (u32 i = 0; i < s_sectorCount; i++)
+		s_geoSectors.resize(sectorCount);
+		for (s32 i = 0; i < sectorCount; i++)
 		{
-			RSector* sector = &s_sectors[i];
-			sector_clear(sector);
-			sector->index = i;
+			LevelCacheSector* sector = &s_geoSectors[i];
 
 			// Sector ID and Name
 			line = parser.readLine(bufferPos);
@@ -289,26 +387,10 @@ namespace TFE_Jedi
 			}
 
 			line = parser.readLine(bufferPos);
-			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
-			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
+			sector->nameOffset = LEVEL_CACHE_NO_NAME;
 			if (sscanf(line, " NAME %s", name) == 1)
 			{
-				// Add the sector "address" for later use by the INF system.
-				message_addAddress(name, 0, 0, sector);
-
-				// Track special elevators.
-				if (!strcasecmp(name, "complete"))
-				{
-					s_completeSector = sector;
-				}
-				else if (!strcasecmp(name, "boss"))
-				{
-					s_bossSector = sector;
-				}
-				else if (!strcasecmp(name, "mohc"))
-				{
-					s_mohcSector = sector;
-				}
+				sector->nameOffset = addParsedString(name);
 			}
 
 			// Lighting
@@ -323,19 +405,13 @@ namespace TFE_Jedi
 
 			// Floor Texture & Offset
 			line = parser.readLine(bufferPos);
-			s32 index, tmp;
+			s32 tmp;
 			f32 offsetX, offsetZ;
-			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &sector->floorTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor texture.");
 				return false;
 			}
-
-			sector->floorTex = nullptr;
-			if (index != -1)
-			{
-				sector->floorTex = &s_textures[index];
-			}
 			sector->floorOffset.x = floatToFixed16(offsetX);
 			sector->floorOffset.z = floatToFixed16(offsetZ);
 
@@ -351,16 +427,11 @@ namespace TFE_Jedi
 
 			// Ceiling Texture & Offset
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &sector->ceilTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling texture.");
 				return false;
 			}
-			sector->ceilTex = nullptr;
-			if (index != -1)
-			{
-				sector->ceilTex = &s_textures[index];
-			}
 			sector->ceilOffset.x = floatToFixed16(offsetX);
 			sector->ceilOffset.z = floatToFixed16(offsetZ);
 
@@ -371,7 +442,7 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling altitude.");
 				return false;
 			}
-			sector->ceilingHeight = floatToFixed16(alt);
+			sector->ceilHeight = floatToFixed16(alt);
 
 			// Second Altitude
 			line = parser.readLine(bufferPos);
@@ -389,22 +460,6 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector flags.");
 				return false;
 			}
-			// Create a door if needed.
-			if (sector->flags1 & SEC_FLAGS1_DOOR)
-			{
-				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
-				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
-			}
-			// Create an exploding wall if needed.
-			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
-			{
-				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
-			}
-			// Add secrets.
-			if (sector->flags1 & SEC_FLAGS1_SECRET)
-			{
-				s_secretCount++;
-			}
 
 			// Layer
 			line = parser.readLine(bufferPos);
@@ -413,8 +468,6 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
 				return false;
 			}
-			s_minLayer = min(s_minLayer, sector->layer);
-			s_maxLayer = max(s_maxLayer, sector->layer);
 
 			// Vertices
 			line = parser.readLine(bufferPos);
@@ -424,19 +477,18 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
 				return false;
 			}
-			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
-			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
-			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->vertexStart = u32(s_geoVertices.size());
 			sector->vertexCount = vertexCount;
-
 			for (s32 v = 0; v < vertexCount; v++)
 			{
 				line = parser.readLine(bufferPos);
 
-				f32 x, z;
-				sscanf(line, " X: %f Z: %f", &x, &z);
-				sector->verticesWS[v].x = floatToFixed16(x);
-				sector->verticesWS[v].z = floatToFixed16(z);
+				f32 x = 0.0f, z = 0.0f;
+				if (!level_parseVertexTokens(parser, line, &x, &z))
+				{
+					sscanf(line, " X: %f Z: %f", &x, &z);
+				}
+				s_geoVertices.push_back({ floatToFixed16(x), floatToFixed16(z) });
 			}
 
 			// Walls
@@ -447,96 +499,246 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
 				return false;
 			}
-			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
+			sector->wallStart = u32(s_geoWalls.size());
 			sector->wallCount = wallCount;
 
 			for (s32 w = 0; w < wallCount; w++)
 			{
-				s32 light, flags3, flags2, flags1, walk, mirror, adjoin;
-				s32 signTex, unused;
-				s32 botTex, topTex, midTex, right, left;
+				s32 walk, unused;
 				f32 signOffsetZ, signOffsetX;
 				f32 botOffsetZ, botOffsetX;
 				f32 topOffsetZ, topOffsetX;
 				f32 midOffsetZ, midOffsetX;
+				LevelCacheWall wall;
 
 				line = parser.readLine(bufferPos);
-				if (sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
-					&left, &right, &midTex, &midOffsetX, &midOffsetZ, &unused, &topTex, &topOffsetX, &topOffsetZ, &unused, &botTex, &botOffsetX, &botOffsetZ, &unused,
-					&signTex, &signOffsetX, &signOffsetZ, &adjoin, &mirror, &walk, &flags1, &flags2, &flags3, &light) != 24)
+				void* wallFields[] = { &wall.left, &wall.right, &wall.midTex, &midOffsetX, &midOffsetZ, &unused, &wall.topTex, &topOffsetX, &topOffsetZ, &unused,
+					&wall.botTex, &botOffsetX, &botOffsetZ, &unused, &wall.signTex, &signOffsetX, &signOffsetZ, &wall.adjoin, &wall.mirror, &walk,
+					&wall.flags1, &wall.flags2, &wall.flags3, &wall.light };
+				if (!level_parseFieldTokens(parser, line, c_wallLayout, s32(TFE_ARRAYSIZE(c_wallLayout)), wallFields) &&
+					sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
+					&wall.left, &wall.right, &wall.midTex, &midOffsetX, &midOffsetZ, &unused, &wall.topTex, &topOffsetX, &topOffsetZ, &unused, &wall.botTex, &botOffsetX, &botOffsetZ, &unused,
+					&wall.signTex, &signOffsetX, &signOffsetZ, &wall.adjoin, &wall.mirror, &walk, &wall.flags1, &wall.flags2, &wall.flags3, &wall.light) != 24)
 				{
 					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
 					return false;
 				}
+				if (wall.left < 0 || wall.left >= vertexCount || wall.right < 0 || wall.right >= vertexCount)
+				{
+					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Invalid wall vertex in sector %d.", i);
+					return false;
+				}
+				wall.midOffset  = { floatToFixed16(midOffsetX) * 8,  floatToFixed16(midOffsetZ) * 8 };
+				wall.topOffset  = { floatToFixed16(topOffsetX) * 8,  floatToFixed16(topOffsetZ) * 8 };
+				wall.botOffset  = { floatToFixed16(botOffsetX) * 8,  floatToFixed16(botOffsetZ) * 8 };
+				wall.signOffset = { floatToFixed16(signOffsetX) * 8, floatToFixed16(signOffsetZ) * 8 };
+				s_geoWalls.push_back(wall);
+			}
+		}
+
+		geo->textureCount = u32(s_geoTextureNames.size());
+		geo->sectorCount  = u32(s_geoSectors.size());
+		geo->vertexCount  = u32(s_geoVertices.size());
+		geo->wallCount    = u32(s_geoWalls.size());
+		geo->stringSize   = u32(s_geoStrings.size());
+		geo->textureNames = s_geoTextureNames.data();
+		geo->sectors      = s_geoSectors.data();
+		geo->vertices     = s_geoVertices.data();
+		geo->walls        = s_geoWalls.data();
+		geo->strings      = s_geoStrings.data();
+		return true;
+	}
+
+	void level_freeParsedGeometry()
+	{
+		s_geoTextureNames.clear();
+		s_geoSectors.clear();
+		s_geoVertices.clear();
+		s_geoWalls.clear();
+		s_geoStrings.clear();
+	}
+
+	// Build the level from the parsed geometry, which either comes from the text or the level cache.
+	JBool level_buildGeometry(const LevelGeometry* geo)
+	{
+		s_parallax0 = geo->parallax0;
+		s_parallax1 = geo->parallax1;
+
+		s_textureCount = s32(geo->textureCount);
+		s_textures = (TextureData**)res_alloc(s_textureCount * sizeof(TextureData**));
+
+		// Load Textures.
+		FilePath filePath;
+		TextureData** texture = s_textures;
+		for (s32 i = 0; i < s_textureCount; i++, texture++)
+		{
+			const char* textureName = geo->strings + geo->textureNames[i];
+
+			// If <NoTexture> is found, do not try to load - this will cause the default texture to be used.
+			TextureData* tex = nullptr;
+			if (strcasecmp(textureName, "<NoTexture>"))
+			{
+				if (TFE_Paths::getFilePath(textureName, &filePath))
+				{
+					tex = bitmap_load(&filePath, 1);
+				}
+			}
 
+			if (!tex)
+			{
+				TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
+
+				TFE_Paths::getFilePath("default.bm", &filePath);
+				tex = bitmap_load(&filePath, 1);
+				if (!tex)
+				{
+					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
+					return false;
+				}
+			}
+			*texture = tex;
+
+			// Setup an animated texture.
+			if (tex->uvWidth == BM_ANIMATED_TEXTURE)
+			{
+				bitmap_setupAnimatedTexture(texture);
+			}
+		}
+
+		// Load Sectors.
+		s_sectorCount = geo->sectorCount;
+		s_sectors = (RSector*)level_alloc(sizeof(RSector) * s_sectorCount);
+		memset(s_sectors, 0, sizeof(RSector) * s_sectorCount);
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			const LevelCacheSector* src = &geo->sectors[i];
+			RSector* sector = &s_sectors[i];
+			sector_clear(sector);
+			sector->index = i;
+			sector->id = src->id;
+
+			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
+			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
+			if (src->nameOffset != LEVEL_CACHE_NO_NAME)
+			{
+				const char* name = geo->strings + src->nameOffset;
+				// Add the sector "address" for later use by the INF system.
+				message_addAddress(name, 0, 0, sector);
+
+				// Track special elevators.
+				if (!strcasecmp(name, "complete"))
+				{
+					s_completeSector = sector;
+				}
+				else if (!strcasecmp(name, "boss"))
+				{
+					s_bossSector = sector;
+				}
+				else if (!strcasecmp(name, "mohc"))
+				{
+					s_mohcSector = sector;
+				}
+			}
+
+			// Lighting
+			sector->ambient = src->ambient;
+
+			// Floor
+			sector->floorTex = (src->floorTex != -1) ? &s_textures[src->floorTex] : nullptr;
+			sector->floorOffset = src->floorOffset;
+			sector->floorHeight = src->floorHeight;
+
+			// Ceiling
+			sector->ceilTex = (src->ceilTex != -1) ? &s_textures[src->ceilTex] : nullptr;
+			sector->ceilOffset = src->ceilOffset;
+			sector->ceilingHeight = src->ceilHeight;
+			sector->secHeight = src->secHeight;
+
+			// Sector flags
+			sector->flags1 = src->flags1;
+			sector->flags2 = src->flags2;
+			sector->flags3 = src->flags3;
+			// Create a door if needed.
+			if (sector->flags1 & SEC_FLAGS1_DOOR)
+			{
+				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
+				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
+			}
+			// Create an exploding wall if needed.
+			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
+			{
+				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
+			}
+			// Add secrets.
+			if (sector->flags1 & SEC_FLAGS1_SECRET)
+			{
+				s_secretCount++;
+			}
+
+			// Layer
+			sector->layer = src->layer;
+			s_minLayer = min(s_minLayer, sector->layer);
+			s_maxLayer = max(s_maxLayer, sector->layer);
+
+			// Vertices
+			const size_t vtxSize = src->vertexCount * sizeof(vec2_fixed);
+			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->vertexCount = src->vertexCount;
+			memcpy(sector->verticesWS, geo->vertices + src->vertexStart, vtxSize);
+
+			// Walls
+			sector->walls = (RWall*)level_alloc(src->wallCount * sizeof(RWall));
+			sector->wallCount = src->wallCount;
+
+			const LevelCacheWall* srcWall = geo->walls + src->wallStart;
+			for (s32 w = 0; w < sector->wallCount; w++, srcWall++)
+			{
 				RWall* wall = &sector->walls[w];
 				wall->id = w;
 				wall->sector = sector;
 				wall->mirrorWall = nullptr;
 				wall->seen = JFALSE;
-				wall->flags1 = flags1;
-				wall->flags2 = flags2;
-				wall->flags3 = flags3;
+				wall->flags1 = srcWall->flags1;
+				wall->flags2 = srcWall->flags2;
+				wall->flags3 = srcWall->flags3;
 
-				vec2_fixed* leftVtxWS = &sector->verticesWS[left];
-				vec2_fixed* rightVtxWS = &sector->verticesWS[right];
+				vec2_fixed* leftVtxWS = &sector->verticesWS[srcWall->left];
+				vec2_fixed* rightVtxWS = &sector->verticesWS[srcWall->right];
 				wall->w0 = leftVtxWS;
 				wall->w1 = rightVtxWS;
-				wall->v0 = &sector->verticesVS[left];
-				wall->v1 = &sector->verticesVS[right];
+				wall->v0 = &sector->verticesVS[srcWall->left];
+				wall->v1 = &sector->verticesVS[srcWall->right];
 				// Store the original position 0 in the wall since it is used by the sector rotation INF.
 				wall->worldPos0.x = leftVtxWS->x;
 				wall->worldPos0.z = leftVtxWS->z;
 
 				wall->nextSector = nullptr;
 				wall->mirror = -1;
-				if (adjoin != -1)
+				if (srcWall->adjoin != -1)
 				{
-					wall->nextSector = &s_sectors[adjoin];
-					if (mirror == -1)
+					wall->nextSector = &s_sectors[srcWall->adjoin];
+					if (srcWall->mirror == -1)
 					{
 						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Adjoining wall missing mirror.");
 					}
-					wall->mirror = mirror;
+					wall->mirror = srcWall->mirror;
 				}
 
 				wall->infLink = nullptr;
 				wall->collisionFrame = 0;
 				wall->drawFrame = 0;
 				wall->drawFlags = 0;
-				wall->wallLight = intToFixed16(light);
+				wall->wallLight = intToFixed16(srcWall->light);
 
-				wall->midTex = nullptr;
-				if (midTex != -1)
-				{
-					wall->midTex = &s_textures[midTex];
-					wall->midOffset.x = floatToFixed16(midOffsetX) * 8;
-					wall->midOffset.z = floatToFixed16(midOffsetZ) * 8;
-				}
-
-				wall->topTex = nullptr;
-				if (topTex != -1)
-				{
-					wall->topTex = &s_textures[topTex];
-					wall->topOffset.x = floatToFixed16(topOffsetX) * 8;
-					wall->topOffset.z = floatToFixed16(topOffsetZ) * 8;
-				}
-
-				wall->botTex = nullptr;
-				if (botTex != -1)
-				{
-					wall->botTex = &s_textures[botTex];
-					wall->botOffset.x = floatToFixed16(botOffsetX) * 8;
-					wall->botOffset.z = floatToFixed16(botOffsetZ) * 8;
-				}
-
-				wall->signTex = nullptr;
-				if (signTex != -1)
-				{
-					wall->signTex = &s_textures[signTex];
-					wall->signOffset.x = floatToFixed16(signOffsetX) * 8;
-					wall->signOffset.z = floatToFixed16(signOffsetZ) * 8;
-				}
+				wall->midTex  = (srcWall->midTex  != -1) ? &s_textures[srcWall->midTex]  : nullptr;
+				wall->topTex  = (srcWall->topTex  != -1) ? &s_textures[srcWall->topTex]  : nullptr;
+				wall->botTex  = (srcWall->botTex  != -1) ? &s_textures[srcWall->botTex]  : nullptr;
+				wall->signTex = (srcWall->signTex != -1) ? &s_textures[srcWall->signTex] : nullptr;
+				wall->midOffset  = srcWall->midOffset;
+				wall->topOffset  = srcWall->topOffset;
+				wall->botOffset  = srcWall->botOffset;
+				wall->signOffset = srcWall->signOffset;
 
 				fixed16_16 dx = rightVtxWS->x - leftVtxWS->x;
 				fixed16_16 dz = rightVtxWS->z - leftVtxWS->z;
@@ -570,6 +772,8 @@ namespace TFE_Jedi
 			// TFE: Added to support non-fixed-point rendering.
 			sector->dirtyFlags = SDF_ALL;
 		}
+		// TFE: Added to speed up sector queries in large levels.
+		sector_buildSpatialIndex();
 
 		return true;
 	}
@@ -578,6 +782,7 @@ namespace TFE_Jedi
 	{
 		TFE_Sprite_Jedi::freeAll();
 		TFE_Model_Jedi::freeAll();
+		spriteCache_clear();
 	}
 
 	JBool level_isGoalComplete(s32 goalIndex)
@@ -0,0 +1,279 @@
+#include <cstring>
+
+#include "levelCache.h"
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/system.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	enum
+	{
+		LEVEL_CACHE_MAGIC   = 0x434c4654,	// "TFLC"
+		// Increment whenever the image layout or the values stored change.
+		LEVEL_CACHE_VERSION = 1,
+
+		LEVEL_PVS_MAGIC     = 0x56504654,	// "TFPV"
+		// Increment whenever the way the sets are built changes.
+		LEVEL_PVS_VERSION   = 2,
+	};
+
+	static const u64 c_fnvOffset = 0xcbf29ce484222325ull;
+	static const u64 c_fnvPrime  = 0x100000001b3ull;
+
+	struct LevelCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 sourceSize;
+		u64 sourceHash;
+		u64 payloadHash;
+		u32 payloadSize;
+
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+		u32 textureCount;
+		u32 sectorCount;
+		u32 vertexCount;
+		u32 wallCount;
+		u32 stringSize;
+	};
+
+	struct LevelPvsHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 sourceSize;
+		u64 sourceHash;
+		u64 payloadHash;
+		u32 sectorCount;
+		u32 rowWords;
+	};
+
+	static std::vector<u8> s_image;
+
+	static u64 hashData(u64 hash, const void* data, size_t size)
+	{
+		const u8* bytes = (const u8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * c_fnvPrime;
+		}
+		return hash;
+	}
+
+	static void getCachePath(const char* levelName, const char* ext, char* path)
+	{
+		char cacheDir[TFE_MAX_PATH];
+		snprintf(cacheDir, TFE_MAX_PATH, "%sLevelCache/", TFE_Paths::getPath(PATH_PROGRAM_DATA));
+		if (!FileUtil::directoryExits(cacheDir))
+		{
+			FileUtil::makeDirectory(cacheDir);
+		}
+		snprintf(path, TFE_MAX_PATH, "%s%s.%s", cacheDir, levelName, ext);
+	}
+
+	// Sizes of the payload arrays, in the order they are stored.
+	static void getArraySizes(const LevelCacheHeader* header, u32* sizes)
+	{
+		sizes[0] = header->textureCount * sizeof(u32);
+		sizes[1] = header->sectorCount * sizeof(LevelCacheSector);
+		sizes[2] = header->vertexCount * sizeof(vec2_fixed);
+		sizes[3] = header->wallCount * sizeof(LevelCacheWall);
+		sizes[4] = header->stringSize;
+	}
+
+	JBool levelCache_read(const char* levelName, const void* source, size_t sourceSize, LevelGeometry* geo)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(levelName, "LVC", path);
+
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_READ))
+		{
+			return JFALSE;
+		}
+		const size_t fileSize = file.getSize();
+		LevelCacheHeader header;
+		if (fileSize < sizeof(LevelCacheHeader) || file.readBuffer(&header, sizeof(LevelCacheHeader)) != sizeof(LevelCacheHeader))
+		{
+			return JFALSE;
+		}
+		if (header.magic != LEVEL_CACHE_MAGIC || header.version != LEVEL_CACHE_VERSION || header.sourceSize != sourceSize ||
+			header.payloadSize != fileSize - sizeof(LevelCacheHeader))
+		{
+			return JFALSE;
+		}
+		// Only hash the source once the cheaper checks pass.
+		if (header.sourceHash != hashData(c_fnvOffset, source, sourceSize))
+		{
+			return JFALSE;
+		}
+
+		u32 sizes[5];
+		getArraySizes(&header, sizes);
+		size_t payloadSize = 0;
+		for (s32 i = 0; i < 5; i++)
+		{
+			payloadSize += sizes[i];
+		}
+		if (payloadSize != header.payloadSize)
+		{
+			return JFALSE;
+		}
+
+		s_image.resize(payloadSize);
+		if (file.readBuffer(s_image.data(), u32(payloadSize)) != payloadSize || hashData(c_fnvOffset, s_image.data(), payloadSize) != header.payloadHash)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "The cached level '%s' is corrupt, parsing the level instead.", levelName);
+			return JFALSE;
+		}
+		file.close();
+
+		// Fix up the array pointers, the image is used in place.
+		const u8* data = s_image.data();
+		geo->parallax0    = header.parallax0;
+		geo->parallax1    = header.parallax1;
+		geo->textureCount = header.textureCount;
+		geo->sectorCount  = header.sectorCount;
+		geo->vertexCount  = header.vertexCount;
+		geo->wallCount    = header.wallCount;
+		geo->stringSize   = header.stringSize;
+		geo->textureNames = (const u32*)data;              data += sizes[0];
+		geo->sectors      = (const LevelCacheSector*)data; data += sizes[1];
+		geo->vertices     = (const vec2_fixed*)data;       data += sizes[2];
+		geo->walls        = (const LevelCacheWall*)data;   data += sizes[3];
+		geo->strings      = (const char*)data;
+
+		// Validate the indices, so a stale image built by a different version cannot crash the loader.
+		for (u32 t = 0; t < geo->textureCount; t++)
+		{
+			if (geo->textureNames[t] >= geo->stringSize) { return JFALSE; }
+		}
+		for (u32 s = 0; s < geo->sectorCount; s++)
+		{
+			const LevelCacheSector* sector = &geo->sectors[s];
+			if ((sector->nameOffset != LEVEL_CACHE_NO_NAME && sector->nameOffset >= geo->stringSize) ||
+				sector->vertexStart + sector->vertexCount > geo->vertexCount || sector->wallStart + sector->wallCount > geo->wallCount)
+			{
+				return JFALSE;
+			}
+		}
+		if (geo->stringSize && geo->strings[geo->stringSize - 1] != 0)
+		{
+			return JFALSE;
+		}
+		return JTRUE;
+	}
+
+	void levelCache_write(const char* levelName, const void* source, size_t sourceSize, const LevelGeometry* geo)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(levelName, "LVC", path);
+
+		LevelCacheHeader header = {};
+		header.magic        = LEVEL_CACHE_MAGIC;
+		header.version      = LEVEL_CACHE_VERSION;
+		header.sourceSize   = sourceSize;
+		header.sourceHash   = hashData(c_fnvOffset, source, sourceSize);
+		header.parallax0    = geo->parallax0;
+		header.parallax1    = geo->parallax1;
+		header.textureCount = geo->textureCount;
+		header.sectorCount  = geo->sectorCount;
+		header.vertexCount  = geo->vertexCount;
+		header.wallCount    = geo->wallCount;
+		header.stringSize   = geo->stringSize;
+
+		u32 sizes[5];
+		getArraySizes(&header, sizes);
+		const void* arrays[5] = { geo->textureNames, geo->sectors, geo->vertices, geo->walls, geo->strings };
+
+		u64 payloadHash = c_fnvOffset;
+		for (s32 i = 0; i < 5; i++)
+		{
+			payloadHash = hashData(payloadHash, arrays[i], sizes[i]);
+			header.payloadSize += sizes[i];
+		}
+		header.payloadHash = payloadHash;
+
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cannot write the cached level '%s'.", path);
+			return;
+		}
+		file.writeBuffer(&header, sizeof(LevelCacheHeader));
+		for (s32 i = 0; i < 5; i++)
+		{
+			if (sizes[i]) { file.writeBuffer(arrays[i], sizes[i]); }
+		}
+		file.close();
+	}
+
+	JBool levelCache_readPvs(const char* levelName, const void* source, size_t sourceSize, u32 sectorCount, u32 rowWords, u32* bits)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(levelName, "PVS", path);
+
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_READ))
+		{
+			return JFALSE;
+		}
+		const size_t payloadSize = sizeof(u32) * rowWords * sectorCount;
+		LevelPvsHeader header;
+		if (file.getSize() != sizeof(LevelPvsHeader) + payloadSize || file.readBuffer(&header, sizeof(LevelPvsHeader)) != sizeof(LevelPvsHeader))
+		{
+			return JFALSE;
+		}
+		if (header.magic != LEVEL_PVS_MAGIC || header.version != LEVEL_PVS_VERSION || header.sourceSize != sourceSize ||
+			header.sectorCount != sectorCount || header.rowWords != rowWords)
+		{
+			return JFALSE;
+		}
+		if (header.sourceHash != hashData(c_fnvOffset, source, sourceSize))
+		{
+			return JFALSE;
+		}
+		if (file.readBuffer(bits, u32(payloadSize)) != payloadSize || hashData(c_fnvOffset, bits, payloadSize) != header.payloadHash)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "The cached visible sets for '%s' are corrupt, building them instead.", levelName);
+			return JFALSE;
+		}
+		return JTRUE;
+	}
+
+	void levelCache_writePvs(const char* levelName, const void* source, size_t sourceSize, u32 sectorCount, u32 rowWords, const u32* bits)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(levelName, "PVS", path);
+
+		const size_t payloadSize = sizeof(u32) * rowWords * sectorCount;
+		LevelPvsHeader header = {};
+		header.magic       = LEVEL_PVS_MAGIC;
+		header.version     = LEVEL_PVS_VERSION;
+		header.sourceSize  = sourceSize;
+		header.sourceHash  = hashData(c_fnvOffset, source, sourceSize);
+		header.payloadHash = hashData(c_fnvOffset, bits, payloadSize);
+		header.sectorCount = sectorCount;
+		header.rowWords    = rowWords;
+
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cannot write the cached visible sets '%s'.", path);
+			return;
+		}
+		file.writeBuffer(&header, sizeof(LevelPvsHeader));
+		file.writeBuffer(bits, u32(payloadSize));
+		file.close();
+	}
+
+	void levelCache_free()
+	{
+		s_image.clear();
+		s_image.shrink_to_fit();
+	}
+}
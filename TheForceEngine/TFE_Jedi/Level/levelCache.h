@@ -0,0 +1,98 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Cache
+// Binary image of the parsed level geometry (.LEV), stored in
+// PATH_PROGRAM_DATA so levels can be reloaded without parsing the
+// text again.
+//
+// The image stores the values read from the text with references
+// (textures, vertices, adjoins) as indices, which are fixed up into
+// pointers when the level is built. The image is versioned and
+// checksummed, and it records the size and hash of the source file
+// so it is rebuilt whenever the level changes.
+//
+// The potentially visible sets (see levelPvs.h) are stored in a
+// separate file with the same checks.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+namespace TFE_Jedi
+{
+	enum
+	{
+		LEVEL_CACHE_NO_NAME = 0xffffffff,
+	};
+
+	struct LevelCacheSector
+	{
+		s32 id;
+		u32 nameOffset;			// offset into the string table or LEVEL_CACHE_NO_NAME.
+		fixed16_16 ambient;
+		s32 floorTex;
+		vec2_fixed floorOffset;
+		fixed16_16 floorHeight;
+		s32 ceilTex;
+		vec2_fixed ceilOffset;
+		fixed16_16 ceilHeight;
+		fixed16_16 secHeight;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 layer;
+		u32 vertexStart;
+		u32 vertexCount;
+		u32 wallStart;
+		u32 wallCount;
+	};
+
+	struct LevelCacheWall
+	{
+		s32 left;
+		s32 right;
+		s32 midTex;
+		s32 topTex;
+		s32 botTex;
+		s32 signTex;
+		vec2_fixed midOffset;	// offsets are in texels, so the values read are scaled by 8.
+		vec2_fixed topOffset;
+		vec2_fixed botOffset;
+		vec2_fixed signOffset;
+		s32 adjoin;
+		s32 mirror;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 light;
+	};
+
+	// Parsed level geometry, the arrays either point into the cache image or into the text parser output.
+	struct LevelGeometry
+	{
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+
+		u32 textureCount;
+		u32 sectorCount;
+		u32 vertexCount;
+		u32 wallCount;
+		u32 stringSize;
+
+		const u32* textureNames;		// offsets into the string table.
+		const LevelCacheSector* sectors;
+		const vec2_fixed* vertices;
+		const LevelCacheWall* walls;
+		const char* strings;
+	};
+
+	// Returns JTRUE and fills in 'geo' if a valid image exists for the source file.
+	// The geometry points into memory owned by the cache, which remains valid until the next read.
+	JBool levelCache_read(const char* levelName, const void* source, size_t sourceSize, LevelGeometry* geo);
+	// Write the image for the source file, failures are not fatal and the level is simply parsed next time.
+	void levelCache_write(const char* levelName, const void* source, size_t sourceSize, const LevelGeometry* geo);
+	// Read the potentially visible sets into 'bits' (sectorCount rows of rowWords), returns JFALSE if they need to be built.
+	JBool levelCache_readPvs(const char* levelName, const void* source, size_t sourceSize, u32 sectorCount, u32 rowWords, u32* bits);
+	void levelCache_writePvs(const char* levelName, const void* source, size_t sourceSize, u32 sectorCount, u32 rowWords, const u32* bits);
+	// Free the memory used by the last image read.
+	void levelCache_free();
+}
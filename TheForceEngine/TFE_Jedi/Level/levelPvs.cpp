@@ -0,0 +1,550 @@
+#include <cstring>
+#include <cmath>
+
+#include "levelPvs.h"
+#include "levelCache.h"
+#include "level.h"
+#include "rsector.h"
+#include "rwall.h"
+#include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_System/system.h>
+#include <algorithm>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	enum PvsConstants
+	{
+		PVS_MAX_DEPTH = 256,		// portal chains longer than this are not followed, the set is flood filled instead.
+		PVS_MAX_STEPS = 16384,		// the amount of work allowed per sector before the set is flood filled.
+		PVS_MAX_PLANES = 5,			// up to 4 separating planes and the window plane.
+	};
+	// Slack in world units, so geometry that lies on a boundary within the precision of the ray tests is kept.
+	static const f64 c_pvsEpsilon = 1.0 / 16.0;
+
+	struct PvsSegment
+	{
+		f64 x0, z0;
+		f64 x1, z1;
+	};
+
+	// Half-plane where nx*x + nz*z + c >= 0.
+	struct PvsPlane
+	{
+		f64 nx, nz;
+		f64 c;
+	};
+
+	// The sets live in the level region, like the sector grid.
+	static u32* s_pvsBits = nullptr;
+	static u32  s_pvsRowWords = 0;
+	static u32  s_pvsSectorCount = 0;
+	static JBool s_pvsEnabled = JFALSE;
+
+	SNAPSHOT_STATE(s_pvsBits);
+	SNAPSHOT_STATE(s_pvsRowWords);
+	SNAPSHOT_STATE(s_pvsSectorCount);
+	SNAPSHOT_STATE(s_pvsEnabled);
+
+	// Build state.
+	static std::vector<u8>  s_pvsOpen;			// sectors that do not narrow the view, see pvs_findOpenSectors().
+	static std::vector<u32> s_pvsWallBase;		// global index of the first wall of each sector.
+	static std::vector<u8>  s_pvsOnPath;		// portals on the current path, by global wall index.
+	static std::vector<u32> s_pvsVisit;
+	static std::vector<RSector*> s_pvsStack;
+	static u32* s_pvsRow = nullptr;
+	static u32  s_pvsVisitFrame = 0;
+	static s32  s_pvsSteps = 0;
+	static JBool s_pvsOverflow = JFALSE;
+
+	void pvs_build();
+
+	/////////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////////
+	void pvs_load(const char* levelName, const void* source, size_t sourceSize)
+	{
+		pvs_clear();
+		if (!s_sectorCount) { return; }
+
+		s_pvsSectorCount = s_sectorCount;
+		s_pvsRowWords = (s_sectorCount + 31) >> 5;
+		const size_t size = sizeof(u32) * s_pvsRowWords * s_pvsSectorCount;
+		s_pvsBits = (u32*)level_alloc(size);
+		if (!s_pvsBits)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level PVS", "Cannot allocate the potentially visible sets for '%s' (%u bytes).", levelName, u32(size));
+			pvs_clear();
+			return;
+		}
+
+		if (!levelCache_readPvs(levelName, source, sourceSize, s_pvsSectorCount, s_pvsRowWords, s_pvsBits))
+		{
+			pvs_build();
+			levelCache_writePvs(levelName, source, sourceSize, s_pvsSectorCount, s_pvsRowWords, s_pvsBits);
+		}
+		s_pvsEnabled = JTRUE;
+	}
+
+	void pvs_clear()
+	{
+		s_pvsBits = nullptr;
+		s_pvsRowWords = 0;
+		s_pvsSectorCount = 0;
+		s_pvsEnabled = JFALSE;
+	}
+
+	void pvs_disable()
+	{
+		if (s_pvsEnabled)
+		{
+			TFE_System::logWrite(LOG_MSG, "Level PVS", "The level adjoins have changed, the potentially visible sets are disabled.");
+		}
+		s_pvsEnabled = JFALSE;
+	}
+
+	JBool pvs_isEnabled()
+	{
+		return s_pvsEnabled;
+	}
+
+	JBool pvs_isVisible(const RSector* from, const RSector* to)
+	{
+		if (!s_pvsEnabled || !from || !to) { return JTRUE; }
+
+		const u32* row = &s_pvsBits[u32(from->index) * s_pvsRowWords];
+		return (row[to->index >> 5] & (1u << (to->index & 31))) ? JTRUE : JFALSE;
+	}
+
+	/////////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////////
+	static void pvs_mark(s32 index)
+	{
+		s_pvsRow[index >> 5] |= 1u << (index & 31);
+	}
+
+	static u32 pvs_wallIndex(RWall* wall)
+	{
+		return s_pvsWallBase[wall->sector->index] + u32(wall - wall->sector->walls);
+	}
+
+	// Portals are marked on both sides, so a path never turns back through the portal it came from.
+	static void pvs_setOnPath(RWall* wall, u8 value)
+	{
+		s_pvsOnPath[pvs_wallIndex(wall)] = value;
+		if (wall->mirrorWall)
+		{
+			s_pvsOnPath[pvs_wallIndex(wall->mirrorWall)] = value;
+		}
+	}
+
+	static void pvs_getWallSegment(const RWall* wall, PvsSegment* seg)
+	{
+		seg->x0 = f64(wall->w0->x) / 65536.0;
+		seg->z0 = f64(wall->w0->z) / 65536.0;
+		seg->x1 = f64(wall->w1->x) / 65536.0;
+		seg->z1 = f64(wall->w1->z) / 65536.0;
+	}
+
+	// The wall segment lengthened by the epsilon at both ends, used for the portals being tested.
+	static void pvs_getExtendedWallSegment(const RWall* wall, PvsSegment* seg)
+	{
+		pvs_getWallSegment(wall, seg);
+		const f64 dx = seg->x1 - seg->x0;
+		const f64 dz = seg->z1 - seg->z0;
+		const f64 len = sqrt(dx*dx + dz*dz);
+		if (len > 0.0)
+		{
+			const f64 scale = c_pvsEpsilon / len;
+			seg->x0 -= dx * scale;
+			seg->z0 -= dz * scale;
+			seg->x1 += dx * scale;
+			seg->z1 += dz * scale;
+		}
+	}
+
+	// Signed distance from the line through a with direction d, positive on the left (which is outside of a sector for its walls).
+	static f64 pvs_signedDist(f64 ax, f64 az, f64 dx, f64 dz, f64 px, f64 pz)
+	{
+		const f64 len = sqrt(dx*dx + dz*dz);
+		if (len <= 0.0) { return 0.0; }
+		return (dx*(pz - az) - dz*(px - ax)) / len;
+	}
+
+	static PvsPlane pvs_makePlane(f64 ax, f64 az, f64 dx, f64 dz, f64 sign)
+	{
+		const f64 scale = sign / sqrt(dx*dx + dz*dz);
+		PvsPlane plane;
+		plane.nx = -dz * scale;
+		plane.nz =  dx * scale;
+		plane.c  = -(plane.nx*ax + plane.nz*az);
+		return plane;
+	}
+
+	// Clip the segment to the 'sign' side of the plane, returns JFALSE if nothing is left.
+	static JBool pvs_clipSegment(PvsSegment* seg, const PvsPlane* plane, f64 sign)
+	{
+		const f64 d0 = sign * (plane->nx*seg->x0 + plane->nz*seg->z0 + plane->c) + c_pvsEpsilon;
+		const f64 d1 = sign * (plane->nx*seg->x1 + plane->nz*seg->z1 + plane->c) + c_pvsEpsilon;
+		if (d0 < 0.0 && d1 < 0.0)
+		{
+			return JFALSE;
+		}
+		if (d0 < 0.0)
+		{
+			const f64 t = d0 / (d0 - d1);
+			seg->x0 += t * (seg->x1 - seg->x0);
+			seg->z0 += t * (seg->z1 - seg->z0);
+		}
+		else if (d1 < 0.0)
+		{
+			const f64 t = d1 / (d1 - d0);
+			seg->x1 += t * (seg->x0 - seg->x1);
+			seg->z1 += t * (seg->z0 - seg->z1);
+		}
+		return JTRUE;
+	}
+
+	// Lines through an endpoint of the source and an endpoint of the window, that have the source and window on opposite sides.
+	// Every line through both segments continues past the window on the window side of these planes.
+	static s32 pvs_getSeparatingPlanes(const PvsSegment* source, const PvsSegment* window, PvsPlane* planes)
+	{
+		const f64 src[2][2] = { { source->x0, source->z0 }, { source->x1, source->z1 } };
+		const f64 win[2][2] = { { window->x0, window->z0 }, { window->x1, window->z1 } };
+
+		s32 count = 0;
+		for (s32 i = 0; i < 2; i++)
+		{
+			for (s32 j = 0; j < 2; j++)
+			{
+				const f64* s = src[i];
+				const f64* w = win[j];
+				const f64 dx = w[0] - s[0];
+				const f64 dz = w[1] - s[1];
+				// Lines through a shared vertex can point anywhere.
+				if (dx*dx + dz*dz < c_pvsEpsilon * c_pvsEpsilon) { continue; }
+
+				const f64 sideSrc = pvs_signedDist(s[0], s[1], dx, dz, src[i ^ 1][0], src[i ^ 1][1]);
+				const f64 sideWin = pvs_signedDist(s[0], s[1], dx, dz, win[j ^ 1][0], win[j ^ 1][1]);
+				if ((sideSrc > 0.0 && sideWin > 0.0) || (sideSrc < 0.0 && sideWin < 0.0) || (sideSrc == 0.0 && sideWin == 0.0))
+				{
+					continue;
+				}
+				const f64 sign = (sideWin != 0.0) ? (sideWin > 0.0 ? 1.0 : -1.0) : (sideSrc > 0.0 ? -1.0 : 1.0);
+				planes[count++] = pvs_makePlane(s[0], s[1], dx, dz, sign);
+			}
+		}
+		return count;
+	}
+
+	// Lines through both the source and the window cover the double wedge between the separating planes.
+	static JBool pvs_segmentInDoubleWedge(const PvsSegment* seg, const PvsPlane* planes, s32 planeCount)
+	{
+		for (s32 side = 0; side < 2; side++)
+		{
+			const f64 sign = side ? -1.0 : 1.0;
+			PvsSegment clipped = *seg;
+			s32 p = 0;
+			for (; p < planeCount; p++)
+			{
+				if (!pvs_clipSegment(&clipped, &planes[p], sign)) { break; }
+			}
+			if (p == planeCount) { return JTRUE; }
+		}
+		return JFALSE;
+	}
+
+	// Mark every sector reachable from 'start' through portals that intersect the double wedge of the planes.
+	// The constraint does not depend on the path, so this is a simple flood fill. With no planes, the whole
+	// connected part of the level is marked.
+	// Fills from within the portal recursion (planes is not null) count against the step budget, like the recursion itself.
+	static void pvs_fill(RSector* start, const PvsPlane* planes, s32 planeCount)
+	{
+		s_pvsVisitFrame++;
+		s_pvsStack.clear();
+		s_pvsStack.push_back(start);
+		s_pvsVisit[start->index] = s_pvsVisitFrame;
+		pvs_mark(start->index);
+
+		while (!s_pvsStack.empty())
+		{
+			RSector* sector = s_pvsStack.back();
+			s_pvsStack.pop_back();
+			if (planes && ++s_pvsSteps > PVS_MAX_STEPS)
+			{
+				s_pvsOverflow = JTRUE;
+				return;
+			}
+
+			const JBool open = s_pvsOpen[sector->index] ? JTRUE : JFALSE;
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				RSector* next = wall->nextSector;
+				if (!next || s_pvsVisit[next->index] == s_pvsVisitFrame) { continue; }
+				if (!open && planeCount)
+				{
+					PvsSegment portal;
+					pvs_getExtendedWallSegment(wall, &portal);
+					if (!pvs_segmentInDoubleWedge(&portal, planes, planeCount)) { continue; }
+				}
+
+				s_pvsVisit[next->index] = s_pvsVisitFrame;
+				pvs_mark(next->index);
+				s_pvsStack.push_back(next);
+			}
+		}
+	}
+
+	// Follow the portals of 'sector' that can be seen through the source portal and the window, which is part of 'windowWall'.
+	// The source and window are the same at the first step, in which case only the window plane applies.
+	static void pvs_recurse(RSector* sector, const PvsSegment* source, const PvsSegment* window, const RWall* windowWall, s32 depth)
+	{
+		if (depth > PVS_MAX_DEPTH || ++s_pvsSteps > PVS_MAX_STEPS)
+		{
+			s_pvsOverflow = JTRUE;
+			return;
+		}
+
+		PvsPlane planes[PVS_MAX_PLANES];
+		s32 planeCount = (source != window) ? pvs_getSeparatingPlanes(source, window, planes) : 0;
+		// Lines leaving the window continue beyond the full wall, not just the part of it that can be seen.
+		PvsSegment windowLine;
+		pvs_getWallSegment(windowWall, &windowLine);
+		if (windowLine.x0 != windowLine.x1 || windowLine.z0 != windowLine.z1)
+		{
+			planes[planeCount++] = pvs_makePlane(windowLine.x0, windowLine.z0, windowLine.x1 - windowLine.x0, windowLine.z1 - windowLine.z0, 1.0);
+		}
+
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount && !s_pvsOverflow; w++, wall++)
+		{
+			RSector* next = wall->nextSector;
+			if (!next || s_pvsOnPath[pvs_wallIndex(wall)]) { continue; }
+
+			PvsSegment portal;
+			pvs_getExtendedWallSegment(wall, &portal);
+			s32 p = 0;
+			for (; p < planeCount; p++)
+			{
+				if (!pvs_clipSegment(&portal, &planes[p], 1.0)) { break; }
+			}
+			if (p < planeCount) { continue; }
+
+			pvs_mark(next->index);
+			if (s_pvsOpen[next->index])
+			{
+				// Lines through an open sector can leave it anywhere, but they still pass through the source and this portal.
+				PvsPlane wedge[PVS_MAX_PLANES];
+				const s32 wedgeCount = pvs_getSeparatingPlanes(source, &portal, wedge);
+				pvs_fill(next, wedge, wedgeCount);
+				continue;
+			}
+
+			pvs_setOnPath(wall, 1);
+			pvs_recurse(next, source, &portal, wall, depth + 1);
+			pvs_setOnPath(wall, 0);
+		}
+	}
+
+	static f64 pvs_distToSegment(const RWall* wall, f64 px, f64 pz)
+	{
+		PvsSegment seg;
+		pvs_getWallSegment(wall, &seg);
+		const f64 dx = seg.x1 - seg.x0;
+		const f64 dz = seg.z1 - seg.z0;
+		const f64 lenSq = dx*dx + dz*dz;
+		f64 t = lenSq > 0.0 ? ((px - seg.x0)*dx + (pz - seg.z0)*dz) / lenSq : 0.0;
+		t = std::max(0.0, std::min(1.0, t));
+		const f64 ex = seg.x0 + t*dx - px;
+		const f64 ez = seg.z0 + t*dz - pz;
+		return sqrt(ex*ex + ez*ez);
+	}
+
+	// Even-odd test that ignores points within the epsilon of the sector edges.
+	static JBool pvs_pointStrictlyInside(const RSector* sector, f64 px, f64 pz)
+	{
+		JBool inside = JFALSE;
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			if (pvs_distToSegment(wall, px, pz) <= c_pvsEpsilon) { return JFALSE; }
+
+			PvsSegment seg;
+			pvs_getWallSegment(wall, &seg);
+			if ((seg.z0 > pz) != (seg.z1 > pz))
+			{
+				const f64 x = seg.x0 + (pz - seg.z0) * (seg.x1 - seg.x0) / (seg.z1 - seg.z0);
+				if (px < x) { inside = !inside; }
+			}
+		}
+		return inside;
+	}
+
+	static JBool pvs_wallsCross(const RWall* a, const RWall* b)
+	{
+		PvsSegment sa, sb;
+		pvs_getWallSegment(a, &sa);
+		pvs_getWallSegment(b, &sb);
+		const f64 dax = sa.x1 - sa.x0, daz = sa.z1 - sa.z0;
+		const f64 dbx = sb.x1 - sb.x0, dbz = sb.z1 - sb.z0;
+
+		const f64 b0 = pvs_signedDist(sa.x0, sa.z0, dax, daz, sb.x0, sb.z0);
+		const f64 b1 = pvs_signedDist(sa.x0, sa.z0, dax, daz, sb.x1, sb.z1);
+		if (!((b0 > c_pvsEpsilon && b1 < -c_pvsEpsilon) || (b0 < -c_pvsEpsilon && b1 > c_pvsEpsilon))) { return JFALSE; }
+
+		const f64 a0 = pvs_signedDist(sb.x0, sb.z0, dbx, dbz, sa.x0, sa.z0);
+		const f64 a1 = pvs_signedDist(sb.x0, sb.z0, dbx, dbz, sa.x1, sa.z1);
+		return (a0 > c_pvsEpsilon && a1 < -c_pvsEpsilon) || (a0 < -c_pvsEpsilon && a1 > c_pvsEpsilon);
+	}
+
+	static JBool pvs_sectorInside(const RSector* sector, const RSector* container)
+	{
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			const f64 x0 = f64(wall->w0->x) / 65536.0, z0 = f64(wall->w0->z) / 65536.0;
+			const f64 x1 = f64(wall->w1->x) / 65536.0, z1 = f64(wall->w1->z) / 65536.0;
+			// Test the midpoints as well, sectors inside of others can share all of their vertices.
+			if (pvs_pointStrictlyInside(container, x0, z0) || pvs_pointStrictlyInside(container, (x0 + x1) * 0.5, (z0 + z1) * 0.5))
+			{
+				return JTRUE;
+			}
+		}
+		return JFALSE;
+	}
+
+	static JBool pvs_sectorsOverlap(const RSector* a, const RSector* b)
+	{
+		const RWall* wallA = a->walls;
+		for (s32 i = 0; i < a->wallCount; i++, wallA++)
+		{
+			const RWall* wallB = b->walls;
+			for (s32 j = 0; j < b->wallCount; j++, wallB++)
+			{
+				if (pvs_wallsCross(wallA, wallB)) { return JTRUE; }
+			}
+		}
+		return pvs_sectorInside(a, b) || pvs_sectorInside(b, a);
+	}
+
+	// Sectors are open if their walls can move or if they overlap other sectors, in both cases lines through
+	// the sector may leave it through any of its portals.
+	static void pvs_findOpenSectors()
+	{
+		s_pvsOpen.assign(s_sectorCount, 0);
+		std::vector<s32> order(s_sectorCount);
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			RSector* sector = &s_sectors[i];
+			order[i] = s32(i);
+
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->flags1 & WF1_WALL_MORPHS)
+				{
+					s_pvsOpen[i] = 1;
+					break;
+				}
+			}
+		}
+
+		// Sweep the sector bounds along X to find the pairs to test.
+		std::sort(order.begin(), order.end(), [](s32 a, s32 b) { return s_sectors[a].boundsMin.x < s_sectors[b].boundsMin.x; });
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			const RSector* a = &s_sectors[order[i]];
+			for (u32 j = i + 1; j < s_sectorCount; j++)
+			{
+				const RSector* b = &s_sectors[order[j]];
+				if (b->boundsMin.x >= a->boundsMax.x) { break; }
+				if (b->boundsMin.z >= a->boundsMax.z || b->boundsMax.z <= a->boundsMin.z) { continue; }
+				if (s_pvsOpen[a->index] && s_pvsOpen[b->index]) { continue; }
+
+				if (pvs_sectorsOverlap(a, b))
+				{
+					s_pvsOpen[a->index] = 1;
+					s_pvsOpen[b->index] = 1;
+				}
+			}
+		}
+	}
+
+	void pvs_build()
+	{
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		memset(s_pvsBits, 0, sizeof(u32) * s_pvsRowWords * s_pvsSectorCount);
+
+		u32 wallCount = 0;
+		s_pvsWallBase.resize(s_sectorCount);
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			s_pvsWallBase[i] = wallCount;
+			wallCount += u32(s_sectors[i].wallCount);
+		}
+		s_pvsOnPath.assign(wallCount, 0);
+		s_pvsVisit.assign(s_sectorCount, 0);
+		s_pvsVisitFrame = 0;
+		pvs_findOpenSectors();
+
+		s32 openCount = 0;
+		s32 fillCount = 0;
+		for (u32 i = 0; i < s_sectorCount; i++)
+		{
+			RSector* sector = &s_sectors[i];
+			s_pvsRow = &s_pvsBits[i * s_pvsRowWords];
+			s_pvsSteps = 0;
+			s_pvsOverflow = JFALSE;
+			pvs_mark(s32(i));
+
+			// A line starting in an open sector can leave it through any portal in any direction.
+			if (s_pvsOpen[i])
+			{
+				openCount++;
+				pvs_fill(sector, nullptr, 0);
+				continue;
+			}
+
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount && !s_pvsOverflow; w++, wall++)
+			{
+				RSector* next = wall->nextSector;
+				if (!next) { continue; }
+
+				pvs_mark(next->index);
+				if (s_pvsOpen[next->index])
+				{
+					// Nothing narrows the view through a single portal.
+					s_pvsOverflow = JTRUE;
+					break;
+				}
+
+				PvsSegment portal;
+				pvs_getWallSegment(wall, &portal);
+				pvs_setOnPath(wall, 1);
+				pvs_recurse(next, &portal, &portal, wall, 1);
+				pvs_setOnPath(wall, 0);
+			}
+
+			if (s_pvsOverflow)
+			{
+				fillCount++;
+				pvs_fill(sector, nullptr, 0);
+			}
+		}
+
+		s_pvsOpen.clear();
+		s_pvsWallBase.clear();
+		s_pvsOnPath.clear();
+		s_pvsVisit.clear();
+		s_pvsStack.clear();
+		s_pvsRow = nullptr;
+
+		const f64 seconds = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start);
+		TFE_System::logWrite(LOG_MSG, "Level PVS", "Built the potentially visible sets for %u sectors in %0.3f seconds, %d open and %d flood filled.",
+			s_pvsSectorCount, seconds, openCount, fillCount);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Potentially Visible Sectors
+// For every sector, a bitset of the sectors that can be seen from it
+// through adjoins. The sets are computed in 2D (heights are ignored)
+// when the level is loaded and stored in the level cache next to the
+// geometry image.
+//
+// The sets are conservative: a sector that is not in the set of
+// another cannot be reached by any straight line through the adjoins,
+// so the renderer can skip it and line of sight tests can fail early.
+// Both only use the sets when r_pvsCull is enabled.
+// Sectors with moving walls or that overlap other sectors do not
+// narrow the view. If adjoins change at runtime the sets no longer
+// apply and every sector is treated as visible.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	// Load the sets for the current level geometry from the level cache, or build and cache them.
+	void pvs_load(const char* levelName, const void* source, size_t sourceSize);
+	void pvs_clear();
+	// Call when the adjoins change at runtime, after which every sector is considered visible.
+	void pvs_disable();
+	JBool pvs_isEnabled();
+
+	// Returns JFALSE only if 'to' cannot be seen from anywhere in 'from'.
+	JBool pvs_isVisible(const RSector* from, const RSector* to);
+}
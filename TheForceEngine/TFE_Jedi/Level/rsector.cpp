@@ -6,9 +6,11 @@
 #include "robject.h"
 #include "level.h"
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_System/system.h>
 #include <TFE_DarkForces/player.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/losQuery.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/message.h>
 // TODO: Find a better way to handle this.
@@ -26,6 +28,49 @@ namespace TFE_Jedi
 	void sector_moveObjects(RSector* sector, u32 flags, fixed16_16 offsetX, fixed16_16 offsetZ);
 
 	f32 isLeft(Vec2f p0, Vec2f p1, Vec2f p2);
+	void sector_updateSpatialIndex(RSector* sector);
+
+	/////////////////////////////////////////////////
+	// Spatial Index
+	// A uniform grid over the sector XZ bounds, used to find the candidate
+	// sectors for point queries without testing every sector in the level.
+	// Each cell holds the indices of the sectors whose bounds overlap it.
+	/////////////////////////////////////////////////
+	struct SectorGridCell
+	{
+		s32* sectors;
+		s32 count;
+		s32 capacity;
+	};
+
+	struct SectorGridRect
+	{
+		s32 x0, z0;
+		s32 x1, z1;
+	};
+
+	enum SectorGridConstants
+	{
+		SECTOR_GRID_MIN_CELL_SIZE = FIXED(16),
+		SECTOR_GRID_MAX_DIM = 256,
+	};
+
+	static SectorGridCell* s_sectorGrid = nullptr;
+	static SectorGridRect* s_sectorGridRect = nullptr;
+	static s32 s_sectorGridWidth = 0;
+	static s32 s_sectorGridHeight = 0;
+	static fixed16_16 s_sectorGridMinX = 0;
+	static fixed16_16 s_sectorGridMinZ = 0;
+	static fixed16_16 s_sectorGridCellSize = SECTOR_GRID_MIN_CELL_SIZE;
+
+	// The grid lives in the level region, so moving sectors keep it in sync with snapshots.
+	SNAPSHOT_STATE(s_sectorGrid);
+	SNAPSHOT_STATE(s_sectorGridRect);
+	SNAPSHOT_STATE(s_sectorGridWidth);
+	SNAPSHOT_STATE(s_sectorGridHeight);
+	SNAPSHOT_STATE(s_sectorGridMinX);
+	SNAPSHOT_STATE(s_sectorGridMinZ);
+	SNAPSHOT_STATE(s_sectorGridCellSize);
 	
 	/////////////////////////////////////////////////
 	// API Implementation
@@ -89,9 +134,24 @@ namespace TFE_Jedi
 		}
 	}
 		
+	// Moving walls also moves the mirror walls, so the adjoined sectors change as well.
+	static void sector_invalidateLineOfSight(RSector* sector)
+	{
+		losQuery_invalidateSector(sector);
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			if (wall->nextSector)
+			{
+				losQuery_invalidateSector(wall->nextSector);
+			}
+		}
+	}
+
 	void sector_adjustHeights(RSector* sector, fixed16_16 floorOffset, fixed16_16 ceilOffset, fixed16_16 secondHeightOffset)
 	{
 		sector->dirtyFlags |= SDF_HEIGHTS;
+		losQuery_invalidateSector(sector);
 
 		// Adjust objects.
 		if (sector->objectCount)
@@ -198,6 +258,8 @@ namespace TFE_Jedi
 		sector->boundsMax.x = maxX;
 		sector->boundsMin.z = minZ;
 		sector->boundsMax.z = maxZ;
+		// Moving or rotating walls may change which grid cells the sector overlaps.
+		sector_updateSpatialIndex(sector);
 
 		// Setup when needed.
 		//s_minX = minX;
@@ -232,6 +294,7 @@ namespace TFE_Jedi
 	JBool sector_moveWalls(RSector* sector, fixed16_16 delta, fixed16_16 dirX, fixed16_16 dirZ, u32 flags)
 	{
 		sector->dirtyFlags |= SDF_VERTICES;
+		sector_invalidateLineOfSight(sector);
 
 		fixed16_16 offsetX = mul16(delta, dirX);
 		fixed16_16 offsetZ = mul16(delta, dirZ);
@@ -473,43 +536,192 @@ namespace TFE_Jedi
 		}
 	}
 	
+	// The sector grid is allocated from the level region, so it is simply dropped when the level is cleared.
+	void sector_clearSpatialIndex()
+	{
+		s_sectorGrid = nullptr;
+		s_sectorGridRect = nullptr;
+		s_sectorGridWidth = 0;
+		s_sectorGridHeight = 0;
+	}
+
+	inline s32 sector_gridCellX(fixed16_16 x)
+	{
+		const s32 cell = s32((s64(x) - s64(s_sectorGridMinX)) / s_sectorGridCellSize);
+		return clamp(cell, 0, s_sectorGridWidth - 1);
+	}
+
+	inline s32 sector_gridCellZ(fixed16_16 z)
+	{
+		const s32 cell = s32((s64(z) - s64(s_sectorGridMinZ)) / s_sectorGridCellSize);
+		return clamp(cell, 0, s_sectorGridHeight - 1);
+	}
+
+	void sector_gridAdd(s32 sectorIndex, const SectorGridRect* rect)
+	{
+		for (s32 z = rect->z0; z <= rect->z1; z++)
+		{
+			SectorGridCell* cell = &s_sectorGrid[z * s_sectorGridWidth + rect->x0];
+			for (s32 x = rect->x0; x <= rect->x1; x++, cell++)
+			{
+				if (cell->count >= cell->capacity)
+				{
+					cell->capacity = cell->capacity ? cell->capacity * 2 : 4;
+					cell->sectors = (s32*)level_realloc(cell->sectors, sizeof(s32) * cell->capacity);
+				}
+				cell->sectors[cell->count++] = sectorIndex;
+			}
+		}
+	}
+
+	void sector_gridRemove(s32 sectorIndex, const SectorGridRect* rect)
+	{
+		for (s32 z = rect->z0; z <= rect->z1; z++)
+		{
+			SectorGridCell* cell = &s_sectorGrid[z * s_sectorGridWidth + rect->x0];
+			for (s32 x = rect->x0; x <= rect->x1; x++, cell++)
+			{
+				// Order within a cell does not matter, see sector_isBetterCandidate().
+				for (s32 i = 0; i < cell->count; i++)
+				{
+					if (cell->sectors[i] == sectorIndex)
+					{
+						cell->sectors[i] = cell->sectors[cell->count - 1];
+						cell->count--;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void sector_gridComputeRect(RSector* sector, SectorGridRect* rect)
+	{
+		rect->x0 = sector_gridCellX(sector->boundsMin.x);
+		rect->z0 = sector_gridCellZ(sector->boundsMin.z);
+		rect->x1 = sector_gridCellX(sector->boundsMax.x);
+		rect->z1 = sector_gridCellZ(sector->boundsMax.z);
+	}
+
+	// Called after the level geometry is loaded and the sector bounds have been computed.
+	void sector_buildSpatialIndex()
+	{
+		sector_clearSpatialIndex();
+		if (!s_sectorCount) { return; }
+
+		// Compute the level bounds.
+		RSector* sector = s_sectors;
+		fixed16_16 minX = sector->boundsMin.x, maxX = sector->boundsMax.x;
+		fixed16_16 minZ = sector->boundsMin.z, maxZ = sector->boundsMax.z;
+		sector++;
+		for (u32 i = 1; i < s_sectorCount; i++, sector++)
+		{
+			minX = min(minX, sector->boundsMin.x);
+			minZ = min(minZ, sector->boundsMin.z);
+			maxX = max(maxX, sector->boundsMax.x);
+			maxZ = max(maxZ, sector->boundsMax.z);
+		}
+
+		// Size the cells so there is roughly one sector per cell.
+		const f32 width  = fixed16ToFloat(maxX - minX) + 1.0f;
+		const f32 height = fixed16ToFloat(maxZ - minZ) + 1.0f;
+		const f32 cellSize = sqrtf(width * height / f32(s_sectorCount));
+		s_sectorGridCellSize = max(floatToFixed16(cellSize), (fixed16_16)SECTOR_GRID_MIN_CELL_SIZE);
+		s_sectorGridCellSize = max(s_sectorGridCellSize, floatToFixed16(max(width, height) / f32(SECTOR_GRID_MAX_DIM)) + 1);
+		s_sectorGridMinX = minX;
+		s_sectorGridMinZ = minZ;
+		s_sectorGridWidth  = s32((s64(maxX) - s64(minX)) / s_sectorGridCellSize) + 1;
+		s_sectorGridHeight = s32((s64(maxZ) - s64(minZ)) / s_sectorGridCellSize) + 1;
+
+		const s32 cellCount = s_sectorGridWidth * s_sectorGridHeight;
+		s_sectorGrid = (SectorGridCell*)level_alloc(sizeof(SectorGridCell) * cellCount);
+		s_sectorGridRect = (SectorGridRect*)level_alloc(sizeof(SectorGridRect) * s_sectorCount);
+		memset(s_sectorGrid, 0, sizeof(SectorGridCell) * cellCount);
+
+		sector = s_sectors;
+		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		{
+			sector_gridComputeRect(sector, &s_sectorGridRect[i]);
+			sector_gridAdd(i, &s_sectorGridRect[i]);
+		}
+	}
+
+	void sector_updateSpatialIndex(RSector* sector)
+	{
+		if (!s_sectorGrid || sector < s_sectors || sector >= s_sectors + s_sectorCount) { return; }
+
+		const s32 index = s32(sector - s_sectors);
+		SectorGridRect rect;
+		sector_gridComputeRect(sector, &rect);
+
+		SectorGridRect* prevRect = &s_sectorGridRect[index];
+		if (rect.x0 == prevRect->x0 && rect.z0 == prevRect->z0 && rect.x1 == prevRect->x1 && rect.z1 == prevRect->z1)
+		{
+			return;
+		}
+		sector_gridRemove(index, prevRect);
+		sector_gridAdd(index, &rect);
+		*prevRect = rect;
+	}
+
+	// The original code loops through all of the sectors in order and picks the containing sector with the smallest area,
+	// so the lowest index wins ties. Comparing the index as well gives the same result regardless of the order sectors are tested.
+	inline JBool sector_isBetterCandidate(RSector* sector, fixed16_16 ix, fixed16_16 iz, s32* bestArea, RSector* bestSector)
+	{
+		const fixed16_16 sectorMaxX = sector->boundsMax.x;
+		const fixed16_16 sectorMinX = sector->boundsMin.x;
+		const fixed16_16 sectorMaxZ = sector->boundsMax.z;
+		const fixed16_16 sectorMinZ = sector->boundsMin.z;
+		if (ix < sectorMinX || ix > sectorMaxX || iz < sectorMinZ || iz > sectorMaxZ)
+		{
+			return JFALSE;
+		}
+
+		const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
+		const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
+		const s32 sectorUnitArea = dzInt * dxInt;
+		if (sectorUnitArea > *bestArea || (sectorUnitArea == *bestArea && (!bestSector || sector > bestSector)))
+		{
+			return JFALSE;
+		}
+		if (!sector_pointInsideDF(sector, ix, iz))
+		{
+			return JFALSE;
+		}
+		*bestArea = sectorUnitArea;
+		return JTRUE;
+	}
+	
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz)
 	{
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 		fixed16_16 y = dy;
 		
-		RSector* sector = s_sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
-
-		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		if (s_sectorGrid)
 		{
-			if (y >= sector->ceilingHeight && y <= sector->floorHeight)
+			const SectorGridCell* cell = &s_sectorGrid[sector_gridCellZ(iz) * s_sectorGridWidth + sector_gridCellX(ix)];
+			for (s32 i = 0; i < cell->count; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-				
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_sectors[cell->sectors[i]];
+				if (y >= sector->ceilingHeight && y <= sector->floorHeight && sector_isBetterCandidate(sector, ix, iz, &prevSectorUnitArea, foundSector))
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					foundSector = sector;
 				}
 			}
+			return foundSector;
 		}
 
+		RSector* sector = s_sectors;
+		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		{
+			if (y >= sector->ceilingHeight && y <= sector->floorHeight && sector_isBetterCandidate(sector, ix, iz, &prevSectorUnitArea, foundSector))
+			{
+				foundSector = sector;
+			}
+		}
 		return foundSector;
 	}
 
@@ -518,37 +730,30 @@ namespace TFE_Jedi
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 
-		RSector* sector = s_sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
-
-		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		if (s_sectorGrid)
 		{
-			if (sector->layer == layer)
+			const SectorGridCell* cell = &s_sectorGrid[sector_gridCellZ(iz) * s_sectorGridWidth + sector_gridCellX(ix)];
+			for (s32 i = 0; i < cell->count; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_sectors[cell->sectors[i]];
+				if (sector->layer == layer && sector_isBetterCandidate(sector, ix, iz, &prevSectorUnitArea, foundSector))
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					foundSector = sector;
 				}
 			}
+			return foundSector;
 		}
 
+		RSector* sector = s_sectors;
+		for (u32 i = 0; i < s_sectorCount; i++, sector++)
+		{
+			if (sector->layer == layer && sector_isBetterCandidate(sector, ix, iz, &prevSectorUnitArea, foundSector))
+			{
+				foundSector = sector;
+			}
+		}
 		return foundSector;
 	}
 
@@ -925,6 +1130,8 @@ namespace TFE_Jedi
 
 	void sector_rotateWalls(RSector* sector, fixed16_16 centerX, fixed16_16 centerZ, angle14_32 angle)
 	{
+		sector_invalidateLineOfSight(sector);
+
 		s32 cosAngle, sinAngle;
 		sinCosFixed(angle, &sinAngle, &cosAngle);
 
@@ -150,6 +150,9 @@ namespace TFE_Jedi
 	void sector_addObject(RSector* sector, SecObject* obj);
 	void sector_removeObject(SecObject* obj);
 
+	// Spatial index used by sector_which3D() and sector_which3D_Map(), built once the level geometry is loaded.
+	void sector_buildSpatialIndex();
+	void sector_clearSpatialIndex();
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz);
 	RSector* sector_which3D_Map(fixed16_16 dx, fixed16_16 dz, s32 layer);
 	bool sector_pointInside(RSector* sector, fixed16_16 x, fixed16_16 z);
@@ -1,6 +1,13 @@
+#include <cstring>
+
 #include "allocator.h"
 #include <TFE_System/system.h>
 #include <TFE_Game/igame.h>
+#include <algorithm>
+
+// Set to 0 to allocate each item separately from the level region, as the original code does.
+// Otherwise items are carved out of contiguous slabs and an index table gives O(1) random access.
+#define ALLOCATOR_SLABS 1
 
 struct AllocHeader
 {
@@ -8,6 +15,20 @@ struct AllocHeader
 	AllocHeader* next;
 };
 
+#if ALLOCATOR_SLABS
+// Slabs are linked together so they can be freed with the allocator, the items follow the slab header.
+struct AllocSlab
+{
+	AllocSlab* next;
+};
+
+enum AllocatorConstants
+{
+	ALLOC_SLAB_ITEMS = 32,	// slabs start with a single item and double in size up to this count.
+	ALLOC_TABLE_MIN  = 8,
+};
+#endif
+
 struct Allocator
 {
 	Allocator*   self;
@@ -18,6 +39,16 @@ struct Allocator
 	s32 size;
 	s32 refCount;
 	s32* u1c;
+
+#if ALLOCATOR_SLABS
+	AllocSlab*    slabs;
+	AllocHeader*  freeList;		// deleted items, reused before a new slab is allocated.
+	AllocHeader** table;		// items in list order, built on the first random access and rebuilt lazily when it falls out of date.
+	s32 tableCapacity;
+	s32 slabItems;				// item count of the next slab.
+	s32 count;
+	JBool tableValid;
+#endif
 };
 
 namespace TFE_Jedi
@@ -44,6 +75,18 @@ namespace TFE_Jedi
 		res->refCount = 0;
 		res->u1c = nullptr;
 
+	#if ALLOCATOR_SLABS
+		// Round up so items in a slab stay pointer aligned.
+		res->size = (res->size + sizeof(void*) - 1) & ~s32(sizeof(void*) - 1);
+		res->slabs = nullptr;
+		res->freeList = nullptr;
+		res->table = nullptr;
+		res->tableCapacity = 0;
+		res->slabItems = 1;
+		res->count = 0;
+		res->tableValid = JFALSE;
+	#endif
+
 		return res;
 	}
 
@@ -58,16 +101,87 @@ namespace TFE_Jedi
 			item = allocator_getNext(alloc);
 		}
 
+	#if ALLOCATOR_SLABS
+		AllocSlab* slab = alloc->slabs;
+		while (slab)
+		{
+			AllocSlab* next = slab->next;
+			level_free(slab);
+			slab = next;
+		}
+		level_free(alloc->table);
+	#endif
+
 		alloc->self = (Allocator*)ALLOC_INVALID_PTR;
 		level_free(alloc);
 	}
 
+#if ALLOCATOR_SLABS
+	static AllocHeader* allocator_allocHeader(Allocator* alloc)
+	{
+		if (!alloc->freeList)
+		{
+			// Most allocators only ever hold one or two items, so slabs grow geometrically.
+			const s32 itemCount = alloc->slabItems;
+			alloc->slabItems = std::min(alloc->slabItems * 2, s32(ALLOC_SLAB_ITEMS));
+
+			AllocSlab* slab = (AllocSlab*)level_alloc(sizeof(AllocSlab) + alloc->size * itemCount);
+			slab->next = alloc->slabs;
+			alloc->slabs = slab;
+
+			// Link the items in reverse so they are handed out in memory order.
+			u8* items = (u8*)slab + sizeof(AllocSlab);
+			for (s32 i = itemCount - 1; i >= 0; i--)
+			{
+				AllocHeader* header = (AllocHeader*)(items + i * alloc->size);
+				header->next = alloc->freeList;
+				alloc->freeList = header;
+			}
+		}
+
+		AllocHeader* header = alloc->freeList;
+		alloc->freeList = header->next;
+		return header;
+	}
+
+	static void allocator_buildTable(Allocator* alloc)
+	{
+		if (alloc->count > alloc->tableCapacity)
+		{
+			// Leave room so items added afterwards can be appended without a rebuild.
+			alloc->tableCapacity = std::max(alloc->count * 2, s32(ALLOC_TABLE_MIN));
+			alloc->table = (AllocHeader**)level_realloc(alloc->table, sizeof(AllocHeader*) * alloc->tableCapacity);
+		}
+
+		s32 index = 0;
+		for (AllocHeader* header = alloc->head; header != ALLOC_INVALID_PTR; header = header->next, index++)
+		{
+			alloc->table[index] = header;
+		}
+		alloc->tableValid = JTRUE;
+	}
+#endif
+
 	// Allocate and free individual items.
 	void* allocator_newItem(Allocator* alloc)
 	{
 		if (!alloc) { return nullptr; }
 
+	#if ALLOCATOR_SLABS
+		AllocHeader* header = allocator_allocHeader(alloc);
+		// Keep an existing table in sync while it has room, otherwise it is rebuilt on the next random access.
+		if (alloc->tableValid && alloc->count < alloc->tableCapacity)
+		{
+			alloc->table[alloc->count] = header;
+		}
+		else
+		{
+			alloc->tableValid = JFALSE;
+		}
+		alloc->count++;
+	#else
 		AllocHeader* header = (AllocHeader*)level_alloc(alloc->size);
+	#endif
 		header->next = ALLOC_INVALID_PTR;
 		header->prev = alloc->tail;
 
@@ -108,12 +222,26 @@ namespace TFE_Jedi
 			alloc->iterPrev = header->next;
 		}
 
+	#if ALLOCATOR_SLABS
+		alloc->count--;
+		// Removing the tail keeps the table in order, otherwise it is rebuilt when next needed.
+		if (next != ALLOC_INVALID_PTR)
+		{
+			alloc->tableValid = JFALSE;
+		}
+		header->next = alloc->freeList;
+		alloc->freeList = header;
+	#else
 		level_free(header);
+	#endif
 	}
 
 	// Random access.
 	s32 allocator_getCount(Allocator* alloc)
 	{
+	#if ALLOCATOR_SLABS
+		return alloc->count;
+	#else
 		s32 count = 0;
 		AllocHeader* header = alloc->head;
 		while (header != ALLOC_INVALID_PTR)
@@ -122,18 +250,29 @@ namespace TFE_Jedi
 			header = header->next;
 		}
 		return count;
+	#endif
 	}
 
 	void* allocator_getByIndex(Allocator* alloc, s32 index)
 	{
 		if (!alloc) { return nullptr; }
 
+	#if ALLOCATOR_SLABS
+		// Matches walking the list: negative indices return the head, indices past the end return null.
+		AllocHeader* header = alloc->head;
+		if (index > 0)
+		{
+			if (!alloc->tableValid) { allocator_buildTable(alloc); }
+			header = index < alloc->count ? alloc->table[index] : ALLOC_INVALID_PTR;
+		}
+	#else
 		AllocHeader* header = alloc->head;
 		while (index > 0 && header != ALLOC_INVALID_PTR)
 		{
 			index--;
 			header = header->next;
 		}
+	#endif
 
 		alloc->iterPrev = header;
 		alloc->iter = header;
@@ -174,6 +174,7 @@ namespace RClassic_Fixed
 	void resetState()
 	{
 		s_rcfState.depth1d_all = nullptr;
+		s_rcfState.wallSegListSrc = nullptr;
 		s_rcfState.skyTable = nullptr;
 		s_rcfState.column_Z_Over_X = nullptr;
 		s_rcfState.column_X_Over_Z = nullptr;
@@ -187,6 +188,33 @@ namespace RClassic_Fixed
 		s_windowBot_all = nullptr;
 	}
 
+	void resizeFrameBuffers()
+	{
+		// The segment and edge lists share a single block, largest alignment first.
+		const size_t wallSegSize    = sizeof(RWallSegmentFixed) * s_segLimit;
+		const size_t adjoinSegSize  = sizeof(RWallSegmentFixed*) * s_adjoinSegLimit;
+		const size_t flatEdgeSize   = sizeof(EdgePairFixed) * s_segLimit;
+		const size_t adjoinEdgeSize = sizeof(EdgePairFixed) * s_adjoinSegLimit;
+		const size_t sortKeySize    = sizeof(u32) * 2 * s_segLimit;
+		const size_t sortIndexSize  = sizeof(s32) * 2 * s_segLimit;
+		u8* block = (u8*)game_realloc(s_rcfState.wallSegListSrc, 3 * wallSegSize + adjoinSegSize + flatEdgeSize + adjoinEdgeSize + sortKeySize + sortIndexSize);
+
+		s_rcfState.wallSegListSrc  = (RWallSegmentFixed*)block;  block += wallSegSize;
+		s_rcfState.wallSegListDst  = (RWallSegmentFixed*)block;  block += wallSegSize;
+		s_rcfState.wallSortScratch = (RWallSegmentFixed*)block;  block += wallSegSize;
+		s_rcfState.adjoinSegList   = (RWallSegmentFixed**)block; block += adjoinSegSize;
+		s_rcfState.flatEdgeList    = (EdgePairFixed*)block;      block += flatEdgeSize;
+		s_rcfState.adjoinEdgeList  = (EdgePairFixed*)block;      block += adjoinEdgeSize;
+		s_rcfState.wallSortKeys    = (u32*)block;                block += sortKeySize;
+		s_rcfState.wallSortIndices = (s32*)block;
+
+		// One set of window and depth values per adjoin level.
+		const s32 depthCount = s_adjoinDepthLimit + 1;
+		s_rcfState.depth1d_all = (fixed16_16*)game_realloc(s_rcfState.depth1d_all, s_width * sizeof(fixed16_16) * depthCount);
+		s_windowTop_all = (s32*)game_realloc(s_windowTop_all, s_width * sizeof(s32) * depthCount);
+		s_windowBot_all = (s32*)game_realloc(s_windowBot_all, s_width * sizeof(s32) * depthCount);
+	}
+
 	void buildProjectionTables(s32 xc, s32 yc, s32 w, s32 h)
 	{
 		s32 halfHeight = h >> 1;
@@ -198,15 +226,14 @@ namespace RClassic_Fixed
 		s32 widthFract = div16(intToFixed16(w), FIXED(320));
 		setWidthFraction(widthFract);
 
+		resizeFrameBuffers();
+
 		EdgePairFixed* flatEdge = &s_rcfState.flatEdgeList[s_flatCount];
 		s_rcfState.flatEdge = flatEdge;
 		flat_addEdges(s_screenWidth, s_minScreenX_Pixels, 0, s_rcfState.windowMaxY, 0, s_rcfState.windowMinY);
 		
 		s_columnTop = (s32*)game_realloc(s_columnTop, s_width * sizeof(s32));
 		s_columnBot = (s32*)game_realloc(s_columnBot, s_width * sizeof(s32));
-		s_rcfState.depth1d_all = (fixed16_16*)game_realloc(s_rcfState.depth1d_all, s_width * sizeof(fixed16_16) * (MAX_ADJOIN_DEPTH + 1));
-		s_windowTop_all = (s32*)game_realloc(s_windowTop_all, s_width * sizeof(s32) * (MAX_ADJOIN_DEPTH + 1));
-		s_windowBot_all = (s32*)game_realloc(s_windowBot_all, s_width * sizeof(s32) * (MAX_ADJOIN_DEPTH + 1));
 
 		memset(s_windowTop_all, s_minScreenY, 320);
 		memset(s_windowBot_all, s_maxScreenY, 320);
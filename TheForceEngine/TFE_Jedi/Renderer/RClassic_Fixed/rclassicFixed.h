@@ -12,6 +12,8 @@ namespace TFE_Jedi
 		void resetState();
 		void setupInitCameraAndLights();
 		void changeResolution(s32 width, s32 height);
+		// Resize the per-frame buffers to match the current render limits.
+		void resizeFrameBuffers();
 
 		void computeCameraTransform(RSector* sector, angle14_32 pitch, angle14_32 yaw, fixed16_16 camX, fixed16_16 camY, fixed16_16 camZ);
 		void transformPointByCamera(vec3_fixed* worldPoint, vec3_fixed* viewPoint);
@@ -56,13 +56,17 @@ namespace TFE_Jedi
 		// Flats
 		fixed16_16*    rcpY;
 		EdgePairFixed* flatEdge;
-		EdgePairFixed  flatEdgeList[MAX_SEG];
+		EdgePairFixed* flatEdgeList;		// [s_segLimit]
 		EdgePairFixed* adjoinEdge;
-		EdgePairFixed  adjoinEdgeList[MAX_ADJOIN_SEG * MAX_ADJOIN_DEPTH];
+		EdgePairFixed* adjoinEdgeList;	// [s_adjoinSegLimit]
 
-		RWallSegmentFixed   wallSegListDst[MAX_SEG];
-		RWallSegmentFixed   wallSegListSrc[MAX_SEG];
+		RWallSegmentFixed*  wallSegListDst;	// [s_segLimit]
+		RWallSegmentFixed*  wallSegListSrc;	// [s_segLimit]
 		RWallSegmentFixed** adjoinSegment;
+		RWallSegmentFixed** adjoinSegList;	// [s_adjoinSegLimit]
+		RWallSegmentFixed*  wallSortScratch;	// [s_segLimit]
+		u32* wallSortKeys;					// [2 * s_segLimit]
+		s32* wallSortIndices;				// [2 * s_segLimit]
 	};
 	extern RClassicFixedState s_rcfState;
 }  // TFE_Jedi
\ No newline at end of file
@@ -36,7 +36,7 @@ namespace RClassic_Fixed
 		
 	void flat_addEdges(s32 length, s32 x0, fixed16_16 dyFloor_dx, fixed16_16 yFloor, fixed16_16 dyCeil_dx, fixed16_16 yCeil)
 	{
-		if (s_flatCount < MAX_SEG && length > 0)
+		if (s_flatCount < s_segLimit && length > 0)
 		{
 			const fixed16_16 lengthFixed = intToFixed16(length - 1);
 
@@ -73,6 +73,10 @@ namespace RClassic_Fixed
 			s_rcfState.flatEdge++;
 			s_flatCount++;
 		}
+		else if (length > 0)
+		{
+			s_limitsExceeded |= RLIMIT_SEG;
+		}
 	}
 				
 	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
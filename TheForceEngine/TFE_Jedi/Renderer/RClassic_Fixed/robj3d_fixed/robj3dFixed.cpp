@@ -11,6 +11,7 @@
 #include "robj3dFixed_PolygonDraw.h"
 #include "../rclassicFixedSharedState.h"
 #include "../../rcommon.h"
+#include "../../rsort.h"
 
 namespace TFE_Jedi
 {
@@ -21,6 +22,11 @@ namespace RClassic_Fixed
 	void robj3d_drawVertices(s32 vertexCount, const vec3_fixed* vertices, u8 color);
 	s32 polygonSort(const void* r0, const void* r1);
 
+	// Scratch space used to sort the visible polygons.
+	static Polygon* s_sortPolygons[MAX_POLYGON_COUNT_3DO];
+	static u32 s_sortPolygonKeys[MAX_POLYGON_COUNT_3DO * 2];
+	static s32 s_sortPolygonIndices[MAX_POLYGON_COUNT_3DO * 2];
+
 	void robj3d_draw(SecObject* obj, JediModel* model)
 	{
 		// Handle transforms and vertex lighting.
@@ -40,7 +46,13 @@ namespace RClassic_Fixed
 		if (visPolygonCount < 1) { return; }
 
 		// Sort polygons from back to front.
-		qsort(s_visPolygons, visPolygonCount, sizeof(Polygon*), polygonSort);
+		// The keys are inverted so the farthest polygons come first.
+		for (s32 i = 0; i < visPolygonCount; i++)
+		{
+			s_sortPolygonKeys[i] = ~sortKey_s32(s_visPolygons[i]->zAve);
+		}
+		if (s_sortCapture) { sortBench_capture(SORT_BENCH_POLYGON_FIXED, s_sortPolygonKeys, visPolygonCount); }
+		sort_byKeyAsQsort(s_visPolygons, s_sortPolygonKeys, visPolygonCount, polygonSort, s_sortPolygons, s_sortPolygonKeys + MAX_POLYGON_COUNT_3DO, s_sortPolygonIndices);
 
 		// Draw polygons
 		Polygon** visPolygon = s_visPolygons;
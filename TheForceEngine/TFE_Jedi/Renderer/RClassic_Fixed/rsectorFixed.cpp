@@ -16,6 +16,7 @@
 #include "rclassicFixedSharedState.h"
 #include "robj3d_fixed/robj3dFixed.h"
 #include "../rcommon.h"
+#include "../rsort.h"
 
 using namespace TFE_Jedi::RClassic_Fixed;
 
@@ -75,8 +76,14 @@ namespace TFE_Jedi
 			SecObject** obj = sector->objectList;
 			s32 count = sector->objectCount;
 
-			for (s32 i = count - 1; i >= 0 && drawCount < MAX_VIEW_OBJ_COUNT; i--, obj++)
+			for (s32 i = count - 1; i >= 0; i--, obj++)
 			{
+				if (drawCount == s_viewObjLimit)
+				{
+					s_limitsExceeded |= RLIMIT_VIEW_OBJ;
+					break;
+				}
+
 				// Search for the next allocated object.
 				SecObject* curObj = *obj;
 				while (!curObj)
@@ -158,6 +165,8 @@ namespace TFE_Jedi
 
 	void TFE_Sectors_Fixed::prepare()
 	{
+		resizeBuffers();
+
 		EdgePairFixed* flatEdge = &s_rcfState.flatEdgeList[s_flatCount];
 		s_rcfState.flatEdge = flatEdge;
 		flat_addEdges(s_screenWidth, s_minScreenX_Pixels, 0, s_rcfState.windowMaxY, 0, s_rcfState.windowMinY);
@@ -258,12 +267,19 @@ namespace TFE_Jedi
 		}
 
 		RWallSegmentFixed* wallSegment = &s_rcfState.wallSegListDst[s_curWallSeg];
-		s32 drawSegCnt = wall_mergeSort(wallSegment, MAX_SEG - s_curWallSeg, startWall, drawWallCount);
+		s32 drawSegCnt = wall_mergeSort(wallSegment, s_segLimit - s_curWallSeg, startWall, drawWallCount);
 		s_curWallSeg += drawSegCnt;
 
-		TFE_ZONE_BEGIN(wallQSort, "Wall QSort");
-			qsort(wallSegment, drawSegCnt, sizeof(RWallSegmentFixed), wallSortX);
-		TFE_ZONE_END(wallQSort);
+		TFE_ZONE_BEGIN(wallSort, "Wall Sort");
+			// Sort by screen X, the keys are stored after the wall segments in the scratch buffer.
+			u32* sortKeys = s_rcfState.wallSortKeys;
+			for (s32 i = 0; i < drawSegCnt; i++)
+			{
+				sortKeys[i] = sortKey_s32(wallSegment[i].wallX0);
+			}
+			if (s_sortCapture) { sortBench_capture(SORT_BENCH_WALL_X, sortKeys, drawSegCnt); }
+			sort_byKeyAsQsort(wallSegment, sortKeys, drawSegCnt, wallSortX, s_rcfState.wallSortScratch, sortKeys + s_segLimit, s_rcfState.wallSortIndices);
+		TFE_ZONE_END(wallSort);
 
 		s32 flatCount = s_flatCount;
 		EdgePairFixed* flatEdge = &s_rcfState.flatEdgeList[s_flatCount];
@@ -271,7 +287,7 @@ namespace TFE_Jedi
 
 		s32 adjoinStart = s_adjoinSegCount;
 		EdgePairFixed* adjoinEdges = &s_rcfState.adjoinEdgeList[adjoinStart];
-		RWallSegmentFixed* adjoinList[MAX_ADJOIN_DEPTH];
+		RWallSegmentFixed** adjoinList = &s_rcfState.adjoinSegList[adjoinStart];
 
 		s_rcfState.adjoinEdge = adjoinEdges;
 		s_rcfState.adjoinSegment = adjoinList;
@@ -387,7 +403,11 @@ namespace TFE_Jedi
 
 		// Adjoins
 		s32 adjoinCount = s_adjoinSegCount - adjoinStart;
-		if (adjoinCount && s_adjoinDepth < MAX_ADJOIN_DEPTH)
+		if (adjoinCount && s_adjoinDepth >= s_adjoinDepthLimit)
+		{
+			s_limitsExceeded |= RLIMIT_ADJOIN_DEPTH;
+		}
+		else if (adjoinCount)
 		{
 			adjoin_setupAdjoinWindow(winBot, winBotNext, winTop, winTopNext, adjoinEdges, adjoinCount);
 			RWallSegmentFixed** seg = adjoinList;
@@ -403,7 +423,7 @@ namespace TFE_Jedi
 				RWall* srcWall = curAdjoinSeg->srcWall;
 				RWallSegmentFixed* nextAdjoin = (i < adjoinEnd) ? *(seg + 1) : nullptr;
 				RSector* nextSector = srcWall->nextSector;
-				if (s_adjoinDepth < MAX_ADJOIN_DEPTH && s_adjoinDepth < s_maxDepthCount)
+				if (s_adjoinDepth < s_adjoinDepthLimit && s_adjoinDepth < s_maxDepthCount)
 				{
 					s32 index = s_adjoinDepth - 1;
 					saveValues(index);
@@ -460,6 +480,7 @@ namespace TFE_Jedi
 		// Objects
 		TFE_ZONE_BEGIN(secDrawObjects, "Draw Objects");
 		const s32 objCount = cullObjects(s_curSector, s_objBuffer);
+		s_viewObjHighWater = max(s_viewObjHighWater, objCount);
 		if (objCount > 0)
 		{
 			// Which top and bottom edges are we going to use to clip objects?
@@ -12,6 +12,7 @@
 #include "redgePairFixed.h"
 #include "rclassicFixedSharedState.h"
 #include "../rcommon.h"
+#include "../rspriteCache.h"
 #include "../jediRenderer.h"
 
 namespace TFE_Jedi
@@ -334,9 +335,9 @@ namespace RClassic_Fixed
 			wall->visible = 0;
 			return;
 		}
-		if (s_nextWall == MAX_SEG)
+		if (s_nextWall == s_segLimit)
 		{
-			TFE_System::logWrite(LOG_ERROR, "ClassicRenderer", "Wall_Process : Maximum processed walls exceeded!");
+			s_limitsExceeded |= RLIMIT_SEG;
 			wall->visible = 0;
 			return;
 		}
@@ -651,7 +652,7 @@ namespace RClassic_Fixed
 				{
 					if (outIndex == availSpace)
 					{
-						TFE_System::logWrite(LOG_ERROR, "RendererClassic", "Wall_MergeSort : Maximum merged walls exceeded!");
+						s_limitsExceeded |= RLIMIT_SEG;
 					}
 					else
 					{
@@ -2136,7 +2137,7 @@ namespace RClassic_Fixed
 
 	void wall_addAdjoinSegment(s32 length, s32 x0, fixed16_16 top_dydx, fixed16_16 y1, fixed16_16 bot_dydx, fixed16_16 y0, RWallSegmentFixed* wallSegment)
 	{
-		if (s_adjoinSegCount < MAX_ADJOIN_SEG)
+		if (s_adjoinSegCount < s_adjoinSegLimit)
 		{
 			fixed16_16 lengthFixed = intToFixed16(length - 1);
 			fixed16_16 y0End = y0;
@@ -2157,6 +2158,10 @@ namespace RClassic_Fixed
 			*s_rcfState.adjoinSegment = wallSegment;
 			s_rcfState.adjoinSegment++;
 		}
+		else
+		{
+			s_limitsExceeded |= RLIMIT_ADJOIN_SEG;
+		}
 	}
 
 	void sprite_decompressColumn(const u8* colData, u8* outBuffer, s32 height)
@@ -2287,6 +2292,8 @@ namespace RClassic_Fixed
 		s_texHeightMask = 0xffff;
 
 		const u32* columnOffset = (u32*)(basePtr + cell->columnOffset);
+		// Compressed cells are decompressed once and cached.
+		const u8* cellImage = compressed ? spriteCache_getCell(basePtr, cell) : nullptr;
 		for (s32 x = x0_pixel; x <= x1_pixel; x++, uCoord += uCoordStep)
 		{
 			if (z < s_rcfState.depth1d[x])
@@ -2317,7 +2324,11 @@ namespace RClassic_Fixed
 						texelU = cell->sizeX - texelU - 1;
 					}
 										
-					if (compressed)
+					if (cellImage)
+					{
+						s_texImage = (u8*)cellImage + texelU * cell->sizeY;
+					}
+					else if (compressed)
 					{
 						const u8* colPtr = (u8*)cell + columnOffset[texelU];
 
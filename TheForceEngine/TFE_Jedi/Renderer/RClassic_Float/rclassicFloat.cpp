@@ -200,9 +200,37 @@ namespace RClassic_Float
 	void resetState()
 	{
 		s_rcfltState.depth1d_all = nullptr;
+		s_rcfltState.wallSegListSrc = nullptr;
 		s_rcfltState.skyTable = nullptr;
 	}
 
+	void resizeFrameBuffers()
+	{
+		// The segment and edge lists share a single block, largest alignment first.
+		const size_t wallSegSize    = sizeof(RWallSegmentFloat) * s_segLimit;
+		const size_t adjoinSegSize  = sizeof(RWallSegmentFloat*) * s_adjoinSegLimit;
+		const size_t flatEdgeSize   = sizeof(EdgePairFloat) * s_segLimit;
+		const size_t adjoinEdgeSize = sizeof(EdgePairFloat) * s_adjoinSegLimit;
+		const size_t sortKeySize    = sizeof(u32) * 2 * s_segLimit;
+		const size_t sortIndexSize  = sizeof(s32) * 2 * s_segLimit;
+		u8* block = (u8*)game_realloc(s_rcfltState.wallSegListSrc, 3 * wallSegSize + adjoinSegSize + flatEdgeSize + adjoinEdgeSize + sortKeySize + sortIndexSize);
+
+		s_rcfltState.wallSegListSrc  = (RWallSegmentFloat*)block;  block += wallSegSize;
+		s_rcfltState.wallSegListDst  = (RWallSegmentFloat*)block;  block += wallSegSize;
+		s_rcfltState.wallSortScratch = (RWallSegmentFloat*)block;  block += wallSegSize;
+		s_rcfltState.adjoinSegList   = (RWallSegmentFloat**)block; block += adjoinSegSize;
+		s_rcfltState.flatEdgeList    = (EdgePairFloat*)block;      block += flatEdgeSize;
+		s_rcfltState.adjoinEdgeList  = (EdgePairFloat*)block;      block += adjoinEdgeSize;
+		s_rcfltState.wallSortKeys    = (u32*)block;                block += sortKeySize;
+		s_rcfltState.wallSortIndices = (s32*)block;
+
+		// One set of window and depth values per adjoin level.
+		const s32 depthCount = s_adjoinDepthLimit + 1;
+		s_rcfltState.depth1d_all = (f32*)game_realloc(s_rcfltState.depth1d_all, s_width * sizeof(f32) * depthCount);
+		s_windowTop_all = (s32*)game_realloc(s_windowTop_all, s_width * sizeof(s32) * depthCount);
+		s_windowBot_all = (s32*)game_realloc(s_windowBot_all, s_width * sizeof(s32) * depthCount);
+	}
+
 	void buildProjectionTables(s32 xc, s32 yc, s32 w, s32 h)
 	{
 		s32 halfHeight = h >> 1;
@@ -212,15 +240,14 @@ namespace RClassic_Float
 		setupProjectionParameters(f32(halfWidth), xc, yc);
 		setWidthFraction(1.0f);
 
+		resizeFrameBuffers();
+
 		EdgePairFloat* flatEdge = &s_rcfltState.flatEdgeList[s_flatCount];
 		s_rcfltState.flatEdge = flatEdge;
 		flat_addEdges(s_screenWidth, s_minScreenX_Pixels, 0, s_rcfltState.windowMaxY, 0, s_rcfltState.windowMinY);
 		
 		s_columnTop = (s32*)game_realloc(s_columnTop, s_width * sizeof(s32));
 		s_columnBot = (s32*)game_realloc(s_columnBot, s_width * sizeof(s32));
-		s_rcfltState.depth1d_all = (f32*)game_realloc(s_rcfltState.depth1d_all, s_width * sizeof(f32) * (MAX_ADJOIN_DEPTH + 1));
-		s_windowTop_all = (s32*)game_realloc(s_windowTop_all, s_width * sizeof(s32) * (MAX_ADJOIN_DEPTH + 1));
-		s_windowBot_all = (s32*)game_realloc(s_windowBot_all, s_width * sizeof(s32) * (MAX_ADJOIN_DEPTH + 1));
 
 		memset(s_windowTop_all, s_minScreenY, s_width);
 		memset(s_windowBot_all, s_maxScreenY, s_width);
@@ -12,6 +12,8 @@ namespace TFE_Jedi
 		void resetState();
 		void setupInitCameraAndLights(s32 width, s32 height);
 		void changeResolution(s32 width, s32 height);
+		// Resize the per-frame buffers to match the current render limits.
+		void resizeFrameBuffers();
 
 		void computeCameraTransform(RSector* sector, f32 pitch, f32 yaw, f32 camX, f32 camY, f32 camZ);
 		void transformPointByCamera(vec3_float* worldPoint, vec3_float* viewPoint);
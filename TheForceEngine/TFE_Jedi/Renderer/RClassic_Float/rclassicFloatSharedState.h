@@ -54,13 +54,17 @@ namespace TFE_Jedi
 
 		// Flats
 		EdgePairFloat* flatEdge;
-		EdgePairFloat  flatEdgeList[MAX_SEG];
+		EdgePairFloat* flatEdgeList;		// [s_segLimit]
 		EdgePairFloat* adjoinEdge;
-		EdgePairFloat  adjoinEdgeList[MAX_ADJOIN_SEG * MAX_ADJOIN_DEPTH];
+		EdgePairFloat* adjoinEdgeList;	// [s_adjoinSegLimit]
 
-		RWallSegmentFloat   wallSegListDst[MAX_SEG];
-		RWallSegmentFloat   wallSegListSrc[MAX_SEG];
+		RWallSegmentFloat*  wallSegListDst;	// [s_segLimit]
+		RWallSegmentFloat*  wallSegListSrc;	// [s_segLimit]
 		RWallSegmentFloat** adjoinSegment;
+		RWallSegmentFloat** adjoinSegList;	// [s_adjoinSegLimit]
+		RWallSegmentFloat*  wallSortScratch;	// [s_segLimit]
+		u32* wallSortKeys;					// [2 * s_segLimit]
+		s32* wallSortIndices;				// [2 * s_segLimit]
 	};
 	extern RClassicFloatState s_rcfltState;
 }  // TFE_Jedi
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "rsectorFloat.h"
 #include "rflatFloat.h"
 #include "rlightingFloat.h"
+#include "rrasterFloat.h"
 #include "redgePairFloat.h"
 #include "rclassicFloat.h"
 #include "rclassicFloatSharedState.h"
@@ -38,7 +39,7 @@ namespace RClassic_Float
 		
 	void flat_addEdges(s32 length, s32 x0, f32 dyFloor_dx, f32 yFloor, f32 dyCeil_dx, f32 yCeil)
 	{
-		if (s_flatCount < MAX_SEG && length > 0)
+		if (s_flatCount < s_segLimit && length > 0)
 		{
 			const f32 lengthFlt = f32(length - 1);
 
@@ -75,76 +76,52 @@ namespace RClassic_Float
 			s_rcfltState.flatEdge++;
 			s_flatCount++;
 		}
+		else if (length > 0)
+		{
+			s_limitsExceeded |= RLIMIT_SEG;
+		}
 	}
 				
 	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
 	// to account for C vs ASM differences.
 	void drawScanline()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		if (s_rasterDeferred)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_scanlineLight[s_ftexImage[texel]];
+			raster_pushScanline(SCANFUNC_LIT, s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineLight, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
+			return;
 		}
+		s_rasterScanlineLit(s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineLight, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
 	}
 
 	void drawScanline_Fullbright()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		if (s_rasterDeferred)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_ftexImage[texel];
+			raster_pushScanline(SCANFUNC_FULLBRIGHT, s_scanlineOut, s_ftexImage, s_ftexDataEnd, nullptr, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
+			return;
 		}
+		raster_scanlineFullbright(s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
 	}
 
 	void drawScanline_Trans()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		if (s_rasterDeferred)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
-
-			if (baseColor) { s_scanlineOut[i] = s_scanlineLight[baseColor]; }
+			raster_pushScanline(SCANFUNC_LIT_TRANS, s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineLight, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
+			return;
 		}
+		s_rasterScanlineLitTrans(s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineLight, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
 	}
 
 	void drawScanline_Fullbright_Trans()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		if (s_rasterDeferred)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
-
-			if (baseColor) { s_scanlineOut[i] = baseColor; }
+			raster_pushScanline(SCANFUNC_FULLBRIGHT_TRANS, s_scanlineOut, s_ftexImage, s_ftexDataEnd, nullptr, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
+			return;
 		}
+		raster_scanlineFullbrightTrans(s_scanlineOut, s_ftexImage, s_ftexDataEnd, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX, s_scanlineWidth);
 	}
 			   
 	bool flat_setTexture(TextureData* tex)
@@ -12,7 +12,9 @@
 #include "robj3dFloat_Clipping.h"
 #include "robj3dFloat_PolygonDraw.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rrasterFloat.h"
 #include "../../rcommon.h"
+#include "../../rsort.h"
 
 namespace TFE_Jedi
 {
@@ -23,10 +25,15 @@ namespace RClassic_Float
 	void robj3d_drawVertices(s32 vertexCount, const vec3_float* vertices, u8 color, s32 size);
 	s32 polygonSort(const void* r0, const void* r1);
 
+	// Scratch space used to sort the visible polygons.
+	static Polygon* s_sortPolygons[MAX_POLYGON_COUNT_3DO];
+	static u32 s_sortPolygonKeys[MAX_POLYGON_COUNT_3DO * 2];
+	static s32 s_sortPolygonIndices[MAX_POLYGON_COUNT_3DO * 2];
+
 	void robj3d_draw(SecObject* obj, JediModel* model)
 	{
 		// Handle transforms and vertex lighting.
-		robj3d_transformAndLight(obj, model);
+		if (!robj3d_transformAndLight(obj, model)) { return; }
 
 		// Draw vertices and return if the flag is set.
 		if (model->flags & MFLAG_DRAW_VERTICES)
@@ -47,7 +54,13 @@ namespace RClassic_Float
 		if (visPolygonCount < 1) { return; }
 
 		// Sort polygons from back to front.
-		qsort(s_visPolygons, visPolygonCount, sizeof(Polygon*), polygonSort);
+		// The keys are inverted so the farthest polygons come first.
+		for (s32 i = 0; i < visPolygonCount; i++)
+		{
+			s_sortPolygonKeys[i] = ~sortKey_f32(s_visPolygons[i]->zAvef);
+		}
+		if (s_sortCapture) { sortBench_capture(SORT_BENCH_POLYGON_FLOAT, s_sortPolygonKeys, visPolygonCount); }
+		sort_byKeyAsQsort(s_visPolygons, s_sortPolygonKeys, visPolygonCount, polygonSort, s_sortPolygons, s_sortPolygonKeys + MAX_POLYGON_COUNT_3DO, s_sortPolygonIndices);
 
 		// Draw polygons
 		Polygon** visPolygon = s_visPolygons;
@@ -102,6 +115,11 @@ namespace RClassic_Float
 			{
 				const s32 x = clamp(pixel_x - halfSize + (i % size), s_minScreenX_Pixels, s_maxScreenX_Pixels);
 				const s32 y = clamp(pixel_y - halfSize + (i / size), s_windowMinY_Pixels, s_windowMaxY_Pixels);
+				if (s_rasterDeferred)
+				{
+					raster_pushPixel(&s_display[y*s_width + x], color);
+					continue;
+				}
 				s_display[y*s_width + x] = color;
 			}
 		}
@@ -4,6 +4,7 @@
 
 #include "robj3dFloat_Culling.h"
 #include "robj3dFloat_TransformAndLighting.h"
+#include "robj3dFloat_Simd.h"
 #include "../rclassicFloatSharedState.h"
 #include "../../rcommon.h"
 
@@ -51,11 +52,18 @@ namespace RClassic_Float
 			s32 facing = getPolygonFacing(polygonNormal, pos);
 			if (facing == POLYGON_BACK_FACING) { continue; }
 
-			visPolygonCount++;
 			s32 vertexCount = polygon->vertexCount;
-			f32 zAve = 0.0f;
-
 			s32* indices = polygon->indices;
+			// Skip polygons with every vertex outside of the same frustum plane, clipping would remove them anyway.
+			u32 sharedCode = VCLIP_ALL;
+			for (s32 v = 0; v < vertexCount && sharedCode; v++)
+			{
+				sharedCode &= s_vertexOutcodes[indices[v]];
+			}
+			if (sharedCode) { continue; }
+
+			visPolygonCount++;
+			f32 zAve = 0.0f;
 			for (s32 v = 0; v < vertexCount; v++)
 			{
 				zAve += s_verticesVS[indices[v]].z;
@@ -169,6 +169,14 @@ s32 robj3d_findPrevEdge(s32 minXIndex)
 #if !defined(POLY_INTENSITY) && !defined(POLY_UV)
 void robj3d_drawColumnFlatColor()
 {
+	if (s_rasterDeferred)
+	{
+		RasterPolyColumn params;
+		params.colorIndex = s_polyColorIndex;
+		raster_pushPolyColumn(POLYFUNC_FLAT_COLOR, s_pcolumnOut, s_columnHeight, &params);
+		return;
+	}
+
 	s32 end = s_columnHeight - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
@@ -187,6 +195,19 @@ void robj3d_drawColumnShadedColor()
 	u8  colorIndex = s_polyColorIndex;
 	s32 dither = s_dither;
 
+	if (s_rasterDeferred)
+	{
+		RasterPolyColumn params;
+		params.colorMap = colorMap;
+		params.colorIndex = colorIndex;
+		params.I0 = intensity;
+		params.dIdY = s_col_dIdY;
+		params.dither = dither;
+		params.ditherOffset = s_ditherOffset;
+		raster_pushPolyColumn(POLYFUNC_SHADED_COLOR, s_pcolumnOut, s_columnHeight, &params);
+		return;
+	}
+
 	s32 end = s_columnHeight - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
@@ -212,6 +233,19 @@ void robj3d_drawColumnShadedColor()
 void robj3d_drawColumnFlatTexture()
 {
 	const u8* colorMap = &s_polyColorMap[s_polyColorIndex * 256];
+	if (s_rasterDeferred)
+	{
+		RasterPolyColumn params;
+		params.colorMap = colorMap;
+		params.texture = s_polyTexture;
+		params.U0 = s_col_Uv0.x;
+		params.V0 = s_col_Uv0.z;
+		params.dUdY = s_col_dUVdY.x;
+		params.dVdY = s_col_dUVdY.z;
+		raster_pushPolyColumn(POLYFUNC_FLAT_TEXTURE, s_pcolumnOut, s_columnHeight, &params);
+		return;
+	}
+
 	const u8* textureData = s_polyTexture->image;
 	const s32 texHeight = s_polyTexture->height;
 	const s32 texWidthMask = s_polyTexture->width - 1;
@@ -237,6 +271,21 @@ void robj3d_drawColumnFlatTexture()
 void robj3d_drawColumnShadedTexture()
 {
 	const u8* colorMap = s_polyColorMap;
+	if (s_rasterDeferred)
+	{
+		RasterPolyColumn params;
+		params.colorMap = colorMap;
+		params.texture = s_polyTexture;
+		params.I0 = s_col_I0;
+		params.dIdY = s_col_dIdY;
+		params.U0 = s_col_Uv0.x;
+		params.V0 = s_col_Uv0.z;
+		params.dUdY = s_col_dUVdY.x;
+		params.dVdY = s_col_dUVdY.z;
+		raster_pushPolyColumn(POLYFUNC_SHADED_TEXTURE, s_pcolumnOut, s_columnHeight, &params);
+		return;
+	}
+
 	const u8* textureData = s_polyTexture->image;
 	const s32 texHeight = s_polyTexture->height;
 	const s32 texWidthMask = s_polyTexture->width - 1;
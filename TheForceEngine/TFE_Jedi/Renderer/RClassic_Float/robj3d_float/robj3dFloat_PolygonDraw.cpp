@@ -14,6 +14,7 @@
 #include "../rflatFloat.h"
 #include "../rclassicFloatSharedState.h"
 #include "../rlightingFloat.h"
+#include "../rrasterFloat.h"
 #include "../../rcommon.h"
 
 namespace TFE_Jedi
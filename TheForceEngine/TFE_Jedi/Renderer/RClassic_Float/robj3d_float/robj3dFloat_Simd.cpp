@@ -0,0 +1,187 @@
+#include "robj3dFloat_Simd.h"
+#include "robj3dFloat_TransformAndLighting.h"
+#include "../rclassicFloatSharedState.h"
+#include "../rrasterFloat.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define OBJ3D_X86 1
+	#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+	#define OBJ3D_NEON 1
+	#include <arm_neon.h>
+#endif
+
+// MSVC allows intrinsics for any instruction set, GCC and Clang need the target enabled per function.
+#if defined(_MSC_VER)
+	#define OBJ3D_TARGET_SSE2
+	#define OBJ3D_TARGET_AVX2
+#else
+	#define OBJ3D_TARGET_SSE2 __attribute__((target("sse2")))
+	#define OBJ3D_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	// Scalar
+	#define SIMD_FUNC(name) name##_Scalar
+	#define SIMD_TARGET
+	#define SIMD_LANES 1
+	#define SIMD_VECF f32
+	#define SIMD_LOADF(p) (*(p))
+	#define SIMD_STOREF(p, a) (*(p) = (a))
+	#define SIMD_SET1F(x) f32(x)
+	#define SIMD_ADDF(a, b) ((a) + (b))
+	#define SIMD_SUBF(a, b) ((a) - (b))
+	#define SIMD_MULF(a, b) ((a) * (b))
+	#define SIMD_CMPLTF(a, b) ((a) < (b))
+	#define SIMD_CMPGTF(a, b) ((a) > (b))
+	#define SIMD_SELECTF(m, a) ((m) ? (a) : 0.0f)
+	#define SIMD_MASKBITS(m) u32(m)
+	#include "robj3dFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VECF
+	#undef SIMD_LOADF
+	#undef SIMD_STOREF
+	#undef SIMD_SET1F
+	#undef SIMD_ADDF
+	#undef SIMD_SUBF
+	#undef SIMD_MULF
+	#undef SIMD_CMPLTF
+	#undef SIMD_CMPGTF
+	#undef SIMD_SELECTF
+	#undef SIMD_MASKBITS
+
+#if OBJ3D_X86
+	// SSE2
+	#define SIMD_FUNC(name) name##_SSE2
+	#define SIMD_TARGET OBJ3D_TARGET_SSE2
+	#define SIMD_LANES 4
+	#define SIMD_VECF __m128
+	#define SIMD_LOADF(p) _mm_loadu_ps(p)
+	#define SIMD_STOREF(p, a) _mm_storeu_ps(p, a)
+	#define SIMD_SET1F(x) _mm_set1_ps(x)
+	#define SIMD_ADDF(a, b) _mm_add_ps(a, b)
+	#define SIMD_SUBF(a, b) _mm_sub_ps(a, b)
+	#define SIMD_MULF(a, b) _mm_mul_ps(a, b)
+	#define SIMD_CMPLTF(a, b) _mm_cmplt_ps(a, b)
+	#define SIMD_CMPGTF(a, b) _mm_cmpgt_ps(a, b)
+	#define SIMD_SELECTF(m, a) _mm_and_ps(m, a)
+	#define SIMD_MASKBITS(m) u32(_mm_movemask_ps(m))
+	#include "robj3dFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VECF
+	#undef SIMD_LOADF
+	#undef SIMD_STOREF
+	#undef SIMD_SET1F
+	#undef SIMD_ADDF
+	#undef SIMD_SUBF
+	#undef SIMD_MULF
+	#undef SIMD_CMPLTF
+	#undef SIMD_CMPGTF
+	#undef SIMD_SELECTF
+	#undef SIMD_MASKBITS
+
+	// AVX2
+	#define SIMD_FUNC(name) name##_AVX2
+	#define SIMD_TARGET OBJ3D_TARGET_AVX2
+	#define SIMD_LANES 8
+	#define SIMD_VECF __m256
+	#define SIMD_LOADF(p) _mm256_loadu_ps(p)
+	#define SIMD_STOREF(p, a) _mm256_storeu_ps(p, a)
+	#define SIMD_SET1F(x) _mm256_set1_ps(x)
+	#define SIMD_ADDF(a, b) _mm256_add_ps(a, b)
+	#define SIMD_SUBF(a, b) _mm256_sub_ps(a, b)
+	#define SIMD_MULF(a, b) _mm256_mul_ps(a, b)
+	#define SIMD_CMPLTF(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+	#define SIMD_CMPGTF(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+	#define SIMD_SELECTF(m, a) _mm256_and_ps(m, a)
+	#define SIMD_MASKBITS(m) u32(_mm256_movemask_ps(m))
+	#include "robj3dFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VECF
+	#undef SIMD_LOADF
+	#undef SIMD_STOREF
+	#undef SIMD_SET1F
+	#undef SIMD_ADDF
+	#undef SIMD_SUBF
+	#undef SIMD_MULF
+	#undef SIMD_CMPLTF
+	#undef SIMD_CMPGTF
+	#undef SIMD_SELECTF
+	#undef SIMD_MASKBITS
+#endif
+
+#if OBJ3D_NEON
+	inline u32 neon_maskBits(uint32x4_t mask)
+	{
+		u32 lanes[4];
+		vst1q_u32(lanes, mask);
+		return (lanes[0] & 1) | ((lanes[1] & 1) << 1) | ((lanes[2] & 1) << 2) | ((lanes[3] & 1) << 3);
+	}
+
+	// NEON
+	#define SIMD_FUNC(name) name##_NEON
+	#define SIMD_TARGET
+	#define SIMD_LANES 4
+	#define SIMD_VECF float32x4_t
+	#define SIMD_LOADF(p) vld1q_f32(p)
+	#define SIMD_STOREF(p, a) vst1q_f32(p, a)
+	#define SIMD_SET1F(x) vdupq_n_f32(x)
+	#define SIMD_ADDF(a, b) vaddq_f32(a, b)
+	#define SIMD_SUBF(a, b) vsubq_f32(a, b)
+	#define SIMD_MULF(a, b) vmulq_f32(a, b)
+	#define SIMD_CMPLTF(a, b) vcltq_f32(a, b)
+	#define SIMD_CMPGTF(a, b) vcgtq_f32(a, b)
+	#define SIMD_SELECTF(m, a) vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(a)))
+	#define SIMD_MASKBITS(m) neon_maskBits(m)
+	#include "robj3dFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VECF
+	#undef SIMD_LOADF
+	#undef SIMD_STOREF
+	#undef SIMD_SET1F
+	#undef SIMD_ADDF
+	#undef SIMD_SUBF
+	#undef SIMD_MULF
+	#undef SIMD_CMPLTF
+	#undef SIMD_CMPGTF
+	#undef SIMD_SELECTF
+	#undef SIMD_MASKBITS
+#endif
+
+	// Indexed by RasterSimd, instruction sets that are not built fall back to scalar.
+	static const Obj3dKernels c_obj3dKernels[RSIMD_COUNT] =
+	{
+		{ robj3d_transformStreams_Scalar, robj3d_classifyVertices_Scalar, robj3d_lightVertices_Scalar },	// RSIMD_SCALAR
+	#if OBJ3D_X86
+		{ robj3d_transformStreams_SSE2, robj3d_classifyVertices_SSE2, robj3d_lightVertices_SSE2 },			// RSIMD_SSE2
+		{ robj3d_transformStreams_AVX2, robj3d_classifyVertices_AVX2, robj3d_lightVertices_AVX2 },			// RSIMD_AVX2
+	#else
+		{ robj3d_transformStreams_Scalar, robj3d_classifyVertices_Scalar, robj3d_lightVertices_Scalar },	// RSIMD_SSE2
+		{ robj3d_transformStreams_Scalar, robj3d_classifyVertices_Scalar, robj3d_lightVertices_Scalar },	// RSIMD_AVX2
+	#endif
+	#if OBJ3D_NEON
+		{ robj3d_transformStreams_NEON, robj3d_classifyVertices_NEON, robj3d_lightVertices_NEON },			// RSIMD_NEON
+	#else
+		{ robj3d_transformStreams_Scalar, robj3d_classifyVertices_Scalar, robj3d_lightVertices_Scalar },	// RSIMD_NEON
+	#endif
+	};
+
+	const Obj3dKernels* robj3d_getKernels()
+	{
+		return &c_obj3dKernels[raster_getSimd()];
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,50 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// 3D Object vertex kernels
+// Dark Forces Derived Renderer - batched vertex processing
+//
+// Vertices are processed as structure of arrays, several vertices
+// at a time, using the instruction set selected for the float
+// rasterizer. The SIMD kernels perform the same operations in the
+// same order as the scalar kernels, so the results are identical.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Asset/modelAsset_jedi.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "../rlightingFloat.h"
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		// Per vertex frustum outcodes, a bit is set if the vertex is outside of the plane.
+		// The planes match the ones used by the polygon clipper.
+		enum VertexClipCode
+		{
+			VCLIP_NEAR   = FLAG_BIT(0),
+			VCLIP_LEFT   = FLAG_BIT(1),
+			VCLIP_RIGHT  = FLAG_BIT(2),
+			VCLIP_TOP    = FLAG_BIT(3),
+			VCLIP_BOTTOM = FLAG_BIT(4),
+			VCLIP_ALL    = VCLIP_NEAR | VCLIP_LEFT | VCLIP_RIGHT | VCLIP_TOP | VCLIP_BOTTOM,
+		};
+
+		// Transform the input streams by the 3x3 matrix and add the offset.
+		// Whole vectors are processed, so the output streams must hold the padded count.
+		typedef void(*Obj3dTransformFunc)(s32 count, const VertexStreams* vtxIn, const f32* xform, const vec3_float* offset, const VertexStreams* vtxOut);
+		// Compute the outcode of each view space vertex, returns the outcode bits shared by all of the vertices.
+		typedef u32(*Obj3dClassifyFunc)(s32 count, const VertexStreams* vtx, u8* outcodes);
+		// Sum the intensity from the camera lights for each vertex, normals are stored as vertex + normal.
+		typedef void(*Obj3dLightFunc)(s32 count, const VertexStreams* vtx, const VertexStreams* normals, const CameraLightFlt* lights, s32 lightCount, f32* outIntensity);
+
+		struct Obj3dKernels
+		{
+			Obj3dTransformFunc transform;
+			Obj3dClassifyFunc  classify;
+			Obj3dLightFunc     light;
+		};
+
+		// Kernels for the instruction set used by the float rasterizer.
+		const Obj3dKernels* robj3d_getKernels();
+	}
+}
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////
+// Inline 3D object vertex kernels
+// Included once per instruction set by robj3dFloat_Simd.cpp, the
+// following must be defined:
+//   SIMD_FUNC(name)         - decorate the function name.
+//   SIMD_TARGET             - function attributes required by the ISA.
+//   SIMD_LANES              - the number of 32-bit lanes.
+//   SIMD_VECF               - the float vector type.
+//   SIMD_LOADF(p)           - unaligned load.
+//   SIMD_STOREF(p, a)       - unaligned store.
+//   SIMD_SET1F(x)           - broadcast x to all lanes.
+//   SIMD_ADDF, SIMD_SUBF, SIMD_MULF
+//   SIMD_CMPLTF, SIMD_CMPGTF
+//   SIMD_SELECTF(mask, a)   - a where the mask is set, otherwise 0.
+//   SIMD_MASKBITS(mask)     - lane k of the mask in bit k.
+//
+// The scalar kernels are built from the same code with one lane.
+// Input streams are padded to MODEL_STREAM_PAD, so whole vectors are
+// always loaded; lanes past the count are computed but not used.
+//////////////////////////////////////////////////////////////////////
+
+SIMD_TARGET void SIMD_FUNC(robj3d_transformStreams)(s32 count, const VertexStreams* vtxIn, const f32* xform, const vec3_float* offset, const VertexStreams* vtxOut)
+{
+	const SIMD_VECF m0 = SIMD_SET1F(xform[0]), m1 = SIMD_SET1F(xform[1]), m2 = SIMD_SET1F(xform[2]);
+	const SIMD_VECF m3 = SIMD_SET1F(xform[3]), m4 = SIMD_SET1F(xform[4]), m5 = SIMD_SET1F(xform[5]);
+	const SIMD_VECF m6 = SIMD_SET1F(xform[6]), m7 = SIMD_SET1F(xform[7]), m8 = SIMD_SET1F(xform[8]);
+	const SIMD_VECF offsetX = SIMD_SET1F(offset->x);
+	const SIMD_VECF offsetY = SIMD_SET1F(offset->y);
+	const SIMD_VECF offsetZ = SIMD_SET1F(offset->z);
+
+	for (s32 i = 0; i < count; i += SIMD_LANES)
+	{
+		const SIMD_VECF x = SIMD_LOADF(&vtxIn->x[i]);
+		const SIMD_VECF y = SIMD_LOADF(&vtxIn->y[i]);
+		const SIMD_VECF z = SIMD_LOADF(&vtxIn->z[i]);
+
+		SIMD_STOREF(&vtxOut->x[i], SIMD_ADDF(SIMD_ADDF(SIMD_ADDF(SIMD_MULF(x, m0), SIMD_MULF(y, m3)), SIMD_MULF(z, m6)), offsetX));
+		SIMD_STOREF(&vtxOut->y[i], SIMD_ADDF(SIMD_ADDF(SIMD_ADDF(SIMD_MULF(x, m1), SIMD_MULF(y, m4)), SIMD_MULF(z, m7)), offsetY));
+		SIMD_STOREF(&vtxOut->z[i], SIMD_ADDF(SIMD_ADDF(SIMD_ADDF(SIMD_MULF(x, m2), SIMD_MULF(y, m5)), SIMD_MULF(z, m8)), offsetZ));
+	}
+}
+
+SIMD_TARGET u32 SIMD_FUNC(robj3d_classifyVertices)(s32 count, const VertexStreams* vtx, u8* outcodes)
+{
+	const SIMD_VECF zero = SIMD_SET1F(0.0f);
+	const SIMD_VECF nearZ = SIMD_SET1F(1.0f);
+	const SIMD_VECF halfLen = SIMD_SET1F(s_rcfltState.nearPlaneHalfLen);
+	const SIMD_VECF planeTop = SIMD_SET1F(s_rcfltState.yPlaneTop);
+	const SIMD_VECF planeBot = SIMD_SET1F(s_rcfltState.yPlaneBot);
+
+	u32 sharedCode = VCLIP_ALL;
+	for (s32 i = 0; i < count; i += SIMD_LANES)
+	{
+		const SIMD_VECF x = SIMD_LOADF(&vtx->x[i]);
+		const SIMD_VECF y = SIMD_LOADF(&vtx->y[i]);
+		const SIMD_VECF z = SIMD_LOADF(&vtx->z[i]);
+		const SIMD_VECF planeX = SIMD_MULF(z, halfLen);
+
+		const u32 nearBits  = SIMD_MASKBITS(SIMD_CMPLTF(z, nearZ));
+		const u32 leftBits  = SIMD_MASKBITS(SIMD_CMPLTF(x, SIMD_SUBF(zero, planeX)));
+		const u32 rightBits = SIMD_MASKBITS(SIMD_CMPGTF(x, planeX));
+		const u32 topBits   = SIMD_MASKBITS(SIMD_CMPLTF(y, SIMD_MULF(planeTop, z)));
+		const u32 botBits   = SIMD_MASKBITS(SIMD_CMPGTF(y, SIMD_MULF(planeBot, z)));
+
+		const s32 laneCount = min(SIMD_LANES, count - i);
+		for (s32 k = 0; k < laneCount; k++)
+		{
+			const u32 code = ((nearBits >> k) & 1) | (((leftBits >> k) & 1) << 1) | (((rightBits >> k) & 1) << 2) |
+				(((topBits >> k) & 1) << 3) | (((botBits >> k) & 1) << 4);
+			outcodes[i + k] = u8(code);
+			sharedCode &= code;
+		}
+	}
+	return sharedCode;
+}
+
+SIMD_TARGET void SIMD_FUNC(robj3d_lightVertices)(s32 count, const VertexStreams* vtx, const VertexStreams* normals, const CameraLightFlt* lights, s32 lightCount, f32* outIntensity)
+{
+	const SIMD_VECF zero = SIMD_SET1F(0.0f);
+	for (s32 i = 0; i < count; i += SIMD_LANES)
+	{
+		const SIMD_VECF x = SIMD_LOADF(&vtx->x[i]);
+		const SIMD_VECF y = SIMD_LOADF(&vtx->y[i]);
+		const SIMD_VECF z = SIMD_LOADF(&vtx->z[i]);
+		const SIMD_VECF nx = SIMD_SUBF(SIMD_LOADF(&normals->x[i]), x);
+		const SIMD_VECF ny = SIMD_SUBF(SIMD_LOADF(&normals->y[i]), y);
+		const SIMD_VECF nz = SIMD_SUBF(SIMD_LOADF(&normals->z[i]), z);
+
+		SIMD_VECF intensity = zero;
+		for (s32 l = 0; l < lightCount; l++)
+		{
+			const CameraLightFlt* light = &lights[l];
+			const SIMD_VECF dx = SIMD_SUBF(SIMD_ADDF(x, SIMD_SET1F(light->lightVS.x)), x);
+			const SIMD_VECF dy = SIMD_SUBF(SIMD_ADDF(y, SIMD_SET1F(light->lightVS.y)), y);
+			const SIMD_VECF dz = SIMD_SUBF(SIMD_ADDF(z, SIMD_SET1F(light->lightVS.z)), z);
+			const SIMD_VECF I = SIMD_ADDF(SIMD_ADDF(SIMD_MULF(nx, dx), SIMD_MULF(ny, dy)), SIMD_MULF(nz, dz));
+
+			// Only lights facing the vertex contribute.
+			const SIMD_VECF sourceIntensity = SIMD_SET1F(VSHADE_MAX_INTENSITY_FLT * light->brightness);
+			intensity = SIMD_ADDF(intensity, SIMD_SELECTF(SIMD_CMPGTF(I, zero), SIMD_MULF(I, sourceIntensity)));
+		}
+		SIMD_STOREF(&outIntensity[i], intensity);
+	}
+}
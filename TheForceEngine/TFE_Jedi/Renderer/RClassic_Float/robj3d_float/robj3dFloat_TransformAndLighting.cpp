@@ -2,6 +2,7 @@
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include "robj3dFloat_TransformAndLighting.h"
+#include "robj3dFloat_Simd.h"
 #include "../rclassicFloatSharedState.h"
 #include "../rlightingFloat.h"
 #include "../../rcommon.h"
@@ -21,25 +22,47 @@ namespace RClassic_Float
 	/////////////////////////////////////////////
 	// Vertex attributes transformed to viewspace.
 	vec3_float s_verticesVS[MAX_VERTEX_COUNT_3DO];
-	vec3_float s_vertexNormalsVS[MAX_VERTEX_COUNT_3DO];
 	// Vertex Lighting.
 	f32 s_vertexIntensity[MAX_VERTEX_COUNT_3DO];
+	// Frustum outcodes of the viewspace vertices (VertexClipCode).
+	u8 s_vertexOutcodes[MAX_VERTEX_COUNT_3DO];
 
 	/////////////////////////////////////////////
 	// Polygon Processing
 	/////////////////////////////////////////////
 	// Polygon normals in viewspace (used for culling).
 	vec3_float s_polygonNormalsVS[MAX_POLYGON_COUNT_3DO];
-			
-	void robj3d_transformVertices(s32 vertexCount, vec3_fixed* vtxIn, f32* xform, vec3_float* offset, vec3_float* vtxOut)
+
+	/////////////////////////////////////////////
+	// Structure of arrays working buffers
+	// The kernels write whole vectors, so these
+	// are padded like the model streams.
+	/////////////////////////////////////////////
+	enum
 	{
-		for (s32 v = 0; v < vertexCount; v++, vtxOut++, vtxIn++)
+		VERTEX_STREAM_SIZE  = MAX_VERTEX_COUNT_3DO  + MODEL_STREAM_PAD,
+		POLYGON_STREAM_SIZE = MAX_POLYGON_COUNT_3DO + MODEL_STREAM_PAD,
+	};
+	static f32 s_vertexStreamData[3][VERTEX_STREAM_SIZE];
+	static f32 s_vertexNormalStreamData[3][VERTEX_STREAM_SIZE];
+	static f32 s_polygonNormalStreamData[3][POLYGON_STREAM_SIZE];
+	static f32 s_vertexLightIntensity[VERTEX_STREAM_SIZE];
+
+	static const VertexStreams s_vertexStreamsVS        = { s_vertexStreamData[0], s_vertexStreamData[1], s_vertexStreamData[2] };
+	static const VertexStreams s_vertexNormalStreamsVS  = { s_vertexNormalStreamData[0], s_vertexNormalStreamData[1], s_vertexNormalStreamData[2] };
+	static const VertexStreams s_polygonNormalStreamsVS = { s_polygonNormalStreamData[0], s_polygonNormalStreamData[1], s_polygonNormalStreamData[2] };
+
+	// The rest of the object renderer works on arrays of vectors.
+	void robj3d_streamsToVec3(s32 count, const VertexStreams* streams, vec3_float* out)
+	{
+		const f32* x = streams->x;
+		const f32* y = streams->y;
+		const f32* z = streams->z;
+		for (s32 i = 0; i < count; i++, out++)
 		{
-			const vec3_float vtxFlt = { fixed16ToFloat(vtxIn->x), fixed16ToFloat(vtxIn->y), fixed16ToFloat(vtxIn->z) };
-
-			vtxOut->x = (vtxFlt.x*xform[0]) + (vtxFlt.y*xform[3]) + (vtxFlt.z*xform[6]) + offset->x;
-			vtxOut->y = (vtxFlt.x*xform[1]) + (vtxFlt.y*xform[4]) + (vtxFlt.z*xform[7]) + offset->y;
-			vtxOut->z = (vtxFlt.x*xform[2]) + (vtxFlt.y*xform[5]) + (vtxFlt.z*xform[8]) + offset->z;
+			out->x = x[i];
+			out->y = y[i];
+			out->z = z[i];
 		}
 	}
 
@@ -65,28 +88,11 @@ namespace RClassic_Float
 		mtxOut[8] = (mtx0[2] * mtx1Flt[2]) + (mtx0[5] * mtx1Flt[5]) + (mtx0[8] * mtx1Flt[8]);
 	}
 
-	f32 robj3d_dotProduct(const vec3_float* pos, const vec3_float* normal, const vec3_float* dir)
-	{
-		f32 nx = normal->x - pos->x;
-		f32 ny = normal->y - pos->y;
-		f32 nz = normal->z - pos->z;
-
-		f32 dx = dir->x - pos->x;
-		f32 dy = dir->y - pos->y;
-		f32 dz = dir->z - pos->z;
-
-		f32 ndx = nx * dx;
-		f32 ndy = ny * dy;
-		f32 ndz = nz * dz;
-
-		return ndx + ndy + ndz;
-	}
-		
-	void robj3d_shadeVertices(s32 vertexCount, f32* outShading, const vec3_float* vertices, const vec3_float* normals)
+	// The camera light contribution (lightIntensity) is computed by the vertex kernels.
+	void robj3d_shadeVertices(s32 vertexCount, f32* outShading, const vec3_float* vertices, const f32* lightIntensity)
 	{
-		const vec3_float* normal = normals;
 		const vec3_float* vertex = vertices;
-		for (s32 i = 0; i < vertexCount; i++, normal++, vertex++, outShading++)
+		for (s32 i = 0; i < vertexCount; i++, vertex++, outShading++)
 		{
 			f32 intensity = 0.0f;
 			if (s_sectorAmbient >= 31)
@@ -95,28 +101,7 @@ namespace RClassic_Float
 			}
 			else
 			{
-				f32 lightIntensity = intensity;
-
-				// Lighting
-				for (s32 i = 0; i < s_lightCount; i++)
-				{
-					const CameraLightFlt* light = &s_cameraLight[i];
-					const vec3_float dir =
-					{
-						vertex->x + light->lightVS.x,
-						vertex->y + light->lightVS.y,
-						vertex->z + light->lightVS.z
-					};
-
-					const f32 I = robj3d_dotProduct(vertex, normal, &dir);
-					if (I > 0.0f)
-					{
-						f32 source = light->brightness;
-						f32 sourceIntensity = VSHADE_MAX_INTENSITY_FLT * source;
-						lightIntensity += (I * sourceIntensity);
-					}
-				}
-				intensity += lightIntensity * fixed16ToFloat(s_sectorAmbientFraction);
+				intensity += lightIntensity[i] * fixed16ToFloat(s_sectorAmbientFraction);
 
 				// Distance falloff
 				const f32 z = max(0.0f, vertex->z);
@@ -138,8 +123,10 @@ namespace RClassic_Float
 		}
 	}
 		
-	void robj3d_transformAndLight(SecObject* obj, JediModel* model)
+	JBool robj3d_transformAndLight(SecObject* obj, JediModel* model)
 	{
+		const Obj3dKernels* kernels = robj3d_getKernels();
+
 		vec3_float offsetWS;
 		offsetWS.x = fixed16ToFloat(obj->posWS.x) - s_rcfltState.cameraPos.x;
 		offsetWS.y = fixed16ToFloat(obj->posWS.y) - s_rcfltState.eyeHeight;
@@ -154,20 +141,33 @@ namespace RClassic_Float
 		robj3d_mulMatrix3x3(s_rcfltState.cameraMtx, obj->transform, xform);
 
 		// Transform model vertices into view space.
-		robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertices, xform, &offsetVS, s_verticesVS);
+		kernels->transform(model->vertexCount, &model->vertexStreams, xform, &offsetVS, &s_vertexStreamsVS);
+		robj3d_streamsToVec3(model->vertexCount, &s_vertexStreamsVS, s_verticesVS);
 
 		// No need for polygon normals or lighting if MFLAG_DRAW_VERTICES is set.
-		if (model->flags & MFLAG_DRAW_VERTICES) { return; }
+		if (model->flags & MFLAG_DRAW_VERTICES) { return JTRUE; }
+
+		// Nothing is visible if all of the vertices are outside of the same frustum plane.
+		if (kernels->classify(model->vertexCount, &s_vertexStreamsVS, s_vertexOutcodes))
+		{
+			return JFALSE;
+		}
 
 		// Polygon normals (used for backface culling)
-		robj3d_transformVertices(model->polygonCount, (vec3_fixed*)model->polygonNormals, xform, &offsetVS, s_polygonNormalsVS);
+		kernels->transform(model->polygonCount, &model->polygonNormalStreams, xform, &offsetVS, &s_polygonNormalStreamsVS);
+		robj3d_streamsToVec3(model->polygonCount, &s_polygonNormalStreamsVS, s_polygonNormalsVS);
 
 		// Lighting
 		if (model->flags & MFLAG_VERTEX_LIT)
 		{
-			robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertexNormals, xform, &offsetVS, s_vertexNormalsVS);
-			robj3d_shadeVertices(model->vertexCount, s_vertexIntensity, s_verticesVS, s_vertexNormalsVS);
+			if (s_sectorAmbient < 31)
+			{
+				kernels->transform(model->vertexCount, &model->vertexNormalStreams, xform, &offsetVS, &s_vertexNormalStreamsVS);
+				kernels->light(model->vertexCount, &s_vertexStreamsVS, &s_vertexNormalStreamsVS, s_cameraLight, s_lightCount, s_vertexLightIntensity);
+			}
+			robj3d_shadeVertices(model->vertexCount, s_vertexIntensity, s_verticesVS, s_vertexLightIntensity);
 		}
+		return JTRUE;
 	}
 
 }}  // TFE_Jedi
\ No newline at end of file
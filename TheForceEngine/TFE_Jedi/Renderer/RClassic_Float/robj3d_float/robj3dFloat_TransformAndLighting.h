@@ -18,12 +18,14 @@ namespace TFE_Jedi
 		extern s32 s_enableFlatShading;
 		// Vertex attributes transformed to viewspace.
 		extern vec3_float s_verticesVS[MAX_VERTEX_COUNT_3DO];
-		extern vec3_float s_vertexNormalsVS[MAX_VERTEX_COUNT_3DO];
 		// Vertex Lighting.
 		extern f32 s_vertexIntensity[MAX_VERTEX_COUNT_3DO];
+		// Frustum outcodes of the viewspace vertices (VertexClipCode).
+		extern u8 s_vertexOutcodes[MAX_VERTEX_COUNT_3DO];
 		// Polygon normals in viewspace (used for culling).
 		extern vec3_float s_polygonNormalsVS[MAX_POLYGON_COUNT_3DO];
 
-		void robj3d_transformAndLight(SecObject* obj, JediModel* model);
+		// Returns JFALSE if the model is entirely outside of the view frustum.
+		JBool robj3d_transformAndLight(SecObject* obj, JediModel* model);
 	}
 }
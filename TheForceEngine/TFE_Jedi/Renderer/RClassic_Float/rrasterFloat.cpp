@@ -0,0 +1,435 @@
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_System/Threads/thread.h>
+#include <TFE_System/Threads/signal.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "rrasterFloat.h"
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	enum RasterCmdType
+	{
+		RCMD_COLUMN = 0,
+		RCMD_COLUMN_COMPRESSED,
+		RCMD_SCANLINE,
+		RCMD_POLY_COLUMN,
+		RCMD_PIXEL,
+	};
+
+	struct RasterColumn
+	{
+		const u8* tex;
+		const u8* light;
+		fixed44_20 vCoord;
+		fixed44_20 vStep;
+		s32 heightMask;
+		s32 texHeight;
+	};
+
+	struct RasterScanline
+	{
+		const u8* tex;
+		const u8* light;
+		fixed44_20 U;
+		fixed44_20 V;
+		fixed44_20 dUdX;
+		fixed44_20 dVdX;
+		s32 dataEnd;
+	};
+
+	struct RasterCmd
+	{
+		u8  type;
+		u8  func;
+		u8  color;
+		s32 count;
+		u8* out;
+		union
+		{
+			RasterColumn column;
+			RasterScanline scanline;
+			RasterPolyColumn poly;
+		};
+	};
+
+	struct RasterBand
+	{
+		RasterCmd* cmd;
+		s32 cmdCount;
+		s32 cmdCapacity;
+
+		// Worker data, unused for band 0 which is executed on the main thread.
+		Thread* thread;
+		Signal* start;
+	};
+
+	JBool s_rasterDeferred = JFALSE;
+
+	static RasterBand s_bands[MAX_RASTER_THREADS] = { 0 };
+	static s32 s_bandCount = 1;
+	static s32 s_bandWidth = 0;
+	static u8* s_columnBand = nullptr;
+	static s32 s_columnBandCapacity = 0;
+
+	static Signal* s_bandsDone = nullptr;
+	static atomic_s32 s_bandsRemaining;
+	static std::atomic<bool> s_workersRunning;
+
+	TFE_THREADRET TFE_STDCALL raster_workerFunc(void* userData);
+	void raster_executeBand(RasterBand* band);
+	void raster_stopWorkers();
+
+	void raster_destroy()
+	{
+		raster_stopWorkers();
+		for (s32 i = 0; i < MAX_RASTER_THREADS; i++)
+		{
+			free(s_bands[i].cmd);
+			s_bands[i].cmd = nullptr;
+			s_bands[i].cmdCount = 0;
+			s_bands[i].cmdCapacity = 0;
+		}
+		free(s_columnBand);
+		s_columnBand = nullptr;
+		s_columnBandCapacity = 0;
+		s_bandWidth = 0;
+		s_rasterDeferred = JFALSE;
+	}
+
+	void raster_stopWorkers()
+	{
+		s_workersRunning.store(false);
+		for (s32 i = 1; i < MAX_RASTER_THREADS; i++)
+		{
+			if (s_bands[i].thread && s_bands[i].thread->isRunning())
+			{
+				s_bands[i].start->fire();
+				s_bands[i].thread->waitOnExit();
+			}
+			delete s_bands[i].thread;
+			delete s_bands[i].start;
+			s_bands[i].thread = nullptr;
+			s_bands[i].start = nullptr;
+		}
+		delete s_bandsDone;
+		s_bandsDone = nullptr;
+		s_bandCount = 1;
+	}
+
+	bool raster_startWorkers(s32 bandCount)
+	{
+		s_bandsDone = Signal::create();
+		s_workersRunning.store(true);
+
+		char name[32];
+		for (s32 i = 1; i < bandCount; i++)
+		{
+			sprintf(name, "RasterThread%d", i);
+			s_bands[i].start = Signal::create();
+			s_bands[i].thread = Thread::create(name, raster_workerFunc, &s_bands[i]);
+			if (!s_bands[i].start || !s_bands[i].thread || !s_bands[i].thread->run())
+			{
+				TFE_System::logWrite(LOG_ERROR, "Renderer", "Cannot create raster thread %d, falling back to single-threaded rasterization.", i);
+				raster_stopWorkers();
+				return false;
+			}
+		}
+		s_bandCount = bandCount;
+		return true;
+	}
+
+	// Assign each screen column to a band, bands are contiguous and roughly equal in width.
+	void raster_buildColumnBands()
+	{
+		if (s_width > s_columnBandCapacity)
+		{
+			s_columnBandCapacity = s_width;
+			s_columnBand = (u8*)realloc(s_columnBand, s_columnBandCapacity);
+		}
+		for (s32 b = 0; b < s_bandCount; b++)
+		{
+			const s32 x0 = b * s_width / s_bandCount;
+			const s32 x1 = (b + 1) * s_width / s_bandCount;
+			memset(&s_columnBand[x0], b, x1 - x0);
+		}
+		s_bandWidth = s_width;
+	}
+
+	void raster_beginFrame(s32 threadCount)
+	{
+		threadCount = clamp(threadCount, 1, MAX_RASTER_THREADS);
+		if (threadCount > s_width) { threadCount = 1; }
+
+		if (threadCount != s_bandCount)
+		{
+			raster_stopWorkers();
+			if (threadCount > 1 && raster_startWorkers(threadCount))
+			{
+				raster_buildColumnBands();
+			}
+		}
+		else if (s_bandCount > 1 && s_bandWidth != s_width)
+		{
+			raster_buildColumnBands();
+		}
+
+		s_rasterDeferred = s_bandCount > 1 ? JTRUE : JFALSE;
+		for (s32 i = 0; i < s_bandCount; i++)
+		{
+			s_bands[i].cmdCount = 0;
+		}
+	}
+
+	void raster_endFrame()
+	{
+		if (!s_rasterDeferred) { return; }
+		s_rasterDeferred = JFALSE;
+
+		TFE_ZONE("Rasterize");
+		s_bandsRemaining.store(s_bandCount - 1);
+		for (s32 i = 1; i < s_bandCount; i++)
+		{
+			s_bands[i].start->fire();
+		}
+		raster_executeBand(&s_bands[0]);
+		// The last worker to finish always fires the signal, so wait even if the count already reached zero -
+		// this also resets the signal before the next frame.
+		s_bandsDone->wait();
+	}
+
+	TFE_THREADRET TFE_STDCALL raster_workerFunc(void* userData)
+	{
+		RasterBand* band = (RasterBand*)userData;
+		TFE_Profiler::setThreadName("RasterThread");
+		while (1)
+		{
+			band->start->wait();
+			if (!s_workersRunning.load()) { break; }
+
+			{
+				TFE_ZONE("Rasterize Band");
+				raster_executeBand(band);
+			}
+			if (s_bandsRemaining.fetch_sub(1) == 1)
+			{
+				s_bandsDone->fire();
+			}
+		}
+		return (TFE_THREADRET)0;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Command recording
+	//////////////////////////////////////////////////////////////////////
+	RasterCmd* raster_allocCmd(s32 x)
+	{
+		assert(x >= 0 && x < s_width);
+		RasterBand* band = &s_bands[s_columnBand[x]];
+		if (band->cmdCount >= band->cmdCapacity)
+		{
+			band->cmdCapacity = band->cmdCapacity ? band->cmdCapacity * 2 : 4096;
+			band->cmd = (RasterCmd*)realloc(band->cmd, sizeof(RasterCmd) * band->cmdCapacity);
+		}
+		RasterCmd* cmd = &band->cmd[band->cmdCount];
+		band->cmdCount++;
+		return cmd;
+	}
+
+	inline s32 raster_getColumn(const u8* out)
+	{
+		return s32((out - s_display) % s_width);
+	}
+
+	void raster_pushColumn(ColumnFuncId func, u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		if (count <= 0) { return; }
+
+		RasterCmd* cmd = raster_allocCmd(raster_getColumn(out));
+		cmd->type  = RCMD_COLUMN;
+		cmd->func  = func;
+		cmd->count = count;
+		cmd->out   = out;
+		cmd->column.tex   = tex;
+		cmd->column.light = light;
+		cmd->column.vCoord = vCoord;
+		cmd->column.vStep  = vStep;
+		cmd->column.heightMask = heightMask;
+		cmd->column.texHeight  = 0;
+	}
+
+	void raster_pushColumnCompressed(ColumnFuncId func, u8* out, const u8* colData, s32 texHeight, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 count)
+	{
+		if (count <= 0) { return; }
+
+		RasterCmd* cmd = raster_allocCmd(raster_getColumn(out));
+		cmd->type  = RCMD_COLUMN_COMPRESSED;
+		cmd->func  = func;
+		cmd->count = count;
+		cmd->out   = out;
+		cmd->column.tex   = colData;
+		cmd->column.light = light;
+		cmd->column.vCoord = vCoord;
+		cmd->column.vStep  = vStep;
+		cmd->column.heightMask = 0xffff;
+		cmd->column.texHeight  = texHeight;
+	}
+
+	// Scanlines are split at band boundaries.
+	// The scanline is drawn from right to left, so the texture coordinates for each piece are computed by stepping from the right edge
+	// using the same fixed point values the single-threaded loop would reach at that pixel.
+	void raster_pushScanline(ScanlineFuncId func, u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		if (width <= 0) { return; }
+
+		const s32 x0 = raster_getColumn(out);
+		assert(x0 + width <= s_width);
+		for (s32 a = 0; a < width; )
+		{
+			const u8 bandIndex = s_columnBand[x0 + a];
+			s32 b = a;
+			while (b + 1 < width && s_columnBand[x0 + b + 1] == bandIndex) { b++; }
+
+			const fixed44_20 step = fixed44_20(width - 1 - b);
+			RasterCmd* cmd = raster_allocCmd(x0 + a);
+			cmd->type  = RCMD_SCANLINE;
+			cmd->func  = func;
+			cmd->count = b - a + 1;
+			cmd->out   = out + a;
+			cmd->scanline.tex   = tex;
+			cmd->scanline.light = light;
+			cmd->scanline.U = U + step * dUdX;
+			cmd->scanline.V = V + step * dVdX;
+			cmd->scanline.dUdX = dUdX;
+			cmd->scanline.dVdX = dVdX;
+			cmd->scanline.dataEnd = dataEnd;
+
+			a = b + 1;
+		}
+	}
+
+	void raster_pushPolyColumn(PolyColumnFuncId func, u8* out, s32 height, const RasterPolyColumn* params)
+	{
+		if (height <= 0) { return; }
+
+		RasterCmd* cmd = raster_allocCmd(raster_getColumn(out));
+		cmd->type  = RCMD_POLY_COLUMN;
+		cmd->func  = func;
+		cmd->count = height;
+		cmd->out   = out;
+		cmd->poly  = *params;
+	}
+
+	void raster_pushPixel(u8* out, u8 color)
+	{
+		RasterCmd* cmd = raster_allocCmd(raster_getColumn(out));
+		cmd->type  = RCMD_PIXEL;
+		cmd->color = color;
+		cmd->count = 1;
+		cmd->out   = out;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Execution
+	// Note: this runs on worker threads, so no profiling zones or
+	// shared renderer state other than the framebuffer dimensions.
+	//////////////////////////////////////////////////////////////////////
+	void raster_executeColumn(const RasterCmd* cmd, const u8* tex)
+	{
+		const RasterColumn* col = &cmd->column;
+		switch (cmd->func)
+		{
+			case COLFUNC_FULLBRIGHT:
+				raster_columnFullbright(cmd->out, tex, col->vCoord, col->vStep, col->heightMask, cmd->count);
+				break;
+			case COLFUNC_LIT:
+				s_rasterColumnLit(cmd->out, tex, col->light, col->vCoord, col->vStep, col->heightMask, cmd->count);
+				break;
+			case COLFUNC_FULLBRIGHT_TRANS:
+				raster_columnFullbrightTrans(cmd->out, tex, col->vCoord, col->vStep, col->heightMask, cmd->count);
+				break;
+			case COLFUNC_LIT_TRANS:
+				s_rasterColumnLitTrans(cmd->out, tex, col->light, col->vCoord, col->vStep, col->heightMask, cmd->count);
+				break;
+		}
+	}
+
+	void raster_executeScanline(const RasterCmd* cmd)
+	{
+		const RasterScanline* scan = &cmd->scanline;
+		switch (cmd->func)
+		{
+			case SCANFUNC_LIT:
+				s_rasterScanlineLit(cmd->out, scan->tex, scan->dataEnd, scan->light, scan->U, scan->V, scan->dUdX, scan->dVdX, cmd->count);
+				break;
+			case SCANFUNC_FULLBRIGHT:
+				raster_scanlineFullbright(cmd->out, scan->tex, scan->dataEnd, scan->U, scan->V, scan->dUdX, scan->dVdX, cmd->count);
+				break;
+			case SCANFUNC_LIT_TRANS:
+				s_rasterScanlineLitTrans(cmd->out, scan->tex, scan->dataEnd, scan->light, scan->U, scan->V, scan->dUdX, scan->dVdX, cmd->count);
+				break;
+			case SCANFUNC_FULLBRIGHT_TRANS:
+				raster_scanlineFullbrightTrans(cmd->out, scan->tex, scan->dataEnd, scan->U, scan->V, scan->dUdX, scan->dVdX, cmd->count);
+				break;
+		}
+	}
+
+	void raster_executePolyColumn(const RasterCmd* cmd)
+	{
+		const RasterPolyColumn* poly = &cmd->poly;
+		switch (cmd->func)
+		{
+			case POLYFUNC_FLAT_COLOR:
+				raster_polyColumnFlatColor(cmd->out, poly->colorIndex, cmd->count);
+				break;
+			case POLYFUNC_SHADED_COLOR:
+				raster_polyColumnShadedColor(cmd->out, poly->colorMap, poly->colorIndex, poly->I0, poly->dIdY, poly->dither, poly->ditherOffset, cmd->count);
+				break;
+			case POLYFUNC_FLAT_TEXTURE:
+				raster_polyColumnFlatTexture(cmd->out, poly->colorMap, poly->texture, poly->U0, poly->V0, poly->dUdY, poly->dVdY, cmd->count);
+				break;
+			case POLYFUNC_SHADED_TEXTURE:
+				raster_polyColumnShadedTexture(cmd->out, poly->colorMap, poly->texture, poly->I0, poly->dIdY, poly->U0, poly->V0, poly->dUdY, poly->dVdY, cmd->count);
+				break;
+		}
+	}
+
+	void raster_executeBand(RasterBand* band)
+	{
+		// Each thread decompresses sprite columns into its own buffer.
+		u8 workBuffer[1024];
+
+		const RasterCmd* cmd = band->cmd;
+		for (s32 i = 0; i < band->cmdCount; i++, cmd++)
+		{
+			switch (cmd->type)
+			{
+				case RCMD_COLUMN:
+					raster_executeColumn(cmd, cmd->column.tex);
+					break;
+				case RCMD_COLUMN_COMPRESSED:
+					sprite_decompressColumn(cmd->column.tex, workBuffer, cmd->column.texHeight);
+					raster_executeColumn(cmd, workBuffer);
+					break;
+				case RCMD_SCANLINE:
+					raster_executeScanline(cmd);
+					break;
+				case RCMD_POLY_COLUMN:
+					raster_executePolyColumn(cmd);
+					break;
+				case RCMD_PIXEL:
+					*cmd->out = cmd->color;
+					break;
+			}
+		}
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,305 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Rasterization
+// Column and scanline inner loops for the floating point sub-renderer.
+//
+// The inner loops are shared between two paths:
+// 1. Immediate - pixels are written as the sectors are traversed,
+//    this is the original single-threaded behavior.
+// 2. Banded - the sector traversal still runs on the main thread but
+//    pixel output is recorded into per-band command lists. Each band
+//    owns a contiguous range of screen columns and is rasterized by
+//    its own thread once traversal is complete. Every pixel is written
+//    by the same commands, in the same order, as the immediate path so
+//    the output is bit-identical regardless of the thread count.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Level/rtexture.h>
+#include "fixedPoint20.h"
+#include "../rcommon.h"
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	#define MAX_RASTER_THREADS 16
+
+	// Column rendering functions that can be chosen at runtime.
+	enum ColumnFuncId
+	{
+		COLFUNC_FULLBRIGHT = 0,
+		COLFUNC_LIT,
+		COLFUNC_FULLBRIGHT_TRANS,
+		COLFUNC_LIT_TRANS,
+
+		COLFUNC_COUNT
+	};
+
+	enum ScanlineFuncId
+	{
+		SCANFUNC_LIT = 0,
+		SCANFUNC_FULLBRIGHT,
+		SCANFUNC_LIT_TRANS,
+		SCANFUNC_FULLBRIGHT_TRANS,
+
+		SCANFUNC_COUNT
+	};
+
+	// 3D object (polygon) column functions.
+	enum PolyColumnFuncId
+	{
+		POLYFUNC_FLAT_COLOR = 0,
+		POLYFUNC_SHADED_COLOR,
+		POLYFUNC_FLAT_TEXTURE,
+		POLYFUNC_SHADED_TEXTURE,
+
+		POLYFUNC_COUNT
+	};
+
+	// Instruction sets available for the lit column and scanline loops.
+	enum RasterSimd
+	{
+		RSIMD_SCALAR = 0,
+		RSIMD_SSE2,
+		RSIMD_AVX2,
+		RSIMD_NEON,
+
+		RSIMD_COUNT
+	};
+
+	// Parameters for a single 3D object polygon column, only the values required by the
+	// column function need to be filled in.
+	struct RasterPolyColumn
+	{
+		const u8* colorMap;
+		const TextureData* texture;
+		fixed44_20 I0;
+		fixed44_20 dIdY;
+		fixed44_20 U0;
+		fixed44_20 V0;
+		fixed44_20 dUdY;
+		fixed44_20 dVdY;
+		fixed44_20 ditherOffset;
+		s32 dither;
+		u8  colorIndex;
+	};
+
+	// Set when pixel output should be recorded into the band command lists rather than written immediately.
+	extern JBool s_rasterDeferred;
+
+	void raster_init();
+	void raster_destroy();
+
+	// Select the instruction set used by the lit column and scanline loops, returns false if the CPU does not support it.
+	bool raster_setSimd(RasterSimd simd);
+	RasterSimd raster_getSimd();
+	bool raster_isSimdSupported(RasterSimd simd);
+	// Renders randomized spans with the scalar and SIMD loops and compares the results, returns the number of mismatched spans.
+	s32 raster_verifySimd(RasterSimd simd, s32 spanCount);
+
+	// Call before and after the sector traversal.
+	// If threadCount > 1 then output is deferred and rasterized in parallel by raster_endFrame().
+	void raster_beginFrame(s32 threadCount);
+	void raster_endFrame();
+
+	// Record commands, only valid while s_rasterDeferred is set.
+	void raster_pushColumn(ColumnFuncId func, u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count);
+	// Sprite column that is decompressed by the rasterizing thread.
+	void raster_pushColumnCompressed(ColumnFuncId func, u8* out, const u8* colData, s32 texHeight, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 count);
+	void raster_pushScanline(ScanlineFuncId func, u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width);
+	void raster_pushPolyColumn(PolyColumnFuncId func, u8* out, s32 height, const RasterPolyColumn* params);
+	void raster_pushPixel(u8* out, u8 color);
+
+	// Lit column and scanline loops, these point to the fastest variant supported by the CPU.
+	// The other variants are not worth vectorizing since they are just a single texture lookup.
+	typedef void(*RasterColumnFunc)(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count);
+	typedef void(*RasterScanlineFunc)(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width);
+	extern RasterColumnFunc s_rasterColumnLit;
+	extern RasterColumnFunc s_rasterColumnLitTrans;
+	extern RasterScanlineFunc s_rasterScanlineLit;
+	extern RasterScanlineFunc s_rasterScanlineLitTrans;
+
+	// Implemented in rwallFloat.cpp
+	void sprite_decompressColumn(const u8* colData, u8* outBuffer, s32 height);
+
+	//////////////////////////////////////////////////////////////////////
+	// Inner loops
+	// These are the reference implementations, the SIMD variants in
+	// rrasterFloat_Simd.cpp must produce identical output.
+	//////////////////////////////////////////////////////////////////////
+	// Wall, sky and sprite columns are drawn from the bottom up.
+	inline void raster_columnFullbright(u8* out, const u8* tex, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		const s32 stride = s_width;
+		const s32 end = count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoord += vStep)
+		{
+			const s32 v = floor20(vCoord) & heightMask;
+			out[offset] = tex[v];
+		}
+	}
+
+	inline void raster_columnLit(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		const s32 stride = s_width;
+		const s32 end = count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoord += vStep)
+		{
+			const s32 v = floor20(vCoord) & heightMask;
+			out[offset] = light[tex[v]];
+		}
+	}
+
+	inline void raster_columnFullbrightTrans(u8* out, const u8* tex, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		const s32 stride = s_width;
+		const s32 end = count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoord += vStep)
+		{
+			const s32 v = floor20(vCoord) & heightMask;
+			const u8 c = tex[v];
+			if (c) { out[offset] = c; }
+		}
+	}
+
+	inline void raster_columnLitTrans(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		const s32 stride = s_width;
+		const s32 end = count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoord += vStep)
+		{
+			const s32 v = floor20(vCoord) & heightMask;
+			const u8 c = tex[v];
+			if (c) { out[offset] = light[c]; }
+		}
+	}
+
+	// Flat scanlines are drawn from right to left.
+	// Note this produces a distorted mapping if the texture is not 64x64.
+	// This behavior matches the original.
+	inline void raster_scanlineLit(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		for (s32 i = width - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			out[i] = light[tex[texel]];
+		}
+	}
+
+	inline void raster_scanlineFullbright(u8* out, const u8* tex, s32 dataEnd, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		for (s32 i = width - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			out[i] = tex[texel];
+		}
+	}
+
+	inline void raster_scanlineLitTrans(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		for (s32 i = width - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			const u8 baseColor = tex[texel];
+			if (baseColor) { out[i] = light[baseColor]; }
+		}
+	}
+
+	inline void raster_scanlineFullbrightTrans(u8* out, const u8* tex, s32 dataEnd, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		for (s32 i = width - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			const u8 baseColor = tex[texel];
+			if (baseColor) { out[i] = baseColor; }
+		}
+	}
+
+	// 3D object polygon columns are drawn from the bottom up.
+	inline void raster_polyColumnFlatColor(u8* out, u8 colorIndex, s32 height)
+	{
+		const s32 stride = s_width;
+		s32 end = height - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			out[offset] = colorIndex;
+		}
+	}
+
+	inline void raster_polyColumnShadedColor(u8* out, const u8* colorMap, u8 colorIndex, fixed44_20 intensity, fixed44_20 dIdY, s32 dither, fixed44_20 ditherOffset, s32 height)
+	{
+		const s32 stride = s_width;
+		s32 end = height - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			s32 pixelIntensity = floor20(intensity);
+			if (dither)
+			{
+				const fixed44_20 iOffset = intensity - ditherOffset;
+				if (iOffset >= 0)
+				{
+					pixelIntensity = floor20(iOffset);
+				}
+			}
+			out[offset] = colorMap[(pixelIntensity&31)*256 + colorIndex];
+
+			intensity += dIdY;
+			dither = !dither;
+		}
+	}
+
+	inline void raster_polyColumnFlatTexture(u8* out, const u8* colorMap, const TextureData* texture, fixed44_20 U, fixed44_20 V, fixed44_20 dUdY, fixed44_20 dVdY, s32 height)
+	{
+		const u8* textureData = texture->image;
+		const s32 texHeight = texture->height;
+		const s32 texWidthMask = texture->width - 1;
+		const s32 texHeightMask = texHeight - 1;
+
+		const s32 stride = s_width;
+		s32 end = height - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
+			out[offset] = colorMap[colorIndex];
+
+			U += dUdY;
+			V += dVdY;
+		}
+	}
+
+	inline void raster_polyColumnShadedTexture(u8* out, const u8* colorMap, const TextureData* texture, fixed44_20 I, fixed44_20 dIdY, fixed44_20 U, fixed44_20 V, fixed44_20 dUdY, fixed44_20 dVdY, s32 height)
+	{
+		const u8* textureData = texture->image;
+		const s32 texHeight = texture->height;
+		const s32 texWidthMask = texture->width - 1;
+		const s32 texHeightMask = texHeight - 1;
+
+		const s32 stride = s_width;
+		s32 end = height - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
+			const s32 pixelIntensity = floor20(I)&31;
+			out[offset] = colorMap[pixelIntensity*256 + colorIndex];
+
+			I += dIdY;
+			U += dUdY;
+			V += dVdY;
+		}
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,389 @@
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <TFE_System/system.h>
+#include <TFE_FrontEndUI/console.h>
+#include <SDL_cpuinfo.h>
+#include "rrasterFloat.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define RASTER_X86 1
+	#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+	#define RASTER_NEON 1
+	#include <arm_neon.h>
+#endif
+
+// MSVC allows intrinsics for any instruction set, GCC and Clang need the target enabled per function.
+#if defined(_MSC_VER)
+	#define RASTER_TARGET_SSE2
+	#define RASTER_TARGET_AVX2
+#else
+	#define RASTER_TARGET_SSE2 __attribute__((target("sse2")))
+	#define RASTER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	static const char* c_rasterSimdName[RSIMD_COUNT] =
+	{
+		"Scalar",	// RSIMD_SCALAR
+		"SSE2",		// RSIMD_SSE2
+		"AVX2",		// RSIMD_AVX2
+		"NEON",		// RSIMD_NEON
+	};
+
+	static RasterSimd s_rasterSimd = RSIMD_SCALAR;
+
+	// Scalar
+	void raster_columnLit_Scalar(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		raster_columnLit(out, tex, light, vCoord, vStep, heightMask, count);
+	}
+
+	void raster_columnLitTrans_Scalar(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+	{
+		raster_columnLitTrans(out, tex, light, vCoord, vStep, heightMask, count);
+	}
+
+	void raster_scanlineLit_Scalar(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		raster_scanlineLit(out, tex, dataEnd, light, U, V, dUdX, dVdX, width);
+	}
+
+	void raster_scanlineLitTrans_Scalar(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+	{
+		raster_scanlineLitTrans(out, tex, dataEnd, light, U, V, dUdX, dVdX, width);
+	}
+
+	RasterColumnFunc s_rasterColumnLit = raster_columnLit_Scalar;
+	RasterColumnFunc s_rasterColumnLitTrans = raster_columnLitTrans_Scalar;
+	RasterScanlineFunc s_rasterScanlineLit = raster_scanlineLit_Scalar;
+	RasterScanlineFunc s_rasterScanlineLitTrans = raster_scanlineLitTrans_Scalar;
+
+#if RASTER_X86
+	// SSE2
+	#define SIMD_FUNC(name) name##_SSE2
+	#define SIMD_TARGET RASTER_TARGET_SSE2
+	#define SIMD_LANES 4
+	#define SIMD_VEC __m128i
+	#define SIMD_SET1(x) _mm_set1_epi32(s32(x))
+	#define SIMD_RAMP(b, s) _mm_setr_epi32(s32(b), s32((b) + (s)), s32((b) + 2*(s)), s32((b) + 3*(s)))
+	#define SIMD_ADD(a, b) _mm_add_epi32(a, b)
+	#define SIMD_AND(a, b) _mm_and_si128(a, b)
+	#define SIMD_OR(a, b)  _mm_or_si128(a, b)
+	#define SIMD_SRL(a, n) _mm_srli_epi32(a, n)
+	#define SIMD_SLL(a, n) _mm_slli_epi32(a, n)
+	#define SIMD_STORE(p, a) _mm_store_si128((__m128i*)(p), a)
+	#include "rrasterFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VEC
+	#undef SIMD_SET1
+	#undef SIMD_RAMP
+	#undef SIMD_ADD
+	#undef SIMD_AND
+	#undef SIMD_OR
+	#undef SIMD_SRL
+	#undef SIMD_SLL
+	#undef SIMD_STORE
+
+	// AVX2
+	#define SIMD_FUNC(name) name##_AVX2
+	#define SIMD_TARGET RASTER_TARGET_AVX2
+	#define SIMD_LANES 8
+	#define SIMD_VEC __m256i
+	#define SIMD_SET1(x) _mm256_set1_epi32(s32(x))
+	#define SIMD_RAMP(b, s) _mm256_setr_epi32(s32(b), s32((b) + (s)), s32((b) + 2*(s)), s32((b) + 3*(s)), s32((b) + 4*(s)), s32((b) + 5*(s)), s32((b) + 6*(s)), s32((b) + 7*(s)))
+	#define SIMD_ADD(a, b) _mm256_add_epi32(a, b)
+	#define SIMD_AND(a, b) _mm256_and_si256(a, b)
+	#define SIMD_OR(a, b)  _mm256_or_si256(a, b)
+	#define SIMD_SRL(a, n) _mm256_srli_epi32(a, n)
+	#define SIMD_SLL(a, n) _mm256_slli_epi32(a, n)
+	#define SIMD_STORE(p, a) _mm256_store_si256((__m256i*)(p), a)
+	#include "rrasterFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VEC
+	#undef SIMD_SET1
+	#undef SIMD_RAMP
+	#undef SIMD_ADD
+	#undef SIMD_AND
+	#undef SIMD_OR
+	#undef SIMD_SRL
+	#undef SIMD_SLL
+	#undef SIMD_STORE
+#endif
+
+#if RASTER_NEON
+	inline uint32x4_t neon_ramp(u32 base, u32 step)
+	{
+		const u32 lanes[4] = { base, base + step, base + 2*step, base + 3*step };
+		return vld1q_u32(lanes);
+	}
+
+	// NEON
+	#define SIMD_FUNC(name) name##_NEON
+	#define SIMD_TARGET
+	#define SIMD_LANES 4
+	#define SIMD_VEC uint32x4_t
+	#define SIMD_SET1(x) vdupq_n_u32(u32(x))
+	#define SIMD_RAMP(b, s) neon_ramp(b, s)
+	#define SIMD_ADD(a, b) vaddq_u32(a, b)
+	#define SIMD_AND(a, b) vandq_u32(a, b)
+	#define SIMD_OR(a, b)  vorrq_u32(a, b)
+	#define SIMD_SRL(a, n) vshrq_n_u32(a, n)
+	#define SIMD_SLL(a, n) vshlq_n_u32(a, n)
+	#define SIMD_STORE(p, a) vst1q_u32(p, a)
+	#include "rrasterFloat_SimdFunc.h"
+	#undef SIMD_FUNC
+	#undef SIMD_TARGET
+	#undef SIMD_LANES
+	#undef SIMD_VEC
+	#undef SIMD_SET1
+	#undef SIMD_RAMP
+	#undef SIMD_ADD
+	#undef SIMD_AND
+	#undef SIMD_OR
+	#undef SIMD_SRL
+	#undef SIMD_SLL
+	#undef SIMD_STORE
+#endif
+
+	void console_setRasterSimd(const ConsoleArgList& args);
+	void console_getRasterSimd(const ConsoleArgList& args);
+	void console_verifyRasterSimd(const ConsoleArgList& args);
+
+	void raster_init()
+	{
+		// Pick the widest instruction set supported by the CPU.
+		if (!raster_setSimd(RSIMD_AVX2) && !raster_setSimd(RSIMD_SSE2) && !raster_setSimd(RSIMD_NEON))
+		{
+			raster_setSimd(RSIMD_SCALAR);
+		}
+		TFE_System::logWrite(LOG_MSG, "Renderer", "Float rasterizer using %s.", c_rasterSimdName[s_rasterSimd]);
+
+		CCMD("rsetRasterSimd", console_setRasterSimd, 1, "Set the instruction set used by the Classic_Float rasterizer - valid values are: Scalar, SSE2, AVX2, NEON");
+		CCMD("rgetRasterSimd", console_getRasterSimd, 0, "Get the instruction set used by the Classic_Float rasterizer.");
+		CCMD("rverifyRasterSimd", console_verifyRasterSimd, 0, "Verify that the SIMD rasterizer output is identical to the scalar output.");
+	}
+
+	bool raster_isSimdSupported(RasterSimd simd)
+	{
+		switch (simd)
+		{
+			case RSIMD_SCALAR:
+				return true;
+		#if RASTER_X86
+			case RSIMD_SSE2:
+				return SDL_HasSSE2() == SDL_TRUE;
+			case RSIMD_AVX2:
+				return SDL_HasAVX2() == SDL_TRUE;
+		#endif
+		#if RASTER_NEON
+			case RSIMD_NEON:
+				return SDL_HasNEON() == SDL_TRUE;
+		#endif
+			default:
+				break;
+		}
+		return false;
+	}
+
+	bool raster_setSimd(RasterSimd simd)
+	{
+		if (!raster_isSimdSupported(simd)) { return false; }
+
+		switch (simd)
+		{
+			case RSIMD_SCALAR:
+				s_rasterColumnLit = raster_columnLit_Scalar;
+				s_rasterColumnLitTrans = raster_columnLitTrans_Scalar;
+				s_rasterScanlineLit = raster_scanlineLit_Scalar;
+				s_rasterScanlineLitTrans = raster_scanlineLitTrans_Scalar;
+				break;
+		#if RASTER_X86
+			case RSIMD_SSE2:
+				s_rasterColumnLit = raster_columnLit_SSE2;
+				s_rasterColumnLitTrans = raster_columnLitTrans_SSE2;
+				s_rasterScanlineLit = raster_scanlineLit_SSE2;
+				s_rasterScanlineLitTrans = raster_scanlineLitTrans_SSE2;
+				break;
+			case RSIMD_AVX2:
+				s_rasterColumnLit = raster_columnLit_AVX2;
+				s_rasterColumnLitTrans = raster_columnLitTrans_AVX2;
+				s_rasterScanlineLit = raster_scanlineLit_AVX2;
+				s_rasterScanlineLitTrans = raster_scanlineLitTrans_AVX2;
+				break;
+		#endif
+		#if RASTER_NEON
+			case RSIMD_NEON:
+				s_rasterColumnLit = raster_columnLit_NEON;
+				s_rasterColumnLitTrans = raster_columnLitTrans_NEON;
+				s_rasterScanlineLit = raster_scanlineLit_NEON;
+				s_rasterScanlineLitTrans = raster_scanlineLitTrans_NEON;
+				break;
+		#endif
+			default:
+				return false;
+		}
+		s_rasterSimd = simd;
+		return true;
+	}
+
+	RasterSimd raster_getSimd()
+	{
+		return s_rasterSimd;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Verification
+	// Renders randomized spans into two buffers, one with the scalar
+	// loops and one with the selected SIMD loops, and compares them.
+	//////////////////////////////////////////////////////////////////////
+	enum
+	{
+		VERIFY_STRIDE = 64,
+		VERIFY_MAX_LEN = 1024,
+	};
+
+	static u32 s_verifySeed;
+
+	u32 verify_random()
+	{
+		s_verifySeed = s_verifySeed * 1664525u + 1013904223u;
+		return s_verifySeed;
+	}
+
+	fixed44_20 verify_randomFixed(s32 intBits)
+	{
+		// Random sign, integer and fractional parts.
+		const s64 value = s64(verify_random() & ((1u << intBits) - 1u)) << 20 | s64(verify_random() & 0xfffff);
+		return (verify_random() & 1) ? -value : value;
+	}
+
+	s32 raster_verifySimd(RasterSimd simd, s32 spanCount)
+	{
+		if (simd == RSIMD_SCALAR || !raster_isSimdSupported(simd)) { return 0; }
+
+		const RasterSimd prevSimd = s_rasterSimd;
+		const s32 prevWidth = s_width;
+		// The column loops use s_width as the stride.
+		s_width = VERIFY_STRIDE;
+		s_verifySeed = 1234567u;
+
+		u8* tex = (u8*)malloc(4096);
+		u8* light = (u8*)malloc(256);
+		u8* refBuffer = (u8*)malloc(VERIFY_STRIDE * VERIFY_MAX_LEN);
+		u8* simdBuffer = (u8*)malloc(VERIFY_STRIDE * VERIFY_MAX_LEN);
+		for (s32 i = 0; i < 4096; i++)
+		{
+			// Include transparent texels.
+			tex[i] = (verify_random() & 7) ? u8(verify_random()) : 0;
+		}
+		for (s32 i = 0; i < 256; i++)
+		{
+			light[i] = u8(verify_random());
+		}
+
+		static const s32 c_heightMask[] = { 0, 31, 63, 127, 255, 1023, 4095 };
+		s32 mismatchCount = 0;
+		for (s32 s = 0; s < spanCount; s++)
+		{
+			const s32 func = s & 3;
+			const s32 len = 1 + s32(verify_random() % VERIFY_MAX_LEN);
+			const s32 dataEnd = (verify_random() & 1) ? 4095 : 1023;
+			const s32 heightMask = c_heightMask[verify_random() % TFE_ARRAYSIZE(c_heightMask)];
+			const fixed44_20 U = verify_randomFixed(16);
+			const fixed44_20 V = verify_randomFixed(16);
+			const fixed44_20 dU = verify_randomFixed(4);
+			const fixed44_20 dV = verify_randomFixed(4);
+			const u8 clearValue = u8(verify_random());
+			memset(refBuffer, clearValue, VERIFY_STRIDE * VERIFY_MAX_LEN);
+			memset(simdBuffer, clearValue, VERIFY_STRIDE * VERIFY_MAX_LEN);
+
+			for (s32 pass = 0; pass < 2; pass++)
+			{
+				raster_setSimd(pass == 0 ? RSIMD_SCALAR : simd);
+				u8* out = pass == 0 ? refBuffer : simdBuffer;
+				switch (func)
+				{
+					case 0: s_rasterColumnLit(out, tex, light, U, dU, heightMask, len); break;
+					case 1: s_rasterColumnLitTrans(out, tex, light, U, dU, heightMask, len); break;
+					case 2: s_rasterScanlineLit(out, tex, dataEnd, light, U, V, dU, dV, len); break;
+					case 3: s_rasterScanlineLitTrans(out, tex, dataEnd, light, U, V, dU, dV, len); break;
+				}
+			}
+			if (memcmp(refBuffer, simdBuffer, VERIFY_STRIDE * VERIFY_MAX_LEN) != 0)
+			{
+				mismatchCount++;
+			}
+		}
+
+		free(tex);
+		free(light);
+		free(refBuffer);
+		free(simdBuffer);
+
+		s_width = prevWidth;
+		raster_setSimd(prevSimd);
+		return mismatchCount;
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Console
+	//////////////////////////////////////////////////////////////////////
+	void console_setRasterSimd(const ConsoleArgList& args)
+	{
+		if (args.size() < 2) { return; }
+		const char* value = args[1].c_str();
+
+		for (s32 i = 0; i < RSIMD_COUNT; i++)
+		{
+			if (strcasecmp(value, c_rasterSimdName[i]) == 0)
+			{
+				if (!raster_setSimd(RasterSimd(i)))
+				{
+					char res[256];
+					sprintf(res, "%s is not supported on this CPU.", c_rasterSimdName[i]);
+					TFE_Console::addToHistory(res);
+				}
+				return;
+			}
+		}
+	}
+
+	void console_getRasterSimd(const ConsoleArgList& args)
+	{
+		TFE_Console::addToHistory(c_rasterSimdName[s_rasterSimd]);
+	}
+
+	void console_verifyRasterSimd(const ConsoleArgList& args)
+	{
+		const s32 spanCount = 4096;
+		char res[256];
+		for (s32 i = RSIMD_SCALAR + 1; i < RSIMD_COUNT; i++)
+		{
+			if (!raster_isSimdSupported(RasterSimd(i))) { continue; }
+
+			const s32 mismatchCount = raster_verifySimd(RasterSimd(i), spanCount);
+			if (mismatchCount)
+			{
+				sprintf(res, "%s: FAILED, %d of %d spans differ from the scalar output.", c_rasterSimdName[i], mismatchCount, spanCount);
+			}
+			else
+			{
+				sprintf(res, "%s: %d spans match the scalar output.", c_rasterSimdName[i], spanCount);
+			}
+			TFE_Console::addToHistory(res);
+		}
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////
+// Inline SIMD raster functions
+// Included once per instruction set by rrasterFloat_Simd.cpp, the
+// following must be defined:
+//   SIMD_FUNC(name)         - decorate the function name.
+//   SIMD_TARGET             - function attributes required by the ISA.
+//   SIMD_LANES              - the number of 32-bit lanes.
+//   SIMD_VEC                - the 32-bit integer vector type.
+//   SIMD_SET1(x)            - broadcast x to all lanes.
+//   SIMD_RAMP(base, step)   - lane k = base + k*step.
+//   SIMD_ADD, SIMD_AND, SIMD_OR, SIMD_SRL, SIMD_SLL, SIMD_STORE
+//
+// Texel addresses are computed SIMD_LANES at a time, the texture and
+// colormap lookups are still done per pixel - byte gathers do not exist
+// and 32-bit gathers could read past the end of the texture data.
+//
+// Only the low 32 bits of the fixed point coordinates are used, which
+// is exact as long as the result only depends on bits 20-31.
+// This is always true for flats (6 bits each for U and V) and for
+// columns when the height mask is less than 4096.
+//////////////////////////////////////////////////////////////////////
+
+// Compute the texel offset for each lane: ((U >> 20) & 63) * 64 + ((V >> 20) & 63), masked by the texture data end.
+#define SIMD_SCANLINE_TEXEL(u, v) SIMD_AND(SIMD_OR(SIMD_SLL(SIMD_AND(SIMD_SRL(u, 20), mask63), 6), SIMD_AND(SIMD_SRL(v, 20), mask63)), dataEndVec)
+
+SIMD_TARGET void SIMD_FUNC(raster_scanlineLit)(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+{
+	alignas(32) u32 texel[SIMD_LANES];
+	const SIMD_VEC mask63 = SIMD_SET1(63);
+	const SIMD_VEC dataEndVec = SIMD_SET1(u32(dataEnd));
+	const SIMD_VEC stepU = SIMD_SET1(u32(dUdX) * SIMD_LANES);
+	const SIMD_VEC stepV = SIMD_SET1(u32(dVdX) * SIMD_LANES);
+	SIMD_VEC u = SIMD_RAMP(u32(U), u32(dUdX));
+	SIMD_VEC v = SIMD_RAMP(u32(V), u32(dVdX));
+
+	s32 i = width - 1;
+	for (; i >= SIMD_LANES - 1; i -= SIMD_LANES)
+	{
+		SIMD_STORE(texel, SIMD_SCANLINE_TEXEL(u, v));
+		for (s32 k = 0; k < SIMD_LANES; k++)
+		{
+			out[i - k] = light[tex[texel[k]]];
+		}
+		u = SIMD_ADD(u, stepU);
+		v = SIMD_ADD(v, stepV);
+	}
+
+	// Finish the remaining pixels with the scalar loop.
+	const fixed44_20 done = fixed44_20(width - 1 - i);
+	raster_scanlineLit(out, tex, dataEnd, light, U + done*dUdX, V + done*dVdX, dUdX, dVdX, i + 1);
+}
+
+SIMD_TARGET void SIMD_FUNC(raster_scanlineLitTrans)(u8* out, const u8* tex, s32 dataEnd, const u8* light, fixed44_20 U, fixed44_20 V, fixed44_20 dUdX, fixed44_20 dVdX, s32 width)
+{
+	alignas(32) u32 texel[SIMD_LANES];
+	const SIMD_VEC mask63 = SIMD_SET1(63);
+	const SIMD_VEC dataEndVec = SIMD_SET1(u32(dataEnd));
+	const SIMD_VEC stepU = SIMD_SET1(u32(dUdX) * SIMD_LANES);
+	const SIMD_VEC stepV = SIMD_SET1(u32(dVdX) * SIMD_LANES);
+	SIMD_VEC u = SIMD_RAMP(u32(U), u32(dUdX));
+	SIMD_VEC v = SIMD_RAMP(u32(V), u32(dVdX));
+
+	s32 i = width - 1;
+	for (; i >= SIMD_LANES - 1; i -= SIMD_LANES)
+	{
+		SIMD_STORE(texel, SIMD_SCANLINE_TEXEL(u, v));
+		for (s32 k = 0; k < SIMD_LANES; k++)
+		{
+			const u8 baseColor = tex[texel[k]];
+			if (baseColor) { out[i - k] = light[baseColor]; }
+		}
+		u = SIMD_ADD(u, stepU);
+		v = SIMD_ADD(v, stepV);
+	}
+
+	const fixed44_20 done = fixed44_20(width - 1 - i);
+	raster_scanlineLitTrans(out, tex, dataEnd, light, U + done*dUdX, V + done*dVdX, dUdX, dVdX, i + 1);
+}
+
+SIMD_TARGET void SIMD_FUNC(raster_columnLit)(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+{
+	// Large masks (such as sprites) need more than the low 32 bits.
+	if (heightMask > 0xfff)
+	{
+		raster_columnLit(out, tex, light, vCoord, vStep, heightMask, count);
+		return;
+	}
+
+	alignas(32) u32 texel[SIMD_LANES];
+	const SIMD_VEC mask = SIMD_SET1(u32(heightMask));
+	const SIMD_VEC step = SIMD_SET1(u32(vStep) * SIMD_LANES);
+	SIMD_VEC v = SIMD_RAMP(u32(vCoord), u32(vStep));
+
+	const s32 stride = s_width;
+	s32 i = count - 1;
+	s32 offset = i * stride;
+	for (; i >= SIMD_LANES - 1; i -= SIMD_LANES)
+	{
+		SIMD_STORE(texel, SIMD_AND(SIMD_SRL(v, 20), mask));
+		for (s32 k = 0; k < SIMD_LANES; k++, offset -= stride)
+		{
+			out[offset] = light[tex[texel[k]]];
+		}
+		v = SIMD_ADD(v, step);
+	}
+
+	const fixed44_20 done = fixed44_20(count - 1 - i);
+	raster_columnLit(out, tex, light, vCoord + done*vStep, vStep, heightMask, i + 1);
+}
+
+SIMD_TARGET void SIMD_FUNC(raster_columnLitTrans)(u8* out, const u8* tex, const u8* light, fixed44_20 vCoord, fixed44_20 vStep, s32 heightMask, s32 count)
+{
+	if (heightMask > 0xfff)
+	{
+		raster_columnLitTrans(out, tex, light, vCoord, vStep, heightMask, count);
+		return;
+	}
+
+	alignas(32) u32 texel[SIMD_LANES];
+	const SIMD_VEC mask = SIMD_SET1(u32(heightMask));
+	const SIMD_VEC step = SIMD_SET1(u32(vStep) * SIMD_LANES);
+	SIMD_VEC v = SIMD_RAMP(u32(vCoord), u32(vStep));
+
+	const s32 stride = s_width;
+	s32 i = count - 1;
+	s32 offset = i * stride;
+	for (; i >= SIMD_LANES - 1; i -= SIMD_LANES)
+	{
+		SIMD_STORE(texel, SIMD_AND(SIMD_SRL(v, 20), mask));
+		for (s32 k = 0; k < SIMD_LANES; k++, offset -= stride)
+		{
+			const u8 c = tex[texel[k]];
+			if (c) { out[offset] = light[c]; }
+		}
+		v = SIMD_ADD(v, step);
+	}
+
+	const fixed44_20 done = fixed44_20(count - 1 - i);
+	raster_columnLitTrans(out, tex, light, vCoord + done*vStep, vStep, heightMask, i + 1);
+}
+
+#undef SIMD_SCANLINE_TEXEL
@@ -1,9 +1,11 @@
 #include <cstring>
 
 #include <TFE_System/profiler.h>
+#include <TFE_System/system.h>
 #include <TFE_Asset/modelAsset_jedi.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelPvs.h>
 #include <TFE_Jedi/Level/rsector.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rtexture.h>
@@ -18,6 +20,7 @@
 #include "rclassicFloatSharedState.h"
 #include "robj3d_float/robj3dFloat.h"
 #include "../rcommon.h"
+#include "../rsort.h"
 
 using namespace TFE_Jedi::RClassic_Float;
 #define PTR_OFFSET(ptr, base) size_t((u8*)ptr - (u8*)base)
@@ -27,6 +30,32 @@ namespace TFE_Jedi
 	namespace
 	{
 		static TFE_Sectors_Float* s_ctx = nullptr;
+		static RSector* s_pvsRoot = nullptr;
+		static RSector* s_pvsErrorRoot = nullptr;
+		static RSector* s_pvsErrorSector = nullptr;
+
+		// TFE: Returns true if the sector cannot be seen from the root sector according to the level PVS.
+		// In validation mode nothing is skipped, instead sectors that are drawn outside of the set are reported.
+		bool pvsRejectSector(RSector* sector)
+		{
+			if ((!s_pvsCull && !s_pvsValidate) || pvs_isVisible(s_pvsRoot, sector))
+			{
+				return false;
+			}
+			if (s_pvsValidate)
+			{
+				s_pvsErrorCount++;
+				if (s_pvsErrorRoot != s_pvsRoot || s_pvsErrorSector != sector)
+				{
+					s_pvsErrorRoot = s_pvsRoot;
+					s_pvsErrorSector = sector;
+					TFE_System::logWrite(LOG_WARNING, "Renderer", "PVS validation failed: sector %d is drawn from sector %d but is not in its visible set.", sector->index, s_pvsRoot->index);
+				}
+				return false;
+			}
+			s_pvsCullCount++;
+			return true;
+		}
 
 		s32 wallSortX(const void* r0, const void* r1)
 		{
@@ -85,8 +114,14 @@ namespace TFE_Jedi
 
 			const SectorCached* cached = &s_ctx->m_cachedSectors[sector->index];
 
-			for (s32 i = count - 1; i >= 0 && drawCount < MAX_VIEW_OBJ_COUNT; i--, obj++)
+			for (s32 i = count - 1; i >= 0; i--, obj++)
 			{
+				if (drawCount == s_viewObjLimit)
+				{
+					s_limitsExceeded |= RLIMIT_VIEW_OBJ;
+					break;
+				}
+
 				// Search for the next allocated object.
 				SecObject* curObj = *obj;
 				while (!curObj)
@@ -174,6 +209,7 @@ namespace TFE_Jedi
 
 	void TFE_Sectors_Float::prepare()
 	{
+		resizeBuffers();
 		allocateCachedData();
 
 		EdgePairFloat* flatEdge = &s_rcfltState.flatEdgeList[s_flatCount];
@@ -196,6 +232,10 @@ namespace TFE_Jedi
 	{
 		s_ctx = this;
 		s_curSector = sector;
+		if (s_adjoinDepth == 1)
+		{
+			s_pvsRoot = sector;
+		}
 		s_sectorIndex++;
 		s_adjoinIndex++;
 		if (s_adjoinIndex > s_maxAdjoinIndex)
@@ -293,12 +333,19 @@ namespace TFE_Jedi
 		}
 
 		RWallSegmentFloat* wallSegment = &s_rcfltState.wallSegListDst[s_curWallSeg];
-		s32 drawSegCnt = wall_mergeSort(wallSegment, MAX_SEG - s_curWallSeg, startWall, drawWallCount);
+		s32 drawSegCnt = wall_mergeSort(wallSegment, s_segLimit - s_curWallSeg, startWall, drawWallCount);
 		s_curWallSeg += drawSegCnt;
 
-		TFE_ZONE_BEGIN(wallQSort, "Wall QSort");
-			qsort(wallSegment, drawSegCnt, sizeof(RWallSegmentFloat), wallSortX);
-		TFE_ZONE_END(wallQSort);
+		TFE_ZONE_BEGIN(wallSort, "Wall Sort");
+			// Sort by screen X, the keys are stored after the wall segments in the scratch buffer.
+			u32* sortKeys = s_rcfltState.wallSortKeys;
+			for (s32 i = 0; i < drawSegCnt; i++)
+			{
+				sortKeys[i] = sortKey_s32(wallSegment[i].wallX0);
+			}
+			if (s_sortCapture) { sortBench_capture(SORT_BENCH_WALL_X, sortKeys, drawSegCnt); }
+			sort_byKeyAsQsort(wallSegment, sortKeys, drawSegCnt, wallSortX, s_rcfltState.wallSortScratch, sortKeys + s_segLimit, s_rcfltState.wallSortIndices);
+		TFE_ZONE_END(wallSort);
 
 		s32 flatCount = s_flatCount;
 		EdgePairFloat* flatEdge = &s_rcfltState.flatEdgeList[s_flatCount];
@@ -306,7 +353,7 @@ namespace TFE_Jedi
 
 		s32 adjoinStart = s_adjoinSegCount;
 		EdgePairFloat* adjoinEdges = &s_rcfltState.adjoinEdgeList[adjoinStart];
-		RWallSegmentFloat* adjoinList[MAX_ADJOIN_DEPTH];
+		RWallSegmentFloat** adjoinList = &s_rcfltState.adjoinSegList[adjoinStart];
 
 		s_rcfltState.adjoinEdge = adjoinEdges;
 		s_rcfltState.adjoinSegment = adjoinList;
@@ -422,7 +469,11 @@ namespace TFE_Jedi
 
 		// Adjoins
 		s32 adjoinCount = s_adjoinSegCount - adjoinStart;
-		if (adjoinCount && s_adjoinDepth < MAX_ADJOIN_DEPTH)
+		if (adjoinCount && s_adjoinDepth >= s_adjoinDepthLimit)
+		{
+			s_limitsExceeded |= RLIMIT_ADJOIN_DEPTH;
+		}
+		else if (adjoinCount)
 		{
 			adjoin_setupAdjoinWindow(winBot, winBotNext, winTop, winTopNext, adjoinEdges, adjoinCount);
 			RWallSegmentFloat** seg = adjoinList;
@@ -438,7 +489,7 @@ namespace TFE_Jedi
 				RWall* srcWall = curAdjoinSeg->srcWall->wall;
 				RWallSegmentFloat* nextAdjoin = (i < adjoinEnd) ? *(seg + 1) : nullptr;
 				RSector* nextSector = srcWall->nextSector;
-				if (s_adjoinDepth < MAX_ADJOIN_DEPTH && s_adjoinDepth < s_maxDepthCount)
+				if (s_adjoinDepth < s_adjoinDepthLimit && s_adjoinDepth < s_maxDepthCount && !pvsRejectSector(nextSector))
 				{
 					s32 index = s_adjoinDepth - 1;
 					saveValues(index);
@@ -495,6 +546,7 @@ namespace TFE_Jedi
 		// Objects
 		TFE_ZONE_BEGIN(secDrawObjects, "Draw Objects");
 		const s32 objCount = cullObjects(s_curSector, s_objBuffer);
+		s_viewObjHighWater = max(s_viewObjHighWater, objCount);
 		if (objCount > 0)
 		{
 			// Which top and bottom edges are we going to use to clip objects?
@@ -9,10 +9,12 @@
 #include "rwallFloat.h"
 #include "rflatFloat.h"
 #include "rlightingFloat.h"
+#include "rrasterFloat.h"
 #include "rsectorFloat.h"
 #include "redgePairFloat.h"
 #include "rclassicFloatSharedState.h"
 #include "../rcommon.h"
+#include "../rspriteCache.h"
 #include "../jediRenderer.h"
 
 namespace TFE_Jedi
@@ -46,17 +48,6 @@ namespace RClassic_Float
 	void drawColumn_Fullbright_Trans();
 	void drawColumn_Lit_Trans();
 
-	// Column rendering functions that can be chosen at runtime.
-	enum ColumnFuncId
-	{
-		COLFUNC_FULLBRIGHT = 0,
-		COLFUNC_LIT,
-		COLFUNC_FULLBRIGHT_TRANS,
-		COLFUNC_LIT_TRANS,
-
-		COLFUNC_COUNT
-	};
-
 	typedef void(*ColumnFunction)();
 	ColumnFunction s_columnFunc[COLFUNC_COUNT] =
 	{
@@ -372,9 +363,9 @@ namespace RClassic_Float
 			wall->visible = 0;
 			return;
 		}
-		if (s_nextWall == MAX_SEG)
+		if (s_nextWall == s_segLimit)
 		{
-			TFE_System::logWrite(LOG_ERROR, "ClassicRenderer", "Wall_Process : Maximum processed walls exceeded!");
+			s_limitsExceeded |= RLIMIT_SEG;
 			wall->visible = 0;
 			return;
 		}
@@ -684,7 +675,7 @@ namespace RClassic_Float
 				{
 					if (outIndex == availSpace)
 					{
-						TFE_System::logWrite(LOG_ERROR, "RendererClassic", "Wall_MergeSort : Maximum merged walls exceeded!");
+						s_limitsExceeded |= RLIMIT_SEG;
 					}
 					else
 					{
@@ -2124,65 +2115,47 @@ namespace RClassic_Float
 
 	void drawColumn_Fullbright()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		if (s_rasterDeferred)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = tex[v];
+			raster_pushColumn(COLFUNC_FULLBRIGHT, s_columnOut, s_texImage, nullptr, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
+			return;
 		}
+		raster_columnFullbright(s_columnOut, s_texImage, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
 	}
 
 	void drawColumn_Lit()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		if (s_rasterDeferred)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = s_columnLight[tex[v]];
+			raster_pushColumn(COLFUNC_LIT, s_columnOut, s_texImage, s_columnLight, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
+			return;
 		}
+		s_rasterColumnLit(s_columnOut, s_texImage, s_columnLight, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
 	}
 
 	void drawColumn_Fullbright_Trans()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		if (s_rasterDeferred)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = c; }
+			raster_pushColumn(COLFUNC_FULLBRIGHT_TRANS, s_columnOut, s_texImage, nullptr, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
+			return;
 		}
+		raster_columnFullbrightTrans(s_columnOut, s_texImage, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
 	}
 
 	void drawColumn_Lit_Trans()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		if (s_rasterDeferred)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = s_columnLight[c]; }
+			raster_pushColumn(COLFUNC_LIT_TRANS, s_columnOut, s_texImage, s_columnLight, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
+			return;
 		}
+		s_rasterColumnLitTrans(s_columnOut, s_texImage, s_columnLight, s_vCoordFixed, s_vCoordStep, s_texHeightMask, s_yPixelCount);
 	}
 
 	void wall_addAdjoinSegment(s32 length, s32 x0, f32 top_dydx, f32 y1, f32 bot_dydx, f32 y0, RWallSegmentFloat* wallSegment)
 	{
-		if (s_adjoinSegCount < MAX_ADJOIN_SEG)
+		if (s_adjoinSegCount < s_adjoinSegLimit)
 		{
 			f32 lengthFlt = f32(length - 1);
 			f32 y0End = y0;
@@ -2203,6 +2176,10 @@ namespace RClassic_Float
 			*s_rcfltState.adjoinSegment = wallSegment;
 			s_rcfltState.adjoinSegment++;
 		}
+		else
+		{
+			s_limitsExceeded |= RLIMIT_ADJOIN_SEG;
+		}
 	}
 
 	void sprite_decompressColumn(const u8* colData, u8* outBuffer, s32 height)
@@ -2301,15 +2278,16 @@ namespace RClassic_Float
 		s_columnLight = computeLighting(z, 0);
 
 		// Figure out the correct column function.
-		ColumnFunction spriteColumnFunc;
+		ColumnFuncId spriteColumnId;
 		if (s_columnLight && !(obj->flags & OBJ_FLAG_FULLBRIGHT) && !s_flatLighting)
 		{
-			spriteColumnFunc = s_columnFunc[COLFUNC_LIT_TRANS];
+			spriteColumnId = COLFUNC_LIT_TRANS;
 		}
 		else
 		{
-			spriteColumnFunc = s_columnFunc[COLFUNC_FULLBRIGHT_TRANS];
+			spriteColumnId = COLFUNC_FULLBRIGHT_TRANS;
 		}
+		ColumnFunction spriteColumnFunc = s_columnFunc[spriteColumnId];
 
 		// Draw
 		const s32 compressed = cell->compressed;
@@ -2337,6 +2315,8 @@ namespace RClassic_Float
 		s_texHeightMask = 0xffff;
 
 		const u32* columnOffset = (u32*)(basePtr + cell->columnOffset);
+		// Compressed cells are decompressed once and cached.
+		const u8* cellImage = compressed ? spriteCache_getCell(basePtr, cell) : nullptr;
 		for (s32 x = x0_pixel; x <= x1_pixel; x++, uCoord += uCoordStep)
 		{
 			if (z < s_rcfltState.depth1d[x])
@@ -2367,7 +2347,20 @@ namespace RClassic_Float
 						texelU = cell->sizeX - texelU - 1;
 					}
 
-					if (compressed)
+					if (cellImage)
+					{
+						s_texImage = (u8*)cellImage + texelU * cell->sizeY;
+					}
+					else if (compressed && s_rasterDeferred)
+					{
+						// Defer decompression to the thread that owns this column, the work buffer cannot be shared.
+						assert(cell->sizeY <= 1024 && texelU >= 0 && texelU < cell->sizeX);
+						const u8* colPtr = (u8*)cell + columnOffset[texelU];
+						raster_pushColumnCompressed(spriteColumnId, &s_display[y0 * s_width + x], colPtr, cell->sizeY, s_columnLight, s_vCoordFixed, s_vCoordStep, s_yPixelCount);
+						if (s_yPixelCount > 1) { drawn = JTRUE; }
+						continue;
+					}
+					else if (compressed)
 					{
 						const u8* colPtr = (u8*)cell + columnOffset[texelU];
 
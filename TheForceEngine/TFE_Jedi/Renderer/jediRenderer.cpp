@@ -4,6 +4,7 @@
 #include <TFE_Jedi/Level/level.h>
 #include "rcommon.h"
 #include "rsectorRender.h"
+#include "rsort.h"
 #include "RClassic_Fixed/rclassicFixedSharedState.h"
 #include "RClassic_Fixed/rclassicFixed.h"
 #include "RClassic_Fixed/rsectorFixed.h"
@@ -11,7 +12,9 @@
 #include "RClassic_Float/rclassicFloat.h"
 #include "RClassic_Float/rsectorFloat.h"
 #include "RClassic_Float/rclassicFloatSharedState.h"
+#include "RClassic_Float/rrasterFloat.h"
 
+#include <TFE_System/system.h>
 #include <TFE_System/profiler.h>
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Settings/settings.h>
@@ -25,6 +28,7 @@ namespace TFE_Jedi
 
 	static bool s_init = false;
 	static TFE_SubRenderer s_subRenderer = TSR_CLASSIC_FIXED;
+	static s32 s_sortBenchIterations = 0;
 	
 	TFE_Sectors* s_sectorRenderer = nullptr;
 
@@ -32,8 +36,12 @@ namespace TFE_Jedi
 	// Forward Declarations
 	/////////////////////////////////////////////
 	void clear1dDepth();
+	void growRenderLimits();
 	void console_setSubRenderer(const std::vector<std::string>& args);
 	void console_getSubRenderer(const std::vector<std::string>& args);
+	void console_setThreadCount(const std::vector<std::string>& args);
+	void console_getThreadCount(const std::vector<std::string>& args);
+	void console_sortBench(const std::vector<std::string>& args);
 
 	/////////////////////////////////////////////
 	// Implementation
@@ -55,10 +63,17 @@ namespace TFE_Jedi
 		s_maxDepthCount = 0xffff;
 		CVAR_INT(s_maxWallCount, "d_maxWallCount", CVFLAG_DO_NOT_SERIALIZE, "Maximum wall count for a given sector.");
 		CVAR_INT(s_maxDepthCount, "d_maxDepthCount", CVFLAG_DO_NOT_SERIALIZE, "Maximum adjoin depth count.");
+		s_pvsCull = false;
+		s_pvsValidate = false;
+		CVAR_BOOL(s_pvsCull, "r_pvsCull", CVFLAG_DO_NOT_SERIALIZE, "Skip sectors that the level PVS reports as not visible from the camera sector (Classic_Float) and fail line of sight tests between them. Off until r_pvsValidate reports no errors in the shipped levels.");
+		CVAR_BOOL(s_pvsValidate, "r_pvsValidate", CVFLAG_DO_NOT_SERIALIZE, "Draw every sector and run every line of sight test, and report the sectors that the level PVS would have culled.");
 
 		// Remove temporarily until they do something useful again.
 		CCMD("rsetSubRenderer", console_setSubRenderer, 1, "Set the sub-renderer - valid values are: Classic_Fixed, Classic_Float, Classic_GPU");
 		CCMD("rgetSubRenderer", console_getSubRenderer, 0, "Get the current sub-renderer.");
+		CCMD("rsetThreadCount", console_setThreadCount, 1, "Set the number of threads used to rasterize the Classic_Float sub-renderer, range is 1 to 16.");
+		CCMD("rgetThreadCount", console_getThreadCount, 0, "Get the number of threads used to rasterize the Classic_Float sub-renderer.");
+		CCMD("rsortBench", console_sortBench, 0, "rsortBench [iterations] - capture the wall segment and polygon lists of the next frame, time qsort against the render sort and check that the order matches (default 1000 iterations).");
 
 		// Setup performance counters.
 		TFE_COUNTER(s_maxAdjoinDepth, "Maximum Adjoin Depth");
@@ -67,12 +82,20 @@ namespace TFE_Jedi
 		TFE_COUNTER(s_flatCount, "Flat Count");
 		TFE_COUNTER(s_curWallSeg, "Wall Segment Count");
 		TFE_COUNTER(s_adjoinSegCount, "Adjoin Segment Count");
-
+		TFE_COUNTER(s_pvsCullCount, "PVS Culled Sectors");
+		TFE_COUNTER(s_pvsErrorCount, "PVS Validation Errors");
+		TFE_COUNTER(s_segHighWater, "Wall Segment High Water");
+		TFE_COUNTER(s_adjoinSegHighWater, "Adjoin Segment High Water");
+		TFE_COUNTER(s_adjoinDepthHighWater, "Adjoin Depth High Water");
+		TFE_COUNTER(s_viewObjHighWater, "View Object High Water");
+
+		RClassic_Float::raster_init();
 		s_sectorRenderer = new TFE_Sectors_Fixed();
 	}
 
 	void renderer_destroy()
 	{
+		RClassic_Float::raster_destroy();
 		delete s_sectorRenderer;
 	}
 
@@ -145,6 +168,27 @@ namespace TFE_Jedi
 		TFE_Console::addToHistory(c_subRenderers[s_subRenderer]);
 	}
 
+	void console_setThreadCount(const std::vector<std::string>& args)
+	{
+		if (args.size() < 2) { return; }
+		TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
+		graphics->renderThreadCount = clamp(s32(atoi(args[1].c_str())), 1, MAX_RASTER_THREADS);
+		TFE_Settings::writeToDisk();
+	}
+
+	void console_getThreadCount(const std::vector<std::string>& args)
+	{
+		char res[256];
+		sprintf(res, "Render Thread Count: %d", TFE_Settings::getGraphicsSettings()->renderThreadCount);
+		TFE_Console::addToHistory(res);
+	}
+
+	void console_sortBench(const std::vector<std::string>& args)
+	{
+		s_sortBenchIterations = args.size() >= 2 ? max(1, atoi(args[1].c_str())) : 1000;
+		s_sortCapture = JTRUE;
+	}
+
 	JBool render_setResolution()
 	{
 		TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
@@ -279,6 +323,11 @@ namespace TFE_Jedi
 			s_subRenderer = TSR_INVALID;
 			setSubRenderer(subRenderer);
 		}
+		// Resize the frame buffers if the previous frame ran out of space.
+		if (s_limitsExceeded)
+		{
+			growRenderLimits();
+		}
 
 		// Clear the top pixel row.
 		memset(display, 0, s_width);
@@ -312,6 +361,8 @@ namespace TFE_Jedi
 
 		s_prevSector = nullptr;
 		s_sectorIndex = 0;
+		s_pvsCullCount = 0;
+		s_pvsErrorCount = 0;
 		s_maxAdjoinIndex = 0;
 		s_adjoinSegCount = 1;
 		s_adjoinIndex = 0;
@@ -330,14 +381,60 @@ namespace TFE_Jedi
 		// Recursively draws sectors and their contents (sprites, 3D objects).
 		{
 			TFE_ZONE("Sector Draw");
+			// Only the floating point sub-renderer supports banded rasterization.
+			const s32 threadCount = (s_subRenderer == TSR_CLASSIC_FLOAT) ? TFE_Settings::getGraphicsSettings()->renderThreadCount : 1;
+			RClassic_Float::raster_beginFrame(threadCount);
+
 			s_sectorRenderer->prepare();
 			s_sectorRenderer->draw(sector);
+
+			RClassic_Float::raster_endFrame();
+		}
+
+		s_segHighWater = max(s_segHighWater, max(s_nextWall, max(s_curWallSeg, s_flatCount)));
+		s_adjoinSegHighWater = max(s_adjoinSegHighWater, s_adjoinSegCount);
+		s_adjoinDepthHighWater = max(s_adjoinDepthHighWater, s_maxAdjoinDepth);
+
+		if (s_sortBenchIterations)
+		{
+			sortBench_run(s_sortBenchIterations);
+			s_sortBenchIterations = 0;
 		}
 	}
 
 	/////////////////////////////////////////////
 	// Internal
 	/////////////////////////////////////////////
+	void growRenderLimits()
+	{
+		const s32 prevSegLimit = s_segLimit;
+		const s32 prevAdjoinSegLimit = s_adjoinSegLimit;
+		const s32 prevAdjoinDepthLimit = s_adjoinDepthLimit;
+		const s32 prevViewObjLimit = s_viewObjLimit;
+		if (s_limitsExceeded & RLIMIT_SEG)          { s_segLimit = min(s_segLimit * 2, MAX_SEG_CAP); }
+		if (s_limitsExceeded & RLIMIT_ADJOIN_SEG)   { s_adjoinSegLimit = min(s_adjoinSegLimit * 2, MAX_ADJOIN_SEG_CAP); }
+		if (s_limitsExceeded & RLIMIT_ADJOIN_DEPTH) { s_adjoinDepthLimit = min(s_adjoinDepthLimit * 2, MAX_ADJOIN_DEPTH_CAP); }
+		if (s_limitsExceeded & RLIMIT_VIEW_OBJ)     { s_viewObjLimit = min(s_viewObjLimit * 2, MAX_VIEW_OBJ_CAP); }
+		s_limitsExceeded = 0;
+		// Once a limit reaches its cap, frames that need more are drawn with what fits.
+		if (s_segLimit == prevSegLimit && s_adjoinSegLimit == prevAdjoinSegLimit && s_adjoinDepthLimit == prevAdjoinDepthLimit && s_viewObjLimit == prevViewObjLimit)
+		{
+			return;
+		}
+		TFE_System::logWrite(LOG_MSG, "Renderer", "Render limits raised - wall segments: %d, adjoin segments: %d, adjoin depth: %d, objects: %d.",
+			s_segLimit, s_adjoinSegLimit, s_adjoinDepthLimit, s_viewObjLimit);
+
+		// The sector stack and object buffer are resized in TFE_Sectors::prepare().
+		if (s_subRenderer == TSR_CLASSIC_FIXED)
+		{
+			RClassic_Fixed::resizeFrameBuffers();
+		}
+		else if (s_subRenderer == TSR_CLASSIC_FLOAT)
+		{
+			RClassic_Float::resizeFrameBuffers();
+		}
+	}
+
 	void clear1dDepth()
 	{
 		if (s_subRenderer == TSR_CLASSIC_FIXED)
@@ -76,9 +76,24 @@ namespace TFE_Jedi
 	s32 s_lightCount = 3;
 	JBool s_flatLighting = JFALSE;
 
+	// Render Limits
+	s32 s_segLimit = MAX_SEG;
+	s32 s_adjoinSegLimit = MAX_ADJOIN_SEG;
+	s32 s_adjoinDepthLimit = MAX_ADJOIN_DEPTH;
+	s32 s_viewObjLimit = MAX_VIEW_OBJ_COUNT;
+	u32 s_limitsExceeded = 0;
+	s32 s_segHighWater = 0;
+	s32 s_adjoinSegHighWater = 0;
+	s32 s_adjoinDepthHighWater = 0;
+	s32 s_viewObjHighWater = 0;
+
 	// Debug
 	s32 s_maxWallCount;
 	s32 s_maxDepthCount;
+	bool s_pvsCull;
+	bool s_pvsValidate;
+	s32 s_pvsCullCount;
+	s32 s_pvsErrorCount;
 
 	s32 s_drawnSpriteCount;
 	SecObject* s_drawnSprites[MAX_DRAWN_SPRITE_STORE];
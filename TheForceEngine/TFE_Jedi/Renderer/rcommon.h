@@ -79,7 +79,33 @@ namespace TFE_Jedi
 
 	extern JBool s_flatLighting;
 
+	// Render Limits
+	// The per-frame buffers start at the sizes in rlimits.h, when a frame runs out of space
+	// the matching flag is set and the limit is doubled before the next frame is drawn.
+	enum RenderLimitFlags
+	{
+		RLIMIT_SEG          = (1 << 0),
+		RLIMIT_ADJOIN_SEG   = (1 << 1),
+		RLIMIT_ADJOIN_DEPTH = (1 << 2),
+		RLIMIT_VIEW_OBJ     = (1 << 3),
+	};
+	extern s32 s_segLimit;
+	extern s32 s_adjoinSegLimit;
+	extern s32 s_adjoinDepthLimit;
+	extern s32 s_viewObjLimit;
+	extern u32 s_limitsExceeded;
+	// Largest amounts used in a single frame.
+	extern s32 s_segHighWater;
+	extern s32 s_adjoinSegHighWater;
+	extern s32 s_adjoinDepthHighWater;
+	extern s32 s_viewObjHighWater;
+
 	// Debug
 	extern s32 s_maxWallCount;
 	extern s32 s_maxDepthCount;
+	// Level PVS culling (Classic_Float only, off by default), validation draws everything and reports sectors the PVS would have culled.
+	extern bool s_pvsCull;
+	extern bool s_pvsValidate;
+	extern s32 s_pvsCullCount;
+	extern s32 s_pvsErrorCount;
 }
@@ -1,18 +1,24 @@
 #pragma once
 #include <TFE_System/types.h>
 
-// TODO: Add an option to increase these limits, particularly
-// MAX_ADJOIN_SEG (tested up to 384) and
-// MAX_ADJOIN_DEPTH (tested up to 256).
+// MAX_SEG, MAX_ADJOIN_SEG, MAX_ADJOIN_DEPTH and MAX_VIEW_OBJ_COUNT are
+// the initial sizes of the per-frame render buffers. If a frame needs
+// more, the limit is doubled and the buffers are resized before the
+// next frame (see the render limits in rcommon.h), up to the matching
+// *_CAP value below.
 
 namespace TFE_Jedi
 {
 	#define MAX_DRAWN_SPRITE_STORE 32 // Maximum number of drawn sprites stored for future reference (like autoaim).
-	#define MAX_SEG				384 // Maximum number of wall segments visible in the frame.
-	#define MAX_ADJOIN_SEG		128 // Maximum number of adjoin segements visible in the frame.
+	#define MAX_SEG				384 // Initial number of wall segments visible in the frame.
+	#define MAX_ADJOIN_SEG		128 // Initial number of adjoin segements visible in the frame.
 	#define MAX_SPLIT_WALLS		 40 // Maximum number of times walls can be split in a sector.
-	#define MAX_ADJOIN_DEPTH	 40 // Maximum adjoin depth - basically how many adjoins you can see through.
-	#define MAX_VIEW_OBJ_COUNT	128 // Maximum number of rendered objects in a single sector / view.
+	#define MAX_ADJOIN_DEPTH	 40 // Initial adjoin depth - basically how many adjoins you can see through.
+	#define MAX_VIEW_OBJ_COUNT	128 // Initial number of rendered objects in a single sector / view.
+	#define MAX_SEG_CAP			65536 // Render limits never grow past these values.
+	#define MAX_ADJOIN_SEG_CAP	16384
+	#define MAX_ADJOIN_DEPTH_CAP	  256 // The adjoin depth is also the recursion depth of the sector renderers.
+	#define MAX_VIEW_OBJ_CAP	 4096
 	#define LIGHT_SOURCE_LEVELS	128 // Number of levels in the light source (like the headlamp or weapon fire).
 	#define LIGHT_LEVELS		 32 // Number of light levels, maximum = LIGHT_LEVELS - 1
 	#define MAX_LIGHT_LEVEL (LIGHT_LEVELS-1)
@@ -2,9 +2,30 @@
 #include "redgePair.h"
 #include <TFE_Jedi/Level/robject.h>
 #include "rcommon.h"
+#include <stdlib.h>
 
 namespace TFE_Jedi
 {
+	TFE_Sectors::~TFE_Sectors()
+	{
+		free(s_sectorStack);
+		free(s_objBuffer);
+	}
+
+	void TFE_Sectors::resizeBuffers()
+	{
+		if (s_sectorStackSize != s_adjoinDepthLimit)
+		{
+			s_sectorStackSize = s_adjoinDepthLimit;
+			s_sectorStack = (SectorSaveValues*)realloc(s_sectorStack, sizeof(SectorSaveValues) * s_sectorStackSize);
+		}
+		if (s_objBufferSize != s_viewObjLimit)
+		{
+			s_objBufferSize = s_viewObjLimit;
+			s_objBuffer = (SecObject**)realloc(s_objBuffer, sizeof(SecObject*) * s_objBufferSize);
+		}
+	}
+
 	void TFE_Sectors::computeAdjoinWindowBounds(EdgePairFixed* adjoinEdges)
 	{
 		s32 yC = adjoinEdges->yPixel_C0;
@@ -53,6 +53,7 @@ namespace TFE_Jedi
 	class TFE_Sectors
 	{
 	public:
+		virtual ~TFE_Sectors();
 		void computeAdjoinWindowBounds(EdgePairFixed* adjoinEdges);
 
 		// Sub-Renderer specific
@@ -71,10 +72,15 @@ namespace TFE_Jedi
 		}
 
 	protected:
-		SectorSaveValues s_sectorStack[MAX_ADJOIN_DEPTH];
+		// Resize the sector stack and object buffer to match the current render limits.
+		void resizeBuffers();
+
+		SectorSaveValues* s_sectorStack = nullptr;	// [s_adjoinDepthLimit]
+		s32 s_sectorStackSize = 0;
 
 		RSector* s_curSector;
 		MemoryPool* s_memPool;
-		SecObject* s_objBuffer[MAX_VIEW_OBJ_COUNT];
+		SecObject** s_objBuffer = nullptr;			// [s_viewObjLimit]
+		s32 s_objBufferSize = 0;
 	};
 }
@@ -0,0 +1,203 @@
+#include "rsort.h"
+#include "rwallSegment.h"
+#include <TFE_System/system.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Asset/modelAsset_jedi.h>
+#include <TFE_FrontEndUI/console.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	JBool s_sortCapture = JFALSE;
+	static std::vector<u32> s_capturedKeys;
+	static std::vector<s32> s_capturedCounts;
+	static std::vector<u8>  s_capturedLists;
+
+	static const char* c_sortBenchListNames[SORT_BENCH_COUNT] =
+	{
+		"Wall X",			// SORT_BENCH_WALL_X
+		"Polygon Fixed",	// SORT_BENCH_POLYGON_FIXED
+		"Polygon Float",	// SORT_BENCH_POLYGON_FLOAT
+	};
+
+	void sortBench_capture(SortBenchList list, const u32* keys, s32 count)
+	{
+		if (count < 2) { return; }
+		s_capturedLists.push_back(u8(list));
+		s_capturedCounts.push_back(count);
+		s_capturedKeys.insert(s_capturedKeys.end(), keys, keys + count);
+	}
+
+	// Copies of the comparisons used by the renderers.
+	static s32 benchWallSortX(const void* r0, const void* r1)
+	{
+		return ((const RWallSegmentFloat*)r0)->wallX0 - ((const RWallSegmentFloat*)r1)->wallX0;
+	}
+
+	static s32 benchPolygonSortFixed(const void* r0, const void* r1)
+	{
+		Polygon* p0 = *((Polygon**)r0);
+		Polygon* p1 = *((Polygon**)r1);
+		return p1->zAve - p0->zAve;
+	}
+
+	static s32 benchPolygonSortFloat(const void* r0, const void* r1)
+	{
+		Polygon* p0 = *((Polygon**)r0);
+		Polygon* p1 = *((Polygon**)r1);
+		return signZero(p1->zAvef - p0->zAvef);
+	}
+
+	static u32 keyToFloatBits(u32 key)
+	{
+		return (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+	}
+
+	// Fill the wall segments from the captured keys, wallX1 is set to the original index so the order can be compared.
+	static void fillSegments(RWallSegmentFloat* segments, const u32* keys, s32 count)
+	{
+		for (s32 i = 0; i < count; i++)
+		{
+			segments[i].wallX0 = s32(keys[i] ^ 0x80000000u);
+			segments[i].wallX1 = i;
+		}
+	}
+
+	static void fillPolygons(Polygon* polygons, Polygon** list, SortBenchList type, const u32* keys, s32 count)
+	{
+		for (s32 i = 0; i < count; i++)
+		{
+			if (type == SORT_BENCH_POLYGON_FIXED)
+			{
+				polygons[i].zAve = s32(~keys[i] ^ 0x80000000u);
+			}
+			else
+			{
+				const u32 bits = keyToFloatBits(~keys[i]);
+				memcpy(&polygons[i].zAvef, &bits, sizeof(u32));
+			}
+			list[i] = &polygons[i];
+		}
+	}
+
+	// Recompute the keys the same way the renderers do.
+	static void computeKeys(SortBenchList type, const RWallSegmentFloat* segments, Polygon* const* list, u32* keys, s32 count)
+	{
+		for (s32 i = 0; i < count; i++)
+		{
+			if (type == SORT_BENCH_WALL_X)              { keys[i] = sortKey_s32(segments[i].wallX0); }
+			else if (type == SORT_BENCH_POLYGON_FIXED) { keys[i] = ~sortKey_s32(list[i]->zAve); }
+			else                                        { keys[i] = ~sortKey_f32(list[i]->zAvef); }
+		}
+	}
+
+	void sortBench_run(s32 iterations)
+	{
+		s_sortCapture = JFALSE;
+		const s32 listCount = s32(s_capturedCounts.size());
+		if (!listCount)
+		{
+			TFE_Console::addToHistory("No sort lists were captured.");
+			return;
+		}
+
+		s32 maxCount = 0;
+		for (s32 l = 0; l < listCount; l++)
+		{
+			maxCount = max(maxCount, s_capturedCounts[l]);
+		}
+		std::vector<RWallSegmentFloat> segments(maxCount);
+		std::vector<RWallSegmentFloat> segmentScratch(maxCount);
+		std::vector<Polygon> polygons(maxCount);
+		std::vector<Polygon*> polygonList(maxCount);
+		std::vector<Polygon*> polygonScratch(maxCount);
+		std::vector<u32> keys(maxCount * 2);
+		std::vector<s32> indices(maxCount * 2);
+		// The original index (walls) or polygon of each sorted element after qsort(), to compare element identity.
+		std::vector<s32> referenceIndex(maxCount);
+		std::vector<Polygon*> referencePolygon(maxCount);
+		memset(segments.data(), 0, sizeof(RWallSegmentFloat) * maxCount);
+		memset(polygons.data(), 0, sizeof(Polygon) * maxCount);
+
+		u64 qsortTicks[SORT_BENCH_COUNT] = { 0 };
+		u64 sortTicks[SORT_BENCH_COUNT] = { 0 };
+		s32 lists[SORT_BENCH_COUNT] = { 0 };
+		s32 elements[SORT_BENCH_COUNT] = { 0 };
+		s32 fallbacks[SORT_BENCH_COUNT] = { 0 };
+		s32 mismatches[SORT_BENCH_COUNT] = { 0 };
+		for (s32 it = 0; it < iterations; it++)
+		{
+			const u32* listKeys = s_capturedKeys.data();
+			for (s32 l = 0; l < listCount; l++)
+			{
+				const s32 count = s_capturedCounts[l];
+				const SortBenchList type = SortBenchList(s_capturedLists[l]);
+				const JBool isWall = (type == SORT_BENCH_WALL_X) ? JTRUE : JFALSE;
+				s32 (*compare)(const void*, const void*) = isWall ? benchWallSortX : (type == SORT_BENCH_POLYGON_FIXED ? benchPolygonSortFixed : benchPolygonSortFloat);
+
+				// Reference: qsort() with the original comparison.
+				if (isWall) { fillSegments(segments.data(), listKeys, count); }
+				else { fillPolygons(polygons.data(), polygonList.data(), type, listKeys, count); }
+				u64 start = TFE_System::getCurrentTimeInTicks();
+				if (isWall) { qsort(segments.data(), count, sizeof(RWallSegmentFloat), compare); }
+				else { qsort(polygonList.data(), count, sizeof(Polygon*), compare); }
+				qsortTicks[type] += TFE_System::getCurrentTimeInTicks() - start;
+				if (it == 0)
+				{
+					for (s32 i = 0; i < count; i++)
+					{
+						if (isWall) { referenceIndex[i] = segments[i].wallX1; }
+						else { referencePolygon[i] = polygonList[i]; }
+					}
+				}
+
+				// The render sort, including computing the keys.
+				if (isWall) { fillSegments(segments.data(), listKeys, count); }
+				else { fillPolygons(polygons.data(), polygonList.data(), type, listKeys, count); }
+				start = TFE_System::getCurrentTimeInTicks();
+				computeKeys(type, segments.data(), polygonList.data(), keys.data(), count);
+				JBool fallback;
+				if (isWall) { fallback = sort_byKeyAsQsort(segments.data(), keys.data(), count, compare, segmentScratch.data(), keys.data() + maxCount, indices.data()); }
+				else { fallback = sort_byKeyAsQsort(polygonList.data(), keys.data(), count, compare, polygonScratch.data(), keys.data() + maxCount, indices.data()); }
+				sortTicks[type] += TFE_System::getCurrentTimeInTicks() - start;
+
+				if (it == 0)
+				{
+					lists[type]++;
+					elements[type] += count;
+					fallbacks[type] += fallback ? 1 : 0;
+					for (s32 i = 0; i < count; i++)
+					{
+						const JBool same = isWall ? (referenceIndex[i] == segments[i].wallX1) : (referencePolygon[i] == polygonList[i]);
+						if (!same) { mismatches[type]++; break; }
+					}
+				}
+
+				listKeys += count;
+			}
+		}
+
+		s32 totalMismatches = 0;
+		for (s32 t = 0; t < SORT_BENCH_COUNT; t++)
+		{
+			if (!lists[t]) { continue; }
+			char result[256];
+			sprintf(result, "%s: sorted %d lists (%d elements) x %d: qsort %.3f ms, sort_byKeyAsQsort %.3f ms, qsort fallbacks: %d, mismatched lists: %d",
+				c_sortBenchListNames[t], lists[t], elements[t], iterations,
+				TFE_System::convertFromTicksToSeconds(qsortTicks[t]) * 1000.0, TFE_System::convertFromTicksToSeconds(sortTicks[t]) * 1000.0,
+				fallbacks[t], mismatches[t]);
+			TFE_Console::addToHistory(result);
+			TFE_System::logWrite(LOG_MSG, "Renderer", "%s", result);
+			totalMismatches += mismatches[t];
+		}
+		if (totalMismatches)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Renderer", "The render sort order differs from qsort() in %d lists.", totalMismatches);
+		}
+
+		s_capturedKeys.clear();
+		s_capturedCounts.clear();
+		s_capturedLists.clear();
+	}
+}
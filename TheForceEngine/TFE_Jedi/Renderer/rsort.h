@@ -0,0 +1,165 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Render Sorting
+// Allocation free sorts used to order wall segments and polygons
+// every frame, replacing qsort() and its function pointer comparisons.
+//
+// The result must match qsort() exactly, including the order of
+// elements that compare equal, so rendering stays identical. When no
+// keys are equal the sorted order is unique and the key sort is used,
+// otherwise the list falls back to qsort() with the original comparison.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <cstring>
+#include <stdlib.h>
+
+namespace TFE_Jedi
+{
+	// Lists up to this size use insertion sort, larger lists use radix sort.
+	#define SORT_INSERTION_MAX 24
+
+	// Map keys to unsigned values with the same ascending order.
+	inline u32 sortKey_s32(s32 value)
+	{
+		return u32(value) ^ 0x80000000u;
+	}
+
+	inline u32 sortKey_f32(f32 value)
+	{
+		u32 bits;
+		memcpy(&bits, &value, sizeof(u32));
+		// -0 and +0 compare equal, so they need the same key.
+		if (bits == 0x80000000u) { bits = 0; }
+		return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	}
+
+	// Insertion sort of items by precomputed keys, in ascending order.
+	template <typename T>
+	void sort_insertion(T* items, u32* keys, s32 count)
+	{
+		for (s32 i = 1; i < count; i++)
+		{
+			const u32 key = keys[i];
+			if (keys[i - 1] <= key) { continue; }
+
+			const T item = items[i];
+			s32 j = i - 1;
+			for (; j >= 0 && keys[j] > key; j--)
+			{
+				items[j + 1] = items[j];
+				keys[j + 1]  = keys[j];
+			}
+			items[j + 1] = item;
+			keys[j + 1]  = key;
+		}
+	}
+
+	// LSD radix sort of items by precomputed keys, in ascending order, 8 bits per pass.
+	// Passes where every key shares the same digit are skipped, so screen space keys usually take one or two passes.
+	// scratchItems and scratchKeys must hold 'count' elements.
+	template <typename T>
+	void sort_radix(T* items, u32* keys, s32 count, T* scratchItems, u32* scratchKeys)
+	{
+		T*   srcItems = items;
+		u32* srcKeys  = keys;
+		T*   dstItems = scratchItems;
+		u32* dstKeys  = scratchKeys;
+
+		for (u32 shift = 0; shift < 32; shift += 8)
+		{
+			s32 offset[256] = { 0 };
+			for (s32 i = 0; i < count; i++)
+			{
+				offset[(srcKeys[i] >> shift) & 0xff]++;
+			}
+			if (offset[(srcKeys[0] >> shift) & 0xff] == count) { continue; }
+
+			for (s32 d = 0, sum = 0; d < 256; d++)
+			{
+				const s32 digitCount = offset[d];
+				offset[d] = sum;
+				sum += digitCount;
+			}
+			for (s32 i = 0; i < count; i++)
+			{
+				const s32 index = offset[(srcKeys[i] >> shift) & 0xff]++;
+				dstItems[index] = srcItems[i];
+				dstKeys[index]  = srcKeys[i];
+			}
+
+			T*   tempItems = srcItems; srcItems = dstItems; dstItems = tempItems;
+			u32* tempKeys  = srcKeys;  srcKeys  = dstKeys;  dstKeys  = tempKeys;
+		}
+
+		if (srcItems != items)
+		{
+			for (s32 i = 0; i < count; i++)
+			{
+				items[i] = srcItems[i];
+				keys[i]  = srcKeys[i];
+			}
+		}
+	}
+
+	// Sort items by precomputed keys in ascending order.
+	template <typename T>
+	void sort_byKey(T* items, u32* keys, s32 count, T* scratchItems, u32* scratchKeys)
+	{
+		if (count <= SORT_INSERTION_MAX)
+		{
+			sort_insertion(items, keys, count);
+		}
+		else
+		{
+			sort_radix(items, keys, count, scratchItems, scratchKeys);
+		}
+	}
+
+	// Sort items with the same result as qsort(items, count, sizeof(T), compare), where 'compare' orders the items
+	// the same way as the keys. The keys are sorted together with the item indices and the items are moved once at the end.
+	// If any keys are equal, the order of those items depends on the qsort() implementation, so qsort() is used instead.
+	// 'indices' must hold 2 * count elements, 'scratchItems' and 'scratchKeys' must hold 'count' elements.
+	// Returns JTRUE if the list fell back to qsort().
+	template <typename T>
+	JBool sort_byKeyAsQsort(T* items, u32* keys, s32 count, s32 (*compare)(const void*, const void*), T* scratchItems, u32* scratchKeys, s32* indices)
+	{
+		if (count < 2) { return JFALSE; }
+
+		for (s32 i = 0; i < count; i++)
+		{
+			indices[i] = i;
+		}
+		sort_byKey(indices, keys, count, indices + count, scratchKeys);
+
+		for (s32 i = 1; i < count; i++)
+		{
+			if (keys[i] == keys[i - 1])
+			{
+				qsort(items, count, sizeof(T), compare);
+				return JTRUE;
+			}
+		}
+
+		for (s32 i = 0; i < count; i++)
+		{
+			scratchItems[i] = items[indices[i]];
+		}
+		memcpy(items, scratchItems, sizeof(T) * count);
+		return JFALSE;
+	}
+
+	// Lists captured by the micro-benchmark, the keys are converted back into the values the original comparisons use.
+	enum SortBenchList
+	{
+		SORT_BENCH_WALL_X = 0,		// sortKey_s32(wallX0)
+		SORT_BENCH_POLYGON_FIXED,	// ~sortKey_s32(zAve)
+		SORT_BENCH_POLYGON_FLOAT,	// ~sortKey_f32(zAvef)
+		SORT_BENCH_COUNT
+	};
+
+	// Micro-benchmark and check, compares qsort() with sort_byKeyAsQsort() on the wall segment and polygon lists sorted
+	// while drawing a frame. Set s_sortCapture for a frame, then call sortBench_run() once it has been drawn.
+	extern JBool s_sortCapture;
+	void sortBench_capture(SortBenchList list, const u32* keys, s32 count);
+	void sortBench_run(s32 iterations);
+}
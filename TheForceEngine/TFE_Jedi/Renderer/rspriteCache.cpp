@@ -0,0 +1,206 @@
+#include <cstring>
+
+#include "rspriteCache.h"
+#include "rcommon.h"
+#include <TFE_Asset/spriteAsset_Jedi.h>
+#include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
+#include <TFE_System/profiler.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+namespace TFE_Jedi
+{
+	enum
+	{
+		SPRITE_CACHE_MAX_CELLS = 1024,
+		SPRITE_CACHE_BUCKETS   = 1024,	// Must be a power of 2.
+		SPRITE_CACHE_BUDGET    = 2 * 1024 * 1024,
+		SPRITE_CACHE_ALIGN     = 64,	// Cells start on a cache line.
+	};
+
+	struct SpriteCacheEntry
+	{
+		const WaxCell* cell;
+		u8* alloc;
+		u8* image;
+		u32 size;
+		s32 lastFrame;
+		// Least recently used list, the head is the most recently drawn cell.
+		s32 prev;
+		s32 next;
+		s32 hashNext;
+	};
+
+	struct SpriteCache
+	{
+		SpriteCacheEntry entries[SPRITE_CACHE_MAX_CELLS];
+		s32 buckets[SPRITE_CACHE_BUCKETS];
+		s32 freeList;
+		s32 lruHead;
+		s32 lruTail;
+		s32 cellCount;
+		u32 memoryUsed;
+		JBool init;
+	};
+	// The images live in the resource region, so the index is captured with game snapshots to stay in sync with it.
+	static SpriteCache s_spriteCache = { 0 };
+	SNAPSHOT_STATE(s_spriteCache);
+
+	void spriteCache_clear()
+	{
+		// The images are not freed, the resource region is cleared along with the level.
+		s_spriteCache.init = JFALSE;
+	}
+
+	static void spriteCache_init()
+	{
+		for (s32 i = 0; i < SPRITE_CACHE_BUCKETS; i++)
+		{
+			s_spriteCache.buckets[i] = -1;
+		}
+		for (s32 i = 0; i < SPRITE_CACHE_MAX_CELLS; i++)
+		{
+			s_spriteCache.entries[i].hashNext = (i + 1 < SPRITE_CACHE_MAX_CELLS) ? i + 1 : -1;
+		}
+		s_spriteCache.freeList = 0;
+		s_spriteCache.lruHead = -1;
+		s_spriteCache.lruTail = -1;
+		s_spriteCache.cellCount = 0;
+		s_spriteCache.memoryUsed = 0;
+		s_spriteCache.init = JTRUE;
+	}
+
+	static u32 spriteCache_hash(const WaxCell* cell)
+	{
+		return u32((size_t(cell) >> 4) * 2654435761u) & (SPRITE_CACHE_BUCKETS - 1);
+	}
+
+	static void lru_remove(s32 index)
+	{
+		SpriteCacheEntry* entry = &s_spriteCache.entries[index];
+		if (entry->prev >= 0) { s_spriteCache.entries[entry->prev].next = entry->next; }
+		else { s_spriteCache.lruHead = entry->next; }
+
+		if (entry->next >= 0) { s_spriteCache.entries[entry->next].prev = entry->prev; }
+		else { s_spriteCache.lruTail = entry->prev; }
+	}
+
+	static void lru_pushFront(s32 index)
+	{
+		SpriteCacheEntry* entry = &s_spriteCache.entries[index];
+		entry->prev = -1;
+		entry->next = s_spriteCache.lruHead;
+		if (s_spriteCache.lruHead >= 0) { s_spriteCache.entries[s_spriteCache.lruHead].prev = index; }
+		else { s_spriteCache.lruTail = index; }
+		s_spriteCache.lruHead = index;
+	}
+
+	// Evict the least recently drawn cell, returns false if every cell has been drawn this frame.
+	static bool spriteCache_evict()
+	{
+		const s32 index = s_spriteCache.lruTail;
+		if (index < 0) { return false; }
+		SpriteCacheEntry* entry = &s_spriteCache.entries[index];
+		if (entry->lastFrame == s_drawFrame) { return false; }
+
+		// Remove from the hash chain.
+		s32* link = &s_spriteCache.buckets[spriteCache_hash(entry->cell)];
+		while (*link != index)
+		{
+			link = &s_spriteCache.entries[*link].hashNext;
+		}
+		*link = entry->hashNext;
+		lru_remove(index);
+
+		res_free(entry->alloc);
+		s_spriteCache.memoryUsed -= entry->size;
+		s_spriteCache.cellCount--;
+
+		entry->cell = nullptr;
+		entry->hashNext = s_spriteCache.freeList;
+		s_spriteCache.freeList = index;
+		return true;
+	}
+
+	static void decompressColumn(const u8* colData, u8* outBuffer, s32 height)
+	{
+		for (s32 y = 0; y < height; )
+		{
+			const u8 code = *colData;
+			colData++;
+
+			// Cells are packed together, so runs are clamped to the column height.
+			const s32 count = min(s32(code & 0x7f), height - y);
+			if (code & 0x80)
+			{
+				memset(&outBuffer[y], 0, count);
+			}
+			else
+			{
+				memcpy(&outBuffer[y], colData, count);
+				colData += count;
+			}
+			y += count;
+		}
+	}
+
+	const u8* spriteCache_getCell(const u8* basePtr, const WaxCell* cell)
+	{
+		if (!s_spriteCache.init)
+		{
+			spriteCache_init();
+		}
+
+		const u32 bucket = spriteCache_hash(cell);
+		for (s32 index = s_spriteCache.buckets[bucket]; index >= 0; index = s_spriteCache.entries[index].hashNext)
+		{
+			SpriteCacheEntry* entry = &s_spriteCache.entries[index];
+			if (entry->cell == cell)
+			{
+				if (index != s_spriteCache.lruHead)
+				{
+					lru_remove(index);
+					lru_pushFront(index);
+				}
+				entry->lastFrame = s_drawFrame;
+				return entry->image;
+			}
+		}
+
+		const u32 size = u32(cell->sizeX * cell->sizeY);
+		if (!size || size > SPRITE_CACHE_BUDGET / 4) { return nullptr; }
+
+		// Make room for the new cell.
+		while (s_spriteCache.freeList < 0 || s_spriteCache.memoryUsed + size > SPRITE_CACHE_BUDGET)
+		{
+			if (!spriteCache_evict()) { return nullptr; }
+		}
+		u8* alloc = (u8*)res_alloc(size + SPRITE_CACHE_ALIGN - 1);
+		if (!alloc) { return nullptr; }
+
+		TFE_ZONE("Sprite Cell Decompress");
+		const s32 index = s_spriteCache.freeList;
+		SpriteCacheEntry* entry = &s_spriteCache.entries[index];
+		s_spriteCache.freeList = entry->hashNext;
+
+		entry->cell  = cell;
+		entry->alloc = alloc;
+		entry->image = (u8*)((size_t(alloc) + SPRITE_CACHE_ALIGN - 1) & ~size_t(SPRITE_CACHE_ALIGN - 1));
+		entry->size  = size;
+		entry->lastFrame = s_drawFrame;
+		entry->hashNext = s_spriteCache.buckets[bucket];
+		s_spriteCache.buckets[bucket] = index;
+		lru_pushFront(index);
+		s_spriteCache.memoryUsed += size;
+		s_spriteCache.cellCount++;
+
+		// Decompress the cell into column-major order.
+		const u32* columnOffset = (u32*)(basePtr + cell->columnOffset);
+		u8* column = entry->image;
+		for (s32 x = 0; x < cell->sizeX; x++, column += cell->sizeY)
+		{
+			decompressColumn((u8*)cell + columnOffset[x], column, cell->sizeY);
+		}
+		return entry->image;
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sprite Cell Cache
+// Decompressed copies of RLE compressed WAX and FME cells, so drawing
+// a compressed sprite only pays for scaling and lighting.
+//
+// Each cell is decompressed the first time it is drawn into a
+// column-major image allocated from the resource region. Once the
+// cache is over budget the least recently drawn cells are evicted.
+// Cells drawn in the current frame are never evicted because the
+// rasterizer threads may still be reading them.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+struct WaxCell;
+
+namespace TFE_Jedi
+{
+	// Returns the decompressed image of a compressed cell, column x starts at x * cell->sizeY.
+	// Returns null if the cell cannot be cached, in which case the columns must be decompressed as they are drawn.
+	const u8* spriteCache_getCell(const u8* basePtr, const WaxCell* cell);
+	// Forget all cached cells, called when the resource region is cleared or the sprite assets are freed.
+	void spriteCache_clear();
+}
@@ -16,6 +16,7 @@ namespace TFE_Jedi
 	static u32 s_prevHeight = 0;
 	static s32 s_widescreenOffset = 0;
 	static bool s_widescreen = false;
+	static JBool s_headless = JFALSE;
 
 	static fixed16_16 s_xScale = ONE_16;
 	static fixed16_16 s_yScale = ONE_16;
@@ -117,9 +118,20 @@ namespace TFE_Jedi
 
 	void vfb_setPalette(const u32* palette)
 	{
+		if (s_headless) { return; }
 		TFE_RenderBackend::setPalette(palette);
 	}
 
+	void vfb_setHeadless(JBool headless)
+	{
+		s_headless = headless;
+	}
+
+	JBool vfb_isHeadless()
+	{
+		return s_headless;
+	}
+
 	////////////////////////////
 	// Get Scale Factors
 	////////////////////////////
@@ -152,6 +164,7 @@ namespace TFE_Jedi
 	// Frame rendering is done, copy the results to GPU memory.
 	void vfb_swap()
 	{
+		if (s_headless) { return; }
 		TFE_RenderBackend::updateVirtualDisplay(s_curFrameBuffer, s_width * s_height);
 	}
 
@@ -200,6 +213,8 @@ namespace TFE_Jedi
 	////////////////////////////
 	void vfb_createVirtualDisplay(u32 width, u32 height)
 	{
+		if (s_headless) { return; }
+
 		// Setup or update the virtual display.
 		TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
 		u32 vdispFlags = 0;
@@ -34,6 +34,9 @@ namespace TFE_Jedi
 	////////////////////////////////////////////////////////////////////////
 	JBool vfb_setResolution(u32 width, u32 height);
 	void vfb_setPalette(const u32* palette);
+	// Headless mode renders into the CPU buffer only, nothing is sent to the render backend.
+	void vfb_setHeadless(JBool headless);
+	JBool vfb_isHeadless();
 
 	////////////////////////////
 	// Get Scale Factors
@@ -161,9 +161,19 @@ namespace TFE_Jedi
 		return SoundSourceID(TFE_VocAsset::getIndex(sound) + 1);
 	}
 
+	// The shift is in 1/16th semitone steps.
 	void sound_pitchShift(SoundEffectID soundId, s32 shift)
 	{
-		// STUB
+		if (soundId == NULL_SOUND) { return; }
+
+		u32 slot = soundId & JSND_SLOT_MASK;
+		u32 uid = soundId >> JSND_UID_SHIFT;
+		SoundSource* curSoundSource = getSourceFromSlot(slot);
+
+		if (curSoundSource == s_slotMapping[slot] && uid == s_slotID[slot])
+		{
+			setSourcePitch(curSoundSource, powf(2.0f, f32(shift) / (16.0f * 12.0f)));
+		}
 	}
 
 	void setSoundSourceVolume(SoundSourceID soundId, s32 volume)
@@ -5,8 +5,11 @@
 #include <TFE_DarkForces/time.h>
 #include <TFE_System/system.h>
 #include <TFE_Game/igame.h>
+#include <TFE_Game/gameSnapshot.h>
 #include <TFE_System/profiler.h>
 #include <stdarg.h>
+#include <algorithm>
+#include <map>
 #include <tuple>
 #include <vector>
 
@@ -62,6 +65,15 @@ struct Task
 	// Timing.
 	Tick nextTick;
 	s32 activeIndex;
+
+	// Schedule tree, see the "Scheduling" section below.
+	Task* schedParent;
+	Task* schedLeft;
+	Task* schedRight;
+	u32  schedPriority;
+	Tick schedMin;			// minimum scheduling key in this subtree.
+
+	u32 profileTimer;
 };
 
 namespace TFE_Jedi
@@ -85,14 +97,294 @@ namespace TFE_Jedi
 	MessageType s_currentMsg = MSG_FREE_TASK;
 
 	TaskContext* s_curContext = nullptr;
+	Task* s_schedRoot = nullptr;
 
 	static f64 s_prevTime = 0.0;
 	static f64 s_minIntervalInSec = 0.0;
 	static s32 s_frameActiveTaskCount = 0;
 	static JBool s_taskSystemPaused = JFALSE;
 	static Task* s_taskPauseTask = nullptr;
+	// Profile timers by task function, this is not game state.
+	static std::map<TaskFunc, u32> s_profileTimers;
+
+	// Game state captured by snapshots, the tasks themselves are in the game region.
+	SNAPSHOT_STATE(s_tasks);
+	SNAPSHOT_STATE(s_stackBlocks);
+	SNAPSHOT_STATE(s_taskCount);
+	SNAPSHOT_STATE(s_rootTask);
+	SNAPSHOT_STATE(s_taskIter);
+	SNAPSHOT_STATE(s_curTask);
+	SNAPSHOT_STATE(s_currentMsg);
+	SNAPSHOT_STATE(s_curContext);
+	SNAPSHOT_STATE(s_schedRoot);
+	SNAPSHOT_STATE(s_frameActiveTaskCount);
+	SNAPSHOT_STATE(s_taskSystemPaused);
+	SNAPSHOT_STATE(s_taskPauseTask);
+
+	JBool selectNextTask();
+
+	//////////////////////////////////////////////////////////////////////
+	// Scheduling
+	// Tasks are executed in a fixed order: the main tasks in list order
+	// starting from the root, where the sub-tasks of each task run before
+	// the task itself. A task is selected if nextTick <= s_curTick, and
+	// the framebreak task is always selected.
+	//
+	// Rather than walking the task lists and checking every task, the
+	// tasks are also kept in a balanced tree (treap) in execution order,
+	// where each node stores the minimum nextTick in its subtree. The next
+	// runnable task after the current one is found in O(log n) by skipping
+	// subtrees that are not ready, and since the tick is only compared
+	// when selecting, s_curTick can change at any time. The tree nodes are
+	// stored in the tasks themselves, so they are captured by snapshots.
+	//////////////////////////////////////////////////////////////////////
+	inline Tick sched_getKey(const Task* task)
+	{
+		return task->framebreak ? 0 : task->nextTick;
+	}
+
+	inline u32 sched_getPriority(const Task* task)
+	{
+		// Hash the address, the priority only needs to be well distributed.
+		u64 h = u64(size_t(task));
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return u32(h);
+	}
+
+	inline void sched_updateNode(Task* task)
+	{
+		Tick minKey = sched_getKey(task);
+		if (task->schedLeft)  { minKey = std::min(minKey, task->schedLeft->schedMin); }
+		if (task->schedRight) { minKey = std::min(minKey, task->schedRight->schedMin); }
+		task->schedMin = minKey;
+	}
+
+	// Update the subtree minimums after a change, stopping once they are no longer affected.
+	void sched_updatePath(Task* task)
+	{
+		while (task)
+		{
+			const Tick prevMin = task->schedMin;
+			sched_updateNode(task);
+			if (task->schedMin == prevMin) { break; }
+			task = task->schedParent;
+		}
+	}
 
-	void selectNextTask();
+	void sched_setTick(Task* task, Tick tick)
+	{
+		task->nextTick = tick;
+		sched_updatePath(task);
+	}
+
+	// Rotate 'task' above its parent, keeping the execution order.
+	void sched_rotateUp(Task* task)
+	{
+		Task* parent = task->schedParent;
+		Task* grandParent = parent->schedParent;
+		if (parent->schedLeft == task)
+		{
+			parent->schedLeft = task->schedRight;
+			if (task->schedRight) { task->schedRight->schedParent = parent; }
+			task->schedRight = parent;
+		}
+		else
+		{
+			parent->schedRight = task->schedLeft;
+			if (task->schedLeft) { task->schedLeft->schedParent = parent; }
+			task->schedLeft = parent;
+		}
+		parent->schedParent = task;
+		task->schedParent = grandParent;
+
+		if (!grandParent)
+		{
+			s_schedRoot = task;
+		}
+		else if (grandParent->schedLeft == parent)
+		{
+			grandParent->schedLeft = task;
+		}
+		else
+		{
+			grandParent->schedRight = task;
+		}
+		sched_updateNode(parent);
+		sched_updateNode(task);
+	}
+
+	// Insert 'task' directly before or after 'anchor' in execution order.
+	void sched_insert(Task* task, Task* anchor, JBool after)
+	{
+		task->schedLeft = nullptr;
+		task->schedRight = nullptr;
+		task->schedPriority = sched_getPriority(task);
+		task->schedMin = sched_getKey(task);
+
+		Task* parent = anchor;
+		if (after)
+		{
+			if (parent->schedRight)
+			{
+				parent = parent->schedRight;
+				while (parent->schedLeft) { parent = parent->schedLeft; }
+				parent->schedLeft = task;
+			}
+			else
+			{
+				parent->schedRight = task;
+			}
+		}
+		else
+		{
+			if (parent->schedLeft)
+			{
+				parent = parent->schedLeft;
+				while (parent->schedRight) { parent = parent->schedRight; }
+				parent->schedRight = task;
+			}
+			else
+			{
+				parent->schedLeft = task;
+			}
+		}
+		task->schedParent = parent;
+		sched_updatePath(parent);
+
+		while (task->schedParent && task->schedParent->schedPriority < task->schedPriority)
+		{
+			sched_rotateUp(task);
+		}
+	}
+
+	void sched_remove(Task* task)
+	{
+		// Rotate the task down until it is a leaf.
+		while (task->schedLeft || task->schedRight)
+		{
+			Task* child = task->schedLeft;
+			if (!child || (task->schedRight && task->schedRight->schedPriority > child->schedPriority))
+			{
+				child = task->schedRight;
+			}
+			sched_rotateUp(child);
+		}
+
+		Task* parent = task->schedParent;
+		if (!parent)
+		{
+			s_schedRoot = nullptr;
+		}
+		else
+		{
+			if (parent->schedLeft == task) { parent->schedLeft = nullptr; }
+			else { parent->schedRight = nullptr; }
+			sched_updatePath(parent);
+		}
+		task->schedParent = nullptr;
+	}
+
+	void sched_reset()
+	{
+		s_rootTask.schedParent = nullptr;
+		s_rootTask.schedLeft = nullptr;
+		s_rootTask.schedRight = nullptr;
+		s_rootTask.schedPriority = sched_getPriority(&s_rootTask);
+		s_rootTask.schedMin = sched_getKey(&s_rootTask);
+		s_schedRoot = &s_rootTask;
+	}
+
+	// Returns the first task in the subtree that can be selected, the subtree minimum must be <= tick.
+	Task* sched_findFirst(Task* task, Tick tick)
+	{
+		while (1)
+		{
+			if (task->schedLeft && task->schedLeft->schedMin <= tick)
+			{
+				task = task->schedLeft;
+			}
+			else if (sched_getKey(task) <= tick)
+			{
+				return task;
+			}
+			else
+			{
+				task = task->schedRight;
+				assert(task && task->schedMin <= tick);
+			}
+		}
+		return nullptr;
+	}
+
+	// Returns the next task after 'task' that can be selected, wrapping around to the beginning.
+	Task* sched_findNext(Task* task, Tick tick)
+	{
+		if (task->schedRight && task->schedRight->schedMin <= tick)
+		{
+			return sched_findFirst(task->schedRight, tick);
+		}
+		while (task->schedParent)
+		{
+			Task* parent = task->schedParent;
+			if (parent->schedLeft == task)
+			{
+				if (sched_getKey(parent) <= tick)
+				{
+					return parent;
+				}
+				if (parent->schedRight && parent->schedRight->schedMin <= tick)
+				{
+					return sched_findFirst(parent->schedRight, tick);
+				}
+			}
+			task = parent;
+		}
+		// Wrap around, this may select the same task again.
+		if (s_schedRoot && s_schedRoot->schedMin <= tick)
+		{
+			return sched_findFirst(s_schedRoot, tick);
+		}
+		return nullptr;
+	}
+
+	u32 getProfileTimer(const char* name, TaskFunc func)
+	{
+	#ifdef TFE_PROFILE_ENABLED
+		// Tasks are often named per instance ("turret%d"), so timers are keyed by the task function
+		// and named after the first task using it, without the numeric suffix.
+		std::map<TaskFunc, u32>::iterator iTimer = s_profileTimers.find(func);
+		if (iTimer != s_profileTimers.end())
+		{
+			return iTimer->second;
+		}
+
+		char baseName[32];
+		strncpy(baseName, name, sizeof(baseName) - 1);
+		baseName[sizeof(baseName) - 1] = 0;
+		size_t len = strlen(baseName);
+		while (len > 1 && baseName[len - 1] >= '0' && baseName[len - 1] <= '9')
+		{
+			len--;
+		}
+		baseName[len] = 0;
+
+		const u32 id = TFE_Profiler::getTimer(baseName);
+		s_profileTimers[func] = id;
+		return id;
+	#else
+		return 0;
+	#endif
+	}
+
+	void clearProfileTimers()
+	{
+	#ifdef TFE_PROFILE_ENABLED
+		s_profileTimers.clear();
+		TFE_Profiler::clearTimers();
+	#endif
+	}
 
 	void createRootTask()
 	{
@@ -108,6 +400,7 @@ namespace TFE_Jedi
 		s_curTask = &s_rootTask;
 		s_taskCount = 0;
 		s_frameActiveTaskCount = 0;
+		sched_reset();
 	}
 
 	Task* createSubTask(const char* name, TaskFunc func, TaskFunc localRunFunc)
@@ -123,6 +416,13 @@ namespace TFE_Jedi
 		s_taskCount++;
 		strcpy(newTask->name, name);
 
+		// The new subtask runs first, before the current first task in the subtree of the "mainline" task.
+		Task* firstTask = s_curTask;
+		while (firstTask->subtaskNext)
+		{
+			firstTask = firstTask->subtaskNext;
+		}
+
 		// Insert newTask at the head of the subtask list in the current "mainline" task.
 		newTask->next = s_curTask->subtaskNext;
 		newTask->prev = nullptr;
@@ -146,6 +446,8 @@ namespace TFE_Jedi
 		newTask->context.callstack[0] = func;
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
+		newTask->profileTimer = getProfileTimer(name, func);
+		sched_insert(newTask, firstTask, JFALSE);
 		return newTask;
 	}
 
@@ -182,6 +484,9 @@ namespace TFE_Jedi
 		newTask->localRunFunc = localRunFunc;
 		newTask->context.level = TASK_INIT_LEVEL;
 		newTask->nextTick = s_curTick;
+		newTask->profileTimer = getProfileTimer(name, func);
+		// The task runs directly after 's_taskIter', which is the last task in its own subtree.
+		sched_insert(newTask, s_taskIter, JTRUE);
 
 		return newTask;
 	}
@@ -205,6 +510,7 @@ namespace TFE_Jedi
 			selectNextTask();
 		}
 		// Then remove the task.
+		sched_remove(task);
 		if (task->prev)
 		{
 			task->prev->next = task->next;
@@ -244,6 +550,7 @@ namespace TFE_Jedi
 		s_curTask = &s_rootTask;
 		s_taskCount = 0;
 		s_frameActiveTaskCount = 0;
+		sched_reset();
 	}
 
 	void task_freeAll()
@@ -254,6 +561,7 @@ namespace TFE_Jedi
 		s_curTask    = nullptr;
 		s_curContext = nullptr;
 		s_taskCount  = 0;
+		clearProfileTimers();
 	}
 
 	void task_shutdown()
@@ -272,16 +580,18 @@ namespace TFE_Jedi
 		s_minIntervalInSec = 0.0;
 		s_frameActiveTaskCount = 0;
 		s_taskPauseTask = nullptr;
+		s_schedRoot = nullptr;
+		clearProfileTimers();
 	}
 
 	void task_makeActive(Task* task)
 	{
-		task->nextTick = 0;
+		sched_setTick(task, 0);
 	}
 
 	void task_setNextTick(Task* task, Tick tick)
 	{
-		task->nextTick = tick;
+		sched_setTick(task, tick);
 	}
 
 	void task_setUserData(Task* task, void* data)
@@ -360,60 +670,17 @@ namespace TFE_Jedi
 		}
 	}
 
-	void selectNextTask()
+	JBool selectNextTask()
 	{
-		// Find the next task to run.
-		Task* task = s_curTask;
-		while (1)
-		{
-			//////////////////////////////////////////////////////////////////////////////////////////
-			// Execution:
-			//  * Go to the next task
-			//  * Check to see if there are sub-tasks
-			//  * If so, the assign current to the sub-task.
-			//  * Execute the task.
-			//  * Once we are on the last sub-task, then go back to the parent.
-			//  * Once the parent executes, then we move on to parent->next and start all over.
-			if (task->next)
-			{
-				// Move the to the next task.
-				task = task->next;
-				// If the task has sub-tasks, loop until we find the last one.
-				// This is usually only one deep.
-				while (task->subtaskNext)
-				{
-					task = task->subtaskNext;
-				}
-				// Then execute the task.
-				if (task->nextTick <= s_curTick || task->framebreak)
-				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
-				}
-			}
-			else if (task->subtaskParent)
-			{
-				// Otherwise, try to execute the parent.
-				task = task->subtaskParent;
-				if (task->nextTick <= s_curTick || task->framebreak)
-				{
-					s_currentMsg = MSG_RUN_TASK;
-					s_curTask = task;
-					return;
-				}
-			}
-			else
-			{
-				break;
-			}
-		}
-
-		// If no selection is possible, assign the first task.
-		if (!s_curTask && s_taskCount)
+		// Find the next task to run, see "Scheduling" above for the execution order.
+		Task* task = sched_findNext(s_curTask, s_curTick);
+		if (task)
 		{
-			s_curTask = (Task*)chunkedArrayGet(s_tasks, 0);
+			s_currentMsg = MSG_RUN_TASK;
+			s_curTask = task;
+			return JTRUE;
 		}
+		return JFALSE;
 	}
 
 	void itask_run(Task* task, MessageType msg)
@@ -475,7 +742,7 @@ namespace TFE_Jedi
 		}
 
 		// Update the current tick based on the delay.
-		s_curTask->nextTick = (delay < TASK_SLEEP) ? s_curTick + delay : delay;
+		sched_setTick(s_curTask, (delay < TASK_SLEEP) ? s_curTick + delay : delay);
 		
 		// Find the next task to run.
 		selectNextTask();
@@ -502,6 +769,28 @@ namespace TFE_Jedi
 		return JTRUE;
 	}
 
+	void runCurrentTask()
+	{
+		s_curContext = &s_curTask->context;
+		s32 level = max(0, s_curContext->level + 1);
+		TaskFunc runFunc = s_curContext->callstack[level];
+		assert(runFunc);
+
+		if (runFunc)
+		{
+		#ifdef TFE_PROFILE_ENABLED
+			// The task may be freed while running, so read the timer first.
+			// Time spent in tasks run directly from this task is included.
+			const u32 profileTimer = s_curTask->profileTimer;
+			const u64 startTicks = TFE_System::getCurrentTimeInTicks();
+			runFunc(s_currentMsg);
+			TFE_Profiler::addTimerTicks(profileTimer, TFE_System::getCurrentTimeInTicks() - startTicks);
+		#else
+			runFunc(s_currentMsg);
+		#endif
+		}
+	}
+
 	// Called once per frame to run all of the tasks.
 	// Returns JFALSE if it cannot be run due to the time interval.
 	JBool task_run()
@@ -532,16 +821,7 @@ namespace TFE_Jedi
 				if (s_curTask->nextTick <= s_curTick)
 				{
 					s_frameActiveTaskCount++;
-
-					s_curContext = &s_curTask->context;
-					s32 level = max(0, s_curContext->level + 1);
-					TaskFunc runFunc = s_curContext->callstack[level];
-					assert(runFunc);
-
-					if (runFunc)
-					{
-						runFunc(s_currentMsg);
-					}
+					runCurrentTask();
 				}
 			}
 			return JTRUE;
@@ -560,20 +840,12 @@ namespace TFE_Jedi
 			if (s_curTask->nextTick <= s_curTick)
 			{
 				s_frameActiveTaskCount++;
-
-				s_curContext = &s_curTask->context;
-				s32 level = max(0, s_curContext->level + 1);
-				TaskFunc runFunc = s_curContext->callstack[level];
-				assert(runFunc);
-
-				if (runFunc)
-				{
-					runFunc(s_currentMsg);
-				}
+				runCurrentTask();
 			}
-			else
+			else if (!selectNextTask())
 			{
-				selectNextTask();
+				// Nothing can run, which can only happen if there is no framebreak task.
+				break;
 			}
 
 			if (framebreak)
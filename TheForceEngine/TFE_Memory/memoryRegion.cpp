@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <algorithm>
+#include <map>
 
 // #define _VERIFY_MEMORY
 
@@ -33,6 +34,20 @@ enum
 	MAX_BLOCK_SIZE  = 16 * 1024 * 1024,
 	RELATIVE_NON_NULL_BIT = 1u,
 	SHARED_HEADER_SIZE = 8,	// 8 bytes are shared between RegionAllocHeader{} and AllocHeaderFree{}
+	// Small allocations are grouped by size class into slab pages, which are regular allocations in the region.
+	SLAB_CLASS_STEP  = 16,
+	SLAB_CLASS_COUNT = 16,
+	SLAB_MAX_SIZE    = SLAB_CLASS_STEP * SLAB_CLASS_COUNT,
+	SLAB_PAGE_SIZE   = 16 * 1024,
+	SLAB_ITEM_BIT    = 0x80,	// set in the 'bin' of the headers of slab items.
+};
+
+enum RegionTraceOpType
+{
+	TRACE_ALLOC = 0,
+	TRACE_REALLOC,
+	TRACE_FREE,
+	TRACE_CLEAR,
 };
 
 struct RegionAllocHeader
@@ -41,7 +56,7 @@ struct RegionAllocHeader
 	u8  free;
 	u8  bin;
 	u8  pad8[2];
-	u64 pad; // pad to 16 bytes.
+	u64 pad; // pad to 16 bytes, free slab items store the block offset of the next free item here.
 };
 
 // free structure is larger than header, because it fits within the
@@ -69,6 +84,25 @@ struct MemoryBlock
 	//     4: [257, 512]
 	//     5: [513+]
 	AllocHeaderFree* freeListBins[ALLOC_BIN_COUNT];
+	// Block offset of the first free slab item of each size class, 0 = none.
+	// Offsets are used so the lists are position independent when serialized.
+	u32 slabFree[SLAB_CLASS_COUNT];
+};
+
+struct RegionTraceOp
+{
+	u32 type;
+	u32 id;
+	u32 size;
+};
+
+// Allocation trace, recorded while tracing is enabled so it can be replayed by region_benchmarkTrace().
+struct RegionTrace
+{
+	std::vector<RegionTraceOp> ops;
+	std::map<void*, u32> ids;
+	u32  idCount;
+	bool recording;
 };
 
 struct MemoryRegion
@@ -80,6 +114,9 @@ struct MemoryRegion
 	size_t blockCount;
 	size_t blockSize;
 	size_t maxBlocks;
+
+	bool useSlabs;
+	RegionTrace* trace;
 };
 
 static_assert(sizeof(RegionAllocHeader) == 16, "RegionAllocHeader is the wrong size.");
@@ -98,6 +135,18 @@ namespace TFE_Memory
 	bool allocateNewBlock(MemoryRegion* region);
 	void removeHeaderFromFreelist(MemoryBlock* block, RegionAllocHeader* header);
 	void insertBlockIntoFreelist(MemoryBlock* block, RegionAllocHeader* header);
+	void clearBlock(MemoryRegion* region, MemoryBlock* block);
+	void* allocInternal(MemoryRegion* region, size_t size);
+	void* reallocInternal(MemoryRegion* region, void* ptr, size_t size);
+	void  freeInternal(MemoryRegion* region, void* ptr);
+	void* slabAlloc(MemoryRegion* region, size_t size);
+	void  traceOp(MemoryRegion* region, u32 type, void* ptr, void* newPtr, size_t size);
+
+	// Blocks are allocated separately, so they are not guaranteed to be in address order.
+	inline bool blockContains(MemoryRegion* region, MemoryBlock* block, const void* ptr)
+	{
+		return (const u8*)ptr >= (u8*)block && (const u8*)ptr < (u8*)block + sizeof(MemoryBlock) + region->blockSize;
+	}
 
 	void verifyMemory(MemoryRegion* region)
 	{
@@ -155,6 +204,8 @@ namespace TFE_Memory
 		region->blockCount = 0;
 		region->blockSize = blockSize;
 		region->maxBlocks = maxSize ? (maxSize + blockSize - 1) / blockSize : 0;
+		region->useSlabs = true;
+		region->trace = nullptr;
 		if (!allocateNewBlock(region))
 		{
 			free(region);
@@ -166,20 +217,29 @@ namespace TFE_Memory
 		return region;
 	}
 
+	void clearBlock(MemoryRegion* region, MemoryBlock* block)
+	{
+		block->sizeFree = u32(region->blockSize);
+		block->count = 1;
+
+		RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
+		header->size = block->sizeFree;
+		header->free = 0;
+		memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
+		memset(block->slabFree, 0, sizeof(u32)*SLAB_CLASS_COUNT);
+		insertBlockIntoFreelist(block, header);
+	}
+
 	void region_clear(MemoryRegion* region)
 	{
 		assert(region);
+		if (region->trace && region->trace->recording)
+		{
+			traceOp(region, TRACE_CLEAR, nullptr, nullptr, 0);
+		}
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
-			MemoryBlock* block = region->memBlocks[i];
-			block->sizeFree = u32(region->blockSize);
-			block->count = 1;
-
-			RegionAllocHeader* header = (RegionAllocHeader*)((u8*)block + sizeof(MemoryBlock));
-			header->size = block->sizeFree;
-			header->free = 0;
-			memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
-			insertBlockIntoFreelist(block, header);
+			clearBlock(region, region->memBlocks[i]);
 			VERIFY_MEMORY();
 		}
 	}
@@ -192,6 +252,7 @@ namespace TFE_Memory
 			free(region->memBlocks[i]);
 		}
 		free(region->memBlocks);
+		delete region->trace;
 		free(region);
 	}
 		
@@ -229,12 +290,38 @@ namespace TFE_Memory
 	void* region_alloc(MemoryRegion* region, size_t size)
 	{
 		assert(region);
-		if (size == 0) { return nullptr; }
+		void* mem = allocInternal(region, size);
+		if (region->trace && region->trace->recording)
+		{
+			traceOp(region, TRACE_ALLOC, nullptr, mem, size);
+		}
+		return mem;
+	}
 
-		size = alloc_align(size + sizeof(RegionAllocHeader));
-		assert(size >= 24);	// at least 24 bytes is required to hold the free header.
-		if (size > region->blockSize) { return nullptr; }
-		
+	void* region_realloc(MemoryRegion* region, void* ptr, size_t size)
+	{
+		assert(region);
+		void* mem = reallocInternal(region, ptr, size);
+		if (region->trace && region->trace->recording)
+		{
+			traceOp(region, ptr ? TRACE_REALLOC : TRACE_ALLOC, ptr, mem, size);
+		}
+		return mem;
+	}
+
+	void region_free(MemoryRegion* region, void* ptr)
+	{
+		if (!ptr || !region) { return; }
+		if (region->trace && region->trace->recording)
+		{
+			traceOp(region, TRACE_FREE, ptr, nullptr, 0);
+		}
+		freeInternal(region, ptr);
+	}
+
+	// Allocate from the region free lists, 'size' includes the header and is aligned.
+	void* allocFromBlocks(MemoryRegion* region, size_t size)
+	{
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
 			MemoryBlock* block = region->memBlocks[i];
@@ -267,7 +354,7 @@ namespace TFE_Memory
 			if (allocateNewBlock(region))
 			{
 				VERIFY_MEMORY();
-				void* mem = region_alloc(region, size);
+				void* mem = allocFromBlocks(region, size);
 				VERIFY_MEMORY();
 				return mem;
 			}
@@ -278,12 +365,26 @@ namespace TFE_Memory
 		return nullptr;
 	}
 
-	void* region_realloc(MemoryRegion* region, void* ptr, size_t size)
+	void* allocInternal(MemoryRegion* region, size_t size)
 	{
-		assert(region);
-		if (!ptr) { return region_alloc(region, size); }
 		if (size == 0) { return nullptr; }
+		if (region->useSlabs && size <= SLAB_MAX_SIZE)
+		{
+			return slabAlloc(region, size);
+		}
 
+		size = alloc_align(size + sizeof(RegionAllocHeader));
+		assert(size >= 24);	// at least 24 bytes is required to hold the free header.
+		if (size > region->blockSize) { return nullptr; }
+		return allocFromBlocks(region, size);
+	}
+
+	void* reallocInternal(MemoryRegion* region, void* ptr, size_t size)
+	{
+		if (!ptr) { return allocInternal(region, size); }
+		if (size == 0) { return nullptr; }
+
+		const size_t requestSize = size;
 		size = alloc_align(size + sizeof(RegionAllocHeader));
 		if (size > region->blockSize) { return nullptr; }
 
@@ -293,13 +394,22 @@ namespace TFE_Memory
 		{
 			return ptr;
 		}
+		// Slab items cannot grow in place.
+		if (header->bin & SLAB_ITEM_BIT)
+		{
+			void* newMem = allocInternal(region, requestSize);
+			if (!newMem) { return nullptr; }
+			memcpy(newMem, ptr, header->size - sizeof(RegionAllocHeader));
+			freeInternal(region, ptr);
+			return newMem;
+		}
 
 		// First try to reallocate in the same region.
 		u32 prevSize = 0;
 		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
 		{
 			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
+			if (blockContains(region, block, ptr))
 			{
 				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
 				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
@@ -358,7 +468,7 @@ namespace TFE_Memory
 		}
 
 		// Allocate a new block of memory.
-		void* newMem = region_alloc(region, size);
+		void* newMem = allocInternal(region, requestSize);
 		if (!newMem) { return nullptr; }
 		// Copy over the contents from the previous block.
 		if (prevSize > sizeof(RegionAllocHeader))
@@ -366,22 +476,36 @@ namespace TFE_Memory
 			memcpy(newMem, ptr, std::min((u32)size, prevSize) - sizeof(RegionAllocHeader));
 		}
 		// Free the previous block
-		region_free(region, ptr);
+		freeInternal(region, ptr);
 		// Then return the new block.
 		VERIFY_MEMORY();
 		return newMem;
 	}
 		
-	void region_free(MemoryRegion* region, void* ptr)
+	void freeInternal(MemoryRegion* region, void* ptr)
 	{
-		if (!ptr || !region) { return; }
-
 		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
 		{
 			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
+			if (blockContains(region, block, ptr))
 			{
 				RegionAllocHeader* header = (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+				if (header->bin & SLAB_ITEM_BIT)
+				{
+					assert(!header->free);
+					if (header->free)
+					{
+						TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Attempted to double free pointer %x in region '%s'.", ptr, region->name);
+						return;
+					}
+					// Push the item onto the free list of its size class.
+					const s32 sizeClass = header->bin & ~SLAB_ITEM_BIT;
+					header->free = 1;
+					header->pad = block->slabFree[sizeClass];
+					block->slabFree[sizeClass] = u32((u8*)header - (u8*)block);
+					return;
+				}
+
 				RegionAllocHeader* nextHeader = (RegionAllocHeader*)((u8*)header + header->size);
 				if ((u8*)nextHeader >= (u8*)block + region->blockSize)
 				{
@@ -432,7 +556,7 @@ namespace TFE_Memory
 		for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
 		{
 			MemoryBlock* block = region->memBlocks[i];
-			if (ptr >= block)
+			if (blockContains(region, block, ptr))
 			{
 				rp = RelativePointer((u8*)ptr - (u8*)block - sizeof(MemoryBlock));
 				rp |= (i << c_relativeBlockShift);
@@ -490,6 +614,7 @@ namespace TFE_Memory
 				RelativePointer ptr = region_getRelativePointer(region, block->freeListBins[bin]);
 				file->write(&ptr);
 			}
+			file->writeBuffer(block->slabFree, sizeof(u32) * SLAB_CLASS_COUNT);
 
 			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
 			for (u32 al = 0; al < block->count; al++)
@@ -527,6 +652,8 @@ namespace TFE_Memory
 		{
 			region = (MemoryRegion*)malloc(sizeof(MemoryRegion));
 			region->blockArrCapacity = 0;
+			region->useSlabs = true;
+			region->trace = nullptr;
 		}
 		if (!region)
 		{
@@ -602,6 +729,7 @@ namespace TFE_Memory
 				file->read(&ptr);
 				block->freeListBins[bin] = (AllocHeaderFree*)region_getRealPointer(region, ptr);
 			}
+			file->readBuffer(block->slabFree, sizeof(u32) * SLAB_CLASS_COUNT);
 
 			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
 			for (u32 al = 0; al < block->count; al++)
@@ -631,6 +759,117 @@ namespace TFE_Memory
 		return region;
 	}
 
+	//////////////////////////////////////////////////////////////////////
+	// In-place snapshots
+	// Each block is written as a list of spans: runs of allocated memory
+	// up to and including the header of the next free slot. Free memory
+	// itself is skipped, so the snapshot size follows the memory in use
+	// rather than the region capacity.
+	//////////////////////////////////////////////////////////////////////
+	static const u32 c_snapshotSpanEnd = 0xffffffffu;
+
+	void writeSnapshotSpan(Stream* stream, MemoryBlock* block, u8* start, u8* end)
+	{
+		if (end <= start) { return; }
+		const u32 offset = u32(start - (u8*)block);
+		const u32 size = u32(end - start);
+		stream->write(&offset);
+		stream->write(&size);
+		stream->writeBuffer(start, size);
+	}
+
+	bool region_writeSnapshot(MemoryRegion* region, Stream* stream)
+	{
+		if (!region || !stream)
+		{
+			return false;
+		}
+
+		const u64 blockSize  = region->blockSize;
+		const u32 blockCount = u32(region->blockCount);
+		stream->writeBuffer(region->name, 32);
+		stream->write(&blockSize);
+		stream->write(&blockCount);
+		// Block addresses, used to verify the snapshot is restored into the same memory.
+		for (u32 b = 0; b < blockCount; b++)
+		{
+			const u64 address = u64(size_t(region->memBlocks[b]));
+			stream->write(&address);
+		}
+
+		for (u32 b = 0; b < blockCount; b++)
+		{
+			MemoryBlock* block = region->memBlocks[b];
+			u8* spanStart = (u8*)block;
+			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
+			for (u32 al = 0; al < block->count; al++)
+			{
+				RegionAllocHeader* header = (RegionAllocHeader*)memPtr;
+				if (header->free)
+				{
+					writeSnapshotSpan(stream, block, spanStart, memPtr + sizeof(AllocHeaderFree));
+					spanStart = memPtr + header->size;
+				}
+				memPtr += header->size;
+			}
+			writeSnapshotSpan(stream, block, spanStart, memPtr);
+			stream->write(&c_snapshotSpanEnd);
+		}
+		return true;
+	}
+
+	bool region_restoreSnapshot(MemoryRegion* region, Stream* stream)
+	{
+		if (!region || !stream)
+		{
+			return false;
+		}
+
+		char name[32];
+		u64 blockSize;
+		u32 blockCount;
+		stream->readBuffer(name, 32);
+		stream->read(&blockSize);
+		stream->read(&blockCount);
+		if (strncmp(name, region->name, 32) != 0 || blockSize != region->blockSize || blockCount > region->blockCount)
+		{
+			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Snapshot does not match region '%s'.", region->name);
+			return false;
+		}
+		// Blocks are never freed before the region is destroyed, so they should be at the same addresses.
+		for (u32 b = 0; b < blockCount; b++)
+		{
+			u64 address;
+			stream->read(&address);
+			if (address != u64(size_t(region->memBlocks[b])))
+			{
+				TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Snapshot memory layout does not match region '%s'.", region->name);
+				return false;
+			}
+		}
+
+		for (u32 b = 0; b < blockCount; b++)
+		{
+			u8* block = (u8*)region->memBlocks[b];
+			while (1)
+			{
+				u32 offset, size;
+				stream->read(&offset);
+				if (offset == c_snapshotSpanEnd) { break; }
+				stream->read(&size);
+				assert(offset + size <= sizeof(MemoryBlock) + region->blockSize);
+				stream->readBuffer(block + offset, size);
+			}
+		}
+		// Blocks allocated after the snapshot was taken are now empty.
+		for (u32 b = blockCount; b < region->blockCount; b++)
+		{
+			clearBlock(region, region->memBlocks[b]);
+		}
+		VERIFY_MEMORY();
+		return true;
+	}
+
 	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block)
 	{
 		block->sizeFree += alloc->size;
@@ -770,11 +1009,226 @@ namespace TFE_Memory
 		header->size = block->sizeFree;
 		header->free = 0;
 		memset(block->freeListBins, 0, sizeof(AllocHeaderFree*)*ALLOC_BIN_COUNT);
+		memset(block->slabFree, 0, sizeof(u32)*SLAB_CLASS_COUNT);
 		insertBlockIntoFreelist(block, header);
 
 		return true;
 	}
 
+	void* slabAlloc(MemoryRegion* region, size_t size)
+	{
+		const s32 sizeClass = s32(size - 1) / SLAB_CLASS_STEP;
+		MemoryBlock* block = nullptr;
+		for (s32 i = 0; i < region->blockCount; i++)
+		{
+			if (region->memBlocks[i]->slabFree[sizeClass])
+			{
+				block = region->memBlocks[i];
+				break;
+			}
+		}
+
+		if (!block)
+		{
+			// Allocate a new page from the region and split it into items.
+			const u32 pageSize = u32(alloc_align(SLAB_PAGE_SIZE + sizeof(RegionAllocHeader)));
+			u8* page = (u8*)allocFromBlocks(region, pageSize);
+			if (!page) { return nullptr; }
+			for (s32 i = (s32)region->blockCount - 1; i >= 0; i--)
+			{
+				if (blockContains(region, region->memBlocks[i], page))
+				{
+					block = region->memBlocks[i];
+					break;
+				}
+			}
+			assert(block);
+
+			const u32 itemSize = sizeof(RegionAllocHeader) + (sizeClass + 1) * SLAB_CLASS_STEP;
+			const u32 itemCount = SLAB_PAGE_SIZE / itemSize;
+			// Link the items in memory order.
+			u32 next = block->slabFree[sizeClass];
+			for (s32 i = s32(itemCount) - 1; i >= 0; i--)
+			{
+				RegionAllocHeader* item = (RegionAllocHeader*)(page + i * itemSize);
+				item->size = itemSize;
+				item->free = 1;
+				item->bin  = u8(SLAB_ITEM_BIT | sizeClass);
+				item->pad8[0] = 0;
+				item->pad8[1] = 0;
+				item->pad = next;
+				next = u32((u8*)item - (u8*)block);
+			}
+			block->slabFree[sizeClass] = next;
+		}
+
+		RegionAllocHeader* item = (RegionAllocHeader*)((u8*)block + block->slabFree[sizeClass]);
+		assert(item->free == 1 && item->bin == (SLAB_ITEM_BIT | sizeClass));
+		block->slabFree[sizeClass] = u32(item->pad);
+		item->free = 0;
+		return (u8*)item + sizeof(RegionAllocHeader);
+	}
+
+	//////////////////////////////////////////////////////////////////////
+	// Allocation tracing
+	// Pointers are mapped to ids as they are recorded, so the trace can be
+	// replayed against a different region.
+	//////////////////////////////////////////////////////////////////////
+	void traceOp(MemoryRegion* region, u32 type, void* ptr, void* newPtr, size_t size)
+	{
+		RegionTrace* trace = region->trace;
+		if (type == TRACE_CLEAR)
+		{
+			trace->ids.clear();
+			trace->ops.push_back({ TRACE_CLEAR, 0, 0 });
+			return;
+		}
+
+		u32 id = 0;
+		if (ptr)
+		{
+			std::map<void*, u32>::iterator iId = trace->ids.find(ptr);
+			if (iId == trace->ids.end())
+			{
+				// Allocated before tracing started, a realloc is recorded as a new allocation.
+				if (type == TRACE_FREE) { return; }
+				type = TRACE_ALLOC;
+				id = trace->idCount++;
+			}
+			else
+			{
+				id = iId->second;
+				trace->ids.erase(iId);
+			}
+		}
+		else
+		{
+			id = trace->idCount++;
+		}
+
+		if (newPtr)
+		{
+			trace->ids[newPtr] = id;
+		}
+		trace->ops.push_back({ type, id, u32(size) });
+	}
+
+	void region_setTracing(MemoryRegion* region, bool enable)
+	{
+		assert(region);
+		if (enable)
+		{
+			if (!region->trace)
+			{
+				region->trace = new RegionTrace();
+			}
+			region->trace->ops.clear();
+			region->trace->ids.clear();
+			region->trace->idCount = 0;
+			region->trace->recording = true;
+		}
+		else if (region->trace)
+		{
+			// Keep the recorded trace but stop recording.
+			region->trace->ids.clear();
+			region->trace->recording = false;
+		}
+	}
+
+	bool region_isTracing(MemoryRegion* region)
+	{
+		return region->trace && region->trace->recording;
+	}
+
+	void replayTrace(MemoryRegion* region, const RegionTrace* trace, void** ptrs)
+	{
+		const size_t opCount = trace->ops.size();
+		const RegionTraceOp* op = trace->ops.data();
+		for (size_t i = 0; i < opCount; i++, op++)
+		{
+			switch (op->type)
+			{
+				case TRACE_ALLOC:
+				{
+					ptrs[op->id] = allocInternal(region, op->size);
+				} break;
+				case TRACE_REALLOC:
+				{
+					ptrs[op->id] = reallocInternal(region, ptrs[op->id], op->size);
+				} break;
+				case TRACE_FREE:
+				{
+					if (ptrs[op->id]) { freeInternal(region, ptrs[op->id]); }
+					ptrs[op->id] = nullptr;
+				} break;
+				case TRACE_CLEAR:
+				{
+					region_clear(region);
+				} break;
+			}
+		}
+	}
+
+	void getFreeSlotInfo(MemoryRegion* region, RegionBenchResult* result)
+	{
+		result->freeSlots = 0;
+		result->largestFree = 0;
+		result->totalFree = 0;
+		for (s32 i = 0; i < region->blockCount; i++)
+		{
+			MemoryBlock* block = region->memBlocks[i];
+			u8* memPtr = (u8*)block + sizeof(MemoryBlock);
+			for (u32 al = 0; al < block->count; al++)
+			{
+				RegionAllocHeader* header = (RegionAllocHeader*)memPtr;
+				if (header->free)
+				{
+					result->freeSlots++;
+					result->totalFree += header->size;
+					result->largestFree = std::max(result->largestFree, size_t(header->size));
+				}
+				memPtr += header->size;
+			}
+		}
+		result->fragmentation = result->totalFree ? 1.0 - f64(result->largestFree) / f64(result->totalFree) : 0.0;
+	}
+
+	bool region_benchmarkTrace(MemoryRegion* region, s32 iterations, RegionBenchResult* slabResult, RegionBenchResult* binResult)
+	{
+		assert(region && slabResult && binResult);
+		const RegionTrace* trace = region->trace;
+		if (!trace || trace->ops.empty()) { return false; }
+		iterations = std::max(iterations, 1);
+
+		std::vector<void*> ptrs(trace->idCount);
+		for (s32 r = 0; r < 2; r++)
+		{
+			RegionBenchResult* result = r == 0 ? slabResult : binResult;
+			MemoryRegion* bench = region_create("TraceBench", region->blockSize);
+			if (!bench) { return false; }
+			bench->useSlabs = (r == 0);
+
+			u64 ticks = 0;
+			for (s32 i = 0; i < iterations; i++)
+			{
+				region_clear(bench);
+				std::fill(ptrs.begin(), ptrs.end(), nullptr);
+
+				const u64 start = TFE_System::getCurrentTimeInTicks();
+				replayTrace(bench, trace, ptrs.data());
+				ticks += TFE_System::getCurrentTimeInTicks() - start;
+			}
+
+			result->opCount  = trace->ops.size();
+			result->seconds  = TFE_System::convertFromTicksToSeconds(ticks) / f64(iterations);
+			result->used     = region_getMemoryUsed(bench);
+			result->capacity = region_getMemoryCapacity(bench);
+			getFreeSlotInfo(bench, result);
+			region_destroy(bench);
+		}
+		return true;
+	}
+
 	// 20k allocations and 1250 deallocations:
 	// Malloc = 0.005514 sec.
 	// Region = 0.000991 sec.
@@ -13,6 +13,19 @@ typedef u32 RelativePointer;
 
 #define NULL_RELATIVE_POINTER 0
 
+// Results of replaying an allocation trace, see region_benchmarkTrace().
+struct RegionBenchResult
+{
+	size_t opCount;
+	f64    seconds;		// average time to replay the trace.
+	size_t used;
+	size_t capacity;
+	u32    freeSlots;
+	size_t largestFree;
+	size_t totalFree;
+	f64    fragmentation;	// 1 - largestFree / totalFree
+};
+
 namespace TFE_Memory
 {
 	MemoryRegion* region_create(const char* name, size_t blockSize, size_t maxSize = 0u);
@@ -36,5 +49,18 @@ namespace TFE_Memory
 	// otherwise it will attempt to reuse the existing region.
 	MemoryRegion* region_restoreFromDisk(MemoryRegion* region, FileStream* file);
 
+	// Fast snapshot of the region contents, only the allocated memory and free headers are written.
+	// Unlike region_serializeToDisk() the restore writes the data back in place, so pointers into the
+	// region remain valid - but this only works with the same region during the same run, which is
+	// verified before anything is modified.
+	bool region_writeSnapshot(MemoryRegion* region, Stream* stream);
+	bool region_restoreSnapshot(MemoryRegion* region, Stream* stream);
+
+	// Record the allocations made in the region, enabling tracing discards the previously recorded trace.
+	void region_setTracing(MemoryRegion* region, bool enable);
+	bool region_isTracing(MemoryRegion* region);
+	// Replay the recorded trace in new regions with and without the small allocation slabs.
+	bool region_benchmarkTrace(MemoryRegion* region, s32 iterations, RegionBenchResult* slabResult, RegionBenchResult* binResult);
+
 	void region_test();
 }
\ No newline at end of file
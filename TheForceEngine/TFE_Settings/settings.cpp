@@ -286,6 +286,7 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "colorCorrection", s_graphicsSettings.colorCorrection);
 		writeKeyValue_Bool(settings, "perspectiveCorrect3DO", s_graphicsSettings.perspectiveCorrectTexturing);
 		writeKeyValue_Bool(settings, "vsync", s_graphicsSettings.vsync);
+		writeKeyValue_Int(settings, "renderThreadCount", s_graphicsSettings.renderThreadCount);
 		writeKeyValue_Float(settings, "brightness", s_graphicsSettings.brightness);
 		writeKeyValue_Float(settings, "contrast", s_graphicsSettings.contrast);
 		writeKeyValue_Float(settings, "saturation", s_graphicsSettings.saturation);
@@ -528,6 +529,10 @@ namespace TFE_Settings
 		{
 			s_graphicsSettings.vsync = parseBool(value);
 		}
+		else if (strcasecmp("renderThreadCount", key) == 0)
+		{
+			s_graphicsSettings.renderThreadCount = parseInt(value);
+		}
 		else if (strcasecmp("brightness", key) == 0)
 		{
 			s_graphicsSettings.brightness = parseFloat(value);
@@ -0,0 +1,72 @@
+#include "signalLinux.h"
+#include <time.h>
+#include <errno.h>
+
+SignalLinux::SignalLinux() : Signal()
+{
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_cond_init(&m_cond, NULL);
+	m_signaled = false;
+}
+
+SignalLinux::~SignalLinux()
+{
+	pthread_cond_destroy(&m_cond);
+	pthread_mutex_destroy(&m_mutex);
+}
+
+void SignalLinux::fire()
+{
+	pthread_mutex_lock(&m_mutex);
+	m_signaled = true;
+	pthread_cond_broadcast(&m_cond);
+	pthread_mutex_unlock(&m_mutex);
+}
+
+bool SignalLinux::wait(u32 timeOutInMS, bool reset)
+{
+	pthread_mutex_lock(&m_mutex);
+	if (timeOutInMS == TIMEOUT_INFINITE)
+	{
+		while (!m_signaled)
+		{
+			pthread_cond_wait(&m_cond, &m_mutex);
+		}
+	}
+	else
+	{
+		timespec timeout;
+		clock_gettime(CLOCK_REALTIME, &timeout);
+		timeout.tv_sec  += timeOutInMS / 1000;
+		timeout.tv_nsec += long(timeOutInMS % 1000) * 1000000L;
+		if (timeout.tv_nsec >= 1000000000L)
+		{
+			timeout.tv_sec++;
+			timeout.tv_nsec -= 1000000000L;
+		}
+
+		while (!m_signaled)
+		{
+			if (pthread_cond_timedwait(&m_cond, &m_mutex, &timeout) == ETIMEDOUT)
+			{
+				break;
+			}
+		}
+	}
+
+	//reset the signal so it can be used again but only if it was signaled.
+	const bool signaled = m_signaled;
+	if (signaled && reset)
+	{
+		m_signaled = false;
+	}
+	pthread_mutex_unlock(&m_mutex);
+
+	return signaled;
+}
+
+//factory
+Signal* Signal::create()
+{
+	return new SignalLinux();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <pthread.h>
+#include "../signal.h"
+
+class SignalLinux : public Signal
+{
+public:
+	SignalLinux();
+	virtual ~SignalLinux();
+
+	virtual void fire();
+	virtual bool wait(u32 timeOutInMS=TIMEOUT_INFINITE, bool reset=true);
+
+protected:
+	pthread_mutex_t m_mutex;
+	pthread_cond_t  m_cond;
+	bool m_signaled;
+};
@@ -7,7 +7,7 @@
 class Signal
 {
 public:
-	~Signal() {};
+	virtual ~Signal() {};
 
 	virtual void fire() = 0;
 	//returns true if signaled, false if the timeout was hit instead.
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <cstdlib>
 
 #include "parser.h"
 #include <algorithm>
@@ -155,6 +156,26 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 {
 	tokens.clear();
 
+	tokenizeLineInternal(line);
+	const size_t count = m_tokenViews.size();
+	const TokenView* views = m_tokenViews.data();
+	for (size_t t = 0; t < count; t++)
+	{
+		tokens.push_back(std::string(views[t].str, views[t].len));
+	}
+}
+
+s32 TFE_Parser::tokenizeLine(const char* line, const TokenView** tokens)
+{
+	tokenizeLineInternal(line);
+	*tokens = m_tokenViews.data();
+	return s32(m_tokenViews.size());
+}
+
+void TFE_Parser::tokenizeLineInternal(const char* line)
+{
+	m_tokenViews.clear();
+
 	const size_t len = strlen(line);
 	// first move past leading whitespace and ending white space.
 	size_t start = 0, end = 0;
@@ -167,55 +188,168 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 		}
 	}
 
+	// Every character of the line is written at most once, plus a terminator per token (an empty quoted token
+	// uses two characters), so the scratch memory is only resized for lines longer than any seen before.
+	if (m_tokenScratch.size() < len * 2 + 2)
+	{
+		m_tokenScratch.resize(len * 2 + 2);
+	}
+	char* scratch = m_tokenScratch.data();
+	size_t scratchPos = 0;
+	size_t tokenStart = 0;
+
 	// next start reading tokens.
 	bool inQuote = false;
-	char curToken[1024];
-	size_t curTokenPos = 0;
 	// TODO: Add an option to allow white space in tokens when not in quotes, but still remove trailing/ending whitespace.
 	// This is useful for names.
 	for (size_t c = start; c < end; c++)
 	{
 		if (line[c] == '"')
 		{
-			if (inQuote && curTokenPos == 0)
+			if (inQuote && scratchPos == tokenStart)
 			{
-				tokens.push_back("");
+				scratch[scratchPos++] = 0;
+				m_tokenViews.push_back({ scratch + tokenStart, 0 });
+				tokenStart = scratchPos;
 			}
 			inQuote = !inQuote;
 		}
 		else if (!inQuote && (isWhitespace(line[c]) || isSeparator(line[c])))
 		{
-			curToken[curTokenPos] = 0;
-			if (curTokenPos)
+			if (scratchPos > tokenStart)
 			{
-				tokens.push_back(curToken);
+				m_tokenViews.push_back({ scratch + tokenStart, u32(scratchPos - tokenStart) });
+				scratch[scratchPos++] = 0;
+				tokenStart = scratchPos;
 			}
-
-			curTokenPos = 0;
-			curToken[0] = 0;
 		}
 		else if (!inQuote && m_enableColorSeperator && line[c] == ':')
 		{
-			curToken[curTokenPos++] = line[c];
+			scratch[scratchPos++] = line[c];
+			m_tokenViews.push_back({ scratch + tokenStart, u32(scratchPos - tokenStart) });
+			scratch[scratchPos++] = 0;
+			tokenStart = scratchPos;
+		}
+		else
+		{
+			scratch[scratchPos++] = line[c];
+		}
+	}
 
-			curToken[curTokenPos] = 0;
-			if (curTokenPos)
-			{
-				tokens.push_back(curToken);
-			}
+	if (scratchPos > tokenStart)
+	{
+		m_tokenViews.push_back({ scratch + tokenStart, u32(scratchPos - tokenStart) });
+		scratch[scratchPos++] = 0;
+	}
+}
+
+////////////////////////////////////////////////
+// Field parsers
+////////////////////////////////////////////////
+bool TFE_Parser::parseS32(const char* str, s32* value, const char** end)
+{
+	const char* c = str;
+	const bool negative = (*c == '-');
+	if (*c == '-' || *c == '+') { c++; }
+	if (*c < '0' || *c > '9') { return false; }
+
+	s64 result = 0;
+	for (; *c >= '0' && *c <= '9'; c++)
+	{
+		result = result * 10 + (*c - '0');
+		if (result > s64(0x80000000ll)) { return false; }
+	}
+	if (negative) { result = -result; }
+	if (result > s64(0x7fffffff)) { return false; }
 
-			curTokenPos = 0;
-			curToken[0] = 0;
+	if (end) { *end = c; }
+	else if (*c) { return false; }
+
+	*value = s32(result);
+	return true;
+}
+
+bool TFE_Parser::parseF32(const char* str, f32* value, const char** end)
+{
+	// Powers of ten that are exact as floats.
+	static const f32 c_pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+	const char* c = str;
+	const bool negative = (*c == '-');
+	if (*c == '-' || *c == '+') { c++; }
+
+	u64 mantissa = 0;
+	s32 digitCount = 0, exponent = 0;
+	bool fastPath = true;
+	for (; *c >= '0' && *c <= '9'; c++, digitCount++)
+	{
+		if (mantissa < 1000000000000000000ull) { mantissa = mantissa * 10 + (*c - '0'); }
+		else { fastPath = false; }
+	}
+	if (*c == '.')
+	{
+		c++;
+		for (; *c >= '0' && *c <= '9'; c++, digitCount++)
+		{
+			if (mantissa < 1000000000000000000ull) { mantissa = mantissa * 10 + (*c - '0'); exponent--; }
+			else { fastPath = false; }
+		}
+	}
+	if (digitCount == 0)
+	{
+		fastPath = false;
+	}
+	else if (*c == 'e' || *c == 'E')
+	{
+		const char* expEnd;
+		s32 exp10;
+		if (parseS32(c + 1, &exp10, &expEnd) && exp10 > -64 && exp10 < 64)
+		{
+			exponent += exp10;
+			c = expEnd;
 		}
 		else
 		{
-			curToken[curTokenPos++] = line[c];
+			fastPath = false;
 		}
 	}
 
-	if (curTokenPos)
+	if (fastPath)
 	{
-		curToken[curTokenPos] = 0;
-		tokens.push_back(curToken);
+		while (mantissa && exponent < 0 && (mantissa % 10) == 0)
+		{
+			mantissa /= 10;
+			exponent++;
+		}
+		// The mantissa and power of ten are both exact, so a single multiply or divide gives the correctly rounded result.
+		if (mantissa == 0 || (mantissa <= (1ull << 24) && exponent >= -10 && exponent <= 10))
+		{
+			f32 result = f32(mantissa);
+			if (exponent < 0) { result /= c_pow10[-exponent]; }
+			else if (exponent > 0) { result *= c_pow10[exponent]; }
+			if (end) { *end = c; }
+			else if (*c) { return false; }
+
+			*value = negative ? -result : result;
+			return true;
+		}
 	}
+
+	// Fall back to the C library for everything else, such as long mantissas, large exponents, inf and nan.
+	char* endPtr = nullptr;
+	const f32 result = strtof(str, &endPtr);
+	if (endPtr == str) { return false; }
+	if (end) { *end = endPtr; }
+	else if (*endPtr) { return false; }
+
+	*value = result;
+	return true;
+}
+
+bool TFE_Parser::parseFixed16(const char* str, s32* value, const char** end)
+{
+	f32 result;
+	if (!parseF32(str, &result, end)) { return false; }
+	*value = s32(result * 65536.0f);
+	return true;
 }
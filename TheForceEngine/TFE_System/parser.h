@@ -10,6 +10,14 @@
 
 typedef std::vector<std::string> TokenList;
 
+// A token produced by the zero-allocation tokenizer, the string is null terminated
+// and lives in the parser scratch memory until the next call to tokenizeLine().
+struct TokenView
+{
+	const char* str;
+	u32 len;
+};
+
 class TFE_Parser
 {
 public:
@@ -35,6 +43,20 @@ public:
 	// Split a line into tokens using space, comma or equals as separators.
 	// Note strings with spaces still work, they need to be closed in quotes, which are removed upon tokenizing.
 	void tokenizeLine(const char* line, TokenList& tokens);
+	// Same as above but without allocating strings, the tokens are written into a per-parser scratch buffer which
+	// is reused for every line. Returns the token count, the tokens remain valid until the next call.
+	s32 tokenizeLine(const char* line, const TokenView** tokens);
+
+	// Fast field parsers to use in place of sscanf(), they return false if the string is not a valid number.
+	// If 'end' is null the whole string must be consumed, otherwise it is set to the first character after the number.
+	static bool parseS32(const char* str, s32* value, const char** end = nullptr);
+	// The result is identical to strtof().
+	static bool parseF32(const char* str, f32* value, const char** end = nullptr);
+	// 16.16 fixed point, rounded the same way as converting the result of parseF32().
+	static bool parseFixed16(const char* str, s32* value, const char** end = nullptr);
+
+private:
+	void tokenizeLineInternal(const char* line);
 
 private:
 	const char* m_buffer;
@@ -44,4 +66,8 @@ private:
 	bool m_blockComment;
 	bool m_enableColorSeperator;
 	bool m_convertToUppercase;
+
+	// Scratch memory for the zero-allocation tokenizer.
+	std::vector<char> m_tokenScratch;
+	std::vector<TokenView> m_tokenViews;
 };
@@ -1,26 +1,29 @@
 #include <cstring>
 
 #include "profiler.h"
+#include <TFE_FileSystem/filestream.h>
 #include <assert.h>
 #include <algorithm>
 #include <vector>
 #include <string>
 #include <map>
 
-// TODO: Support call "paths" - with seperate time per path.
-
 namespace TFE_Profiler
 {
 	#define ZONE_BUFFER_COUNT 2
 	#define MAX_ZONE_STACK 256
-	
+	// Must be a power of 2.
+	#define TRACE_EVENT_COUNT 16384
+	#define TRACE_MAX_THREADS 32
+
+	// Zones form a persistent tree, so the same zone reached through different call paths is tracked separately.
 	struct Zone
 	{
 		u32  id;
 		u32  level = 0;
 		u32  parent = NULL_ZONE;
-		u64  path;
 		u64  frame;
+		const char* namePtr;
 		char name[64];
 		char func[64];
 		u32  lineNumber;
@@ -42,107 +45,172 @@ namespace TFE_Profiler
 		char name[64];
 	};
 
+	struct Timer
+	{
+		u64  ticks;
+		s32  count;
+		f64  time;
+		f64  timeAve;
+		s32  prevCount;
+
+		char name[64];
+	};
+
+	// A completed zone, the name points to the string literal passed to the zone.
+	struct TraceEvent
+	{
+		const char* name;
+		u64 begin;
+		u64 end;
+	};
+
+	// Each thread writes its events into its own ring buffer, so recording requires no locks.
+	// The write count is only modified by the owning thread and is read when writing out a trace.
+	struct ThreadTrace
+	{
+		char name[32];
+		atomic_u32 writeCount;
+		TraceEvent events[TRACE_EVENT_COUNT];
+	};
+
 	typedef std::map<std::string, u32> ZoneMap;
 	typedef std::vector<Zone> ZoneList;
 	typedef std::vector<u32> SortedZoneList;
 	typedef std::vector<Counter> CounterList;
+	typedef std::vector<Timer> TimerList;
 
-	static ZoneMap  s_zoneMap;
 	static ZoneList s_zoneList;
 	static SortedZoneList s_sortedZoneList;
-	static SortedZoneList s_roots;
+	static u32 s_rootZone = NULL_ZONE;
 
 	static ZoneMap  s_counterMap;
 	static CounterList s_counterList;
 
+	static ZoneMap   s_timerMap;
+	static TimerList s_timerList;
+
 	static u64 s_frameBegin;
 	static f64 s_frameTime;
 	static u32 s_readBuffer = 0;
 	static u32 s_writeBuffer = 1;
 	static u32 s_level;
-	static u32 s_maxLevel;
 	static u32 s_zoneStack[MAX_ZONE_STACK];
 	static u64 s_currentFrame = 1;
-	static u64 s_currentPath;
 
-	void addZoneChild(u32 parentId, u32 zoneId)
+	// Zone statistics are only gathered on the main thread, other threads only record trace events.
+	static thread_local bool t_mainThread = false;
+
+	// Trace buffers are never freed since threads may still be writing to them.
+	static atomic_bool s_traceEnabled;
+	static atomic_u32 s_traceThreadCount;
+	static std::atomic<ThreadTrace*> s_traceThreads[TRACE_MAX_THREADS];
+	static thread_local ThreadTrace* t_trace = nullptr;
+	static thread_local const char* t_threadName = nullptr;
+	static thread_local bool t_traceFull = false;
+
+	static u32 findZone(u32 parentId, const char* name)
 	{
-		Zone& parent = s_zoneList[parentId];
-		Zone& zone = s_zoneList[zoneId];
-		// This has already been added.
-		if (zone.sibling != NULL_ZONE)
+		u32 id = parentId == NULL_ZONE ? s_rootZone : s_zoneList[parentId].child;
+		while (id != NULL_ZONE)
 		{
-			return;
+			const Zone* zone = &s_zoneList[id];
+			if (zone->namePtr == name || strncmp(zone->name, name, sizeof(zone->name) - 1) == 0)
+			{
+				return id;
+			}
+			id = zone->sibling;
 		}
+		return NULL_ZONE;
+	}
+
+	static u32 addZone(u32 parentId, const char* name, const char* func, u32 lineNumber)
+	{
+		const u32 id = (u32)s_zoneList.size();
 
-		if (parent.child == zoneId)
+		Zone zone;
+		zone.id = id;
+		zone.level = s_level;
+		zone.parent = parentId;
+		zone.frame = 0;
+		zone.namePtr = name;
+		strncpy(zone.name, name, sizeof(zone.name) - 1);
+		zone.name[sizeof(zone.name) - 1] = 0;
+		strncpy(zone.func, func, sizeof(zone.func) - 1);
+		zone.func[sizeof(zone.func) - 1] = 0;
+		zone.lineNumber = lineNumber;
+		zone.timeInZone[s_readBuffer]  = 0;
+		zone.timeInZone[s_writeBuffer] = 0;
+		zone.timeInZoneAve = 0.0;
+		zone.fractOfParentAve = 0.0;
+
+		// Add as the last child so zones are listed in the order they are first reached.
+		u32* link = parentId == NULL_ZONE ? &s_rootZone : &s_zoneList[parentId].child;
+		while (*link != NULL_ZONE)
 		{
-			return;
+			link = &s_zoneList[*link].sibling;
 		}
-		else if (parent.child == NULL_ZONE)
+		*link = id;
+
+		s_zoneList.push_back(zone);
+		return id;
+	}
+
+	static ThreadTrace* getThreadTrace()
+	{
+		if (t_trace || t_traceFull)
 		{
-			parent.child = zoneId;
+			return t_trace;
 		}
-		else
+
+		const u32 index = s_traceThreadCount.fetch_add(1);
+		if (index >= TRACE_MAX_THREADS)
 		{
-			Zone* child = &s_zoneList[parent.child];
-			while (1)
-			{
-				if (child->sibling == zoneId)
-				{
-					return;
-				}
-				else if (child->sibling == NULL_ZONE)
-				{
-					child->sibling = zoneId;
-					break;
-				}
-				child = &s_zoneList[child->sibling];
-			};
+			t_traceFull = true;
+			return nullptr;
 		}
-	}
 
-	u32 beginZone(const char* name, const char* func, u32 lineNumber)
-	{
-		ZoneMap::iterator iZone = s_zoneMap.find(name);
-		u32 id = 0;
-
-		if (iZone == s_zoneMap.end())
+		ThreadTrace* trace = new ThreadTrace();
+		trace->writeCount.store(0);
+		if (t_threadName)
 		{
-			id = (u32)s_zoneList.size();
-
-			Zone zone;
-			zone.id = id;
-			zone.path = s_currentPath;
-			zone.timeInZone[s_readBuffer]  = 0;
-			zone.timeInZone[s_writeBuffer] = 0;
-			zone.timeInZoneAve = 0.0;
-			zone.fractOfParentAve = 0.0;
-			zone.frame = 0;
-			
-			s_zoneList.push_back(zone);
-			s_zoneMap[name] = id;
+			strncpy(trace->name, t_threadName, sizeof(trace->name) - 1);
 		}
 		else
 		{
-			id = iZone->second;
+			snprintf(trace->name, sizeof(trace->name), "Thread %u", index);
 		}
+		s_traceThreads[index].store(trace, std::memory_order_release);
+		t_trace = trace;
+		return trace;
+	}
 
-		Zone& zone = s_zoneList[id];
-		strcpy(zone.name, name);
-		strcpy(zone.func, func);
-		zone.lineNumber = lineNumber;
-		zone.level = s_level;
+	static void traceEvent(const char* name, u64 begin, u64 end)
+	{
+		ThreadTrace* trace = getThreadTrace();
+		if (!trace) { return; }
+
+		const u32 index = trace->writeCount.load(std::memory_order_relaxed);
+		TraceEvent* traceEvent = &trace->events[index & (TRACE_EVENT_COUNT - 1)];
+		traceEvent->name  = name;
+		traceEvent->begin = begin;
+		traceEvent->end   = end;
+		trace->writeCount.store(index + 1, std::memory_order_release);
+	}
 
-		zone.parent = s_level > 0 ? s_zoneStack[s_level - 1] : NULL_ZONE;
-		if (zone.parent == NULL_ZONE)
+	u32 beginZone(const char* name, const char* func, u32 lineNumber)
+	{
+		if (!t_mainThread || s_level >= MAX_ZONE_STACK)
 		{
-			s_roots.push_back(id);
+			return NULL_ZONE;
 		}
-		else
+
+		const u32 parentId = s_level > 0 ? s_zoneStack[s_level - 1] : NULL_ZONE;
+		u32 id = findZone(parentId, name);
+		if (id == NULL_ZONE)
 		{
-			addZoneChild(zone.parent, zone.id);
+			id = addZone(parentId, name, func, lineNumber);
 		}
+		s_zoneList[id].frame = s_currentFrame;
 
 		s_zoneStack[s_level] = id;
 		s_level++;
@@ -150,10 +218,27 @@ namespace TFE_Profiler
 		return id;
 	}
 
-	void endZone(u32 id, u64 dt)
+	void endZone(u32 id, const char* name, u64 beginTime, u64 endTime)
+	{
+		if (id != NULL_ZONE)
+		{
+			s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(endTime - beginTime);
+			s_level--;
+		}
+		if (s_traceEnabled.load(std::memory_order_relaxed))
+		{
+			traceEvent(name, beginTime, endTime);
+		}
+	}
+
+	void setThreadName(const char* name)
 	{
-		s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
-		s_level--;
+		if (t_threadName == name) { return; }
+		t_threadName = name;
+		if (t_trace)
+		{
+			strncpy(t_trace->name, name, sizeof(t_trace->name) - 1);
+		}
 	}
 
 	void addCounter(const char* name, s32* counter)
@@ -174,12 +259,46 @@ namespace TFE_Profiler
 		}
 	}
 
+	u32 getTimer(const char* name)
+	{
+		ZoneMap::iterator iTimer = s_timerMap.find(name);
+		if (iTimer != s_timerMap.end())
+		{
+			return iTimer->second;
+		}
+
+		const u32 id = (u32)s_timerList.size();
+		Timer newTimer = {};
+		strncpy(newTimer.name, name, sizeof(newTimer.name) - 1);
+
+		s_timerList.push_back(newTimer);
+		s_timerMap[name] = id;
+		return id;
+	}
+
+	void clearTimers()
+	{
+		s_timerMap.clear();
+		s_timerList.clear();
+	}
+
+	void addTimerTicks(u32 id, u64 ticks)
+	{
+		if (id >= (u32)s_timerList.size()) { return; }
+		s_timerList[id].ticks += ticks;
+		s_timerList[id].count++;
+	}
+
 	void frameBegin()
 	{
+		if (!t_mainThread)
+		{
+			t_mainThread = true;
+			setThreadName("Main");
+		}
+
 		std::swap(s_readBuffer, s_writeBuffer);
 		s_level = 0;
-		s_maxLevel = 0;
-		s_roots.clear();
 
 		// Swap buffers, s_readBuffer is safe to read in the middle of the next frame.
 		const size_t zoneCount = s_zoneList.size();
@@ -199,44 +318,36 @@ namespace TFE_Profiler
 		s_frameBegin = TFE_System::getCurrentTimeInTicks();
 	}
 
+	// List the zones reached this frame in call order, parents before children.
 	void traverseZoneTree(u32 id)
 	{
-		if (id == NULL_ZONE) { return; }
-		Zone* zone = &s_zoneList[id];
-		// Make sure zones are only inserted once for now.
-		if (zone->frame != s_currentFrame)
-		{
-			s_sortedZoneList.push_back(id);
-		}
-		zone->frame = s_currentFrame;
-		
-		while (zone->child != NULL_ZONE)
+		while (id != NULL_ZONE)
 		{
-			traverseZoneTree(zone->child);
-			zone = &s_zoneList[zone->child];
-		}
-
-		zone = &s_zoneList[id];
-		while (zone->sibling != NULL_ZONE)
-		{
-			traverseZoneTree(zone->sibling);
-			zone = &s_zoneList[zone->sibling];
+			const Zone* zone = &s_zoneList[id];
+			if (zone->frame == s_currentFrame)
+			{
+				s_sortedZoneList.push_back(id);
+				traverseZoneTree(zone->child);
+			}
+			id = zone->sibling;
 		}
 	}
 
 	void frameEnd()
 	{
-		s_frameTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_frameBegin);
+		const u64 frameEnd = TFE_System::getCurrentTimeInTicks();
+		s_frameTime = TFE_System::convertFromTicksToSeconds(frameEnd - s_frameBegin);
+		if (s_traceEnabled.load(std::memory_order_relaxed))
+		{
+			traceEvent("Frame", s_frameBegin, frameEnd);
+		}
+
 		const size_t zoneCount = s_zoneList.size();
 		const f64 expBlend = 0.99;
 
 		// Sort Zones
 		s_sortedZoneList.clear();
-		const size_t rootCount = s_roots.size();
-		for (size_t r = 0; r < rootCount; r++)
-		{
-			traverseZoneTree(s_roots[r]);
-		}
+		traverseZoneTree(s_rootZone);
 
 		// First compute delta times for each zone.
 		for (size_t i = 0; i < zoneCount; i++)
@@ -244,7 +355,7 @@ namespace TFE_Profiler
 			s_zoneList[i].timeInZoneAve = expBlend * s_zoneList[i].timeInZoneAve + (1.0 - expBlend)*s_zoneList[i].timeInZone[s_writeBuffer];
 		}
 
-		// Then handle percentage of parent and clear
+		// Then handle percentage of parent
 		for (size_t i = 0; i < zoneCount; i++)
 		{
 			f64 parentTime = (s_zoneList[i].parent != NULL_ZONE) ? s_zoneList[s_zoneList[i].parent].timeInZone[s_writeBuffer] : s_frameTime;
@@ -255,9 +366,18 @@ namespace TFE_Profiler
 			{
 				s_zoneList[i].fractOfParentAve = 0.0;
 			}
+		}
 
-			s_zoneList[i].child = NULL_ZONE;
-			s_zoneList[i].sibling = NULL_ZONE;
+		// Timers are read during the next frame, so the results are copied out and the accumulators reset.
+		const size_t timerCount = s_timerList.size();
+		for (size_t i = 0; i < timerCount; i++)
+		{
+			Timer& timer = s_timerList[i];
+			timer.time = TFE_System::convertFromTicksToSeconds(timer.ticks);
+			timer.timeAve = expBlend * timer.timeAve + (1.0 - expBlend)*timer.time;
+			timer.prevCount = timer.count;
+			timer.ticks = 0;
+			timer.count = 0;
 		}
 
 		s_currentFrame++;
@@ -301,4 +421,120 @@ namespace TFE_Profiler
 		info->name = counter.name;
 		info->value = counter.prevValue;
 	}
+
+	u32 getTimerCount()
+	{
+		return (u32)s_timerList.size();
+	}
+
+	void getTimerInfo(u32 index, TFE_TimerInfo* info)
+	{
+		if (index >= (u32)s_timerList.size()) { return; }
+
+		Timer& timer = s_timerList[index];
+		info->name = timer.name;
+		info->time = timer.time;
+		info->timeAve = timer.timeAve;
+		info->count = timer.prevCount;
+	}
+
+	/////////////////////////////////////////////
+	// Trace Capture
+	/////////////////////////////////////////////
+	void enableTrace(bool enable)
+	{
+		s_traceEnabled.store(enable);
+	}
+
+	bool isTraceEnabled()
+	{
+		return s_traceEnabled.load();
+	}
+
+	// Copy the events that completed in the capture window.
+	// Other threads keep writing while the buffer is copied, so events that may have been overwritten during the copy are discarded.
+	static void copyThreadEvents(ThreadTrace* trace, u64 windowStart, u64 windowEnd, std::vector<TraceEvent>& events)
+	{
+		const u32 writeCount = trace->writeCount.load(std::memory_order_acquire);
+		const u32 first = writeCount > TRACE_EVENT_COUNT ? writeCount - TRACE_EVENT_COUNT : 0;
+		const size_t start = events.size();
+		for (u32 i = first; i < writeCount; i++)
+		{
+			events.push_back(trace->events[i & (TRACE_EVENT_COUNT - 1)]);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const u32 newWriteCount = trace->writeCount.load(std::memory_order_relaxed);
+		// Once the buffer has wrapped, the event being written (index newWriteCount) shares its slot with the oldest event,
+		// so the oldest event may be torn as well.
+		const u32 validFirst = newWriteCount >= TRACE_EVENT_COUNT ? newWriteCount - TRACE_EVENT_COUNT + 1 : 0;
+		const size_t skip = std::min(size_t(validFirst > first ? validFirst - first : 0), events.size() - start);
+
+		size_t outIndex = start;
+		for (size_t i = start + skip; i < events.size(); i++)
+		{
+			if (events[i].end >= windowStart && events[i].end <= windowEnd)
+			{
+				events[outIndex++] = events[i];
+			}
+		}
+		events.resize(outIndex);
+	}
+
+	// Write the events from the last 'windowInSeconds' seconds in the Chrome trace event format, which can be viewed
+	// with chrome://tracing or Perfetto.
+	bool writeTrace(const char* path, f64 windowInSeconds)
+	{
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_WRITE))
+		{
+			return false;
+		}
+
+		const u64 windowEnd = TFE_System::getCurrentTimeInTicks();
+		const f64 ticksPerSecond = 1.0 / TFE_System::convertFromTicksToSeconds(1);
+		const u64 windowTicks = u64(std::max(windowInSeconds, 0.0) * ticksPerSecond);
+		const u64 windowStart = windowEnd > windowTicks ? windowEnd - windowTicks : 0;
+
+		const u32 threadCount = std::min(s_traceThreadCount.load(), u32(TRACE_MAX_THREADS));
+		std::vector<TraceEvent> events;
+		std::vector<u32> threadEventStart;
+		u64 base = windowEnd;
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			threadEventStart.push_back(u32(events.size()));
+			ThreadTrace* trace = s_traceThreads[t].load(std::memory_order_acquire);
+			if (!trace) { continue; }
+
+			copyThreadEvents(trace, windowStart, windowEnd, events);
+		}
+		threadEventStart.push_back(u32(events.size()));
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			base = std::min(base, events[i].begin);
+		}
+
+		file.writeString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		bool first = true;
+		for (u32 t = 0; t < threadCount; t++)
+		{
+			ThreadTrace* trace = s_traceThreads[t].load(std::memory_order_acquire);
+			if (!trace) { continue; }
+
+			file.writeString("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", t, trace->name);
+			first = false;
+			for (u32 i = threadEventStart[t]; i < threadEventStart[t + 1]; i++)
+			{
+				const TraceEvent* traceEvent = &events[i];
+				const f64 ts  = TFE_System::convertFromTicksToSeconds(traceEvent->begin - base) * 1000000.0;
+				const f64 dur = TFE_System::convertFromTicksToSeconds(traceEvent->end - traceEvent->begin) * 1000000.0;
+				file.writeString(",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%0.3f,\"dur\":%0.3f}", traceEvent->name, t, ts, dur);
+			}
+		}
+		file.writeString("\n]}\n");
+		file.close();
+
+		TFE_System::logWrite(LOG_MSG, "Profiler", "Wrote %u trace events from %u threads to '%s'.", u32(events.size()), threadCount, path);
+		return true;
+	}
 }
@@ -3,7 +3,11 @@
 // The Force Engine Profiler
 // Simple "zone" based profiler.
 // Add TFE_PROFILE_ENABLED to preprocessor defines in the build to enable.
-// Currently does not respect the call path, that is TODO.
+// Zone statistics are gathered on the main thread per call path.
+// When tracing is enabled, every thread also records its zones into
+// a lock-free ring buffer, and the last few seconds can be written
+// out in the Chrome trace format (chrome://tracing or Perfetto).
+// Zone names must be string literals.
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
@@ -50,17 +54,34 @@ struct TFE_CounterInfo
 	s32   value;
 };
 
+struct TFE_TimerInfo
+{
+	char* name;
+	f64   time;		// time accumulated during the previous frame.
+	f64   timeAve;
+	s32   count;	// number of times the timer was added to during the previous frame.
+};
+
 namespace TFE_Profiler
 {
 	// The main profiling API is used through Macros which can be disabled based on build flags.
 	u32  beginZone(const char* name, const char* func, u32 lineNumber);
-	void endZone(u32 id, u64 dt);
+	void endZone(u32 id, const char* name, u64 beginTime, u64 endTime);
+	// Name the calling thread in traces, the name must be a string literal.
+	void setThreadName(const char* name);
 		
 	void frameBegin();
 	void frameEnd();
 
 	void addCounter(const char* name, s32* counter);
 
+	// Named timers accumulate time for work that cannot be wrapped in a zone, such as script tasks
+	// whose names are only known at runtime. The name is copied and timers with the same name are shared.
+	u32  getTimer(const char* name);
+	void addTimerTicks(u32 id, u64 ticks);
+	// Remove all timers, previously returned ids are no longer valid.
+	void clearTimers();
+
 	// Profile data API, this is used directly.
 	f64  getTimeInFrame();
 
@@ -69,6 +90,14 @@ namespace TFE_Profiler
 	
 	u32  getCounterCount();
 	void getCounterInfo(u32 index, TFE_CounterInfo* info);
+
+	u32  getTimerCount();
+	void getTimerInfo(u32 index, TFE_TimerInfo* info);
+
+	// Trace capture.
+	void enableTrace(bool enable);
+	bool isTraceEnabled();
+	bool writeTrace(const char* path, f64 windowInSeconds);
 }
 
 class TFE_Profiler_Zone
@@ -76,18 +105,19 @@ class TFE_Profiler_Zone
 public:
 	TFE_Profiler_Zone(const char* name, const char* func, u32 lineNumber)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
+		m_name = name;
 		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		m_time = TFE_System::getCurrentTimeInTicks();
 	}
 
 	~TFE_Profiler_Zone()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id, m_name, m_time, TFE_System::getCurrentTimeInTicks());
 	}
 private:
+	const char* m_name;
 	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 
 class TFE_Profiler_ZoneManual
@@ -95,17 +125,18 @@ class TFE_Profiler_ZoneManual
 public:
 	TFE_Profiler_ZoneManual(const char* name, const char* func, u32 lineNumber)
 	{
-		m_time = TFE_System::getCurrentTimeInTicks();
+		m_name = name;
 		m_id = TFE_Profiler::beginZone(name, func, lineNumber);
+		m_time = TFE_System::getCurrentTimeInTicks();
 	}
 
 	void end()
 	{
-		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id, m_name, m_time, TFE_System::getCurrentTimeInTicks());
 	}
 private:
+	const char* m_name;
 	u64 m_time;
-	s32 m_id;
+	u32 m_id;
 };
 #endif
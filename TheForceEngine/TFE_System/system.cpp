@@ -27,6 +27,8 @@ namespace TFE_System
 
 	static f64 s_dt = 1.0 / 60.0;		// This is just to handle the first frame, so any reasonable value will work.
 	static const f64 c_maxDt = 0.05;	// 20 fps
+	static f64 s_fixedDt = 0.0;
+	static f64 s_fixedTime = 0.0;
 
 	static bool s_synced = false;
 	static bool s_resetStartTime = false;
@@ -100,6 +102,14 @@ namespace TFE_System
 			s_resetStartTime = false;
 		}
 
+		// Fixed time step, time only advances when update() is called.
+		if (s_fixedDt > 0.0)
+		{
+			s_fixedTime += s_fixedDt;
+			s_dt = s_fixedDt;
+			return;
+		}
+
 		// Delta time since the previous frame.
 		f64 dt = f64(uDt) * s_freq;
 
@@ -143,10 +153,20 @@ namespace TFE_System
 	// Get time since "start time"
 	f64 getTime()
 	{
+		if (s_fixedDt > 0.0)
+		{
+			return s_fixedTime;
+		}
 		const u64 uDt = s_time - s_startTime;
 		return f64(uDt) * s_freq;
 	}
 	
+	void setFixedTimeStep(f64 timeStep)
+	{
+		s_fixedDt = std::max(timeStep, 0.0);
+		s_fixedTime = 0.0;
+	}
+
 	u64 getCurrentTimeInTicks()
 	{
 		return SDL_GetPerformanceCounter() - s_startTime;
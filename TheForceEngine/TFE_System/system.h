@@ -37,6 +37,9 @@ namespace TFE_System
 	f64 getDeltaTime();
 	// Get the absolute time since the last start time.
 	f64 getTime();
+	// Use a fixed delta time per update() instead of the measured time, used for deterministic runs such as benchmarks.
+	// Pass 0.0 to go back to real time.
+	void setFixedTimeStep(f64 timeStep);
 
 	u64 getCurrentTimeInTicks();
 	f64 convertFromTicksToSeconds(u64 ticks);
@@ -16,6 +16,7 @@
 #include <TFE_Settings/settings.h>
 #include <TFE_System/system.h>
 #include <TFE_Jedi/Task/task.h>
+#include <TFE_Jedi/Renderer/virtualFramebuffer.h>
 #include <TFE_Asset/paletteAsset.h>
 #include <TFE_Asset/imageAsset.h>
 #include <TFE_Ui/ui.h>
@@ -58,6 +59,7 @@ static u32  s_monitorWidth = 1280;
 static u32  s_monitorHeight = 720;
 static char s_screenshotTime[TFE_MAX_PATH];
 static IGame* s_curGame = nullptr;
+static bool s_headless = false;
 
 void parseOption(const char* name, const std::vector<const char*>& values, bool longName);
 
@@ -430,6 +432,71 @@ void generateScreenshotTime()
 	}
 }
 
+// Run the game without a window or GPU, the game renders into the CPU framebuffer only.
+// This is used by the benchmark runner (--benchmark), input and display events are not processed.
+int runHeadless(int argc, char* argv[])
+{
+	TFE_System::logWrite(LOG_MSG, "Progam Flow", "Running headless.");
+	if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0)
+	{
+		TFE_System::logWrite(LOG_CRITICAL, "SDL", "Cannot initialize SDL.");
+		return PROGRAM_ERROR;
+	}
+	TFE_System::init(0.0f, false, c_gitVersion);
+	TFE_Jedi::vfb_setHeadless(JTRUE);
+
+	TFE_Audio::init();
+	TFE_MidiPlayer::init();
+	TFE_Polygon::init();
+	TFE_Image::init();
+	TFE_Jedi::inf_init();
+	TFE_Palette::createDefault256();
+	game_init();
+	inputMapping_startup();
+
+	setAppState(APP_STATE_GAME, argc, argv);
+	if (s_curState != APP_STATE_GAME)
+	{
+		TFE_System::logWrite(LOG_ERROR, "Progam Flow", "Cannot start the game headless.");
+	}
+
+	while (s_curState == APP_STATE_GAME && s_curGame && !TFE_System::quitMessagePosted())
+	{
+		TFE_FRAME_BEGIN();
+		TFE_System::update();
+		s_curGame->loopGame();
+		const bool endInputFrame = TFE_Jedi::task_run() != 0;
+		TFE_Audio::updateSources();
+
+		if (endInputFrame)
+		{
+			TFE_Input::endFrame();
+			inputMapping_endFrame();
+			TFE_FRAME_END();
+		}
+	}
+
+	if (s_curGame)
+	{
+		freeGame(s_curGame);
+		s_curGame = nullptr;
+	}
+	game_destroy();
+	inputMapping_shutdown();
+
+	TFE_Audio::shutdown();
+	TFE_MidiPlayer::destroy();
+	TFE_Polygon::shutdown();
+	TFE_Image::shutdown();
+	TFE_Jedi::inf_shutdown();
+	TFE_Palette::freeAll();
+	// Settings are not written back to disk, the benchmark changes them for the run.
+	SDL_Quit();
+
+	TFE_System::logWrite(LOG_MSG, "Progam Flow", "Headless run ended.");
+	return PROGRAM_SUCCESS;
+}
+
 int main(int argc, char* argv[])
 {
 	// Paths
@@ -474,6 +541,13 @@ int main(int argc, char* argv[])
 	TFE_System::logWrite(LOG_MSG, "Paths", "User Documents: \"%s\"", TFE_Paths::getPath(PATH_USER_DOCUMENTS));
 	TFE_System::logWrite(LOG_MSG, "Paths", "Source Data: \"%s\"",    TFE_Paths::getPath(PATH_SOURCE_DATA));
 
+	if (s_headless)
+	{
+		const int result = runHeadless(argc, argv);
+		TFE_System::logClose();
+		return result;
+	}
+
 	// Create a screenshot directory
 	char screenshotDir[TFE_MAX_PATH];
 	TFE_Paths::appendPath(TFE_PathType::PATH_USER_DOCUMENTS, "Screenshots/", screenshotDir);
@@ -682,6 +756,7 @@ int main(int argc, char* argv[])
 		{
 			TFE_RenderBackend::clearWindow();
 		}
+		TFE_Audio::updateSources();
 		TFE_FrontEndUI::draw(s_curState == APP_STATE_MENU || s_curState == APP_STATE_NO_GAME_DATA, s_curState == APP_STATE_NO_GAME_DATA);
 
 		bool swap = s_curState != APP_STATE_EDITOR && (s_curState != APP_STATE_MENU || TFE_FrontEndUI::isConfigMenuOpen());
@@ -795,5 +870,17 @@ void parseOption(const char* name, const std::vector<const char*>& values, bool
 			// --nocutscenes
 			TFE_System::logWrite(LOG_MSG, "CommandLine", "Disable cutscenes and title screen.");
 		}
+		else if (strcasecmp(name, "benchmark") == 0 && values.size() >= 1)	// Run the level benchmark without a window, see TFE_DarkForces/benchmark.h
+		{
+			// --benchmark SECBASE
+			TFE_System::logWrite(LOG_MSG, "CommandLine", "Benchmark level: %s", values[0]);
+			s_headless = true;
+		}
+		else if (strcasecmp(name, "benchDemo") == 0 && values.size() >= 1)	// Run the benchmark using a recorded demo, see TFE_DarkForces/demo.h
+		{
+			// --benchDemo run.tfd
+			TFE_System::logWrite(LOG_MSG, "CommandLine", "Benchmark demo: %s", values[0]);
+			s_headless = true;
+		}
 	}
 }
\ No newline at end of file